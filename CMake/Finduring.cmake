@@ -0,0 +1,37 @@
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# - Try to find liburing
+# Once done, this will define
+#
+# URING_FOUND - system has liburing
+# uring::uring will be defined based on CMAKE_FIND_LIBRARY_SUFFIXES priority
+
+include(FindPackageHandleStandardArgs)
+
+find_library(URING_LIBRARY uring PATHS ${URING_LIBRARYDIR})
+
+find_path(URING_INCLUDE_DIR liburing.h PATHS ${URING_INCLUDEDIR})
+
+find_package_handle_standard_args(uring DEFAULT_MSG URING_LIBRARY
+                                  URING_INCLUDE_DIR)
+
+mark_as_advanced(URING_LIBRARY URING_INCLUDE_DIR)
+
+if(NOT TARGET uring::uring)
+  add_library(uring::uring UNKNOWN IMPORTED)
+  set_target_properties(
+    uring::uring PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${URING_INCLUDE_DIR}"
+                            IMPORTED_LOCATION "${URING_LIBRARY}")
+endif()
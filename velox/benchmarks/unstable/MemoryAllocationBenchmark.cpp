@@ -15,6 +15,7 @@
  */
 
 #include <deque>
+#include <thread>
 
 #include <folly/Benchmark.h>
 #include <folly/init/Init.h>
@@ -33,6 +34,11 @@ DEFINE_int64(
     memory_free_every_n_operations,
     5,
     "Specifies memory free for every N operations. If it is 5, then we free one of existing memory allocation for every 5 memory operations");
+DEFINE_int64(
+    memory_reservation_cache_bytes,
+    8 << 20,
+    "The reservation cache size of the leaf memory pools in the concurrent "
+    "allocation benchmarks which enable the reservation cache");
 
 using namespace facebook::velox;
 using namespace facebook::velox::memory;
@@ -432,6 +438,109 @@ BENCHMARK_RELATIVE_MULTI(MmapReallocateMix64) {
   MemoryPoolAllocationBenchMark benchmark(Type::kMmap, 64, 128, 32 << 20);
   return benchmark.runReallocate();
 }
+// Allocates and frees memory from 'numThreads' threads concurrently, each
+// through its own leaf memory pool under a shared root pool as the drivers of
+// a query do. Measures the contention on the memory reservation of the shared
+// root pool with and without the reservation cache of the leaf pools.
+size_t runConcurrentAllocate(
+    int numThreads,
+    bool reservationCache,
+    size_t minSize,
+    size_t maxSize) {
+  folly::BenchmarkSuspender suspender;
+  auto manager = std::make_shared<MemoryManager>(MemoryManagerOptions{
+      .reservationCacheBytes = reservationCache
+          ? static_cast<uint64_t>(FLAGS_memory_reservation_cache_bytes)
+          : 0});
+  auto root = manager->addRootPool("ConcurrentAllocationBenchMark");
+  std::vector<std::shared_ptr<MemoryPool>> pools;
+  pools.reserve(numThreads);
+  for (int i = 0; i < numThreads; ++i) {
+    pools.push_back(root->addLeafChild(fmt::format("leaf{}", i)));
+  }
+  const uint64_t maxBytesPerThread =
+      std::max<uint64_t>(maxSize, FLAGS_memory_allocation_bytes / numThreads);
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads);
+  suspender.dismiss();
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      auto* pool = pools[i].get();
+      folly::Random::DefaultGenerator rng(FLAGS_allocation_size_seed + i);
+      std::deque<std::pair<void*, size_t>> allocations;
+      uint64_t sumAllocBytes{0};
+      auto freeOne = [&]() {
+        const auto [ptr, size] = allocations.front();
+        allocations.pop_front();
+        pool->free(ptr, size);
+        sumAllocBytes -= size;
+      };
+      for (auto iter = 0; iter < FLAGS_memory_allocation_count; ++iter) {
+        if (iter % FLAGS_memory_free_every_n_operations == 0 &&
+            !allocations.empty()) {
+          freeOne();
+        }
+        while (sumAllocBytes >= maxBytesPerThread) {
+          freeOne();
+        }
+        const size_t size =
+            minSize + folly::Random::rand32(maxSize - minSize + 1, rng);
+        allocations.emplace_back(pool->allocate(size), size);
+        sumAllocBytes += size;
+      }
+      while (!allocations.empty()) {
+        freeOne();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  suspender.rehire();
+  return FLAGS_memory_allocation_count * numThreads;
+}
+
+// Concurrent allocateBytes API with and without the reservation cache.
+BENCHMARK_MULTI(ConcurrentAllocateSmall16Threads) {
+  return runConcurrentAllocate(16, false, 128, 3072);
+}
+
+BENCHMARK_RELATIVE_MULTI(ConcurrentAllocateSmall16ThreadsReservationCache) {
+  return runConcurrentAllocate(16, true, 128, 3072);
+}
+
+BENCHMARK_MULTI(ConcurrentAllocateSmall64Threads) {
+  return runConcurrentAllocate(64, false, 128, 3072);
+}
+
+BENCHMARK_RELATIVE_MULTI(ConcurrentAllocateSmall64ThreadsReservationCache) {
+  return runConcurrentAllocate(64, true, 128, 3072);
+}
+
+BENCHMARK_MULTI(ConcurrentAllocateSmall128Threads) {
+  return runConcurrentAllocate(128, false, 128, 3072);
+}
+
+BENCHMARK_RELATIVE_MULTI(ConcurrentAllocateSmall128ThreadsReservationCache) {
+  return runConcurrentAllocate(128, true, 128, 3072);
+}
+
+BENCHMARK_MULTI(ConcurrentAllocateMid64Threads) {
+  return runConcurrentAllocate(64, false, 4 << 10, 1 << 20);
+}
+
+BENCHMARK_RELATIVE_MULTI(ConcurrentAllocateMid64ThreadsReservationCache) {
+  return runConcurrentAllocate(64, true, 4 << 10, 1 << 20);
+}
+
+BENCHMARK_MULTI(ConcurrentAllocateMid128Threads) {
+  return runConcurrentAllocate(128, false, 4 << 10, 1 << 20);
+}
+
+BENCHMARK_RELATIVE_MULTI(ConcurrentAllocateMid128ThreadsReservationCache) {
+  return runConcurrentAllocate(128, true, 4 << 10, 1 << 20);
+}
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -449,6 +449,11 @@ void registerVeloxMetrics() {
       kMetricArbitratorFreeReservedCapacityBytes,
       facebook::velox::StatType::AVG);
 
+  // The sum of memory capacity in bytes granted up front to the query memory
+  // pools from their capacity hints.
+  DEFINE_METRIC(
+      kMetricArbitratorCapacityHintBytes, facebook::velox::StatType::SUM);
+
   // Tracks the leaf memory pool usage leak in bytes.
   DEFINE_METRIC(
       kMetricMemoryPoolUsageLeakBytes, facebook::velox::StatType::SUM);
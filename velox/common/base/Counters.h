@@ -123,6 +123,9 @@ constexpr folly::StringPiece kMetricArbitratorFreeCapacityBytes{
 constexpr folly::StringPiece kMetricArbitratorFreeReservedCapacityBytes{
     "velox.arbitrator_free_reserved_capacity_bytes"};
 
+constexpr folly::StringPiece kMetricArbitratorCapacityHintBytes{
+    "velox.arbitrator_capacity_hint_bytes"};
+
 constexpr folly::StringPiece kMetricDriverYieldCount{
     "velox.driver_yield_count"};
 
@@ -21,6 +21,7 @@
 
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include "velox/common/base/PrefixSortConfig.h"
+#include "velox/common/base/SpillDirectorySelector.h"
 #include "velox/common/compression/Compression.h"
 
 namespace facebook::velox::common {
@@ -72,7 +73,10 @@ struct SpillConfig {
       uint64_t _writerFlushThresholdSize,
       const std::string& _compressionKind,
       std::optional<PrefixSortConfig> _prefixSortConfig = std::nullopt,
-      const std::string& _fileCreateConfig = {});
+      const std::string& _fileCreateConfig = {},
+      uint32_t _maxPendingWrites = 0,
+      bool _columnarEncoding = false,
+      std::shared_ptr<SpillDirectorySelector> _directorySelector = nullptr);
 
   /// Returns the spilling level with given 'startBitOffset' and
   /// 'numPartitionBits'.
@@ -157,5 +161,22 @@ struct SpillConfig {
 
   /// Custom options passed to velox::FileSystem to create spill WriteFile.
   std::string fileCreateConfig;
+
+  /// The max number of serialized spill buffers of a spill writer which can
+  /// be queued for the asynchronous disk writes on 'executor', in addition to
+  /// the one being written. The spilling thread blocks when the queue is
+  /// full. If it is zero or 'executor' is not set, then the spilled data is
+  /// written synchronously on the spilling thread.
+  uint32_t maxPendingWrites{0};
+
+  /// If true, the spilled data with only scalar columns is written in the
+  /// columnar spill format with the lightweight per-column encodings.
+  bool columnarEncoding{false};
+
+  /// If set, the spill files are spread over the directories of the selector
+  /// instead of being created in the directory returned by
+  /// 'getSpillDirPathCb'. The latter is still invoked to create the
+  /// directories before the first spill file.
+  std::shared_ptr<SpillDirectorySelector> directorySelector;
 };
 } // namespace facebook::velox::common
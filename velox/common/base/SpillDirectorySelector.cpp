@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/SpillDirectorySelector.h"
+
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include <map>
+#include <memory>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SuccinctPrinter.h"
+
+namespace facebook::velox::common {
+namespace {
+struct DeviceRegistry {
+  std::mutex mutex;
+  std::map<std::string, std::unique_ptr<SpillDevice>> devices;
+};
+
+DeviceRegistry& deviceRegistry() {
+  static DeviceRegistry registry;
+  return registry;
+}
+
+// Returns the device id of 'directory' if it is on a local file system,
+// otherwise the directory path itself.
+std::string deviceOf(const std::string& directory) {
+  struct stat st;
+  if (::stat(directory.c_str(), &st) == 0) {
+    return fmt::format("dev-{}", static_cast<uint64_t>(st.st_dev));
+  }
+  return directory;
+}
+} // namespace
+
+uint64_t SpillDeviceStats::spillWriteThroughput() const {
+  if (spillWriteTimeNanos == 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(
+      spilledBytes * 1'000'000'000.0 / spillWriteTimeNanos);
+}
+
+std::string SpillDeviceStats::toString() const {
+  return fmt::format(
+      "device[{}] spilledFiles[{}] spilledBytes[{}] spillWriteTimeNanos[{}] "
+      "spillWriteThroughput[{}/s] pendingWrites[{}] capacityBytes[{}] "
+      "freeBytes[{}]",
+      device,
+      spilledFiles,
+      succinctBytes(spilledBytes),
+      succinctNanos(spillWriteTimeNanos),
+      succinctBytes(spillWriteThroughput()),
+      pendingWrites,
+      succinctBytes(capacityBytes),
+      succinctBytes(freeBytes));
+}
+
+// static
+SpillDevice* SpillDevice::get(const std::string& directory) {
+  auto device = deviceOf(directory);
+  auto& registry = deviceRegistry();
+  std::lock_guard<std::mutex> l(registry.mutex);
+  auto& entry = registry.devices[device];
+  if (entry == nullptr) {
+    entry.reset(new SpillDevice(std::move(device)));
+    entry->updateSpace(directory);
+  }
+  return entry.get();
+}
+
+void SpillDevice::finishWrite(uint64_t bytes, uint64_t writeTimeNs) {
+  VELOX_CHECK_GT(pendingWrites_.load(), 0);
+  --pendingWrites_;
+  spilledBytes_ += bytes;
+  spillWriteTimeNanos_ += writeTimeNs;
+}
+
+void SpillDevice::addFile(const std::string& directory) {
+  ++spilledFiles_;
+  updateSpace(directory);
+}
+
+void SpillDevice::updateSpace(const std::string& directory) {
+  struct statvfs st;
+  if (::statvfs(directory.c_str(), &st) != 0) {
+    return;
+  }
+  capacityBytes_ = static_cast<uint64_t>(st.f_blocks) * st.f_frsize;
+  freeBytes_ = static_cast<uint64_t>(st.f_bavail) * st.f_frsize;
+}
+
+SpillDeviceStats SpillDevice::stats() const {
+  SpillDeviceStats stats;
+  stats.device = device_;
+  stats.spilledFiles = spilledFiles_;
+  stats.spilledBytes = spilledBytes_;
+  stats.spillWriteTimeNanos = spillWriteTimeNanos_;
+  stats.pendingWrites = pendingWrites_;
+  stats.capacityBytes = capacityBytes_;
+  stats.freeBytes = freeBytes_;
+  return stats;
+}
+
+std::vector<SpillDeviceStats> globalSpillDeviceStats() {
+  auto& registry = deviceRegistry();
+  std::lock_guard<std::mutex> l(registry.mutex);
+  std::vector<SpillDeviceStats> stats;
+  stats.reserve(registry.devices.size());
+  for (const auto& [_, device] : registry.devices) {
+    stats.push_back(device->stats());
+  }
+  return stats;
+}
+
+// static
+std::string_view SpillDirectorySelector::policyName(Policy policy) {
+  switch (policy) {
+    case Policy::kRoundRobin:
+      return "round_robin";
+    case Policy::kLeastLoaded:
+      return "least_loaded";
+  }
+  VELOX_UNREACHABLE();
+}
+
+// static
+SpillDirectorySelector::Policy SpillDirectorySelector::toPolicy(
+    std::string_view name) {
+  if (name == "round_robin") {
+    return Policy::kRoundRobin;
+  }
+  if (name == "least_loaded") {
+    return Policy::kLeastLoaded;
+  }
+  VELOX_USER_FAIL("Unknown spill directory selection policy: {}", name);
+}
+
+SpillDirectorySelector::SpillDirectorySelector(
+    std::vector<std::string> directories,
+    Policy policy)
+    : directories_(std::move(directories)), policy_(policy) {
+  VELOX_CHECK(!directories_.empty(), "No spill directory specified");
+}
+
+const std::vector<SpillDevice*>& SpillDirectorySelector::devices() {
+  std::call_once(devicesOnce_, [&]() {
+    devices_.reserve(directories_.size());
+    for (const auto& directory : directories_) {
+      devices_.push_back(SpillDevice::get(directory));
+    }
+  });
+  return devices_;
+}
+
+SpillDevice* SpillDirectorySelector::device(uint32_t index) {
+  return devices()[index];
+}
+
+uint32_t SpillDirectorySelector::select() {
+  const auto& spillDevices = devices();
+  const uint32_t numDirectories = directories_.size();
+  // Starts from the round robin choice so that the files are striped across
+  // the devices which are equally loaded. The free space only matters if it
+  // is much less than the others as it varies all the time.
+  const uint32_t start = nextIndex_++ % numDirectories;
+  if (policy_ == Policy::kRoundRobin) {
+    return start;
+  }
+  uint32_t selected = start;
+  for (uint32_t i = 1; i < numDirectories; ++i) {
+    const uint32_t index = (start + i) % numDirectories;
+    const auto* candidate = spillDevices[index];
+    const auto* best = spillDevices[selected];
+    if (candidate->pendingWrites() < best->pendingWrites() ||
+        (candidate->pendingWrites() == best->pendingWrites() &&
+         best->freeBytes() < candidate->freeBytes() / 2)) {
+      selected = index;
+    }
+  }
+  return selected;
+}
+} // namespace facebook::velox::common
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace facebook::velox::common {
+
+/// The process wide stats of a storage device used for spilling.
+struct SpillDeviceStats {
+  /// Identifies the device. It is the device id of the file system if the
+  /// spill directory is on a local file system, otherwise the directory path.
+  std::string device;
+  /// The number of spill files created on the device.
+  uint64_t spilledFiles{0};
+  /// The number of bytes written to the device.
+  uint64_t spilledBytes{0};
+  /// The time spent on writing to the device.
+  uint64_t spillWriteTimeNanos{0};
+  /// The number of spill writes in progress or waiting to start on the device.
+  uint32_t pendingWrites{0};
+  /// The capacity and the free space of the file system on the device in
+  /// bytes. Sampled when a spill file is created on it. Zero if unknown.
+  uint64_t capacityBytes{0};
+  uint64_t freeBytes{0};
+
+  /// Returns the write throughput in bytes per second, or zero if there is no
+  /// write.
+  uint64_t spillWriteThroughput() const;
+
+  std::string toString() const;
+};
+
+/// Tracks the IO on a storage device used for spilling. There is one instance
+/// per device in the process which is shared by all the spill directories on
+/// it.
+class SpillDevice {
+ public:
+  /// Returns the device of 'directory'. The directory must exist if it is on a
+  /// local file system for its device to be identified. The returned device is
+  /// never destroyed.
+  static SpillDevice* get(const std::string& directory);
+
+  /// Invoked before a spill write starts, including the wait for a write slot.
+  void startWrite() {
+    ++pendingWrites_;
+  }
+
+  /// Invoked after a spill write of 'bytes' which took 'writeTimeNs'.
+  void finishWrite(uint64_t bytes, uint64_t writeTimeNs);
+
+  /// Invoked when a spill file is created in 'directory' on this device.
+  /// Samples the free space of the device.
+  void addFile(const std::string& directory);
+
+  uint32_t pendingWrites() const {
+    return pendingWrites_;
+  }
+
+  uint64_t freeBytes() const {
+    return freeBytes_;
+  }
+
+  SpillDeviceStats stats() const;
+
+ private:
+  explicit SpillDevice(std::string device) : device_(std::move(device)) {}
+
+  void updateSpace(const std::string& directory);
+
+  const std::string device_;
+  std::atomic<uint32_t> pendingWrites_{0};
+  std::atomic<uint64_t> spilledFiles_{0};
+  std::atomic<uint64_t> spilledBytes_{0};
+  std::atomic<uint64_t> spillWriteTimeNanos_{0};
+  std::atomic<uint64_t> capacityBytes_{0};
+  std::atomic<uint64_t> freeBytes_{0};
+};
+
+/// Returns the stats of all the devices used for spilling in the process.
+std::vector<SpillDeviceStats> globalSpillDeviceStats();
+
+/// Spreads the spill files of a query task over a number of spill directories,
+/// each on a different local disk, so that the spill bandwidth scales with the
+/// number of disks. A spill writer picks the directory for each new file, so a
+/// large spill partition which is written to a sequence of files bounded by
+/// the max spill file size is striped across the disks.
+class SpillDirectorySelector {
+ public:
+  enum class Policy {
+    /// Picks the directories in turn.
+    kRoundRobin,
+    /// Picks the directories in turn but skips a device which has more
+    /// pending writes than another, or less than half of its free space. This
+    /// steers the writes away from a disk which is busy with other spills or
+    /// is running out of space.
+    kLeastLoaded,
+  };
+
+  static std::string_view policyName(Policy policy);
+
+  static Policy toPolicy(std::string_view name);
+
+  SpillDirectorySelector(std::vector<std::string> directories, Policy policy);
+
+  /// Returns the index of the directory to create the next spill file in. The
+  /// directories must exist.
+  uint32_t select();
+
+  const std::string& directory(uint32_t index) const {
+    return directories_[index];
+  }
+
+  /// Returns the device of the directory at 'index'.
+  SpillDevice* device(uint32_t index);
+
+  const std::vector<std::string>& directories() const {
+    return directories_;
+  }
+
+  Policy policy() const {
+    return policy_;
+  }
+
+ private:
+  // Returns the devices of 'directories_' and looks them up on the first call.
+  const std::vector<SpillDevice*>& devices();
+
+  const std::vector<std::string> directories_;
+  const Policy policy_;
+
+  std::atomic<uint32_t> nextIndex_{0};
+
+  std::once_flag devicesOnce_;
+  std::vector<SpillDevice*> devices_;
+};
+} // namespace facebook::velox::common
@@ -49,6 +49,7 @@ SpillStats::SpillStats(
     uint64_t _spillWrites,
     uint64_t _spillFlushTimeNanos,
     uint64_t _spillWriteTimeNanos,
+    uint64_t _spillWriteQueueWaitTimeNanos,
     uint64_t _spillMaxLevelExceededCount,
     uint64_t _spillReadBytes,
     uint64_t _spillReads,
@@ -67,6 +68,7 @@ SpillStats::SpillStats(
       spillWrites(_spillWrites),
       spillFlushTimeNanos(_spillFlushTimeNanos),
       spillWriteTimeNanos(_spillWriteTimeNanos),
+      spillWriteQueueWaitTimeNanos(_spillWriteQueueWaitTimeNanos),
       spillMaxLevelExceededCount(_spillMaxLevelExceededCount),
       spillReadBytes(_spillReadBytes),
       spillReads(_spillReads),
@@ -87,6 +89,7 @@ SpillStats& SpillStats::operator+=(const SpillStats& other) {
   spillWrites += other.spillWrites;
   spillFlushTimeNanos += other.spillFlushTimeNanos;
   spillWriteTimeNanos += other.spillWriteTimeNanos;
+  spillWriteQueueWaitTimeNanos += other.spillWriteQueueWaitTimeNanos;
   spillMaxLevelExceededCount += other.spillMaxLevelExceededCount;
   spillReadBytes += other.spillReadBytes;
   spillReads += other.spillReads;
@@ -114,6 +117,8 @@ SpillStats SpillStats::operator-(const SpillStats& other) const {
   result.spillWrites = spillWrites - other.spillWrites;
   result.spillFlushTimeNanos = spillFlushTimeNanos - other.spillFlushTimeNanos;
   result.spillWriteTimeNanos = spillWriteTimeNanos - other.spillWriteTimeNanos;
+  result.spillWriteQueueWaitTimeNanos =
+      spillWriteQueueWaitTimeNanos - other.spillWriteQueueWaitTimeNanos;
   result.spillMaxLevelExceededCount =
       spillMaxLevelExceededCount - other.spillMaxLevelExceededCount;
   result.spillReadBytes = spillReadBytes - other.spillReadBytes;
@@ -149,6 +154,7 @@ bool SpillStats::operator<(const SpillStats& other) const {
   UPDATE_COUNTER(spillWrites);
   UPDATE_COUNTER(spillFlushTimeNanos);
   UPDATE_COUNTER(spillWriteTimeNanos);
+  UPDATE_COUNTER(spillWriteQueueWaitTimeNanos);
   UPDATE_COUNTER(spillMaxLevelExceededCount);
   UPDATE_COUNTER(spillReadBytes);
   UPDATE_COUNTER(spillReads);
@@ -190,6 +196,7 @@ bool SpillStats::operator==(const SpillStats& other) const {
              spillWrites,
              spillFlushTimeNanos,
              spillWriteTimeNanos,
+             spillWriteQueueWaitTimeNanos,
              spillMaxLevelExceededCount,
              spillReadBytes,
              spillReads,
@@ -209,6 +216,7 @@ bool SpillStats::operator==(const SpillStats& other) const {
              other.spillWrites,
              other.spillFlushTimeNanos,
              other.spillWriteTimeNanos,
+             other.spillWriteQueueWaitTimeNanos,
              spillMaxLevelExceededCount,
              spillReadBytes,
              spillReads,
@@ -230,6 +238,7 @@ void SpillStats::reset() {
   spillWrites = 0;
   spillFlushTimeNanos = 0;
   spillWriteTimeNanos = 0;
+  spillWriteQueueWaitTimeNanos = 0;
   spillMaxLevelExceededCount = 0;
   spillReadBytes = 0;
   spillReads = 0;
@@ -244,7 +253,8 @@ std::string SpillStats::toString() const {
       "spillSortTimeNanos[{}] spillExtractVectorTime[{}] spillSerializationTimeNanos[{}] spillWrites[{}] "
       "spillFlushTimeNanos[{}] spillWriteTimeNanos[{}] maxSpillExceededLimitCount[{}] "
       "spillReadBytes[{}] spillReads[{}] spillReadTimeNanos[{}] "
-      "spillReadDeserializationTimeNanos[{}]",
+      "spillReadDeserializationTimeNanos[{}] "
+      "spillWriteQueueWaitTimeNanos[{}] spillWriteThroughput[{}/s]",
       spillRuns,
       succinctBytes(spilledInputBytes),
       succinctBytes(spilledBytes),
@@ -262,7 +272,9 @@ std::string SpillStats::toString() const {
       succinctBytes(spillReadBytes),
       spillReads,
       succinctNanos(spillReadTimeNanos),
-      succinctNanos(spillDeserializationTimeNanos));
+      succinctNanos(spillDeserializationTimeNanos),
+      succinctNanos(spillWriteQueueWaitTimeNanos),
+      succinctBytes(spillWriteThroughput()));
 }
 
 void updateGlobalSpillRunStats(uint64_t numRuns) {
@@ -318,6 +330,10 @@ void updateGlobalSpillWriteStats(
   statsLocked->spillWriteTimeNanos += writeTimeNs;
 }
 
+void updateGlobalSpillWriteQueueWaitTime(uint64_t timeNs) {
+  localSpillStats().wlock()->spillWriteQueueWaitTimeNanos += timeNs;
+}
+
 void updateGlobalSpillReadStats(
     uint64_t spillReads,
     uint64_t spillReadBytes,
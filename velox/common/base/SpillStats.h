@@ -56,6 +56,10 @@ struct SpillStats {
   uint64_t spillFlushTimeNanos{0};
   /// The time spent on writing spilled rows to disk.
   uint64_t spillWriteTimeNanos{0};
+  /// The time that the spilling thread spent waiting for the asynchronous disk
+  /// writes, either for a free slot in the bounded write queue or for the
+  /// pending writes to finish when closing a spill file.
+  uint64_t spillWriteQueueWaitTimeNanos{0};
   /// The number of times that an hash build operator exceeds the max spill
   /// limit.
   uint64_t spillMaxLevelExceededCount{0};
@@ -83,6 +87,7 @@ struct SpillStats {
       uint64_t _spillWrites,
       uint64_t _spillFlushTimeNanos,
       uint64_t _spillWriteTimeNanos,
+      uint64_t _spillWriteQueueWaitTimeNanos,
       uint64_t _spillMaxLevelExceededCount,
       uint64_t _spillReadBytes,
       uint64_t _spillReads,
@@ -95,6 +100,16 @@ struct SpillStats {
     return spilledBytes == 0;
   }
 
+  /// Returns the disk write throughput in bytes per second, or zero if there
+  /// is no disk write.
+  uint64_t spillWriteThroughput() const {
+    if (spillWriteTimeNanos == 0) {
+      return 0;
+    }
+    return static_cast<uint64_t>(
+        spilledBytes * 1'000'000'000.0 / spillWriteTimeNanos);
+  }
+
   SpillStats& operator+=(const SpillStats& other);
   SpillStats operator-(const SpillStats& other) const;
   bool operator==(const SpillStats& other) const;
@@ -147,6 +162,10 @@ void updateGlobalSpillWriteStats(
     uint64_t flushTimeNs,
     uint64_t writeTimeNs);
 
+/// Updates the time that the spilling thread spent waiting for the
+/// asynchronous disk writes.
+void updateGlobalSpillWriteQueueWaitTime(uint64_t timeNs);
+
 /// Updates the stats for disk read including the number of disk reads, the
 /// amount of data read in bytes, and the time it takes to read from the disk.
 void updateGlobalSpillReadStats(
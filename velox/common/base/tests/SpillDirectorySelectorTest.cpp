@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/SpillDirectorySelector.h"
+#include <gtest/gtest.h>
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::common;
+
+namespace {
+// Returns the directories which don't exist so that each of them is tracked
+// as a separate device.
+std::vector<std::string> fakeDirectories(const std::string& name, int count) {
+  std::vector<std::string> directories;
+  for (int i = 0; i < count; ++i) {
+    directories.push_back(fmt::format("/nonexistent/{}/disk{}", name, i));
+  }
+  return directories;
+}
+} // namespace
+
+TEST(SpillDirectorySelectorTest, policy) {
+  for (const auto policy :
+       {SpillDirectorySelector::Policy::kRoundRobin,
+        SpillDirectorySelector::Policy::kLeastLoaded}) {
+    ASSERT_EQ(
+        SpillDirectorySelector::toPolicy(
+            SpillDirectorySelector::policyName(policy)),
+        policy);
+  }
+  VELOX_ASSERT_THROW(
+      SpillDirectorySelector::toPolicy("random"),
+      "Unknown spill directory selection policy: random");
+  VELOX_ASSERT_THROW(
+      SpillDirectorySelector({}, SpillDirectorySelector::Policy::kRoundRobin),
+      "No spill directory specified");
+}
+
+TEST(SpillDirectorySelectorTest, roundRobin) {
+  SpillDirectorySelector selector(
+      fakeDirectories("roundRobin", 3),
+      SpillDirectorySelector::Policy::kRoundRobin);
+  // Pending writes are ignored.
+  selector.device(1)->startWrite();
+  for (uint32_t i = 0; i < 9; ++i) {
+    ASSERT_EQ(selector.select(), i % 3);
+  }
+  selector.device(1)->finishWrite(0, 0);
+}
+
+TEST(SpillDirectorySelectorTest, leastLoaded) {
+  SpillDirectorySelector selector(
+      fakeDirectories("leastLoaded", 4),
+      SpillDirectorySelector::Policy::kLeastLoaded);
+  // The equally loaded devices are picked in turn.
+  for (uint32_t i = 0; i < 8; ++i) {
+    ASSERT_EQ(selector.select(), i % 4);
+  }
+
+  // Skips the busy devices.
+  selector.device(0)->startWrite();
+  selector.device(1)->startWrite();
+  selector.device(1)->startWrite();
+  std::vector<uint32_t> selected;
+  for (uint32_t i = 0; i < 4; ++i) {
+    selected.push_back(selector.select());
+  }
+  ASSERT_EQ(selected, (std::vector<uint32_t>{2, 2, 2, 3}));
+
+  selector.device(0)->finishWrite(100, 1'000);
+  selector.device(1)->finishWrite(200, 1'000);
+  selector.device(1)->finishWrite(300, 1'000);
+  ASSERT_EQ(selector.device(1)->pendingWrites(), 0);
+  const auto stats = selector.device(1)->stats();
+  ASSERT_EQ(stats.spilledBytes, 500);
+  ASSERT_EQ(stats.spillWriteTimeNanos, 2'000);
+  ASSERT_EQ(stats.spillWriteThroughput(), 250'000'000);
+}
+
+TEST(SpillDirectorySelectorTest, sharedDevice) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  // The directories on the same file system share one device.
+  SpillDirectorySelector selector(
+      {tempDirectory->getPath(), tempDirectory->getPath()},
+      SpillDirectorySelector::Policy::kLeastLoaded);
+  ASSERT_EQ(selector.device(0), selector.device(1));
+  ASSERT_EQ(SpillDevice::get(tempDirectory->getPath()), selector.device(0));
+
+  const auto numFiles = selector.device(0)->stats().spilledFiles;
+  selector.device(0)->addFile(tempDirectory->getPath());
+  const auto stats = selector.device(0)->stats();
+  ASSERT_EQ(stats.spilledFiles, numFiles + 1);
+  ASSERT_GT(stats.capacityBytes, 0);
+  ASSERT_LE(stats.freeBytes, stats.capacityBytes);
+
+  bool found{false};
+  for (const auto& deviceStats : globalSpillDeviceStats()) {
+    found |= deviceStats.device == stats.device;
+  }
+  ASSERT_TRUE(found);
+}
@@ -30,6 +30,7 @@ TEST(SpillStatsTest, spillStats) {
   stats1.spilledPartitions = 1024;
   stats1.spilledFiles = 1023;
   stats1.spillWriteTimeNanos = 1023;
+  stats1.spillWriteQueueWaitTimeNanos = 1023;
   stats1.spillFlushTimeNanos = 1023;
   stats1.spillWrites = 1023;
   stats1.spillSortTimeNanos = 1023;
@@ -50,6 +51,7 @@ TEST(SpillStatsTest, spillStats) {
   stats2.spilledPartitions = 1025;
   stats2.spilledFiles = 1026;
   stats2.spillWriteTimeNanos = 1026;
+  stats2.spillWriteQueueWaitTimeNanos = 1034;
   stats2.spillFlushTimeNanos = 1027;
   stats2.spillWrites = 1028;
   stats2.spillSortTimeNanos = 1029;
@@ -82,6 +84,7 @@ TEST(SpillStatsTest, spillStats) {
   ASSERT_EQ(delta.spilledPartitions, 1);
   ASSERT_EQ(delta.spilledFiles, 3);
   ASSERT_EQ(delta.spillWriteTimeNanos, 3);
+  ASSERT_EQ(delta.spillWriteQueueWaitTimeNanos, 11);
   ASSERT_EQ(delta.spillFlushTimeNanos, 4);
   ASSERT_EQ(delta.spillWrites, 5);
   ASSERT_EQ(delta.spillSortTimeNanos, 6);
@@ -99,6 +102,7 @@ TEST(SpillStatsTest, spillStats) {
   ASSERT_EQ(delta.spilledPartitions, -1);
   ASSERT_EQ(delta.spilledFiles, -3);
   ASSERT_EQ(delta.spillWriteTimeNanos, -3);
+  ASSERT_EQ(delta.spillWriteQueueWaitTimeNanos, -11);
   ASSERT_EQ(delta.spillFlushTimeNanos, -4);
   ASSERT_EQ(delta.spillWrites, -5);
   ASSERT_EQ(delta.spillSortTimeNanos, -6);
@@ -120,9 +124,11 @@ TEST(SpillStatsTest, spillStats) {
   VELOX_ASSERT_THROW(stats1 >= stats2, "");
   ASSERT_TRUE(stats1 != stats2);
   ASSERT_FALSE(stats1 == stats2);
+  ASSERT_EQ(stats2.spillWriteThroughput(), 998'050'682);
   const SpillStats zeroStats;
   stats1.reset();
   ASSERT_EQ(zeroStats, stats1);
+  ASSERT_EQ(zeroStats.spillWriteThroughput(), 0);
   ASSERT_EQ(
       stats2.toString(),
       "spillRuns[100] spilledInputBytes[2.00KB] spilledBytes[1.00KB] "
@@ -131,7 +137,8 @@ TEST(SpillStatsTest, spillStats) {
       "spillSerializationTimeNanos[1.03us] spillWrites[1028] spillFlushTimeNanos[1.03us] "
       "spillWriteTimeNanos[1.03us] maxSpillExceededLimitCount[4] "
       "spillReadBytes[2.00KB] spillReads[10] spillReadTimeNanos[100ns] "
-      "spillReadDeserializationTimeNanos[100ns]");
+      "spillReadDeserializationTimeNanos[100ns] "
+      "spillWriteQueueWaitTimeNanos[1.03us] spillWriteThroughput[951.82MB/s]");
   ASSERT_EQ(
       fmt::format("{}", stats2),
       "spillRuns[100] spilledInputBytes[2.00KB] spilledBytes[1.00KB] "
@@ -141,5 +148,6 @@ TEST(SpillStatsTest, spillStats) {
       "spillFlushTimeNanos[1.03us] spillWriteTimeNanos[1.03us] "
       "maxSpillExceededLimitCount[4] "
       "spillReadBytes[2.00KB] spillReads[10] spillReadTimeNanos[100ns] "
-      "spillReadDeserializationTimeNanos[100ns]");
+      "spillReadDeserializationTimeNanos[100ns] "
+      "spillWriteQueueWaitTimeNanos[1.03us] spillWriteThroughput[951.82MB/s]");
 }
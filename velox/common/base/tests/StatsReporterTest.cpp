@@ -319,7 +319,8 @@ class TestMemoryPool : public memory::MemoryPool {
   void allocateContiguous(
       memory::MachinePageCount /* unused */,
       memory::ContiguousAllocation& /* unused */,
-      memory::MachinePageCount /* unused */) override {}
+      memory::MachinePageCount /* unused */,
+      bool /* unused */) override {}
 
   void freeContiguous(memory::ContiguousAllocation& /* unused */) override {}
 
@@ -357,6 +358,8 @@ class TestMemoryPool : public memory::MemoryPool {
 
   void release() override {}
 
+  void releaseReservation(uint64_t /* unused */) override {}
+
   uint64_t freeBytes() const override {
     return 0;
   }
@@ -16,6 +16,7 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/base/Fs.h"
+#include "velox/common/file/IoUring.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
@@ -143,8 +144,12 @@ uint64_t InMemoryWriteFile::size() const {
 LocalReadFile::LocalReadFile(
     std::string_view path,
     folly::Executor* executor,
-    bool bufferIo)
-    : executor_(executor), path_(path) {
+    bool bufferIo,
+    IoUring* ioUring)
+    : executor_(executor),
+      ioUring_(ioUring),
+      directIo_(!bufferIo),
+      path_(path) {
   int32_t flags = O_RDONLY;
 #ifdef linux
   if (!bufferIo) {
@@ -175,7 +180,7 @@ LocalReadFile::LocalReadFile(
 }
 
 LocalReadFile::LocalReadFile(int32_t fd, folly::Executor* executor)
-    : executor_(executor), fd_(fd) {}
+    : executor_(executor), ioUring_(nullptr), directIo_(false), fd_(fd) {}
 
 LocalReadFile::~LocalReadFile() {
   const int ret = close(fd_);
@@ -264,10 +269,60 @@ uint64_t LocalReadFile::preadv(
   return totalBytesRead;
 }
 
+uint64_t LocalReadFile::preadv(
+    folly::Range<const common::Region*> regions,
+    folly::Range<folly::IOBuf*> iobufs,
+    filesystems::File::IoStats* stats) const {
+  if (ioUring_ == nullptr) {
+    return ReadFile::preadv(regions, iobufs, stats);
+  }
+  VELOX_CHECK_EQ(regions.size(), iobufs.size());
+  // Submits the reads of all the regions at once.
+  std::vector<IoUring::ReadRequest> requests;
+  requests.reserve(regions.size());
+  uint64_t length{0};
+  for (size_t i = 0; i < regions.size(); ++i) {
+    const auto& region = regions[i];
+    auto& output = iobufs[i];
+    output = folly::IOBuf(folly::IOBuf::CREATE, region.length);
+    requests.push_back(
+        {region.offset,
+         {folly::Range<char*>(
+             reinterpret_cast<char*>(output.writableData()),
+             region.length)}});
+    length += region.length;
+  }
+  bytesRead_ += length;
+  const auto bytesRead =
+      ioUring_->read(fd_, std::move(requests), directIo_).get();
+  VELOX_CHECK_EQ(
+      bytesRead,
+      length,
+      "io_uring read failure in LocalReadFile::preadv, {} vs {}",
+      bytesRead,
+      length);
+  for (size_t i = 0; i < regions.size(); ++i) {
+    iobufs[i].append(regions[i].length);
+  }
+  return length;
+}
+
 folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
     uint64_t offset,
     const std::vector<folly::Range<char*>>& buffers,
     filesystems::File::IoStats* stats) const {
+  if (ioUring_ != nullptr) {
+    for (const auto& buffer : buffers) {
+      if (buffer.data() != nullptr) {
+        bytesRead_ += buffer.size();
+      }
+    }
+    try {
+      return ioUring_->read(fd_, {{offset, buffers}}, directIo_);
+    } catch (const std::exception& e) {
+      return folly::makeSemiFuture<uint64_t>(e);
+    }
+  }
   if (!executor_) {
     return ReadFile::preadvAsync(offset, buffers, stats);
   }
@@ -304,8 +359,9 @@ LocalWriteFile::LocalWriteFile(
     std::string_view path,
     bool shouldCreateParentDirectories,
     bool shouldThrowOnFileAlreadyExists,
-    bool bufferIo)
-    : path_(path) {
+    bool bufferIo,
+    IoUring* ioUring)
+    : ioUring_(ioUring), path_(path) {
   const auto dir = fs::path(path_).parent_path();
   if (shouldCreateParentDirectories && !fs::exists(dir)) {
     VELOX_CHECK(
@@ -408,8 +464,10 @@ void LocalWriteFile::write(
     int64_t length) {
   checkNotClosed(closed_);
   VELOX_CHECK_GE(offset, 0, "Offset cannot be negative.");
-  const auto bytesWritten = ::pwritev(
-      fd_, iovecs.data(), static_cast<ssize_t>(iovecs.size()), offset);
+  const auto bytesWritten = ioUring_ != nullptr
+      ? static_cast<int64_t>(ioUring_->write(fd_, offset, iovecs).get())
+      : ::pwritev(
+            fd_, iovecs.data(), static_cast<ssize_t>(iovecs.size()), offset);
   VELOX_CHECK_EQ(
       bytesWritten,
       length,
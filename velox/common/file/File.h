@@ -291,15 +291,21 @@ class InMemoryWriteFile final : public WriteFile {
   std::string* file_;
 };
 
+class IoUring;
+
 /// Current implementation for the local version is quite simple (e.g. no
 /// internal arenaing), as local disk writes are expected to be cheap. Local
 /// files match against any filepath starting with '/'.
 class LocalReadFile final : public ReadFile {
  public:
+  /// If 'ioUring' is set, preadvAsync and the batched preadv of multiple
+  /// regions are submitted to it instead of running the blocking reads on
+  /// 'executor'.
   LocalReadFile(
       std::string_view path,
       folly::Executor* executor = nullptr,
-      bool bufferIo = true);
+      bool bufferIo = true,
+      IoUring* ioUring = nullptr);
 
   /// TODO: deprecate this after creating local file all through velox fs
   /// interface.
@@ -320,13 +326,18 @@ class LocalReadFile final : public ReadFile {
       const std::vector<folly::Range<char*>>& buffers,
       filesystems::File::IoStats* stats = nullptr) const final;
 
+  uint64_t preadv(
+      folly::Range<const common::Region*> regions,
+      folly::Range<folly::IOBuf*> iobufs,
+      filesystems::File::IoStats* stats = nullptr) const final;
+
   folly::SemiFuture<uint64_t> preadvAsync(
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers,
       filesystems::File::IoStats* stats = nullptr) const override;
 
   bool hasPreadvAsync() const override {
-    return executor_ != nullptr;
+    return executor_ != nullptr || ioUring_ != nullptr;
   }
 
   uint64_t memoryUsage() const final;
@@ -350,6 +361,9 @@ class LocalReadFile final : public ReadFile {
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
 
   folly::Executor* const executor_;
+  IoUring* const ioUring_;
+  // True if the file is opened with O_DIRECT.
+  const bool directIo_;
   std::string path_;
   int32_t fd_;
   long size_;
@@ -369,12 +383,14 @@ class LocalWriteFile final : public WriteFile {
   };
 
   // An error is thrown is a file already exists at |path|,
-  // unless flag shouldThrowOnFileAlreadyExists is false
+  // unless flag shouldThrowOnFileAlreadyExists is false. If 'ioUring' is set,
+  // the positional writes are submitted to it.
   explicit LocalWriteFile(
       std::string_view path,
       bool shouldCreateParentDirectories = false,
       bool shouldThrowOnFileAlreadyExists = true,
-      bool bufferIo = true);
+      bool bufferIo = true,
+      IoUring* ioUring = nullptr);
 
   ~LocalWriteFile();
 
@@ -405,6 +421,8 @@ class LocalWriteFile final : public WriteFile {
   }
 
  private:
+  // If set, the positional writes are submitted to it.
+  IoUring* const ioUring_;
   // File descriptor.
   int32_t fd_{-1};
   std::string path_;
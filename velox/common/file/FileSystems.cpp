@@ -19,6 +19,7 @@
 #include <folly/synchronization/CallOnce.h>
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUring.h"
 
 #include <cstdio>
 #include <filesystem>
@@ -93,6 +94,13 @@ class LocalFileSystem : public FileSystem {
                               std::thread::hardware_concurrency() / 2)),
                       std::make_shared<folly::NamedThreadFactory>(
                           "LocalReadahead"))
+                : nullptr),
+        ioUring_(
+            options.ioUringEnabled
+                ? IoUring::create(IoUring::Options{
+                      .queueDepth = options.ioUringQueueDepth,
+                      .numRegisteredBuffers =
+                          options.ioUringNumRegisteredBuffers})
                 : nullptr) {}
 
   ~LocalFileSystem() override {
@@ -117,7 +125,7 @@ class LocalFileSystem : public FileSystem {
       std::string_view path,
       const FileOptions& options) override {
     return std::make_unique<LocalReadFile>(
-        extractPath(path), executor_.get(), options.bufferIo);
+        extractPath(path), executor_.get(), options.bufferIo, ioUring_.get());
   }
 
   std::unique_ptr<WriteFile> openFileForWrite(
@@ -127,7 +135,8 @@ class LocalFileSystem : public FileSystem {
         extractPath(path),
         options.shouldCreateParentDirectories,
         options.shouldThrowOnFileAlreadyExists,
-        options.bufferIo);
+        options.bufferIo,
+        ioUring_.get());
   }
 
   void remove(std::string_view path) override {
@@ -251,6 +260,8 @@ class LocalFileSystem : public FileSystem {
 
  private:
   const std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  // Set if io_uring is enabled and supported.
+  const std::unique_ptr<IoUring> ioUring_;
 };
 } // namespace
 
@@ -104,6 +104,19 @@ struct FileSystemOptions {
   /// async read by using a background cpu executor. Some filesystem might has
   /// native async read-ahead support.
   bool readAheadEnabled{false};
+
+  /// As for now, only local file system respects the io_uring options. If
+  /// true, the local file system submits the async and batched reads and the
+  /// positional writes to an io_uring if it is available, instead of issuing
+  /// blocking system calls. See IoUring for details.
+  bool ioUringEnabled{false};
+
+  /// The submission queue depth of the io_uring.
+  uint32_t ioUringQueueDepth{256};
+
+  /// The number of 1MB buffers registered with the io_uring for reading the
+  /// files opened with direct IO. 0 to disable.
+  uint32_t ioUringNumRegisteredBuffers{0};
 };
 
 /// Free form statistics for a file system. The keys are arbitrary strings, and
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUring.h"
+
+#include <climits>
+#include <cstdlib>
+
+#include <folly/ScopeGuard.h>
+#include <folly/String.h>
+#include <folly/system/ThreadName.h>
+#include <glog/logging.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/testutil/TestValue.h"
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#include <sys/mman.h>
+#endif // VELOX_ENABLE_IO_URING
+
+using facebook::velox::common::testutil::TestValue;
+
+namespace facebook::velox {
+
+#ifdef VELOX_ENABLE_IO_URING
+namespace {
+// The alignment of the file offsets, sizes and buffers of O_DIRECT IO.
+constexpr uint64_t kDirectIoAlignment = 4096;
+
+io_uring_sqe* getSqe(io_uring* ring) {
+  for (;;) {
+    auto* sqe = io_uring_get_sqe(ring);
+    if (sqe != nullptr) {
+      return sqe;
+    }
+    // The submission queue is full. Submits the queued entries to make room.
+    const auto ret = io_uring_submit(ring);
+    VELOX_CHECK_GE(ret, 0, "io_uring_submit failed: {}", folly::errnoStr(-ret));
+  }
+}
+
+folly::exception_wrapper makeError(const std::string& message) {
+  try {
+    VELOX_FAIL("{}", message);
+  } catch (...) {
+    return folly::exception_wrapper(std::current_exception());
+  }
+}
+} // namespace
+
+struct IoUring::Batch {
+  folly::Promise<uint64_t> promise;
+  std::atomic<int32_t> numPending{0};
+  // The fields below are only accessed on the completion thread.
+  uint64_t bytes{0};
+  folly::exception_wrapper error;
+};
+
+struct IoUring::Op {
+  ~Op() {
+    ::free(bounceBuffer);
+  }
+
+  std::shared_ptr<Batch> batch;
+  int32_t fd;
+  bool write{false};
+  // The file offset of the next byte to transfer.
+  uint64_t offset;
+  std::vector<iovec> iovecs;
+  // The index of the first buffer in 'iovecs' not fully transferred yet.
+  size_t nextIovec{0};
+  // Set if reading through the registered buffer at 'bufferIndex' or through
+  // the owned and aligned 'bounceBuffer'. The read covers the aligned range
+  // around 'offset' and the requested bytes are copied to 'iovecs' on
+  // completion.
+  int32_t bufferIndex{-1};
+  char* bounceBuffer{nullptr};
+  uint64_t alignedOffset{0};
+  uint64_t alignedLength{0};
+
+  bool staged() const {
+    return bufferIndex >= 0 || bounceBuffer != nullptr;
+  }
+};
+
+// static
+bool IoUring::isSupported() {
+  static const bool supported = []() {
+    io_uring ring;
+    if (io_uring_queue_init(1, &ring, 0) != 0) {
+      return false;
+    }
+    io_uring_queue_exit(&ring);
+    return true;
+  }();
+  return supported;
+}
+
+// static
+std::unique_ptr<IoUring> IoUring::create(const Options& options) {
+  if (!isSupported()) {
+    LOG(WARNING) << "io_uring is not supported by the kernel";
+    return nullptr;
+  }
+  return std::unique_ptr<IoUring>(new IoUring(options));
+}
+
+IoUring::IoUring(const Options& options)
+    : options_(options), maxInflight_(2 * options.queueDepth) {
+  VELOX_CHECK_GT(options_.queueDepth, 0);
+  ring_ = new io_uring;
+  // Sizes the completion queue to hold all the IOs in flight.
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = maxInflight_;
+  const auto ret =
+      io_uring_queue_init_params(options_.queueDepth, ring_, &params);
+  if (ret != 0) {
+    delete ring_;
+    VELOX_FAIL("io_uring_queue_init failed: {}", folly::errnoStr(-ret));
+  }
+
+  if (options_.numRegisteredBuffers > 0) {
+    VELOX_CHECK_EQ(options_.registeredBufferSize % kDirectIoAlignment, 0);
+    const auto size =
+        options_.numRegisteredBuffers * options_.registeredBufferSize;
+    void* buffers = ::mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (buffers != MAP_FAILED) {
+      std::vector<iovec> iovecs;
+      iovecs.reserve(options_.numRegisteredBuffers);
+      for (uint32_t i = 0; i < options_.numRegisteredBuffers; ++i) {
+        iovecs.push_back(
+            {static_cast<char*>(buffers) + i * options_.registeredBufferSize,
+             options_.registeredBufferSize});
+      }
+      const auto registerRet =
+          io_uring_register_buffers(ring_, iovecs.data(), iovecs.size());
+      if (registerRet == 0) {
+        registeredBuffers_ = static_cast<char*>(buffers);
+        for (int32_t i = options_.numRegisteredBuffers - 1; i >= 0; --i) {
+          freeBuffers_.push_back(i);
+        }
+      } else {
+        // Registration pins the memory and might exceed RLIMIT_MEMLOCK.
+        LOG(WARNING) << "io_uring_register_buffers failed: "
+                     << folly::errnoStr(-registerRet);
+        ::munmap(buffers, size);
+      }
+    } else {
+      LOG(WARNING) << "Failed to allocate io_uring registered buffers: "
+                   << folly::errnoStr(errno);
+    }
+  }
+
+  completionThread_ = std::thread([this]() {
+    folly::setThreadName("IoUringCompletion");
+    processCompletions();
+  });
+}
+
+IoUring::~IoUring() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stopping_ = true;
+    // A no-op without an Op tells the completion thread to exit.
+    auto* sqe = getSqe(ring_);
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    io_uring_submit(ring_);
+  }
+  completionThread_.join();
+  VELOX_DCHECK_EQ(numInflight_, 0);
+  if (registeredBuffers_ != nullptr) {
+    io_uring_unregister_buffers(ring_);
+    ::munmap(
+        registeredBuffers_,
+        options_.numRegisteredBuffers * options_.registeredBufferSize);
+  }
+  io_uring_queue_exit(ring_);
+  delete ring_;
+}
+
+folly::SemiFuture<uint64_t> IoUring::read(
+    int32_t fd,
+    std::vector<ReadRequest> requests,
+    bool directIo) {
+  auto batch = std::make_shared<Batch>();
+  std::vector<std::unique_ptr<Op>> ops;
+  // Makes one read per run of consecutive buffers with data.
+  for (const auto& request : requests) {
+    uint64_t offset = request.offset;
+    std::unique_ptr<Op> op;
+    for (const auto& buffer : request.buffers) {
+      if (buffer.data() == nullptr) {
+        if (op != nullptr) {
+          ops.push_back(std::move(op));
+        }
+      } else {
+        if (op != nullptr && op->iovecs.size() >= IOV_MAX) {
+          ops.push_back(std::move(op));
+        }
+        if (op == nullptr) {
+          op = std::make_unique<Op>();
+          op->batch = batch;
+          op->fd = fd;
+          op->offset = offset;
+        }
+        op->iovecs.push_back({buffer.data(), buffer.size()});
+      }
+      offset += buffer.size();
+    }
+    if (op != nullptr) {
+      ops.push_back(std::move(op));
+    }
+  }
+  if (ops.empty()) {
+    return folly::makeSemiFuture<uint64_t>(0);
+  }
+  // Returns the registered buffers of the ops not handed over to the ring if
+  // the staging or the submission throws.
+  SCOPE_EXIT {
+    for (const auto& op : ops) {
+      if (op != nullptr && op->bufferIndex >= 0) {
+        releaseBuffer(op->bufferIndex);
+      }
+    }
+  };
+  if (directIo) {
+    for (auto& op : ops) {
+      maybeStageDirectRead(*op);
+    }
+  }
+  auto future = batch->promise.getSemiFuture();
+  batch->numPending = ops.size();
+  submit(ops);
+  return future;
+}
+
+folly::SemiFuture<uint64_t>
+IoUring::write(int32_t fd, uint64_t offset, std::vector<iovec> iovecs) {
+  auto batch = std::make_shared<Batch>();
+  std::vector<std::unique_ptr<Op>> ops;
+  for (size_t i = 0; i < iovecs.size(); i += IOV_MAX) {
+    auto op = std::make_unique<Op>();
+    op->batch = batch;
+    op->fd = fd;
+    op->write = true;
+    op->offset = offset;
+    const auto end = std::min<size_t>(i + IOV_MAX, iovecs.size());
+    op->iovecs.assign(iovecs.begin() + i, iovecs.begin() + end);
+    for (const auto& iov : op->iovecs) {
+      offset += iov.iov_len;
+    }
+    ops.push_back(std::move(op));
+  }
+  if (ops.empty()) {
+    return folly::makeSemiFuture<uint64_t>(0);
+  }
+  auto future = batch->promise.getSemiFuture();
+  batch->numPending = ops.size();
+  submit(ops);
+  return future;
+}
+
+void IoUring::maybeStageDirectRead(Op& op) {
+  const auto isAligned = [](uint64_t value) {
+    return value % kDirectIoAlignment == 0;
+  };
+  bool aligned = isAligned(op.offset);
+  uint64_t length{0};
+  for (const auto& iov : op.iovecs) {
+    aligned = aligned && isAligned(reinterpret_cast<uint64_t>(iov.iov_base)) &&
+        isAligned(iov.iov_len);
+    length += iov.iov_len;
+  }
+  if (aligned) {
+    return;
+  }
+  op.alignedOffset = op.offset & ~(kDirectIoAlignment - 1);
+  op.alignedLength =
+      bits::roundUp(op.offset + length, kDirectIoAlignment) - op.alignedOffset;
+  if (registeredBuffers_ != nullptr &&
+      op.alignedLength <= options_.registeredBufferSize) {
+    op.bufferIndex = acquireBuffer();
+    if (op.bufferIndex >= 0) {
+      return;
+    }
+  }
+  // No registered buffer fits or is free.
+  void* buffer{nullptr};
+  const auto ret =
+      ::posix_memalign(&buffer, kDirectIoAlignment, op.alignedLength);
+  VELOX_CHECK_EQ(
+      ret,
+      0,
+      "Failed to allocate {} bytes for O_DIRECT read",
+      op.alignedLength);
+  op.bounceBuffer = static_cast<char*>(buffer);
+}
+
+int32_t IoUring::acquireBuffer() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (freeBuffers_.empty()) {
+    return -1;
+  }
+  const auto index = freeBuffers_.back();
+  freeBuffers_.pop_back();
+  return index;
+}
+
+void IoUring::releaseBuffer(int32_t index) {
+  std::lock_guard<std::mutex> l(mutex_);
+  freeBuffers_.push_back(index);
+}
+
+uint32_t IoUring::testingNumFreeBuffers() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeBuffers_.size();
+}
+
+void IoUring::submit(std::vector<std::unique_ptr<Op>>& ops) {
+  std::unique_lock<std::mutex> l(mutex_);
+  VELOX_CHECK(!stopping_, "io_uring is stopping");
+  for (auto& op : ops) {
+    if (numInflight_ >= maxInflight_) {
+      // Submits the prepared entries before waiting for their completions.
+      io_uring_submit(ring_);
+      inflightCv_.wait(
+          l, [&]() { return failed_ || numInflight_ < maxInflight_; });
+    }
+    VELOX_CHECK(!failed_, "io_uring completion thread has failed");
+    prepareLocked(op.get());
+    ++numInflight_;
+    inflightOps_.insert(op.release());
+  }
+  const auto ret = io_uring_submit(ring_);
+  VELOX_CHECK_GE(ret, 0, "io_uring_submit failed: {}", folly::errnoStr(-ret));
+}
+
+void IoUring::prepareLocked(Op* op) {
+  auto* sqe = getSqe(ring_);
+  if (op->bufferIndex >= 0) {
+    io_uring_prep_read_fixed(
+        sqe,
+        op->fd,
+        registeredBuffers_ + op->bufferIndex * options_.registeredBufferSize,
+        op->alignedLength,
+        op->alignedOffset,
+        op->bufferIndex);
+  } else if (op->bounceBuffer != nullptr) {
+    io_uring_prep_read(
+        sqe, op->fd, op->bounceBuffer, op->alignedLength, op->alignedOffset);
+  } else if (op->write) {
+    io_uring_prep_writev(
+        sqe,
+        op->fd,
+        op->iovecs.data() + op->nextIovec,
+        op->iovecs.size() - op->nextIovec,
+        op->offset);
+  } else {
+    io_uring_prep_readv(
+        sqe,
+        op->fd,
+        op->iovecs.data() + op->nextIovec,
+        op->iovecs.size() - op->nextIovec,
+        op->offset);
+  }
+  io_uring_sqe_set_data(sqe, op);
+}
+
+void IoUring::processCompletions() {
+  for (;;) {
+    io_uring_cqe* cqe{nullptr};
+    auto ret = io_uring_wait_cqe(ring_, &cqe);
+    TestValue::adjust("facebook::velox::IoUring::processCompletions", &ret);
+    if (ret == -EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      const auto message =
+          fmt::format("io_uring_wait_cqe failed: {}", folly::errnoStr(-ret));
+      LOG(ERROR) << message;
+      failInflight(makeError(message));
+      return;
+    }
+    auto* op = static_cast<Op*>(io_uring_cqe_get_data(cqe));
+    const auto res = cqe->res;
+    io_uring_cqe_seen(ring_, cqe);
+    if (op == nullptr) {
+      return;
+    }
+    if (!complete(op, res)) {
+      continue;
+    }
+
+    std::unique_ptr<Op> completed(op);
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      --numInflight_;
+      inflightOps_.erase(op);
+    }
+    inflightCv_.notify_all();
+    auto& batch = *completed->batch;
+    if (--batch.numPending == 0) {
+      if (batch.error) {
+        batch.promise.setException(std::move(batch.error));
+      } else {
+        batch.promise.setValue(batch.bytes);
+      }
+    }
+  }
+}
+
+void IoUring::failInflight(const folly::exception_wrapper& error) {
+  std::vector<std::unique_ptr<Op>> ops;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    failed_ = true;
+    ops.reserve(inflightOps_.size());
+    for (auto* op : inflightOps_) {
+      ops.emplace_back(op);
+    }
+    inflightOps_.clear();
+    numInflight_ = 0;
+  }
+  inflightCv_.notify_all();
+  for (auto& op : ops) {
+    if (op->bufferIndex >= 0) {
+      releaseBuffer(op->bufferIndex);
+    }
+    auto& batch = *op->batch;
+    if (!batch.error) {
+      batch.error = error;
+    }
+    if (--batch.numPending == 0) {
+      batch.promise.setException(std::move(batch.error));
+    }
+  }
+}
+
+bool IoUring::complete(Op* op, int32_t res) {
+  auto& batch = *op->batch;
+  if (res < 0) {
+    if (op->bufferIndex >= 0) {
+      releaseBuffer(op->bufferIndex);
+    }
+    if (!batch.error) {
+      batch.error = makeError(fmt::format(
+          "io_uring {} failed at offset {}: {}",
+          op->write ? "write" : "read",
+          op->offset,
+          folly::errnoStr(-res)));
+    }
+    return true;
+  }
+
+  if (op->staged()) {
+    const auto skip = op->offset - op->alignedOffset;
+    uint64_t available = res > skip ? res - skip : 0;
+    const char* data = op->bufferIndex >= 0
+        ? registeredBuffers_ + op->bufferIndex * options_.registeredBufferSize
+        : op->bounceBuffer;
+    data += skip;
+    for (const auto& iov : op->iovecs) {
+      const auto size = std::min<uint64_t>(iov.iov_len, available);
+      ::memcpy(iov.iov_base, data, size);
+      data += size;
+      available -= size;
+      batch.bytes += size;
+    }
+    if (op->bufferIndex >= 0) {
+      releaseBuffer(op->bufferIndex);
+    }
+    return true;
+  }
+
+  batch.bytes += res;
+  if (res == 0) {
+    // A read stops at the end of file.
+    if (op->write && !batch.error) {
+      batch.error = makeError(
+          fmt::format("io_uring write made no progress at {}", op->offset));
+    }
+    return true;
+  }
+  op->offset += res;
+  uint64_t remaining = res;
+  while (op->nextIovec < op->iovecs.size() &&
+         remaining >= op->iovecs[op->nextIovec].iov_len) {
+    remaining -= op->iovecs[op->nextIovec].iov_len;
+    ++op->nextIovec;
+  }
+  if (op->nextIovec == op->iovecs.size()) {
+    return true;
+  }
+  // Resubmits the rest of a short transfer.
+  auto& iov = op->iovecs[op->nextIovec];
+  iov.iov_base = static_cast<char*>(iov.iov_base) + remaining;
+  iov.iov_len -= remaining;
+  std::lock_guard<std::mutex> l(mutex_);
+  prepareLocked(op);
+  io_uring_submit(ring_);
+  return false;
+}
+
+#else
+
+// static
+bool IoUring::isSupported() {
+  return false;
+}
+
+// static
+std::unique_ptr<IoUring> IoUring::create(const Options& /*options*/) {
+  LOG(WARNING) << "io_uring is not enabled in this build";
+  return nullptr;
+}
+
+IoUring::~IoUring() = default;
+
+folly::SemiFuture<uint64_t> IoUring::read(
+    int32_t /*fd*/,
+    std::vector<ReadRequest> /*requests*/,
+    bool /*directIo*/) {
+  VELOX_UNSUPPORTED("io_uring is not enabled in this build");
+}
+
+folly::SemiFuture<uint64_t> IoUring::write(
+    int32_t /*fd*/,
+    uint64_t /*offset*/,
+    std::vector<iovec> /*iovecs*/) {
+  VELOX_UNSUPPORTED("io_uring is not enabled in this build");
+}
+
+uint32_t IoUring::testingNumFreeBuffers() const {
+  return 0;
+}
+
+#endif // VELOX_ENABLE_IO_URING
+} // namespace facebook::velox
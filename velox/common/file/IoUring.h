@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sys/uio.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/Range.h>
+#include <folly/container/F14Set.h>
+#include <folly/futures/Future.h>
+
+struct io_uring;
+
+namespace facebook::velox {
+
+/// Submits local file reads and writes to a shared io_uring and completes them
+/// on a dedicated completion thread. Many reads can be submitted with a single
+/// system call, and the submitting thread does not block on the IO.
+///
+/// The unaligned reads from files opened with O_DIRECT go through an aligned
+/// staging buffer, so that the caller's buffers and the read offsets don't
+/// need to be aligned. If 'numRegisteredBuffers' is set, the ring owns a pool
+/// of page aligned buffers registered with the kernel and stages the reads in
+/// them with fixed buffer reads. A read which does not fit in a registered
+/// buffer or finds none free is staged in a temporary aligned buffer.
+///
+/// NOTE: io_uring is only available if built with VELOX_ENABLE_IO_URING on
+/// Linux and supported by the running kernel.
+class IoUring {
+ public:
+  struct Options {
+    /// The number of submission queue entries.
+    uint32_t queueDepth{256};
+    /// The number of registered buffers for O_DIRECT reads. 0 to disable.
+    uint32_t numRegisteredBuffers{0};
+    /// The byte size of each registered buffer.
+    uint64_t registeredBufferSize{1 << 20};
+  };
+
+  /// Reads consecutive 'buffers' starting at 'offset'. The bytes of a buffer
+  /// with null data are skipped.
+  struct ReadRequest {
+    uint64_t offset;
+    std::vector<folly::Range<char*>> buffers;
+  };
+
+  /// Returns nullptr if io_uring is not available.
+  static std::unique_ptr<IoUring> create(const Options& options);
+
+  /// Returns true if io_uring is built in and supported by the kernel.
+  static bool isSupported();
+
+  /// Waits for the completion thread to exit. The IOs in flight must have
+  /// completed.
+  ~IoUring();
+
+  /// Reads 'requests' from 'fd' with one submission. Returns the total number
+  /// of bytes read, which is less than requested only if a read reaches the
+  /// end of file. 'directIo' indicates if 'fd' is opened with O_DIRECT.
+  folly::SemiFuture<uint64_t>
+  read(int32_t fd, std::vector<ReadRequest> requests, bool directIo);
+
+  /// Writes 'iovecs' to 'fd' at 'offset'. Returns the number of bytes written.
+  folly::SemiFuture<uint64_t>
+  write(int32_t fd, uint64_t offset, std::vector<iovec> iovecs);
+
+  /// Returns the number of free registered buffers. Used for test.
+  uint32_t testingNumFreeBuffers() const;
+
+ private:
+  struct Batch;
+  struct Op;
+
+  explicit IoUring(const Options& options);
+
+  // Adds 'ops' to the submission queue and submits them. Blocks if there are
+  // already as many IOs in flight as the completion queue can hold. Each op is
+  // released from 'ops' once the ring owns it, so the ops left in 'ops' on
+  // throw have not been submitted.
+  void submit(std::vector<std::unique_ptr<Op>>& ops);
+
+  // Adds 'op' to the submission queue. Submits the queued entries to make
+  // room if the queue is full.
+  void prepareLocked(Op* op);
+
+  // Makes the O_DIRECT read 'op' read through an aligned staging buffer if its
+  // offset or buffers are not aligned. Uses a registered buffer if one is free
+  // and the aligned read range fits in it, or a temporary buffer otherwise.
+  void maybeStageDirectRead(Op& op);
+
+  // Runs on 'completionThread_' to process the completed IOs. Exits on the
+  // no-op submitted by the destructor or if waiting for a completion fails.
+  void processCompletions();
+
+  // Fails the IOs in flight and the later submissions with 'error'. Called by
+  // the completion thread if it can't wait for the completions any more.
+  void failInflight(const folly::exception_wrapper& error);
+
+  // Processes the completion of 'op' with the result 'res'. Returns true if
+  // 'op' is complete, or false if it has been resubmitted to complete a short
+  // read or write.
+  bool complete(Op* op, int32_t res);
+
+  // Returns the index of a free registered buffer, or -1 if there is none.
+  int32_t acquireBuffer();
+
+  void releaseBuffer(int32_t index);
+
+  const Options options_;
+  const uint32_t maxInflight_;
+  // Owned. A raw pointer as io_uring is incomplete if not built in.
+  io_uring* ring_{nullptr};
+
+  mutable std::mutex mutex_;
+  std::condition_variable inflightCv_;
+  uint32_t numInflight_{0};
+  // The ops owned by the ring.
+  folly::F14FastSet<Op*> inflightOps_;
+  bool stopping_{false};
+  // Set if the completion thread has failed and exited.
+  bool failed_{false};
+
+  char* registeredBuffers_{nullptr};
+  std::vector<int32_t> freeBuffers_;
+
+  std::thread completionThread_;
+};
+} // namespace facebook::velox
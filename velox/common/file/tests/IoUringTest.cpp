@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUring.h"
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/file/File.h"
+#include "velox/common/testutil/TestValue.h"
+#include "velox/exec/tests/utils/TempFilePath.h"
+
+#include "gtest/gtest.h"
+
+using namespace facebook::velox;
+using facebook::velox::common::Region;
+using facebook::velox::common::testutil::TestValue;
+
+class IoUringTest : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    TestValue::enable();
+  }
+
+  void SetUp() override {
+    if (!IoUring::isSupported()) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+    tempFile_ = exec::test::TempFilePath::create();
+    // Writes a byte pattern which identifies the offset of each byte.
+    data_.resize(kFileSize);
+    for (size_t i = 0; i < kFileSize; ++i) {
+      data_[i] = static_cast<char>(i % 251);
+    }
+  }
+
+  void writeTestFile(IoUring* ioUring) {
+    LocalWriteFile writeFile(tempFile_->getPath(), false, false, true, ioUring);
+    // Writes the second half first to verify the positional writes.
+    const auto half = kFileSize / 2;
+    writeFile.write({{data_.data() + half, half}}, half, half);
+    writeFile.write({{data_.data(), half}}, 0, half);
+    ASSERT_EQ(writeFile.size(), kFileSize);
+    writeFile.close();
+  }
+
+  static constexpr size_t kFileSize = 1 << 20;
+
+  std::shared_ptr<exec::test::TempFilePath> tempFile_;
+  std::string data_;
+};
+
+TEST_F(IoUringTest, readAndWrite) {
+  auto ioUring = IoUring::create({.queueDepth = 8});
+  ASSERT_NE(ioUring, nullptr);
+  writeTestFile(ioUring.get());
+
+  LocalReadFile readFile(tempFile_->getPath(), nullptr, true, ioUring.get());
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+  std::string head(100, 0);
+  std::string tail(200, 0);
+  // Skips 1000 bytes between the two buffers.
+  const std::vector<folly::Range<char*>> buffers{
+      {head.data(), head.size()},
+      {nullptr, 1'000},
+      {tail.data(), tail.size()}};
+  ASSERT_EQ(readFile.preadvAsync(10, buffers).get(), 300);
+  ASSERT_EQ(head, data_.substr(10, 100));
+  ASSERT_EQ(tail, data_.substr(1'110, 200));
+
+  // Reads beyond the end of file return the available bytes.
+  std::string end(1'000, 0);
+  ASSERT_EQ(
+      readFile.preadvAsync(kFileSize - 100, {{end.data(), end.size()}})
+          .get(),
+      100);
+  ASSERT_EQ(end.substr(0, 100), data_.substr(kFileSize - 100));
+}
+
+TEST_F(IoUringTest, batchedRegions) {
+  // Submits many more regions than the queue depth.
+  auto ioUring = IoUring::create({.queueDepth = 4});
+  ASSERT_NE(ioUring, nullptr);
+  writeTestFile(ioUring.get());
+
+  LocalReadFile readFile(tempFile_->getPath(), nullptr, true, ioUring.get());
+  std::vector<Region> regions;
+  for (uint64_t offset = 7; offset + 3'000 < kFileSize; offset += 10'007) {
+    regions.emplace_back(offset, 3'000);
+  }
+  std::vector<folly::IOBuf> iobufs(regions.size());
+  ASSERT_EQ(
+      readFile.preadv(regions, {iobufs.data(), iobufs.size()}),
+      regions.size() * 3'000);
+  for (size_t i = 0; i < regions.size(); ++i) {
+    ASSERT_EQ(
+        iobufs[i].moveToFbString().toStdString(),
+        data_.substr(regions[i].offset, regions[i].length));
+  }
+}
+
+TEST_F(IoUringTest, registeredBuffers) {
+  auto ioUring =
+      IoUring::create({.queueDepth = 8, .numRegisteredBuffers = 2});
+  ASSERT_NE(ioUring, nullptr);
+  const auto numFreeBuffers = ioUring->testingNumFreeBuffers();
+  if (numFreeBuffers == 0) {
+    GTEST_SKIP() << "Failed to register io_uring buffers";
+  }
+  writeTestFile(nullptr);
+
+  std::unique_ptr<LocalReadFile> readFile;
+  try {
+    readFile = std::make_unique<LocalReadFile>(
+        tempFile_->getPath(), nullptr, false, ioUring.get());
+  } catch (const VeloxException&) {
+    GTEST_SKIP() << "O_DIRECT is not supported by the file system";
+  }
+  // The unaligned reads go through the registered buffers.
+  for (const auto& [offset, size] :
+       std::vector<std::pair<uint64_t, uint64_t>>{
+           {1, 10}, {4'095, 2}, {100'000, 70'000}, {kFileSize - 10, 10}}) {
+    std::string buffer(size, 0);
+    ASSERT_EQ(
+        readFile->preadvAsync(offset, {{buffer.data(), buffer.size()}})
+            .get(),
+        size);
+    ASSERT_EQ(buffer, data_.substr(offset, size));
+  }
+  ASSERT_EQ(ioUring->testingNumFreeBuffers(), numFreeBuffers);
+}
+
+TEST_F(IoUringTest, bounceBuffers) {
+  // A single small registered buffer, which the larger reads don't fit in and
+  // the concurrent reads contend on.
+  auto ioUring = IoUring::create(
+      {.queueDepth = 8,
+       .numRegisteredBuffers = 1,
+       .registeredBufferSize = 4096});
+  ASSERT_NE(ioUring, nullptr);
+  writeTestFile(nullptr);
+
+  std::unique_ptr<LocalReadFile> readFile;
+  try {
+    readFile = std::make_unique<LocalReadFile>(
+        tempFile_->getPath(), nullptr, false, ioUring.get());
+  } catch (const VeloxException&) {
+    GTEST_SKIP() << "O_DIRECT is not supported by the file system";
+  }
+  const auto numFreeBuffers = ioUring->testingNumFreeBuffers();
+  // The unaligned reads go through the temporary aligned buffers if no
+  // registered buffer is available.
+  const std::vector<std::pair<uint64_t, uint64_t>> ranges{
+      {1, 10}, {5, 100}, {4'095, 20'000}, {kFileSize - 10, 10}};
+  std::vector<std::string> buffers;
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  for (const auto& [offset, size] : ranges) {
+    buffers.emplace_back(size, 0);
+    futures.push_back(readFile->preadvAsync(
+        offset, {{buffers.back().data(), buffers.back().size()}}));
+  }
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    ASSERT_EQ(std::move(futures[i]).get(), ranges[i].second);
+    ASSERT_EQ(buffers[i], data_.substr(ranges[i].first, ranges[i].second));
+  }
+  ASSERT_EQ(ioUring->testingNumFreeBuffers(), numFreeBuffers);
+}
+
+TEST_F(IoUringTest, readError) {
+  auto ioUring = IoUring::create({});
+  ASSERT_NE(ioUring, nullptr);
+  std::string buffer(10, 0);
+  // Reads from an invalid file descriptor.
+  VELOX_ASSERT_THROW(
+      ioUring->read(-1, {{0, {{buffer.data(), buffer.size()}}}}, false).get(),
+      "io_uring read failed");
+}
+
+DEBUG_ONLY_TEST_F(IoUringTest, waitCompletionError) {
+  auto ioUring = IoUring::create({});
+  ASSERT_NE(ioUring, nullptr);
+  writeTestFile(ioUring.get());
+
+  std::atomic_int numWaits{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::IoUring::processCompletions",
+      std::function<void(int*)>([&](int* ret) {
+        // Interrupts the first wait and fails the third.
+        const auto wait = numWaits++;
+        if (wait == 0) {
+          *ret = -EINTR;
+        } else if (wait == 2) {
+          *ret = -EIO;
+        }
+      }));
+
+  LocalReadFile readFile(tempFile_->getPath(), nullptr, true, ioUring.get());
+  std::string buffer(100, 0);
+  // The interrupted wait is retried.
+  ASSERT_EQ(
+      readFile.preadvAsync(0, {{buffer.data(), buffer.size()}}).get(), 100);
+  ASSERT_EQ(buffer, data_.substr(0, 100));
+  ASSERT_EQ(numWaits, 2);
+
+  // The failed wait fails the pending read and the later ones.
+  VELOX_ASSERT_THROW(
+      readFile.preadvAsync(0, {{buffer.data(), buffer.size()}}).get(),
+      "io_uring_wait_cqe failed");
+  VELOX_ASSERT_THROW(
+      readFile.preadvAsync(0, {{buffer.data(), buffer.size()}}).get(),
+      "io_uring completion thread has failed");
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/memory/AllocationSampler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <fmt/format.h>
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/process/StackTrace.h"
+
+namespace facebook::velox::memory {
+
+AllocationSampler::AllocationSampler(uint64_t sampleBytes)
+    : sampleBytes_(sampleBytes),
+      bytesUntilSample_(static_cast<int64_t>(sampleBytes)) {
+  VELOX_CHECK_GT(sampleBytes_, 0);
+}
+
+size_t AllocationSampler::StackHasher::operator()(
+    const std::vector<void*>& stack) const {
+  size_t hash{0};
+  for (const auto* frame : stack) {
+    hash = folly::hash::hash_combine(hash, frame);
+  }
+  return hash;
+}
+
+void AllocationSampler::sample(const void* addr, uint64_t bytes) {
+  // Skips the frames of the sampler.
+  process::StackTrace trace(1);
+  // An allocation of at least 'sampleBytes_' is always sampled and represents
+  // itself. A smaller one is sampled once per 'sampleBytes_' allocated bytes
+  // on average and represents that many bytes.
+  const uint64_t estimatedBytes = std::max(bytes, sampleBytes_);
+  const uint64_t estimatedCount =
+      bytes == 0 ? 1 : std::max<uint64_t>(1, estimatedBytes / bytes);
+
+  std::lock_guard<std::mutex> l(mutex_);
+  // Sets up the next sample point. Concurrent allocations crossing the same
+  // sample point might have been sampled with this one.
+  const int64_t remainingBytes =
+      bytesUntilSample_.load(std::memory_order_relaxed);
+  if (remainingBytes <= 0) {
+    const int64_t interval = sampleBytes_;
+    bytesUntilSample_.fetch_add(
+        (-remainingBytes / interval + 1) * interval, std::memory_order_relaxed);
+  }
+
+  auto it = siteIndices_.find(trace.getStack());
+  if (it == siteIndices_.end()) {
+    it = siteIndices_.emplace(trace.getStack(), sites_.size()).first;
+    sites_.push_back(Site{trace.getStack()});
+  }
+  auto& site = sites_[it->second];
+  site.allocCount += estimatedCount;
+  site.allocBytes += estimatedBytes;
+  if (addr == nullptr) {
+    return;
+  }
+  site.inUseCount += estimatedCount;
+  site.inUseBytes += estimatedBytes;
+  // A freed address might be reused by the next allocation without going
+  // through this sampler.
+  auto liveIt = liveSamples_.find(addr);
+  if (liveIt != liveSamples_.end()) {
+    auto& staleSite = sites_[liveIt->second.siteIndex];
+    staleSite.inUseCount -= liveIt->second.count;
+    staleSite.inUseBytes -= liveIt->second.bytes;
+    liveIt->second = LiveSample{it->second, estimatedCount, estimatedBytes};
+    return;
+  }
+  liveSamples_.emplace(
+      addr, LiveSample{it->second, estimatedCount, estimatedBytes});
+  ++numLiveSamples_;
+}
+
+void AllocationSampler::sampleFree(const void* addr) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = liveSamples_.find(addr);
+  if (it == liveSamples_.end()) {
+    return;
+  }
+  auto& site = sites_[it->second.siteIndex];
+  site.inUseCount -= it->second.count;
+  site.inUseBytes -= it->second.bytes;
+  liveSamples_.erase(it);
+  --numLiveSamples_;
+}
+
+std::vector<AllocationSampler::Site> AllocationSampler::sites() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return sites_;
+}
+
+// static
+std::string AllocationSampler::toPprof(const std::vector<Site>& sites) {
+  Site total;
+  for (const auto& site : sites) {
+    total.inUseCount += site.inUseCount;
+    total.inUseBytes += site.inUseBytes;
+    total.allocCount += site.allocCount;
+    total.allocBytes += site.allocBytes;
+  }
+
+  std::stringstream out;
+  // The samples are already scaled so the sampling rate is not reported.
+  out << fmt::format(
+      "heap profile: {}: {} [{}: {}] @ heap\n",
+      total.inUseCount,
+      total.inUseBytes,
+      total.allocCount,
+      total.allocBytes);
+  for (const auto& site : sites) {
+    out << fmt::format(
+        "{}: {} [{}: {}] @",
+        site.inUseCount,
+        site.inUseBytes,
+        site.allocCount,
+        site.allocBytes);
+    for (const auto* frame : site.stack) {
+      out << fmt::format(" {}", fmt::ptr(frame));
+    }
+    out << "\n";
+  }
+
+  out << "\nMAPPED_LIBRARIES:\n";
+  std::ifstream maps("/proc/self/maps");
+  if (maps.is_open()) {
+    out << maps.rdbuf();
+  }
+  return out.str();
+}
+} // namespace facebook::velox::memory
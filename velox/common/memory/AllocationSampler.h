@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Likely.h>
+
+namespace facebook::velox::memory {
+
+/// Samples the allocations from a leaf memory pool with their call stacks to
+/// find the call sites which drive the memory usage. It samples the
+/// allocation which contains every 'sampleBytes'th allocated byte, so the
+/// overhead is a couple of atomic operations per allocation plus a stack
+/// unwinding per sample. Each sample is weighted by the number of bytes it
+/// represents. The samples are aggregated by call site, and are tracked until
+/// freed to report both the in-use and the cumulative allocations.
+///
+/// The class is thread-safe.
+class AllocationSampler {
+ public:
+  /// The sampled allocations from one call site.
+  struct Site {
+    /// The return addresses of the call stack from the innermost frame.
+    std::vector<void*> stack;
+    /// The estimated number and bytes of the allocations which have not been
+    /// freed.
+    uint64_t inUseCount{0};
+    uint64_t inUseBytes{0};
+    /// The estimated number and bytes of all the allocations.
+    uint64_t allocCount{0};
+    uint64_t allocBytes{0};
+  };
+
+  explicit AllocationSampler(uint64_t sampleBytes);
+
+  uint64_t sampleBytes() const {
+    return sampleBytes_;
+  }
+
+  /// Invoked on an allocation of 'bytes' at 'addr'. Returns true if the
+  /// allocation is sampled.
+  bool recordAlloc(const void* addr, uint64_t bytes) {
+    const auto remainingBytes = bytesUntilSample_.fetch_sub(
+        static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    if (FOLLY_LIKELY(remainingBytes > static_cast<int64_t>(bytes))) {
+      return false;
+    }
+    sample(addr, bytes);
+    return true;
+  }
+
+  /// Invoked on the free of the allocation at 'addr'.
+  void recordFree(const void* addr) {
+    if (numLiveSamples_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    sampleFree(addr);
+  }
+
+  /// Returns the sampled call sites.
+  std::vector<Site> sites() const;
+
+  /// Returns 'sites' as a heap profile in the legacy text format of gperftools
+  /// which can be read by pprof. The profile has the memory mappings of the
+  /// process to symbolize the call stacks offline.
+  static std::string toPprof(const std::vector<Site>& sites);
+
+ private:
+  struct StackHasher {
+    size_t operator()(const std::vector<void*>& stack) const;
+  };
+
+  struct LiveSample {
+    size_t siteIndex;
+    uint64_t count;
+    uint64_t bytes;
+  };
+
+  void sample(const void* addr, uint64_t bytes);
+
+  void sampleFree(const void* addr);
+
+  const uint64_t sampleBytes_;
+
+  // The number of bytes to allocate until the next sample. It goes negative
+  // when an allocation crosses the sample point.
+  std::atomic<int64_t> bytesUntilSample_;
+  std::atomic<uint64_t> numLiveSamples_{0};
+
+  mutable std::mutex mutex_;
+  std::vector<Site> sites_;
+  // Maps from the call stack to its index in 'sites_'.
+  std::unordered_map<std::vector<void*>, size_t, StackHasher> siteIndices_;
+  // Maps from the address of a sampled allocation which has not been freed.
+  std::unordered_map<const void*, LiveSample> liveSamples_;
+};
+} // namespace facebook::velox::memory
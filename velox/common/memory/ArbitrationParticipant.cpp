@@ -316,6 +316,15 @@ bool ArbitrationParticipant::grow(
   return success;
 }
 
+bool ArbitrationParticipant::growToHint(uint64_t growBytes) {
+  std::lock_guard<std::mutex> l(stateLock_);
+  const bool success = pool_->grow(growBytes, 0);
+  if (success) {
+    growBytes_ += growBytes;
+  }
+  return success;
+}
+
 uint64_t ArbitrationParticipant::shrink(bool reclaimAll) {
   std::lock_guard<std::mutex> l(stateLock_);
   return shrinkLocked(reclaimAll);
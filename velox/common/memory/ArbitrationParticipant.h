@@ -227,6 +227,12 @@ class ArbitrationParticipant
   /// fails.
   bool grow(uint64_t growBytes, uint64_t reservationBytes);
 
+  /// Invoked to grow the query memory pool capacity by 'growBytes' up front to
+  /// a capacity hint. Unlike grow(), this is not counted as a capacity growth
+  /// request of the participant. The function returns false if the growth
+  /// fails.
+  bool growToHint(uint64_t growBytes);
+
   /// Invoked to release the unused memory capacity by reducing its capacity. If
   /// 'reclaimAll' is true, the function releases all the unused memory capacity
   /// from the query memory pool without regarding to the minimum free capacity
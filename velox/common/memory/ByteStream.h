@@ -210,6 +210,14 @@ class ByteInputStream {
 
   virtual std::string toString() const = 0;
 
+  /// Returns the IOBuf holding the memory of this stream if the memory is
+  /// immutable and may be referenced beyond the lifetime of the stream, e.g.
+  /// by vectors wrapping the read bytes without copying. Returns nullptr if the
+  /// bytes must be copied out.
+  virtual std::shared_ptr<folly::IOBuf> bufferOwner() const {
+    return nullptr;
+  }
+
  protected:
   // Points to the current buffered byte range.
   ByteRange* current_{nullptr};
@@ -218,7 +226,12 @@ class ByteInputStream {
 /// Read-only input stream backed by a set of buffers.
 class BufferInputStream : public ByteInputStream {
  public:
-  explicit BufferInputStream(std::vector<ByteRange> ranges) {
+  /// If not null, 'bufferOwner' holds the memory of 'ranges' and allows the
+  /// readers to retain the memory after the stream is destroyed.
+  explicit BufferInputStream(
+      std::vector<ByteRange> ranges,
+      std::shared_ptr<folly::IOBuf> bufferOwner = nullptr)
+      : bufferOwner_(std::move(bufferOwner)) {
     VELOX_CHECK(!ranges.empty(), "Empty BufferInputStream");
     ranges_ = std::move(ranges);
     current_ = &ranges_[0];
@@ -249,6 +262,10 @@ class BufferInputStream : public ByteInputStream {
 
   std::string toString() const override;
 
+  std::shared_ptr<folly::IOBuf> bufferOwner() const override {
+    return bufferOwner_;
+  }
+
  private:
   // Sets 'current_' to the next range of input. The input is consecutive
   // ByteRanges in 'ranges_' for the base class but any view over external
@@ -259,6 +276,7 @@ class BufferInputStream : public ByteInputStream {
     return ranges_;
   }
 
+  const std::shared_ptr<folly::IOBuf> bufferOwner_;
   std::vector<ByteRange> ranges_;
 };
 
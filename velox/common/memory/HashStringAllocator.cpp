@@ -85,11 +85,18 @@ HashStringAllocator::~HashStringAllocator() {
   clear();
 }
 
-void HashStringAllocator::clear() {
+void HashStringAllocator::clearFreeLists() {
   state_.numFree() = 0;
   state_.freeBytes() = 0;
   std::fill(
       std::begin(state_.freeNonEmpty()), std::end(state_.freeNonEmpty()), 0);
+  for (auto i = 0; i < kNumFreeLists; ++i) {
+    new (&state_.freeLists()[i]) CompactDoubleList();
+  }
+}
+
+void HashStringAllocator::clear() {
+  clearFreeLists();
   for (auto& pair : state_.allocationsFromPool()) {
     const auto size = pair.second;
     pool()->free(pair.first, size);
@@ -97,9 +104,6 @@ void HashStringAllocator::clear() {
     state_.currentBytes() -= size;
   }
   state_.allocationsFromPool().clear();
-  for (auto i = 0; i < kNumFreeLists; ++i) {
-    new (&state_.freeLists()[i]) CompactDoubleList();
-  }
 
 #ifndef NDEBUG
   static const auto kHugePageSize = memory::AllocationTraits::kHugePageSize;
@@ -144,6 +148,83 @@ void HashStringAllocator::clear() {
   state_.sizeFromPool() = 0;
 }
 
+int64_t HashStringAllocator::compact(
+    const std::function<void(const RelocateFn&)>& relocateLiveBlocks) {
+  VELOX_CHECK_NULL(
+      state_.currentHeader(),
+      "Do not call compact() when a write is in progress");
+  // The owner's pointers are moved to the new blocks one by one, so a failed
+  // allocation could not be rolled back. Makes sure that the pool can hold a
+  // copy of the live blocks before starting.
+  const int64_t copyBytes =
+      state_.pool().allocatedBytes() - state_.freeBytes();
+  int64_t reservedBytes{0};
+  if (pool()->availableReservation() < copyBytes) {
+    const auto reservedBefore = pool()->reservedBytes();
+    if (!pool()->maybeReserve(copyBytes)) {
+      return 0;
+    }
+    reservedBytes = pool()->reservedBytes() - reservedBefore;
+  }
+
+  const auto retainedBytes = retainedSize();
+  // Sets the slabs aside and starts over with empty free lists. The live
+  // blocks are copied out of the old slabs before these are freed.
+  memory::AllocationPool oldPool(pool());
+  oldPool.swap(state_.pool());
+  state_.pool().setHugePageThreshold(oldPool.hugePageThreshold());
+  clearFreeLists();
+  state_.currentBytes() = state_.sizeFromPool();
+  relocateLiveBlocks([this](Header* header) { return relocate(header); });
+  oldPool.clear();
+  if (reservedBytes > 0) {
+    // Keeps the reservation the owner may have made for its next input.
+    pool()->releaseReservation(reservedBytes);
+  }
+  return retainedBytes - retainedSize();
+}
+
+double HashStringAllocator::fragmentation() const {
+  const auto slabBytes = state_.pool().allocatedBytes();
+  if (slabBytes == 0) {
+    return 0;
+  }
+  return static_cast<double>(state_.freeBytes()) / slabBytes;
+}
+
+bool HashStringAllocator::isFromPool(Header* header) const {
+  return header->size() > kMaxAlloc &&
+      state_.allocationsFromPool().find(header) !=
+      state_.allocationsFromPool().end();
+}
+
+HashStringAllocator::Header* HashStringAllocator::relocate(Header* header) {
+  VELOX_CHECK_NOT_NULL(header);
+  if (!header->isContinued() && isFromPool(header)) {
+    return header;
+  }
+  int64_t size = 0;
+  for (auto* part = header;; part = part->nextContinued()) {
+    size += part->usableSize();
+    if (!part->isContinued()) {
+      break;
+    }
+  }
+  VELOX_CHECK_LE(size, Header::kSizeMask);
+  auto* newHeader = allocate(std::max<int32_t>(size, kMinAlloc), true);
+  auto* destination = newHeader->begin();
+  for (auto* part = header; part != nullptr;) {
+    auto* next = part->isContinued() ? part->nextContinued() : nullptr;
+    std::memcpy(destination, part->begin(), part->usableSize());
+    destination += part->usableSize();
+    if (isFromPool(part)) {
+      freeToPool(part, blockBytes(part));
+    }
+    part = next;
+  }
+  return newHeader;
+}
+
 void* HashStringAllocator::allocateFromPool(size_t size) {
   auto* ptr = pool()->allocate(size);
   state_.currentBytes() += size;
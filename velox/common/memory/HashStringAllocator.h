@@ -25,6 +25,8 @@
 
 #include <folly/container/F14Map.h>
 
+#include <functional>
+
 namespace facebook::velox {
 
 /// Implements an arena backed by memory::Allocation. This is for backing
@@ -313,6 +315,29 @@ class HashStringAllocator : public StreamArena {
   /// Frees all memory associated with 'this' and leaves 'this' ready for reuse.
   void clear() override;
 
+  /// Moves a live block and its continuations into one contiguous block and
+  /// returns the Header of the moved block. See compact().
+  using RelocateFn = std::function<Header*(Header*)>;
+
+  /// Moves the live blocks into new densely packed slabs and frees the old
+  /// slabs. This returns the free space scattered over the slabs after long
+  /// sequences of allocations and frees to pool(). 'relocateLiveBlocks' is
+  /// called with a function to move a block. This must be called exactly once
+  /// for the first Header of every live block and the owner must replace its
+  /// pointers into the old block with pointers into the moved one. The blocks
+  /// in the old slabs which are not moved are freed. Large blocks allocated
+  /// directly from pool() stay in place. Needs memory for a copy of the live
+  /// blocks while running. This is reserved from pool() up front if not
+  /// available in its reservation, and nothing is done if the reservation
+  /// fails. Only the reservation added here is released on return. Returns
+  /// the number of bytes released to pool().
+  int64_t compact(
+      const std::function<void(const RelocateFn&)>& relocateLiveBlocks);
+
+  /// Returns the fraction of the slab memory of 'this' which is in free blocks.
+  /// A high value means that compact() can release much memory.
+  double fragmentation() const;
+
   memory::MemoryPool* pool() const {
     return state_.pool().pool();
   }
@@ -401,6 +426,16 @@ class HashStringAllocator : public StreamArena {
   // Returns the free list index for 'size'.
   int32_t freeListIndex(int size);
 
+  // Empties the free lists and the free space accounting.
+  void clearFreeLists();
+
+  // Returns true if 'header' is a large block allocated from pool().
+  bool isFromPool(Header* header) const;
+
+  // Copies the contents of 'header' and its continuations into a new block and
+  // frees the parts which are large blocks from pool(). Used by compact().
+  Header* relocate(Header* header);
+
   /// A class that wraps any fields in the HashStringAllocator, it's main
   /// purpose is to simplify the freeze/unfreeze mechanic.  Fields are exposed
   /// via accessor methods, attempting to invoke a non-const accessor when the
@@ -120,7 +120,8 @@ bool MallocAllocator::allocateContiguousWithoutRetry(
     MachinePageCount numPages,
     Allocation* collateral,
     ContiguousAllocation& allocation,
-    MachinePageCount maxPages) {
+    MachinePageCount maxPages,
+    bool /*hugeTlb*/) {
   bool result;
   stats_.recordAllocate(AllocationTraits::pageBytes(numPages), 1, [&]() {
     result = allocateContiguousImpl(numPages, collateral, allocation, maxPages);
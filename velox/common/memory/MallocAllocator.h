@@ -90,7 +90,8 @@ class MallocAllocator : public MemoryAllocator {
       MachinePageCount numPages,
       Allocation* collateral,
       ContiguousAllocation& allocation,
-      MachinePageCount maxPages = 0) override;
+      MachinePageCount maxPages = 0,
+      bool hugeTlb = false) override;
 
   bool allocateContiguousImpl(
       MachinePageCount numPages,
@@ -52,6 +52,9 @@ std::shared_ptr<MemoryAllocator> createAllocator(
     mmapOptions.largestSizeClass = options.largestSizeClassPages;
     mmapOptions.useMmapArena = options.useMmapArena;
     mmapOptions.mmapArenaCapacityRatio = options.mmapArenaCapacityRatio;
+    mmapOptions.numNumaNodes =
+        options.useNumaLocalArenas ? MmapAllocator::numaNodes() : 1;
+    mmapOptions.hugeTlbPoolBytes = options.hugeTlbPoolBytes;
     return std::make_shared<MmapAllocator>(mmapOptions);
   } else {
     return std::make_shared<MallocAllocator>(
@@ -97,6 +100,9 @@ MemoryManager::MemoryManager(const MemoryManagerOptions& options)
       debugEnabled_(options.debugEnabled),
       coreOnAllocationFailureEnabled_(options.coreOnAllocationFailureEnabled),
       disableMemoryPoolTracking_(options.disableMemoryPoolTracking),
+      reservationCacheBytes_(options.reservationCacheBytes),
+      allocationSampleBytes_(options.allocationSampleBytes),
+      allocationProfileThresholdBytes_(options.allocationProfileThresholdBytes),
       getPreferredSize_(options.getPreferredSize),
       poolDestructionCb_([&](MemoryPool* pool) { dropPool(pool); }),
       sysRoot_{std::make_shared<MemoryPoolImpl>(
@@ -114,7 +120,10 @@ MemoryManager::MemoryManager(const MemoryManagerOptions& options)
               .debugEnabled = options.debugEnabled,
               .coreOnAllocationFailureEnabled =
                   options.coreOnAllocationFailureEnabled,
-              .getPreferredSize = getPreferredSize_})},
+              .getPreferredSize = getPreferredSize_,
+              .allocationSampleBytes = options.allocationSampleBytes,
+              .allocationProfileThresholdBytes =
+                  options.allocationProfileThresholdBytes})},
       spillPool_{addLeafPool("__sys_spilling__")},
       cachePool_{addLeafPool("__sys_caching__")},
       tracePool_{addLeafPool("__sys_tracing__")},
@@ -250,6 +259,9 @@ std::shared_ptr<MemoryPool> MemoryManager::addRootPool(
   options.debugEnabled = debugEnabled_;
   options.coreOnAllocationFailureEnabled = coreOnAllocationFailureEnabled_;
   options.getPreferredSize = getPreferredSize_;
+  options.reservationCacheBytes = reservationCacheBytes_;
+  options.allocationSampleBytes = allocationSampleBytes_;
+  options.allocationProfileThresholdBytes = allocationProfileThresholdBytes_;
 
   auto pool = createRootPool(poolName, reclaimer, options);
   if (!disableMemoryPoolTracking_) {
@@ -84,6 +84,25 @@ struct MemoryManagerOptions {
   /// Disables the memory manager's tracking on memory pools.
   bool disableMemoryPoolTracking{false};
 
+  /// The reservation cache size in bytes of the thread-safe leaf memory pools
+  /// of the root pools created by addRootPool(). A leaf pool reserves this
+  /// much memory ahead of its usage so that the concurrent allocations from
+  /// the drivers of a query don't contend on the shared parent pools. Zero to
+  /// disable. See MemoryPool::Options::reservationCacheBytes.
+  uint64_t reservationCacheBytes{0};
+
+  /// If not zero, the leaf memory pools sample an allocation with its call
+  /// stack every this many allocated bytes. See
+  /// MemoryPool::Options::allocationSampleBytes.
+  uint64_t allocationSampleBytes{
+      FLAGS_velox_memory_pool_allocation_sample_bytes};
+
+  /// If not zero, a leaf memory pool dumps its allocation profile once when its
+  /// memory usage exceeds this many bytes. See
+  /// MemoryPool::Options::allocationProfileThresholdBytes.
+  uint64_t allocationProfileThresholdBytes{
+      FLAGS_velox_memory_pool_allocation_profile_threshold_bytes};
+
   /// ================== 'MemoryAllocator' settings ==================
 
   /// Specifies the max memory allocation capacity in bytes enforced by
@@ -112,6 +131,20 @@ struct MemoryManagerOptions {
   /// NOTE: this only applies for MmapAllocator.
   int32_t mmapArenaCapacityRatio{10};
 
+  /// If true, keeps separate size classes for each NUMA node of the system
+  /// and serves the allocations from the node of the calling thread. See
+  /// MmapAllocator::Options::numNumaNodes.
+  ///
+  /// NOTE: this only applies for MmapAllocator.
+  bool useNumaLocalArenas{false};
+
+  /// If not zero, reserves a pool of this many bytes of explicit huge pages to
+  /// serve the large contiguous allocations which opt in. See
+  /// MmapAllocator::Options::hugeTlbPoolBytes.
+  ///
+  /// NOTE: this only applies for MmapAllocator.
+  uint64_t hugeTlbPoolBytes{0};
+
   /// If not zero, reserve 'smallAllocationReservePct'% of space from
   /// 'allocatorCapacity' for ad hoc small allocations. And those allocations
   /// are delegated to std::malloc. If 'maxMallocBytes' is 0, this value will be
@@ -313,6 +346,9 @@ class MemoryManager {
   const bool debugEnabled_;
   const bool coreOnAllocationFailureEnabled_;
   const bool disableMemoryPoolTracking_;
+  const uint64_t reservationCacheBytes_;
+  const uint64_t allocationSampleBytes_;
+  const uint64_t allocationProfileThresholdBytes_;
   const std::function<size_t(size_t)> getPreferredSize_;
 
   // The destruction callback set for the allocated root memory pools which are
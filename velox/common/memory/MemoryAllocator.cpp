@@ -237,7 +237,8 @@ bool MemoryAllocator::allocateContiguous(
     Allocation* collateral,
     ContiguousAllocation& allocation,
     ReservationCallback reservationCB,
-    MachinePageCount maxPages) {
+    MachinePageCount maxPages,
+    bool hugeTlb) {
   const MachinePageCount numCollateralPages =
       allocation.numPages() + (collateral ? collateral->numPages() : 0);
   const uint64_t totalCollateralBytes =
@@ -282,14 +283,14 @@ bool MemoryAllocator::allocateContiguous(
   bool success = false;
   if (cache() == nullptr) {
     success = allocateContiguousWithoutRetry(
-        numPages, collateral, allocation, maxPages);
+        numPages, collateral, allocation, maxPages, hugeTlb);
   } else {
     success = cache()->makeSpace(
         pagesToAcquire(numPages, numCollateralPages),
         [&](Allocation& acquired) {
           freeNonContiguous(acquired);
           return allocateContiguousWithoutRetry(
-              numPages, collateral, allocation, maxPages);
+              numPages, collateral, allocation, maxPages, hugeTlb);
         });
   }
 
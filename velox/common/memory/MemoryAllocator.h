@@ -276,12 +276,20 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
   /// huge pages without declaring the whole range as held by the query. The
   /// reservation will be increased as and if addresses in the range are used.
   /// See growContiguous().
+  ///
+  /// If 'hugeTlb' is true and 'maxPages' is not larger than 'numPages', the
+  /// allocation may be served from the explicit huge page pool of the
+  /// allocator if it has one. This is an opt-in for the long lived randomly
+  /// accessed allocations, such as the hash table bucket arrays, so that the
+  /// pool is not drained by the other large allocations. The allocation is
+  /// zeroed in this case as well.
   bool allocateContiguous(
       MachinePageCount numPages,
       Allocation* collateral,
       ContiguousAllocation& allocation,
       ReservationCallback reservationCB = nullptr,
-      MachinePageCount maxPages = 0);
+      MachinePageCount maxPages = 0,
+      bool hugeTlb = false);
 
   /// Frees contiguous 'allocation'. 'allocation' is empty on return.
   virtual void freeContiguous(ContiguousAllocation& allocation) = 0;
@@ -437,7 +445,8 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
       MachinePageCount numPages,
       Allocation* collateral,
       ContiguousAllocation& allocation,
-      MachinePageCount maxPages = 0) = 0;
+      MachinePageCount maxPages = 0,
+      bool hugeTlb = false) = 0;
 
   virtual bool allocateNonContiguousWithoutRetry(
       const SizeMix& sizeMix,
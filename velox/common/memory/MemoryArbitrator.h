@@ -170,6 +170,20 @@ class MemoryArbitrator {
   /// 'requestor' to grow.
   virtual void growCapacity(MemoryPool* pool, uint64_t requestBytes) = 0;
 
+  /// Invoked to grow the capacity of a root memory 'pool' up front to
+  /// 'capacityHint', e.g. the peak memory usage predicted from the previous
+  /// executions of the same query. It saves the query from growing its
+  /// capacity through a number of memory arbitration rounds. The hinted
+  /// capacity is only granted from the free capacity without reclaiming memory
+  /// from the other pools, and is capped by the pool's max capacity. The
+  /// function returns the number of bytes granted which is zero if the
+  /// arbitrator doesn't support capacity hints.
+  virtual uint64_t growCapacityToHint(
+      MemoryPool* /*unused*/,
+      uint64_t /*unused*/) {
+    return 0;
+  }
+
   /// Invoked by the memory manager to shrink up to 'targetBytes' free capacity
   /// from a memory 'pool', and returns them back to the arbitrator. If
   /// 'targetBytes' is zero, we shrink all the free capacity from the memory
@@ -17,6 +17,7 @@
 #include "velox/common/memory/MemoryPool.h"
 
 #include <signal.h>
+#include <fstream>
 #include <set>
 
 #include "velox/common/base/Counters.h"
@@ -24,6 +25,7 @@
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/common/time/Timer.h"
 
 #include <re2/re2.h>
 
@@ -166,6 +168,14 @@ std::string capacityToString(int64_t capacity) {
   if (FOLLY_UNLIKELY(debugEnabled_)) { \
     leakCheckDbg();                    \
   }
+#define SAMPLE_ALLOC(addr, size)                       \
+  if (FOLLY_UNLIKELY(allocationSampler_ != nullptr)) { \
+    sampleAlloc(addr, size);                           \
+  }
+#define SAMPLE_FREE(addr)                              \
+  if (FOLLY_UNLIKELY(allocationSampler_ != nullptr)) { \
+    sampleFree(addr);                                  \
+  }
 } // namespace
 
 std::string MemoryPool::Stats::toString() const {
@@ -228,6 +238,10 @@ MemoryPool::MemoryPool(
       threadSafe_(options.threadSafe),
       debugEnabled_(options.debugEnabled),
       coreOnAllocationFailureEnabled_(options.coreOnAllocationFailureEnabled),
+      reservationCacheBytes_(
+          options.threadSafe ? options.reservationCacheBytes : 0),
+      allocationSampleBytes_(options.allocationSampleBytes),
+      allocationProfileThresholdBytes_(options.allocationProfileThresholdBytes),
       getPreferredSize_(
           options.getPreferredSize == nullptr
               ? [](size_t size) { return MemoryPool::getPreferredSize(size); }
@@ -447,12 +461,19 @@ MemoryPoolImpl::MemoryPoolImpl(
       reclaimer_(std::move(reclaimer)),
       // The memory manager sets the capacity through grow() according to the
       // actually used memory arbitration policy.
-      capacity_(parent_ != nullptr ? kMaxMemory : 0) {
+      capacity_(parent_ != nullptr ? kMaxMemory : 0),
+      allocationSampler_(
+          isLeaf() && allocationSampleBytes_ != 0
+              ? std::make_unique<AllocationSampler>(allocationSampleBytes_)
+              : nullptr) {
   VELOX_CHECK(options.threadSafe || isLeaf());
 }
 
 MemoryPoolImpl::~MemoryPoolImpl() {
   DEBUG_LEAK_CHECK();
+  if (isLeaf()) {
+    flushReservationCache();
+  }
   if (parent_ != nullptr) {
     toImpl(parent_)->dropChild(this);
   }
@@ -537,6 +558,7 @@ void* MemoryPoolImpl::allocate(
         allocator_->getAndClearFailureMessage()));
   }
   DEBUG_RECORD_ALLOC(buffer, size);
+  SAMPLE_ALLOC(buffer, alignedSize);
   return buffer;
 }
 
@@ -557,6 +579,7 @@ void* MemoryPoolImpl::allocateZeroFilled(int64_t numEntries, int64_t sizeEach) {
         allocator_->getAndClearFailureMessage()));
   }
   DEBUG_RECORD_ALLOC(buffer, size);
+  SAMPLE_ALLOC(buffer, alignedSize);
   return buffer;
 }
 
@@ -577,6 +600,7 @@ void* MemoryPoolImpl::reallocate(void* p, int64_t size, int64_t newSize) {
         allocator_->getAndClearFailureMessage()));
   }
   DEBUG_RECORD_ALLOC(newP, newSize);
+  SAMPLE_ALLOC(newP, alignedNewSize);
   if (p != nullptr) {
     ::memcpy(newP, p, std::min(size, newSize));
     free(p, size);
@@ -588,6 +612,7 @@ void MemoryPoolImpl::free(void* p, int64_t size) {
   CHECK_AND_INC_MEM_OP_STATS(Frees);
   const auto alignedSize = sizeAlign(size);
   DEBUG_RECORD_FREE(p, size);
+  SAMPLE_FREE(p);
   allocator_->freeBytes(p, alignedSize);
   release(alignedSize);
 }
@@ -605,6 +630,9 @@ void MemoryPoolImpl::allocateNonContiguous(
       "facebook::velox::common::memory::MemoryPoolImpl::allocateNonContiguous",
       this);
   DEBUG_RECORD_FREE(out);
+  if (!out.empty()) {
+    SAMPLE_FREE(out.runAt(0).data());
+  }
   if (!allocator_->allocateNonContiguous(
           numPages,
           out,
@@ -626,6 +654,7 @@ void MemoryPoolImpl::allocateNonContiguous(
   }
   DEBUG_RECORD_ALLOC(out);
   VELOX_CHECK(!out.empty());
+  SAMPLE_ALLOC(out.runAt(0).data(), out.byteSize());
   VELOX_CHECK_NULL(out.pool());
   out.setPool(this);
 }
@@ -633,6 +662,9 @@ void MemoryPoolImpl::allocateNonContiguous(
 void MemoryPoolImpl::freeNonContiguous(Allocation& allocation) {
   CHECK_AND_INC_MEM_OP_STATS(Frees);
   DEBUG_RECORD_FREE(allocation);
+  if (!allocation.empty()) {
+    SAMPLE_FREE(allocation.runAt(0).data());
+  }
   const int64_t freedBytes = allocator_->freeNonContiguous(allocation);
   VELOX_CHECK(allocation.empty());
   release(freedBytes);
@@ -649,13 +681,15 @@ const std::vector<MachinePageCount>& MemoryPoolImpl::sizeClasses() const {
 void MemoryPoolImpl::allocateContiguous(
     MachinePageCount numPages,
     ContiguousAllocation& out,
-    MachinePageCount maxPages) {
+    MachinePageCount maxPages,
+    bool hugeTlb) {
   CHECK_AND_INC_MEM_OP_STATS(Allocs);
   if (!out.empty()) {
     INC_MEM_OP_STATS(Frees);
   }
   VELOX_CHECK_GT(numPages, 0);
   DEBUG_RECORD_FREE(out);
+  SAMPLE_FREE(out.data());
   if (!allocator_->allocateContiguous(
           numPages,
           nullptr,
@@ -667,7 +701,8 @@ void MemoryPoolImpl::allocateContiguous(
               release(allocBytes);
             }
           },
-          maxPages)) {
+          maxPages,
+          hugeTlb)) {
     VELOX_CHECK(out.empty());
     handleAllocationFailure(fmt::format(
         "{} failed with {} pages from {} {}",
@@ -678,6 +713,7 @@ void MemoryPoolImpl::allocateContiguous(
   }
   DEBUG_RECORD_ALLOC(out);
   VELOX_CHECK(!out.empty());
+  SAMPLE_ALLOC(out.data(), out.size());
   VELOX_CHECK_NULL(out.pool());
   out.setPool(this);
 }
@@ -686,6 +722,7 @@ void MemoryPoolImpl::freeContiguous(ContiguousAllocation& allocation) {
   CHECK_AND_INC_MEM_OP_STATS(Frees);
   const int64_t bytesToFree = allocation.size();
   DEBUG_RECORD_FREE(allocation);
+  SAMPLE_FREE(allocation.data());
   allocator_->freeContiguous(allocation);
   VELOX_CHECK(allocation.empty());
   release(bytesToFree);
@@ -773,7 +810,11 @@ std::shared_ptr<MemoryPool> MemoryPoolImpl::genChild(
           .threadSafe = threadSafe,
           .debugEnabled = debugEnabled_,
           .coreOnAllocationFailureEnabled = coreOnAllocationFailureEnabled_,
-          .getPreferredSize = getPreferredSize});
+          .getPreferredSize = getPreferredSize,
+          .reservationCacheBytes = reservationCacheBytes_,
+          .allocationSampleBytes = allocationSampleBytes_,
+          .allocationProfileThresholdBytes =
+              allocationProfileThresholdBytes_});
 }
 
 bool MemoryPoolImpl::maybeReserve(uint64_t increment) {
@@ -820,6 +861,9 @@ void MemoryPoolImpl::reserveThreadSafe(uint64_t size, bool reserveOnly) {
     {
       std::lock_guard<std::mutex> l(mutex_);
       increment = reservationSizeLocked(size);
+      if (increment != 0 && reservationCacheBytes_ != 0 && !reserveOnly) {
+        increment = withReservationCacheLocked(increment);
+      }
       if (increment == 0) {
         if (reserveOnly) {
           minReservationBytes_ = tsanAtomicValue(reservationBytes_);
@@ -932,6 +976,29 @@ void MemoryPoolImpl::release() {
   release(0, true);
 }
 
+void MemoryPoolImpl::releaseReservation(uint64_t size) {
+  CHECK_AND_INC_MEM_OP_STATS(Releases);
+  if (!trackUsage_) {
+    return;
+  }
+  VELOX_CHECK(isLeaf());
+  int64_t freeable{0};
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    minReservationBytes_ = std::max<int64_t>(
+        0, minReservationBytes_ - static_cast<int64_t>(size));
+    const int64_t newQuantized = quantizedSize(
+        std::max(minReservationBytes_, usedReservationBytes_));
+    freeable = reservationBytes_ - newQuantized;
+    if (freeable <= 0) {
+      return;
+    }
+    reservationBytes_ = newQuantized;
+    sanityCheckLocked();
+  }
+  toImpl(parent_)->decrementReservation(freeable);
+}
+
 void MemoryPoolImpl::release(uint64_t size, bool releaseOnly) {
   if (FOLLY_LIKELY(trackUsage_)) {
     if (FOLLY_LIKELY(threadSafe_)) {
@@ -952,7 +1019,7 @@ void MemoryPoolImpl::releaseThreadSafe(uint64_t size, bool releaseOnly) {
     int64_t newQuantized;
     if (FOLLY_UNLIKELY(releaseOnly)) {
       VELOX_DCHECK_EQ(size, 0);
-      if (minReservationBytes_ == 0) {
+      if (minReservationBytes_ == 0 && reservationCacheBytes_ == 0) {
         return;
       }
       newQuantized = quantizedSize(usedReservationBytes_);
@@ -961,7 +1028,9 @@ void MemoryPoolImpl::releaseThreadSafe(uint64_t size, bool releaseOnly) {
       usedReservationBytes_ -= size;
       const int64_t newCap =
           std::max(minReservationBytes_, usedReservationBytes_);
-      newQuantized = quantizedSize(newCap);
+      newQuantized = reservationCacheBytes_ == 0
+          ? quantizedSize(newCap)
+          : cachedReservationLocked(newCap);
     }
     freeable = reservationBytes_ - newQuantized;
     if (freeable > 0) {
@@ -985,6 +1054,55 @@ void MemoryPoolImpl::decrementReservation(uint64_t size) noexcept {
   sanityCheckLocked();
 }
 
+int64_t MemoryPoolImpl::withReservationCacheLocked(int64_t increment) const {
+  VELOX_DCHECK(isLeaf());
+  const int64_t cachedIncrement =
+      roundedDelta(reservationBytes_, increment + reservationCacheBytes_);
+  // NOTE: the root pool counters are read without its lock as this is only a
+  // hint. The reservation is checked against the capacity again when it is
+  // propagated to the root pool.
+  const auto* rootPool = toImpl(root());
+  if (rootPool->capacity_ - rootPool->reservationBytes_ < cachedIncrement) {
+    return increment;
+  }
+  return cachedIncrement;
+}
+
+int64_t MemoryPoolImpl::cachedReservationLocked(int64_t newCap) const {
+  VELOX_DCHECK(isLeaf());
+  if (reservationBytes_ - quantizedSize(newCap) <=
+      2 * static_cast<int64_t>(reservationCacheBytes_)) {
+    return reservationBytes_;
+  }
+  return quantizedSize(newCap + reservationCacheBytes_);
+}
+
+void MemoryPoolImpl::flushReservationCache() {
+  if (!isLeaf()) {
+    visitChildren([](MemoryPool* child) {
+      toImpl(child)->flushReservationCache();
+      return true;
+    });
+    return;
+  }
+  if (reservationCacheBytes_ == 0) {
+    return;
+  }
+  int64_t freeable{0};
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    const int64_t newQuantized = quantizedSize(
+        std::max(minReservationBytes_, usedReservationBytes_));
+    freeable = reservationBytes_ - newQuantized;
+    if (freeable <= 0) {
+      return;
+    }
+    reservationBytes_ = newQuantized;
+    sanityCheckLocked();
+  }
+  toImpl(parent_)->decrementReservation(freeable);
+}
+
 std::string MemoryPoolImpl::treeMemoryUsage(bool skipEmptyPool) const {
   if (parent_ != nullptr) {
     return parent_->treeMemoryUsage(skipEmptyPool);
@@ -1095,6 +1213,9 @@ uint64_t MemoryPoolImpl::shrink(uint64_t targetBytes) {
   if (parent_ != nullptr) {
     return toImpl(parent_)->shrink(targetBytes);
   }
+  if (reservationCacheBytes_ != 0) {
+    flushReservationCache();
+  }
   std::lock_guard<std::mutex> l(mutex_);
   // We don't expect to shrink a memory pool without capacity limit.
   VELOX_CHECK_NE(capacity_, kMaxMemory);
@@ -1280,6 +1401,72 @@ void MemoryPoolImpl::recordGrowDbg(const void* addr, uint64_t newSize) {
   allocResult->second.size = newSize;
 }
 
+void MemoryPoolImpl::sampleAlloc(const void* addr, uint64_t size) {
+  if (allocationSampler_->recordAlloc(addr, size) &&
+      allocationProfileThresholdBytes_ != 0) {
+    maybeDumpAllocationProfile();
+  }
+}
+
+void MemoryPoolImpl::sampleFree(const void* addr) {
+  allocationSampler_->recordFree(addr);
+}
+
+void MemoryPoolImpl::maybeDumpAllocationProfile() {
+  if (static_cast<uint64_t>(usedBytes()) <=
+          allocationProfileThresholdBytes_ ||
+      allocationProfileDumped_.exchange(true)) {
+    return;
+  }
+  const auto path = fmt::format(
+      "{}/{}.{}.heap",
+      FLAGS_velox_memory_pool_allocation_profile_dir,
+      name_,
+      getCurrentTimeMs());
+  try {
+    dumpAllocationProfile(path);
+    VELOX_MEM_LOG(INFO) << "Dumped allocation profile of memory pool " << name_
+                        << " with usage " << succinctBytes(usedBytes())
+                        << " to " << path;
+  } catch (const std::exception& e) {
+    VELOX_MEM_LOG(WARNING)
+        << "Failed to dump allocation profile of memory pool " << name_
+        << " to " << path << ": " << e.what();
+  }
+}
+
+void MemoryPoolImpl::collectAllocationSites(
+    std::vector<AllocationSampler::Site>& sites) const {
+  if (allocationSampler_ != nullptr) {
+    auto poolSites = allocationSampler_->sites();
+    sites.insert(
+        sites.end(),
+        std::make_move_iterator(poolSites.begin()),
+        std::make_move_iterator(poolSites.end()));
+  }
+  visitChildren([&](MemoryPool* child) {
+    toImpl(child)->collectAllocationSites(sites);
+    return true;
+  });
+}
+
+std::string MemoryPoolImpl::allocationProfile() const {
+  if (allocationSampleBytes_ == 0) {
+    return "";
+  }
+  std::vector<AllocationSampler::Site> sites;
+  collectAllocationSites(sites);
+  return AllocationSampler::toPprof(sites);
+}
+
+void MemoryPoolImpl::dumpAllocationProfile(const std::string& path) const {
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  VELOX_CHECK(out.is_open(), "Failed to open {}", path);
+  out << allocationProfile();
+  out.close();
+  VELOX_CHECK(!out.fail(), "Failed to write {}", path);
+}
+
 void MemoryPoolImpl::leakCheckDbg() {
   VELOX_CHECK(debugEnabled_);
   if (debugAllocRecords_.empty()) {
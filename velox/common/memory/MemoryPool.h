@@ -25,11 +25,15 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/memory/Allocation.h"
+#include "velox/common/memory/AllocationSampler.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/common/memory/MemoryArbitrator.h"
 
 DECLARE_bool(velox_memory_leak_check_enabled);
 DECLARE_bool(velox_memory_pool_debug_enabled);
+DECLARE_uint64(velox_memory_pool_allocation_sample_bytes);
+DECLARE_uint64(velox_memory_pool_allocation_profile_threshold_bytes);
+DECLARE_string(velox_memory_pool_allocation_profile_dir);
 DECLARE_bool(velox_memory_pool_capacity_transfer_across_tasks);
 
 namespace facebook::velox::exec {
@@ -142,6 +146,28 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     /// Provides the customized get preferred size function. If not set, uses
     /// the memory pool's default function.
     std::function<size_t(size_t)> getPreferredSize{nullptr};
+
+    /// If not zero, a thread-safe leaf memory pool reserves this many bytes
+    /// ahead of its usage when it has to increment its reservation, and keeps
+    /// up to twice as much unused reservation before giving it back to its
+    /// parent. This serves most allocations and frees locally without
+    /// contending on the shared parent pools. The cached reservation is only
+    /// taken if the root pool has free capacity, and it is flushed by
+    /// release(), on shrink of the root pool for memory arbitration and on
+    /// destruction. This applies to all the leaf pools of a root pool.
+    uint64_t reservationCacheBytes{0};
+
+    /// If not zero, a leaf memory pool samples an allocation with its call
+    /// stack every this many allocated bytes. See AllocationSampler.
+    uint64_t allocationSampleBytes{
+        FLAGS_velox_memory_pool_allocation_sample_bytes};
+
+    /// If not zero, a leaf memory pool with allocation sampling enabled dumps
+    /// its allocation profile once when its memory usage exceeds this many
+    /// bytes. The profile is written to the directory specified by
+    /// 'velox_memory_pool_allocation_profile_dir' flag.
+    uint64_t allocationProfileThresholdBytes{
+        FLAGS_velox_memory_pool_allocation_profile_threshold_bytes};
   };
 
   /// Constructs a named memory pool with specified 'name', 'parent' and 'kind'.
@@ -191,6 +217,12 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
     return threadSafe_;
   }
 
+  /// Returns the size of the reservation cache of a leaf memory pool. See
+  /// Options::reservationCacheBytes.
+  uint64_t reservationCacheBytes() const {
+    return reservationCacheBytes_;
+  }
+
   /// Invoked to visit the memory pool's direct children, and calls 'visitor' on
   /// each visited child memory pool. Note that the traversal stops if 'visitor'
   /// returns false.
@@ -263,11 +295,14 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// range of addresses for huge pages. The range can be larger than
   /// is likely to be used because usage can be declared as needed but
   /// the number of huge pages  can be set according to an assumption of large
-  /// utilization.
+  /// utilization. If 'hugeTlb' is true, the allocation may be served from the
+  /// explicit huge page pool of the allocator. See
+  /// MemoryAllocator::allocateContiguous().
   virtual void allocateContiguous(
       MachinePageCount numPages,
       ContiguousAllocation& out,
-      MachinePageCount maxPages = 0) = 0;
+      MachinePageCount maxPages = 0,
+      bool hugeTlb = false) = 0;
 
   /// Frees contiguous 'allocation'. 'allocation' is empty on return.
   virtual void freeContiguous(ContiguousAllocation& allocation) = 0;
@@ -342,6 +377,13 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   /// usage.
   virtual void release() = 0;
 
+  /// Lowers the minimum reservation set with maybeReserve() by 'size' and
+  /// releases the unused reservation above the lowered minimum. This undoes a
+  /// maybeReserve() which increased reservedBytes() by 'size' while keeping
+  /// the minimum reservation set by the other maybeReserve() calls, unlike
+  /// release().
+  virtual void releaseReservation(uint64_t size) = 0;
+
   /// Memory arbitration related interfaces.
 
   /// Returns the free memory capacity in bytes that haven't been reserved for
@@ -533,6 +575,10 @@ class MemoryPool : public std::enable_shared_from_this<MemoryPool> {
   const bool threadSafe_;
   const bool debugEnabled_;
   const bool coreOnAllocationFailureEnabled_;
+  // Zero for a non-thread-safe leaf memory pool.
+  const uint64_t reservationCacheBytes_;
+  const uint64_t allocationSampleBytes_;
+  const uint64_t allocationProfileThresholdBytes_;
   std::function<size_t(size_t)> getPreferredSize_;
 
   /// Indicates if the memory pool has been aborted by the memory arbitrator or
@@ -604,7 +650,8 @@ class MemoryPoolImpl : public MemoryPool {
   void allocateContiguous(
       MachinePageCount numPages,
       ContiguousAllocation& out,
-      MachinePageCount maxPages = 0) override;
+      MachinePageCount maxPages = 0,
+      bool hugeTlb = false) override;
 
   void freeContiguous(ContiguousAllocation& allocation) override;
 
@@ -636,6 +683,8 @@ class MemoryPoolImpl : public MemoryPool {
 
   void release() override;
 
+  void releaseReservation(uint64_t size) override;
+
   uint64_t freeBytes() const override;
 
   void setReclaimer(std::unique_ptr<MemoryReclaimer> reclaimer) override;
@@ -726,6 +775,18 @@ class MemoryPoolImpl : public MemoryPool {
     debugPoolNameRegex() = regex;
   }
 
+  /// Returns the sampled allocations from this memory pool and its descendant
+  /// pools as a heap profile which can be read by pprof. Returns an empty
+  /// string if the allocation sampling is not enabled.
+  std::string allocationProfile() const;
+
+  /// Writes allocationProfile() to the file at 'path'.
+  void dumpAllocationProfile(const std::string& path) const;
+
+  AllocationSampler* testingAllocationSampler() const {
+    return allocationSampler_.get();
+  }
+
  private:
   void enterArbitration() override;
 
@@ -902,6 +963,21 @@ class MemoryPoolImpl : public MemoryPool {
   // Decrements the reservation in 'this' and parents.
   void decrementReservation(uint64_t size) noexcept;
 
+  // Returns the reservation 'increment' of a leaf memory pool plus its
+  // reservation cache if the root memory pool has free capacity for both. The
+  // reservation cache never triggers memory arbitration.
+  int64_t withReservationCacheLocked(int64_t increment) const;
+
+  // Returns the new reservation of a leaf memory pool with the reservation
+  // cache after its needed reservation drops to 'newCap'. The reservation is
+  // kept unless its unused part exceeds twice the reservation cache size.
+  int64_t cachedReservationLocked(int64_t newCap) const;
+
+  // Gives the cached but unused reservation of the leaf memory pools in this
+  // tree back to their parents. This keeps the minimum reservations set by
+  // maybeReserve().
+  void flushReservationCache();
+
   FOLLY_ALWAYS_INLINE void sanityCheckLocked() const {
     if (FOLLY_UNLIKELY(
             (reservationBytes_ < usedReservationBytes_) ||
@@ -985,6 +1061,21 @@ class MemoryPoolImpl : public MemoryPool {
   // Accounts for ContiguousAllocation size change in growContiguous().
   void recordGrowDbg(const void* addr, uint64_t newSize);
 
+  // Invoked to sample an allocation if the allocation sampling is enabled.
+  void sampleAlloc(const void* addr, uint64_t size);
+
+  // Invoked to sample a free if the allocation sampling is enabled.
+  void sampleFree(const void* addr);
+
+  // Appends the sampled allocation sites of this memory pool and its
+  // descendant pools to 'sites'.
+  void collectAllocationSites(
+      std::vector<AllocationSampler::Site>& sites) const;
+
+  // Dumps the allocation profile once if the memory usage exceeds
+  // 'allocationProfileThresholdBytes_'.
+  void maybeDumpAllocationProfile();
+
   // Invoked by memory pool destructor to detect the sources of leaked memory
   // allocations from the call sites which are still recorded in
   // 'debugAllocRecords_'. If there is no memory leaks, 'debugAllocRecords_'
@@ -1065,6 +1156,13 @@ class MemoryPoolImpl : public MemoryPool {
 
   // Map from address to 'AllocationRecord'.
   std::unordered_map<uint64_t, AllocationRecord> debugAllocRecords_;
+
+  // Samples the allocations of a leaf memory pool if not null.
+  const std::unique_ptr<AllocationSampler> allocationSampler_;
+
+  // Set when the allocation profile has been dumped on exceeding
+  // 'allocationProfileThresholdBytes_'.
+  std::atomic_bool allocationProfileDumped_{false};
 };
 
 /// An Allocator backed by a memory pool for STL containers.
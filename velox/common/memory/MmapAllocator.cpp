@@ -17,6 +17,13 @@
 #include "velox/common/memory/MmapAllocator.h"
 
 #include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
 
 #include "velox/common/base/Counters.h"
 #include "velox/common/base/Portability.h"
@@ -24,9 +31,82 @@
 #include "velox/common/memory/Memory.h"
 
 namespace facebook::velox::memory {
+namespace {
+// The max number of NUMA nodes supported by the single word node mask passed
+// to mbind().
+constexpr int32_t kMaxNumaNodes = 64;
+
+thread_local int32_t testingThreadNumaNode{-1};
+
+// Sets a preferred memory policy for [data, data + bytes) so that the pages
+// are backed by the memory of 'numaNode' if it has free memory. Only the pages
+// faulted in after this call are affected.
+void bindToNode(void* data, uint64_t bytes, int32_t numaNode) {
+#ifdef __linux__
+  // MPOL_PREFERRED from <numaif.h> which is not available without libnuma.
+  constexpr int kMpolPreferred = 1;
+  if (numaNode < 0 || numaNode >= MmapAllocator::numaNodes()) {
+    // Keeps the default first touch policy for the nodes which don't exist.
+    return;
+  }
+  const unsigned long nodeMask = 1UL << numaNode;
+  if (::syscall(
+          SYS_mbind,
+          data,
+          bytes,
+          kMpolPreferred,
+          &nodeMask,
+          kMaxNumaNodes + 1,
+          0) != 0) {
+    VELOX_MEM_LOG_EVERY_MS(WARNING, 1000)
+        << "mbind to NUMA node " << numaNode << " failed with "
+        << folly::errnoStr(errno);
+  }
+#endif
+}
+} // namespace
+
+// static
+int32_t MmapAllocator::numaNodes() {
+  static const int32_t numNodes = []() {
+    // The online nodes are listed as ranges like '0-1,3'.
+    std::ifstream in("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!std::getline(in, nodes) || nodes.empty()) {
+      return 1;
+    }
+    const auto pos = nodes.find_last_of(",-");
+    const auto maxNode = atoi(
+        nodes.c_str() + (pos == std::string::npos ? 0 : pos + 1));
+    return std::clamp<int32_t>(maxNode + 1, 1, kMaxNumaNodes);
+  }();
+  return numNodes;
+}
+
+// static
+int32_t MmapAllocator::currentNumaNode() {
+  if (FOLLY_UNLIKELY(testingThreadNumaNode >= 0)) {
+    return testingThreadNumaNode;
+  }
+#ifdef __linux__
+  unsigned cpu;
+  unsigned node;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+// static
+void MmapAllocator::testingSetThreadNumaNode(int32_t node) {
+  testingThreadNumaNode = node;
+}
+
 MmapAllocator::MmapAllocator(const Options& options)
     : MemoryAllocator(options.largestSizeClass),
       kind_(MemoryAllocator::Kind::kMmap),
+      numNumaNodes_(options.numNumaNodes),
       useMmapArena_(options.useMmapArena),
       maxMallocBytes_(options.maxMallocBytes),
       mallocReservedBytes_(
@@ -35,9 +115,15 @@ MmapAllocator::MmapAllocator(const Options& options)
               : options.capacity * options.smallAllocationReservePct / 100),
       capacity_(bits::roundUp(
           AllocationTraits::numPages(options.capacity - mallocReservedBytes_),
-          64 * sizeClassSizes_.back())) {
-  for (const auto& size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+          64 * sizeClassSizes_.back())),
+      numaNodeCounters_(numNumaNodes_ == 1 ? 0 : numNumaNodes_) {
+  VELOX_CHECK_GE(numNumaNodes_, 1);
+  VELOX_CHECK_LE(numNumaNodes_, kMaxNumaNodes);
+  for (int32_t node = 0; node < numNumaNodes_; ++node) {
+    for (const auto& size : sizeClassSizes_) {
+      sizeClasses_.push_back(std::make_unique<SizeClass>(
+          capacity_ / size, size, numNumaNodes_ == 1 ? -1 : node));
+    }
   }
 
   if (useMmapArena_) {
@@ -47,6 +133,19 @@ MmapAllocator::MmapAllocator(const Options& options)
     managedArenas_ = std::make_unique<ManagedMmapArenas>(
         std::max<uint64_t>(arenaSizeBytes, MmapArena::kMinCapacityBytes));
   }
+
+  if (options.hugeTlbPoolBytes > 0) {
+    const auto poolBytes = bits::roundUp(
+        options.hugeTlbPoolBytes, AllocationTraits::kHugePageSize);
+    try {
+      hugeTlbArena_ = std::make_unique<MmapArena>(poolBytes, /*hugeTlb=*/true);
+    } catch (const VeloxException& e) {
+      VELOX_MEM_LOG(WARNING)
+          << "Failed to reserve " << succinctBytes(poolBytes)
+          << " of explicit huge pages, falls back to transparent huge pages: "
+          << e.message();
+    }
+  }
 }
 
 MmapAllocator::~MmapAllocator() {
@@ -91,6 +190,8 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
 
   ++numAllocations_;
   numAllocatedPages_ += sizeMix.totalPages;
+  const int32_t numaNode = allocationNumaNode();
+  bool remote{false};
   MachinePageCount newMapsNeeded = 0;
   for (int i = 0; i < sizeMix.numSizes; ++i) {
     bool success;
@@ -98,8 +199,13 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
         AllocationTraits::pageBytes(sizeClassSizes_[sizeMix.sizeIndices[i]]),
         sizeMix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[sizeMix.sizeIndices[i]]->allocate(
-              sizeMix.sizeCounts[i], newMapsNeeded, out);
+          success = allocateFromSizeClass(
+              numaNode,
+              sizeMix.sizeIndices[i],
+              sizeMix.sizeCounts[i],
+              newMapsNeeded,
+              out,
+              remote);
         });
     if (success && ((i > 0) || (sizeMix.numSizes == 1)) &&
         testingHasInjectedFailure(InjectedFailure::kAllocate)) {
@@ -122,6 +228,13 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
       return false;
     }
   }
+  if (!numaNodeCounters_.empty()) {
+    auto& counters = numaNodeCounters_[numaNode];
+    ++counters.numAllocations;
+    if (remote) {
+      ++counters.numRemoteAllocations;
+    }
+  }
   if (newMapsNeeded == 0) {
     return true;
   }
@@ -141,6 +254,101 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
   return false;
 }
 
+bool MmapAllocator::allocateFromSizeClass(
+    int32_t numaNode,
+    int32_t sizeIndex,
+    ClassPageCount numPages,
+    MachinePageCount& numUnmapped,
+    Allocation& out,
+    bool& remote) {
+  if (numNumaNodes_ == 1) {
+    return sizeClass(0, sizeIndex).allocate(numPages, numUnmapped, out);
+  }
+  const auto unitSize = sizeClassSizes_[sizeIndex];
+  for (int32_t i = 0; i < numNumaNodes_; ++i) {
+    const int32_t node = (numaNode + i) % numNumaNodes_;
+    const auto numPagesBefore = out.numPages();
+    const bool success =
+        sizeClass(node, sizeIndex).allocate(numPages, numUnmapped, out);
+    // A failed allocation might still have allocated some of the pages.
+    const auto numAllocated = (out.numPages() - numPagesBefore) / unitSize;
+    if (numAllocated > 0) {
+      numaNodeCounters_[node].numAllocatedPages += numAllocated * unitSize;
+      remote |= node != numaNode;
+    }
+    if (success) {
+      return true;
+    }
+    numPages -= numAllocated;
+  }
+  return false;
+}
+
+void MmapAllocator::bindToNumaNode(void* data, uint64_t bytes, int32_t numaNode)
+    const {
+  if (numNumaNodes_ == 1) {
+    return;
+  }
+  bindToNode(data, bytes, numaNode);
+}
+
+void* MmapAllocator::allocateHugeTlb(uint64_t bytes) {
+  if (hugeTlbArena_ == nullptr || bytes < AllocationTraits::kHugePageSize) {
+    return nullptr;
+  }
+  void* data;
+  {
+    std::lock_guard<std::mutex> l(hugeTlbMutex_);
+    data = hugeTlbArena_->allocate(bytes);
+  }
+  if (data == nullptr) {
+    ++numHugeTlbFallbacks_;
+    return nullptr;
+  }
+  ++numHugeTlbAllocations_;
+  ::memset(data, 0, bytes);
+  return data;
+}
+
+bool MmapAllocator::freeHugeTlb(const ContiguousAllocation& allocation) {
+  if (hugeTlbArena_ == nullptr) {
+    return false;
+  }
+  auto* data = allocation.data<uint8_t>();
+  auto* poolStart = reinterpret_cast<uint8_t*>(hugeTlbArena_->address());
+  if (data < poolStart || data >= poolStart + hugeTlbArena_->byteSize()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(hugeTlbMutex_);
+  hugeTlbArena_->free(data, allocation.maxSize());
+  return true;
+}
+
+MmapAllocator::HugeTlbPoolStats MmapAllocator::hugeTlbPoolStats() const {
+  HugeTlbPoolStats stats;
+  if (hugeTlbArena_ != nullptr) {
+    std::lock_guard<std::mutex> l(hugeTlbMutex_);
+    stats.capacityBytes = hugeTlbArena_->byteSize();
+    stats.freeBytes = hugeTlbArena_->freeBytes();
+  }
+  stats.numAllocations = numHugeTlbAllocations_;
+  stats.numFallbacks = numHugeTlbFallbacks_;
+  return stats;
+}
+
+std::vector<MmapAllocator::NumaNodeStats> MmapAllocator::numaNodeStats()
+    const {
+  std::vector<NumaNodeStats> stats;
+  stats.reserve(numaNodeCounters_.size());
+  for (const auto& counters : numaNodeCounters_) {
+    stats.push_back(
+        {counters.numAllocations,
+         counters.numRemoteAllocations,
+         counters.numAllocatedPages});
+  }
+  return stats;
+}
+
 bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   if (testingHasInjectedFailure(InjectedFailure::kMadvise)) {
     return false;
@@ -183,6 +391,7 @@ MachinePageCount MmapAllocator::freeNonContiguousInternal(
     return numFreed;
   }
 
+  const auto numSizes = sizeClassSizes_.size();
   for (auto i = 0; i < sizeClasses_.size(); ++i) {
     auto& sizeClass = sizeClasses_[i];
     int32_t pages = 0;
@@ -195,10 +404,13 @@ MachinePageCount MmapAllocator::freeNonContiguousInternal(
       // Increment the free time only if the allocation contained
       // pages in the class. Note that size class indices in the
       // allocator are not necessarily the same as in the stats.
-      const auto sizeIndex =
-          Stats::sizeIndex(AllocationTraits::pageBytes(sizeClassSizes_[i]));
+      const auto sizeIndex = Stats::sizeIndex(
+          AllocationTraits::pageBytes(sizeClassSizes_[i % numSizes]));
       stats_.sizes[sizeIndex].freeClocks += clocks;
     }
+    if ((pages > 0) && !numaNodeCounters_.empty()) {
+      numaNodeCounters_[i / numSizes].numAllocatedPages -= pages;
+    }
     numFreed += pages;
   }
   allocation.clear();
@@ -209,10 +421,12 @@ bool MmapAllocator::allocateContiguousWithoutRetry(
     MachinePageCount numPages,
     Allocation* collateral,
     ContiguousAllocation& allocation,
-    MachinePageCount maxPages) {
+    MachinePageCount maxPages,
+    bool hugeTlb) {
   bool result;
   stats_.recordAllocate(AllocationTraits::pageBytes(numPages), 1, [&]() {
-    result = allocateContiguousImpl(numPages, collateral, allocation, maxPages);
+    result = allocateContiguousImpl(
+        numPages, collateral, allocation, maxPages, hugeTlb);
   });
   return result;
 }
@@ -221,7 +435,8 @@ bool MmapAllocator::allocateContiguousImpl(
     MachinePageCount numPages,
     Allocation* collateral,
     ContiguousAllocation& allocation,
-    MachinePageCount maxPages) {
+    MachinePageCount maxPages,
+    bool hugeTlb) {
   if (maxPages == 0) {
     maxPages = numPages;
   } else {
@@ -248,14 +463,16 @@ bool MmapAllocator::allocateContiguousImpl(
   }
   const auto numLargeCollateralPages = allocation.numPages();
   if (numLargeCollateralPages > 0) {
-    useHugePages(allocation, false);
-    if (useMmapArena_) {
-      std::lock_guard<std::mutex> l(arenaMutex_);
-      managedArenas_->free(allocation.data(), allocation.maxSize());
-    } else {
-      if (::munmap(allocation.data(), allocation.maxSize()) < 0) {
-        VELOX_MEM_LOG(ERROR) << "munmap got " << folly::errnoStr(errno)
-                             << " for " << allocation.toString();
+    if (!freeHugeTlb(allocation)) {
+      useHugePages(allocation, false);
+      if (useMmapArena_) {
+        std::lock_guard<std::mutex> l(arenaMutex_);
+        managedArenas_->free(allocation.data(), allocation.maxSize());
+      } else {
+        if (::munmap(allocation.data(), allocation.maxSize()) < 0) {
+          VELOX_MEM_LOG(ERROR) << "munmap got " << folly::errnoStr(errno)
+                               << " for " << allocation.toString();
+        }
       }
     }
     allocation.clear();
@@ -322,21 +539,29 @@ bool MmapAllocator::allocateContiguousImpl(
     numMapped_ += numToMap;
   }
 
-  void* data;
-  if (testingHasInjectedFailure(InjectedFailure::kMmap)) {
-    data = nullptr;
-  } else {
-    if (useMmapArena_) {
-      std::lock_guard<std::mutex> l(arenaMutex_);
-      data = managedArenas_->allocate(AllocationTraits::pageBytes(maxPages));
-    } else {
-      data = ::mmap(
-          nullptr,
-          AllocationTraits::pageBytes(maxPages),
-          PROT_READ | PROT_WRITE,
-          MAP_PRIVATE | MAP_ANONYMOUS,
-          -1,
-          0);
+  void* data{nullptr};
+  bool fromHugeTlb{false};
+  const int32_t numaNode = allocationNumaNode();
+  if (!testingHasInjectedFailure(InjectedFailure::kMmap)) {
+    // The pool block is sized by 'numPages' and can't grow, so an allocation
+    // which reserves room to grow doesn't use the pool.
+    if (hugeTlb && maxPages == numPages) {
+      data = allocateHugeTlb(AllocationTraits::pageBytes(numPages));
+      fromHugeTlb = data != nullptr;
+    }
+    if (!fromHugeTlb) {
+      if (useMmapArena_) {
+        std::lock_guard<std::mutex> l(arenaMutex_);
+        data = managedArenas_->allocate(AllocationTraits::pageBytes(maxPages));
+      } else {
+        data = ::mmap(
+            nullptr,
+            AllocationTraits::pageBytes(maxPages),
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+      }
     }
   }
   if (data == nullptr || data == MAP_FAILED) {
@@ -357,7 +582,12 @@ bool MmapAllocator::allocateContiguousImpl(
       data,
       AllocationTraits::pageBytes(numPages),
       AllocationTraits::pageBytes(maxPages));
-  useHugePages(allocation, true);
+  if (!fromHugeTlb) {
+    // Sets the memory policy before the huge page advice so that the huge
+    // pages are also allocated from the node.
+    bindToNumaNode(data, AllocationTraits::pageBytes(maxPages), numaNode);
+    useHugePages(allocation, true);
+  }
   return true;
 }
 
@@ -370,14 +600,16 @@ void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
   if (allocation.empty()) {
     return;
   }
-  useHugePages(allocation, false);
-  if (useMmapArena_) {
-    std::lock_guard<std::mutex> l(arenaMutex_);
-    managedArenas_->free(allocation.data(), allocation.maxSize());
-  } else {
-    if (::munmap(allocation.data(), allocation.maxSize()) < 0) {
-      VELOX_MEM_LOG(ERROR) << "munmap returned " << folly::errnoStr(errno)
-                           << " for " << allocation.toString();
+  if (!freeHugeTlb(allocation)) {
+    useHugePages(allocation, false);
+    if (useMmapArena_) {
+      std::lock_guard<std::mutex> l(arenaMutex_);
+      managedArenas_->free(allocation.data(), allocation.maxSize());
+    } else {
+      if (::munmap(allocation.data(), allocation.maxSize()) < 0) {
+        VELOX_MEM_LOG(ERROR) << "munmap returned " << folly::errnoStr(errno)
+                             << " for " << allocation.toString();
+      }
     }
   }
   numMapped_ -= allocation.numPages();
@@ -509,7 +741,10 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    int32_t numaNode)
     : capacity_(capacity),
       unitSize_(unitSize),
       byteSize_(AllocationTraits::pageBytes(capacity_ * unitSize_)),
@@ -538,6 +773,11 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         unitSize_);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (numaNode >= 0) {
+    // The policy sticks to the range when its pages are advised away, so the
+    // pages faulted in again are also backed by the node.
+    bindToNode(address_, byteSize_, numaNode);
+  }
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -966,8 +1206,24 @@ std::string MmapAllocator::toString() const {
                     capacity() - AllocationTraits::pageBytes(numAllocated())))
       << " allocated pages " << numAllocated_ << " mapped pages " << numMapped_
       << " external mapped pages " << numExternalMapped_ << std::endl;
-  for (auto& sizeClass : sizeClasses_) {
-    out << sizeClass->toString() << std::endl;
+  if (hugeTlbArena_ != nullptr) {
+    const auto hugeTlbStats = hugeTlbPoolStats();
+    out << "Huge TLB pool capacity "
+        << succinctBytes(hugeTlbStats.capacityBytes) << " free "
+        << succinctBytes(hugeTlbStats.freeBytes) << " allocations "
+        << hugeTlbStats.numAllocations << " fallbacks "
+        << hugeTlbStats.numFallbacks << std::endl;
+  }
+  for (auto i = 0; i < sizeClasses_.size(); ++i) {
+    if (numNumaNodes_ > 1 && i % sizeClassSizes_.size() == 0) {
+      const auto node = i / sizeClassSizes_.size();
+      const auto& counters = numaNodeCounters_[node];
+      out << "NUMA node " << node << ": " << counters.numAllocations
+          << " allocations " << counters.numRemoteAllocations
+          << " remote allocations " << counters.numAllocatedPages
+          << " allocated pages" << std::endl;
+    }
+    out << sizeClasses_[i]->toString() << std::endl;
   }
   out << "]";
   return out.str();
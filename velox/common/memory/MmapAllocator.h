@@ -80,6 +80,59 @@ class MmapAllocator : public MemoryAllocator {
     /// and 'smallAllocationReservePct' will be automatically set to 0
     /// disregarding any passed in value.
     int32_t maxMallocBytes = 3072;
+
+    /// If greater than one, keeps a separate set of size classes per NUMA node
+    /// and serves an allocation from the size classes of the node which the
+    /// calling thread runs on. The address ranges of the size classes of a
+    /// node are bound to the node with a preferred memory policy, so their
+    /// pages are backed by the memory of the node as long as it has free
+    /// memory and by the other nodes otherwise. The allocations larger than
+    /// the largest size class are bound to the node of the calling thread in
+    /// the same way. Capacity is shared by all the nodes: the free pages
+    /// backed by the memory of one node are advised away to make room for
+    /// the allocations on another.
+    int32_t numNumaNodes{1};
+
+    /// If not zero, reserves a pool of this many bytes of explicit huge pages
+    /// (MAP_HUGETLB) on construction, rounded up to the huge page size. The
+    /// contiguous allocations of at least one huge page which opt in, such as
+    /// the large hash table bucket arrays, are served from the pool so that
+    /// they are backed by huge pages right away instead of waiting for the
+    /// transparent huge pages to be collapsed in the background. See
+    /// MemoryAllocator::allocateContiguous(). The allocation sizes are rounded
+    /// up to a power of two in the pool. If the pool is exhausted, or could
+    /// not be reserved as the system doesn't have enough free huge pages
+    /// (vm.nr_hugepages), the allocations fall back to the transparent huge
+    /// pages. The allocations from the pool count against 'capacity' as the
+    /// other contiguous allocations do.
+    uint64_t hugeTlbPoolBytes{0};
+  };
+
+  /// The stats of the explicit huge page pool.
+  struct HugeTlbPoolStats {
+    /// The capacity of the pool. Zero if there is no pool.
+    uint64_t capacityBytes{0};
+    /// The free bytes in the pool.
+    uint64_t freeBytes{0};
+    /// The number of contiguous allocations served from the pool.
+    uint64_t numAllocations{0};
+    /// The number of contiguous allocations which fell back to the
+    /// transparent huge pages as the pool was exhausted.
+    uint64_t numFallbacks{0};
+  };
+
+  /// The NUMA stats of the size classes of one node.
+  struct NumaNodeStats {
+    /// The number of size class allocations from the threads running on the
+    /// node.
+    uint64_t numAllocations{0};
+    /// The number of the allocations in 'numAllocations' which were partly
+    /// served by the size classes of other nodes as the size classes of the
+    /// node could not serve them.
+    uint64_t numRemoteAllocations{0};
+    /// The number of machine pages currently allocated from the size classes
+    /// of the node.
+    int64_t numAllocatedPages{0};
   };
 
   explicit MmapAllocator(const Options& options);
@@ -159,16 +212,46 @@ class MmapAllocator : public MemoryAllocator {
     return stats;
   }
 
+  int32_t numNumaNodes() const {
+    return numNumaNodes_;
+  }
+
+  /// Returns the NUMA stats of each node. Empty if there is only one node.
+  std::vector<NumaNodeStats> numaNodeStats() const;
+
+  HugeTlbPoolStats hugeTlbPoolStats() const;
+
   std::string toString() const override;
 
+  /// Returns the number of NUMA nodes of the system, or 1 if it is unknown.
+  static int32_t numaNodes();
+
+  /// Returns the NUMA node of the calling thread, or 0 if it is unknown.
+  static int32_t currentNumaNode();
+
+  /// Makes currentNumaNode() return 'node' for the calling thread if it is
+  /// not negative. Used by test only.
+  static void testingSetThreadNumaNode(int32_t node);
+
  private:
   static constexpr uint64_t kAllSet = 0xffffffffffffffff;
 
+  struct NumaNodeCounters {
+    std::atomic<uint64_t> numAllocations{0};
+    std::atomic<uint64_t> numRemoteAllocations{0};
+    std::atomic<int64_t> numAllocatedPages{0};
+  };
+
   // Represents a range of virtual addresses used for allocating entries of
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    // If 'numaNode' is not negative, binds the address range to that NUMA
+    // node with a preferred memory policy.
+    SizeClass(
+        size_t capacity,
+        MachinePageCount unitSize,
+        int32_t numaNode = -1);
 
     ~SizeClass();
 
@@ -326,13 +409,15 @@ class MmapAllocator : public MemoryAllocator {
       MachinePageCount numPages,
       Allocation* collateral,
       ContiguousAllocation& allocation,
-      MachinePageCount maxPages = 0) override;
+      MachinePageCount maxPages = 0,
+      bool hugeTlb = false) override;
 
   bool allocateContiguousImpl(
       MachinePageCount numPages,
       Allocation* collateral,
       ContiguousAllocation& allocation,
-      MachinePageCount maxPages);
+      MachinePageCount maxPages,
+      bool hugeTlb);
 
   void freeContiguousImpl(ContiguousAllocation& allocation);
 
@@ -372,8 +457,44 @@ class MmapAllocator : public MemoryAllocator {
 
   bool useMalloc(uint64_t bytes);
 
+  // Returns the size class of 'sizeIndex' of 'numaNode'.
+  SizeClass& sizeClass(int32_t numaNode, int32_t sizeIndex) const {
+    return *sizeClasses_[numaNode * sizeClassSizes_.size() + sizeIndex];
+  }
+
+  // Returns the NUMA node to serve an allocation of the calling thread from.
+  int32_t allocationNumaNode() const {
+    return numNumaNodes_ == 1 ? 0 : currentNumaNode() % numNumaNodes_;
+  }
+
+  // Allocates 'numPages' class pages of 'sizeIndex' from the size classes of
+  // 'numaNode', and falls back to the other nodes if the node can't serve
+  // them. Sets 'remote' if any page is allocated from another node.
+  bool allocateFromSizeClass(
+      int32_t numaNode,
+      int32_t sizeIndex,
+      ClassPageCount numPages,
+      MachinePageCount& numUnmapped,
+      Allocation& out,
+      bool& remote);
+
+  // Allocates 'bytes' from the explicit huge page pool and zeroes them as the
+  // freed pool blocks keep their contents. Returns nullptr if there is no
+  // pool, 'bytes' is less than a huge page or the pool is exhausted.
+  void* allocateHugeTlb(uint64_t bytes);
+
+  // Frees 'allocation' to the explicit huge page pool and returns true if it
+  // was allocated from the pool, otherwise returns false.
+  bool freeHugeTlb(const ContiguousAllocation& allocation);
+
+  // Binds the address range of a contiguous allocation to 'numaNode' if
+  // there are multiple NUMA nodes.
+  void bindToNumaNode(void* data, uint64_t bytes, int32_t numaNode) const;
+
   const Kind kind_;
 
+  const int32_t numNumaNodes_;
+
   // If set true, allocations larger than the largest size class size will be
   // delegated to ManagedMmapArena. Otherwise, a system mmap call will be
   // issued for each such allocation.
@@ -408,8 +529,12 @@ class MmapAllocator : public MemoryAllocator {
   // to std::malloc().
   const MachinePageCount capacity_ = 0;
 
+  // The size classes of each NUMA node, ordered by node and then by size.
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
+  // Indexed by NUMA node. Empty if there is only one node.
+  std::vector<NumaNodeCounters> numaNodeCounters_;
+
   // Statistics.
   std::atomic<uint64_t> numAllocations_ = 0;
   std::atomic<uint64_t> numAllocatedPages_ = 0;
@@ -421,6 +546,13 @@ class MmapAllocator : public MemoryAllocator {
   std::mutex arenaMutex_;
   std::unique_ptr<ManagedMmapArenas> managedArenas_;
 
+  // The explicit huge page pool for large contiguous allocations. nullptr if
+  // not configured or failed to reserve.
+  mutable std::mutex hugeTlbMutex_;
+  std::unique_ptr<MmapArena> hugeTlbArena_;
+  std::atomic<uint64_t> numHugeTlbAllocations_{0};
+  std::atomic<uint64_t> numHugeTlbFallbacks_{0};
+
   std::shared_ptr<Cache> cache_;
 };
 
@@ -25,19 +25,24 @@ uint64_t MmapArena::roundBytes(uint64_t bytes) {
   return bits::nextPowerOfTwo(bytes);
 }
 
-MmapArena::MmapArena(size_t capacityBytes) : byteSize_(capacityBytes) {
+MmapArena::MmapArena(size_t capacityBytes, bool hugeTlb)
+    : byteSize_(capacityBytes), hugeTlb_(hugeTlb) {
   VELOX_CHECK_EQ(
       byteSize_ % kMinGrainSizeBytes,
       0,
       "Arena must have a multiple of {} bytes capacity.",
       kMinGrainSizeBytes);
-  void* ptr = mmap(
-      nullptr,
-      capacityBytes,
-      PROT_READ | PROT_WRITE,
-      MAP_PRIVATE | MAP_ANONYMOUS,
-      -1,
-      0);
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (hugeTlb) {
+#ifdef MAP_HUGETLB
+    VELOX_CHECK_EQ(byteSize_ % AllocationTraits::kHugePageSize, 0);
+    flags |= MAP_HUGETLB;
+#else
+    VELOX_FAIL("MAP_HUGETLB is not supported");
+#endif
+  }
+  void* ptr =
+      mmap(nullptr, capacityBytes, PROT_READ | PROT_WRITE, flags, -1, 0);
   if (ptr == MAP_FAILED || ptr == nullptr) {
     VELOX_FAIL(
         "Could not allocate working memory"
@@ -89,7 +94,9 @@ void MmapArena::free(void* address, uint64_t bytes) {
   }
   bytes = roundBytes(bytes);
 
-  ::madvise(address, bytes, MADV_DONTNEED);
+  if (!hugeTlb_) {
+    ::madvise(address, bytes, MADV_DONTNEED);
+  }
   freeBytes_ += bytes;
 
   const auto curAddr = reinterpret_cast<uintptr_t>(address);
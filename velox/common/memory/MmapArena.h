@@ -36,7 +36,12 @@ class MmapArena {
   /// MmapArena capacity should be multiple of kMinGrainSizeBytes.
   static constexpr uint64_t kMinGrainSizeBytes = 1024 * 1024; // 1M
 
-  explicit MmapArena(size_t capacityBytes);
+  /// If 'hugeTlb' is true, the arena is backed by explicit huge pages
+  /// (MAP_HUGETLB) which are reserved from the huge page pool of the system on
+  /// construction. Throws if there are not enough free huge pages. The freed
+  /// blocks of such an arena keep their huge pages and their contents for
+  /// reuse, so allocate() does not return zeroed memory.
+  explicit MmapArena(size_t capacityBytes, bool hugeTlb = false);
   ~MmapArena();
 
   void* allocate(uint64_t bytes);
@@ -105,6 +110,11 @@ class MmapArena {
   // Total capacity size of this arena.
   const uint64_t byteSize_;
 
+  // True if backed by explicit huge pages. The freed blocks are not advised
+  // away as this would return the huge pages to the system pool, from which a
+  // later access might fail to get them back.
+  const bool hugeTlb_;
+
   // Starting address of this arena.
   uint8_t* address_;
 
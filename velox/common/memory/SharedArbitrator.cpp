@@ -737,6 +737,61 @@ void SharedArbitrator::growCapacity(MemoryPool* pool, uint64_t requestBytes) {
   }
 }
 
+uint64_t SharedArbitrator::growCapacityToHint(
+    MemoryPool* pool,
+    uint64_t capacityHint) {
+  checkRunning();
+
+  VELOX_CHECK(pool->isRoot());
+  std::optional<ScopedArbitrationParticipant> participant;
+  {
+    std::shared_lock guard{participantLock_};
+    auto it = participants_.find(pool->name());
+    // The pool might be managed by a different memory manager.
+    if (it == participants_.end() || it->second->pool() != pool) {
+      return 0;
+    }
+    participant = it->second->lock();
+  }
+  if (!participant.has_value()) {
+    return 0;
+  }
+
+  const uint64_t targetCapacity =
+      std::min(capacityHint, participant.value()->maxCapacity());
+  const uint64_t capacity = participant.value()->capacity();
+  if (targetCapacity <= capacity) {
+    return 0;
+  }
+
+  std::vector<ContinuePromise> arbitrationWaiters;
+  uint64_t allocatedBytes{0};
+  {
+    std::lock_guard<std::mutex> l(stateMutex_);
+    // Only allocates from the free non-reserved capacity which returns zero if
+    // there are pending global arbitration requests.
+    allocatedBytes = allocateCapacityLocked(
+        participant.value()->id(), 0, targetCapacity - capacity, 0);
+    // Grows without counting a capacity growth so that the hint doesn't skew
+    // the arbitration round trips of the pool.
+    if (allocatedBytes > 0 &&
+        !participant.value()->growToHint(allocatedBytes)) {
+      VELOX_MEM_LOG(WARNING)
+          << "Failed to grow memory pool " << participant.value()->name()
+          << " to capacity hint " << succinctBytes(capacityHint);
+      freeCapacityLocked(allocatedBytes, arbitrationWaiters);
+      allocatedBytes = 0;
+    }
+  }
+  for (auto& waiter : arbitrationWaiters) {
+    waiter.setValue();
+  }
+  if (allocatedBytes > 0) {
+    RECORD_METRIC_VALUE(kMetricArbitratorCapacityHintBytes, allocatedBytes);
+  }
+  return allocatedBytes;
+}
+
 void SharedArbitrator::growCapacity(ArbitrationOperation& op) {
   TestValue::adjust(
       "facebook::velox::memory::SharedArbitrator::growCapacity", this);
@@ -244,6 +244,8 @@ class SharedArbitrator : public memory::MemoryArbitrator {
 
   void growCapacity(MemoryPool* pool, uint64_t requestBytes) final;
 
+  uint64_t growCapacityToHint(MemoryPool* pool, uint64_t capacityHint) final;
+
   /// NOTE: only support shrinking away all the unused free capacity for now.
   uint64_t shrinkCapacity(MemoryPool* pool, uint64_t requestBytes) final;
 
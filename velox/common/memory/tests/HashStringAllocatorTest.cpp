@@ -739,6 +739,145 @@ TEST_F(HashStringAllocatorTest, clear) {
   EXPECT_EQ(allocator_->retainedSize(), 0);
 }
 
+TEST_F(HashStringAllocatorTest, compact) {
+  constexpr int32_t kNumStrings = 20'000;
+  std::vector<std::string> strings;
+  std::vector<StringView> views(kNumStrings);
+  for (auto i = 0; i < kNumStrings; ++i) {
+    // Every 100th string is multipart.
+    strings.push_back(randomString(i % 100 == 0 ? 5'000 : 50 + i % 100));
+    allocator_->copyMultipart(
+        StringView(strings[i]), reinterpret_cast<char*>(&views[i]), 0);
+  }
+  // Keeps every 4th string.
+  for (auto i = 0; i < kNumStrings; ++i) {
+    if (i % 4 != 0) {
+      allocator_->free(HSA::headerOf(views[i].data()));
+      strings[i].clear();
+    }
+  }
+  // Keeps a position in the middle of a multipart block.
+  auto position = HSA::seek(HSA::headerOf(views[0].data()), 4'000);
+  ASSERT_TRUE(position.isSet());
+
+  const auto retainedSize = allocator_->retainedSize();
+  ASSERT_GT(allocator_->fragmentation(), 0.5);
+  int32_t numRelocated = 0;
+  const auto freedBytes =
+      allocator_->compact([&](const HSA::RelocateFn& relocate) {
+        for (auto i = 0; i < kNumStrings; i += 4) {
+          const auto offset =
+              i == 0 ? HSA::offset(HSA::headerOf(views[i].data()), position)
+                     : 0;
+          auto* header = relocate(HSA::headerOf(views[i].data()));
+          views[i] = StringView(header->begin(), views[i].size());
+          if (i == 0) {
+            ASSERT_EQ(offset, 4'000);
+            position = HSA::seek(header, offset);
+          }
+          ++numRelocated;
+        }
+      });
+  ASSERT_EQ(numRelocated, kNumStrings / 4);
+  ASSERT_GT(freedBytes, 0);
+  ASSERT_EQ(allocator_->retainedSize(), retainedSize - freedBytes);
+  allocator_->checkConsistency();
+
+  for (auto i = 0; i < kNumStrings; i += 4) {
+    // The relocated strings are contiguous.
+    ASSERT_EQ(views[i], StringView(strings[i]));
+  }
+  ASSERT_EQ(*position.position, strings[0][4'000]);
+
+  // The compacted allocator is usable as before.
+  for (auto i = 0; i < kNumStrings; i += 4) {
+    allocator_->free(HSA::headerOf(views[i].data()));
+  }
+  ASSERT_TRUE(allocator_->isEmpty());
+}
+
+TEST_F(HashStringAllocatorTest, compactWithoutMemory) {
+  constexpr int64_t kCapacity = 16 << 20;
+  auto rootPool = memory::memoryManager()->addRootPool("", kCapacity);
+  auto leafPool = rootPool->addLeafChild("compactWithoutMemory");
+  HashStringAllocator allocator(leafPool.get());
+
+  // Fills most of the capacity and frees 3/4 of the strings, so that there is
+  // no room for a copy of the live strings.
+  constexpr int32_t kNumStrings = 14'000;
+  std::vector<std::string> strings;
+  std::vector<StringView> views(kNumStrings);
+  for (auto i = 0; i < kNumStrings; ++i) {
+    strings.push_back(randomString(1'000));
+    allocator.copyMultipart(
+        StringView(strings[i]), reinterpret_cast<char*>(&views[i]), 0);
+  }
+  for (auto i = 0; i < kNumStrings; ++i) {
+    if (i % 4 != 0) {
+      allocator.free(HSA::headerOf(views[i].data()));
+    }
+  }
+  ASSERT_GT(allocator.fragmentation(), 0.5);
+
+  const auto retainedSize = allocator.retainedSize();
+  bool relocated{false};
+  ASSERT_EQ(
+      allocator.compact(
+          [&](const HSA::RelocateFn& /*unused*/) { relocated = true; }),
+      0);
+  ASSERT_FALSE(relocated);
+  ASSERT_EQ(allocator.retainedSize(), retainedSize);
+  allocator.checkConsistency();
+  for (auto i = 0; i < kNumStrings; i += 4) {
+    ASSERT_EQ(views[i], StringView(strings[i]));
+    allocator.free(HSA::headerOf(views[i].data()));
+  }
+  ASSERT_TRUE(allocator.isEmpty());
+}
+
+TEST_F(HashStringAllocatorTest, compactKeepsReservation) {
+  auto leafPool =
+      memory::memoryManager()->addLeafPool("compactKeepsReservation");
+  HashStringAllocator allocator(leafPool.get());
+
+  // The live strings don't fit in the reservation set aside below, so that
+  // compact() reserves more for the copy.
+  constexpr int32_t kNumStrings = 40'000;
+  std::vector<std::string> strings;
+  std::vector<StringView> views(kNumStrings);
+  for (auto i = 0; i < kNumStrings; ++i) {
+    strings.push_back(randomString(1'000));
+    allocator.copyMultipart(
+        StringView(strings[i]), reinterpret_cast<char*>(&views[i]), 0);
+  }
+  for (auto i = 0; i < kNumStrings; i += 2) {
+    allocator.free(HSA::headerOf(views[i].data()));
+  }
+  // The owner reserves for its next input.
+  ASSERT_TRUE(leafPool->maybeReserve(1 << 20));
+  const auto reservedBytes = leafPool->reservedBytes();
+  ASSERT_LT(leafPool->availableReservation(), kNumStrings / 2 * 1'000);
+
+  ASSERT_GT(
+      allocator.compact([&](const HSA::RelocateFn& relocate) {
+        for (auto i = 1; i < kNumStrings; i += 2) {
+          auto* header = relocate(HSA::headerOf(views[i].data()));
+          views[i] = StringView(header->begin(), views[i].size());
+        }
+      }),
+      0);
+  // Only the reservation added for the copy is released.
+  ASSERT_EQ(leafPool->reservedBytes(), reservedBytes);
+  leafPool->release();
+  ASSERT_LT(leafPool->reservedBytes(), reservedBytes);
+
+  for (auto i = 1; i < kNumStrings; i += 2) {
+    ASSERT_EQ(views[i], StringView(strings[i]));
+    allocator.free(HSA::headerOf(views[i].data()));
+  }
+  ASSERT_TRUE(allocator.isEmpty());
+}
+
 TEST_F(HashStringAllocatorTest, freezeAndExecute) {
   std::string str = "abc";
   StringView view(str.data(), str.size());
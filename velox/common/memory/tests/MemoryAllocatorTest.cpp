@@ -1703,6 +1703,33 @@ TEST_F(MmapArenaTest, basic) {
   EXPECT_TRUE(arena->checkConsistency());
 }
 
+TEST_F(MmapArenaTest, hugeTlbFreeAndReallocate) {
+  constexpr uint64_t kHugePageSize = AllocationTraits::kHugePageSize;
+  std::unique_ptr<MmapArena> arena;
+  try {
+    arena = std::make_unique<MmapArena>(4 * kHugePageSize, true);
+  } catch (const VeloxException&) {
+    GTEST_SKIP() << "Not enough free huge pages to reserve the arena";
+  }
+
+  void* first = allocateAndPad(arena.get(), 2 * kHugePageSize);
+  void* second = allocateAndPad(arena.get(), 2 * kHugePageSize);
+  ASSERT_EQ(arena->freeBytes(), 0);
+  arena->free(first, 2 * kHugePageSize);
+  // The freed block keeps its huge pages and is reused by the next allocation.
+  void* reallocated = arena->allocate(2 * kHugePageSize);
+  ASSERT_EQ(reallocated, first);
+  const auto* data = static_cast<const uint8_t*>(reallocated);
+  ASSERT_EQ(data[0], 0xff);
+  ASSERT_EQ(data[2 * kHugePageSize - 1], 0xff);
+  memset(reallocated, 0x11, 2 * kHugePageSize);
+
+  unpadAndFree(arena.get(), reallocated, 2 * kHugePageSize);
+  unpadAndFree(arena.get(), second, 2 * kHugePageSize);
+  ASSERT_TRUE(arena->empty());
+  EXPECT_TRUE(arena->checkConsistency());
+}
+
 TEST_F(MmapArenaTest, managedMmapArenas) {
   {
     // Test natural growing of ManagedMmapArena
@@ -1991,4 +2018,185 @@ TEST_F(MmapConfigTest, sizeClasses) {
   }
 }
 
+TEST(MmapNumaTest, numaLocalSizeClasses) {
+  ASSERT_GE(MmapAllocator::numaNodes(), 1);
+  MmapAllocator::Options options;
+  options.capacity = 256 << 20;
+  // Uses more nodes than the system might have which fall back to the first
+  // touch policy.
+  options.numNumaNodes = 2;
+  MmapAllocator allocator(options);
+  ASSERT_EQ(allocator.numNumaNodes(), 2);
+  auto guard = folly::makeGuard(
+      []() { MmapAllocator::testingSetThreadNumaNode(-1); });
+
+  constexpr MachinePageCount kNumPages = 100;
+  std::vector<Allocation> allocations(2);
+  for (int32_t node = 0; node < 2; ++node) {
+    MmapAllocator::testingSetThreadNumaNode(node);
+    ASSERT_EQ(MmapAllocator::currentNumaNode(), node);
+    ASSERT_TRUE(allocator.allocateNonContiguous(kNumPages, allocations[node]));
+  }
+  auto stats = allocator.numaNodeStats();
+  ASSERT_EQ(stats.size(), 2);
+  for (int32_t node = 0; node < 2; ++node) {
+    ASSERT_EQ(stats[node].numAllocations, 1);
+    ASSERT_EQ(stats[node].numRemoteAllocations, 0);
+    ASSERT_EQ(stats[node].numAllocatedPages, allocations[node].numPages());
+  }
+  ASSERT_TRUE(allocator.checkConsistency());
+
+  // Frees the allocation of node 0 from a thread on node 1.
+  allocator.freeNonContiguous(allocations[0]);
+  stats = allocator.numaNodeStats();
+  ASSERT_EQ(stats[0].numAllocatedPages, 0);
+  ASSERT_EQ(stats[1].numAllocatedPages, allocations[1].numPages());
+
+  // The allocations larger than the largest size class are bound to the node
+  // of the calling thread.
+  ContiguousAllocation contiguous;
+  ASSERT_TRUE(allocator.allocateContiguous(
+      allocator.largestSizeClass() * 2, nullptr, contiguous));
+  memset(contiguous.data(), 1, contiguous.size());
+  allocator.freeContiguous(contiguous);
+
+  allocator.freeNonContiguous(allocations[1]);
+  stats = allocator.numaNodeStats();
+  ASSERT_EQ(stats[1].numAllocatedPages, 0);
+  ASSERT_TRUE(allocator.checkConsistency());
+  ASSERT_EQ(allocator.numAllocated(), 0);
+}
+
+TEST(MmapHugeTlbTest, hugeTlbPool) {
+  constexpr uint64_t kHugePageSize = AllocationTraits::kHugePageSize;
+  constexpr MachinePageCount kHugePagePages =
+      AllocationTraits::numPagesInHugePage();
+  MmapAllocator::Options options;
+  options.capacity = 256 << 20;
+  options.hugeTlbPoolBytes = 4 * kHugePageSize;
+  MmapAllocator allocator(options);
+  auto allocateHugeTlb = [&](MachinePageCount numPages,
+                             ContiguousAllocation& out) {
+    return allocator.allocateContiguous(
+        numPages, nullptr, out, nullptr, /*maxPages=*/0, /*hugeTlb=*/true);
+  };
+
+  // The contiguous allocations always succeed, with or without the pool.
+  ContiguousAllocation large;
+  ASSERT_TRUE(allocateHugeTlb(2 * kHugePagePages, large));
+  memset(large.data(), 1, large.size());
+  const auto stats = allocator.hugeTlbPoolStats();
+  if (stats.capacityBytes == 0) {
+    allocator.freeContiguous(large);
+    ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 0);
+    GTEST_SKIP() << "Not enough free huge pages to reserve the pool";
+  }
+  ASSERT_EQ(stats.capacityBytes, 4 * kHugePageSize);
+  ASSERT_EQ(stats.freeBytes, 2 * kHugePageSize);
+  ASSERT_EQ(stats.numAllocations, 1);
+
+  // Allocations less than a huge page don't use the pool.
+  ContiguousAllocation small;
+  ASSERT_TRUE(allocateHugeTlb(kHugePagePages / 2, small));
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 1);
+
+  // Allocations which don't opt in or which reserve room to grow don't use
+  // the pool.
+  ContiguousAllocation notOptedIn;
+  ASSERT_TRUE(
+      allocator.allocateContiguous(kHugePagePages, nullptr, notOptedIn));
+  ContiguousAllocation growable;
+  ASSERT_TRUE(allocator.allocateContiguous(
+      kHugePagePages,
+      nullptr,
+      growable,
+      nullptr,
+      2 * kHugePagePages,
+      /*hugeTlb=*/true));
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 1);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().freeBytes, 2 * kHugePageSize);
+  allocator.freeContiguous(notOptedIn);
+  allocator.freeContiguous(growable);
+
+  // Falls back to the transparent huge pages when the pool is exhausted.
+  ContiguousAllocation fallback;
+  ASSERT_TRUE(allocateHugeTlb(4 * kHugePagePages, fallback));
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 1);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numFallbacks, 1);
+  ASSERT_EQ(
+      allocator.numAllocated(),
+      2 * kHugePagePages + kHugePagePages / 2 + 4 * kHugePagePages);
+
+  allocator.freeContiguous(large);
+  allocator.freeContiguous(small);
+  allocator.freeContiguous(fallback);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().freeBytes, 4 * kHugePageSize);
+  ASSERT_EQ(allocator.numAllocated(), 0);
+
+  // Reallocates an allocation from the pool in place of another one. The
+  // freed pool memory is usable again.
+  ASSERT_TRUE(allocateHugeTlb(kHugePagePages, large));
+  memset(large.data(), 2, large.size());
+  ASSERT_TRUE(allocateHugeTlb(4 * kHugePagePages, large));
+  memset(large.data(), 3, large.size());
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 3);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().freeBytes, 0);
+  allocator.freeContiguous(large);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().freeBytes, 4 * kHugePageSize);
+  ASSERT_EQ(allocator.numAllocated(), 0);
+}
+
+TEST(MmapHugeTlbTest, reallocatedHugeTlbIsZeroed) {
+  constexpr uint64_t kHugePageSize = AllocationTraits::kHugePageSize;
+  constexpr MachinePageCount kHugePagePages =
+      AllocationTraits::numPagesInHugePage();
+  MmapAllocator::Options options;
+  options.capacity = 256 << 20;
+  options.hugeTlbPoolBytes = 2 * kHugePageSize;
+  MmapAllocator allocator(options);
+  if (allocator.hugeTlbPoolStats().capacityBytes == 0) {
+    GTEST_SKIP() << "Not enough free huge pages to reserve the pool";
+  }
+
+  auto allocateHugeTlb = [&](ContiguousAllocation& out) {
+    ASSERT_TRUE(allocator.allocateContiguous(
+        2 * kHugePagePages,
+        nullptr,
+        out,
+        nullptr,
+        /*maxPages=*/0,
+        /*hugeTlb=*/true));
+  };
+  auto expectZeroed = [](const ContiguousAllocation& allocation) {
+    const auto* data = allocation.data<uint8_t>();
+    for (uint64_t i = 0; i < allocation.size(); i += 4096) {
+      ASSERT_EQ(data[i], 0) << i;
+    }
+    ASSERT_EQ(data[allocation.size() - 1], 0);
+  };
+
+  ContiguousAllocation allocation;
+  allocateHugeTlb(allocation);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 1);
+  expectZeroed(allocation);
+  void* const firstData = allocation.data();
+  memset(allocation.data(), 0xff, allocation.size());
+  allocator.freeContiguous(allocation);
+
+  // The freed block keeps its huge pages and contents in the pool. The next
+  // allocation reuses it and must still see zeroes.
+  allocateHugeTlb(allocation);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 2);
+  ASSERT_EQ(allocation.data(), firstData);
+  expectZeroed(allocation);
+
+  // The same holds when the block is reused in place of the collateral.
+  memset(allocation.data(), 0xff, allocation.size());
+  allocateHugeTlb(allocation);
+  ASSERT_EQ(allocator.hugeTlbPoolStats().numAllocations, 3);
+  expectZeroed(allocation);
+  allocator.freeContiguous(allocation);
+  ASSERT_EQ(allocator.numAllocated(), 0);
+}
+
 } // namespace facebook::velox::memory
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <filesystem>
+
 #include <fmt/format.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -29,10 +31,12 @@
 #include "velox/common/memory/SharedArbitrator.h"
 #include "velox/common/memory/tests/SharedArbitratorTestUtil.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 DECLARE_bool(velox_memory_leak_check_enabled);
 DECLARE_bool(velox_memory_pool_debug_enabled);
 DECLARE_int32(velox_memory_num_shared_leaf_pools);
+DECLARE_string(velox_memory_pool_allocation_profile_dir);
 
 using namespace ::testing;
 using namespace facebook::velox::cache;
@@ -3519,6 +3523,34 @@ TEST_P(MemoryPoolTest, maybeReserve) {
   ASSERT_EQ(child->stats().numShrinks, 0);
 }
 
+TEST_P(MemoryPoolTest, releaseReservation) {
+  constexpr int64_t kMaxSize = 1 << 30; // 1GB
+  setupMemory(
+      {.allocatorCapacity = kMaxSize, .arbitratorCapacity = kMaxSize});
+  auto manager = getMemoryManager();
+  auto root = manager->addRootPool("releaseReservation", kMaxSize);
+  auto child = root->addLeafChild("releaseReservation", isLeafThreadSafe_);
+
+  ASSERT_TRUE(child->maybeReserve(20 * MB));
+  const auto firstReservedBytes = child->reservedBytes();
+  ASSERT_TRUE(child->maybeReserve(100 * MB));
+  const auto secondReservedBytes = child->reservedBytes();
+  ASSERT_GT(secondReservedBytes, firstReservedBytes);
+
+  // Undoes the second reservation and keeps the first one.
+  child->releaseReservation(secondReservedBytes - firstReservedBytes);
+  ASSERT_EQ(child->reservedBytes(), firstReservedBytes);
+  ASSERT_EQ(root->reservedBytes(), firstReservedBytes);
+  void* buffer = child->allocate(10 * MB);
+  child->free(buffer, 10 * MB);
+  ASSERT_EQ(child->reservedBytes(), firstReservedBytes);
+
+  child->releaseReservation(firstReservedBytes);
+  ASSERT_EQ(child->reservedBytes(), 0);
+  ASSERT_EQ(root->reservedBytes(), 0);
+  ASSERT_EQ(child->stats().numReleases, 2);
+}
+
 TEST_P(MemoryPoolTest, maybeReserveFailWithAbort) {
   constexpr int64_t kMaxSize = 1 * GB; // 1GB
   setupMemory(
@@ -3628,6 +3660,203 @@ TEST_P(MemoryPoolTest, quantizedSize) {
   }
 }
 
+TEST_P(MemoryPoolTest, reservationCache) {
+  constexpr int64_t kMaxSize = 1 << 30; // 1GB
+  constexpr uint64_t kCacheSize = 4 * MB;
+  setupMemory(
+      {.reservationCacheBytes = kCacheSize,
+       .allocatorCapacity = kMaxSize,
+       .arbitratorCapacity = kMaxSize,
+       .extraArbitratorConfigs = {
+           {std::string(SharedArbitrator::ExtraConfig::kReservedCapacity),
+            folly::to<std::string>(kMaxSize / 8) + "B"}}});
+  auto manager = getMemoryManager();
+  auto root = manager->addRootPool("reservationCache", kMaxSize);
+  auto child = root->addLeafChild("reservationCache", isLeafThreadSafe_);
+  // The reservation cache only applies to the thread-safe leaf pools.
+  ASSERT_EQ(child->reservationCacheBytes(), isLeafThreadSafe_ ? kCacheSize : 0);
+
+  // Reserves the cache ahead of the usage.
+  void* buffer = child->allocate(KB);
+  ASSERT_EQ(child->usedBytes(), KB);
+  ASSERT_EQ(child->reservedBytes(), isLeafThreadSafe_ ? 5 * MB : MB);
+  ASSERT_EQ(root->reservedBytes(), child->reservedBytes());
+  // Keeps the cached reservation on free.
+  child->free(buffer, KB);
+  ASSERT_EQ(child->usedBytes(), 0);
+  ASSERT_EQ(child->reservedBytes(), isLeafThreadSafe_ ? 5 * MB : 0);
+  ASSERT_EQ(root->reservedBytes(), child->reservedBytes());
+  if (!isLeafThreadSafe_) {
+    return;
+  }
+
+  // Served from the cache without updating the parent.
+  buffer = child->allocate(3 * MB);
+  ASSERT_EQ(child->reservedBytes(), 5 * MB);
+  child->free(buffer, 3 * MB);
+  ASSERT_EQ(child->reservedBytes(), 5 * MB);
+
+  // Gives back the reservation beyond the cache once the unused reservation
+  // exceeds twice the cache size.
+  buffer = child->allocate(6 * MB);
+  ASSERT_EQ(child->reservedBytes(), 10 * MB);
+  ASSERT_EQ(root->reservedBytes(), 10 * MB);
+  child->free(buffer, 6 * MB);
+  ASSERT_EQ(child->reservedBytes(), kCacheSize);
+  ASSERT_EQ(root->reservedBytes(), kCacheSize);
+
+  // release() flushes the cache.
+  buffer = child->allocate(KB);
+  ASSERT_EQ(child->releasableReservation(), kCacheSize);
+  child->release();
+  ASSERT_EQ(child->reservedBytes(), MB);
+  ASSERT_EQ(root->reservedBytes(), MB);
+  child->free(buffer, KB);
+  ASSERT_EQ(child->reservedBytes(), MB);
+
+  // The memory arbitration flushes the cache when it shrinks the root pool.
+  manager->arbitrator()->shrinkCapacity(root.get(), 0);
+  ASSERT_EQ(child->reservedBytes(), 0);
+  ASSERT_EQ(root->reservedBytes(), 0);
+  ASSERT_EQ(root->capacity(), 0);
+
+  // The destruction flushes the cache.
+  child.reset();
+  auto otherChild = root->addLeafChild("otherChild", isLeafThreadSafe_);
+  buffer = otherChild->allocate(KB);
+  otherChild->free(buffer, KB);
+  ASSERT_GT(root->reservedBytes(), 0);
+  otherChild.reset();
+  ASSERT_EQ(root->reservedBytes(), 0);
+}
+
+TEST_P(MemoryPoolTest, concurrentUpdatesWithReservationCache) {
+  setupMemory(
+      {.reservationCacheBytes = 8 * MB,
+       .allocatorCapacity = kDefaultCapacity,
+       .arbitratorCapacity = kDefaultCapacity,
+       .extraArbitratorConfigs = {
+           {std::string(SharedArbitrator::ExtraConfig::kReservedCapacity),
+            "1GB"}}});
+  auto manager = getMemoryManager();
+  auto root = manager->addRootPool("concurrentUpdatesWithReservationCache");
+  const int32_t kNumThreads = 16;
+  std::vector<std::shared_ptr<MemoryPool>> childPools;
+  for (int32_t i = 0; i < kNumThreads; ++i) {
+    childPools.push_back(root->addLeafChild(fmt::format("{}", i)));
+  }
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<std::pair<void*, int64_t>> buffers;
+      folly::Random::DefaultGenerator rng(i);
+      for (int32_t iter = 0; iter < 1'000; ++iter) {
+        if (!buffers.empty() && folly::Random::oneIn(2, rng)) {
+          const auto index = folly::Random::rand32(buffers.size(), rng);
+          childPools[i]->free(buffers[index].first, buffers[index].second);
+          buffers[index] = buffers.back();
+          buffers.pop_back();
+          continue;
+        }
+        const int64_t size = 1 + folly::Random::rand32(2 * MB, rng);
+        buffers.emplace_back(childPools[i]->allocate(size), size);
+      }
+      for (const auto& [data, size] : buffers) {
+        childPools[i]->free(data, size);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t childReservedBytes{0};
+  for (const auto& child : childPools) {
+    ASSERT_EQ(child->usedBytes(), 0);
+    ASSERT_LE(child->reservedBytes(), 3 * 8 * MB);
+    childReservedBytes += child->reservedBytes();
+  }
+  ASSERT_EQ(root->reservedBytes(), childReservedBytes);
+  childPools.clear();
+  ASSERT_EQ(root->reservedBytes(), 0);
+}
+
+TEST_P(MemoryPoolTest, allocationSampling) {
+  gflags::FlagSaver flagSaver;
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  FLAGS_velox_memory_pool_allocation_profile_dir = tempDirectory->getPath();
+  constexpr uint64_t kSampleBytes = 64 * KB;
+  setupMemory(
+      {.allocationSampleBytes = kSampleBytes,
+       .allocationProfileThresholdBytes = 2 * MB,
+       .allocatorCapacity = kDefaultCapacity,
+       .arbitratorCapacity = kDefaultCapacity});
+  auto manager = getMemoryManager();
+  auto root = manager->addRootPool("allocationSampling");
+  auto child = root->addLeafChild("allocationSampling", isLeafThreadSafe_);
+  auto* rootImpl = static_cast<MemoryPoolImpl*>(root.get());
+  auto* childImpl = static_cast<MemoryPoolImpl*>(child.get());
+  // Only the leaf memory pools sample the allocations.
+  ASSERT_EQ(rootImpl->testingAllocationSampler(), nullptr);
+  ASSERT_NE(childImpl->testingAllocationSampler(), nullptr);
+
+  // Samples one allocation per 'kSampleBytes' from the same call site.
+  std::vector<void*> buffers;
+  for (int i = 0; i < 256; ++i) {
+    buffers.push_back(child->allocate(KB));
+  }
+  auto sites = childImpl->testingAllocationSampler()->sites();
+  ASSERT_EQ(sites.size(), 1);
+  ASSERT_FALSE(sites[0].stack.empty());
+  ASSERT_EQ(sites[0].allocCount, 256);
+  ASSERT_EQ(sites[0].allocBytes, 256 * KB);
+  ASSERT_EQ(sites[0].inUseBytes, 256 * KB);
+
+  // The freed samples are not in use.
+  for (int i = 0; i < 128; ++i) {
+    child->free(buffers[i], KB);
+  }
+  sites = childImpl->testingAllocationSampler()->sites();
+  ASSERT_EQ(sites[0].allocBytes, 256 * KB);
+  ASSERT_EQ(sites[0].inUseCount, 128);
+  ASSERT_EQ(sites[0].inUseBytes, 128 * KB);
+
+  // A large allocation is always sampled. It exceeds the profile threshold.
+  ASSERT_TRUE(std::filesystem::is_empty(tempDirectory->getPath()));
+  void* largeBuffer = child->allocate(4 * MB);
+  sites = childImpl->testingAllocationSampler()->sites();
+  ASSERT_EQ(sites.size(), 2);
+  ASSERT_EQ(sites[1].allocCount, 1);
+  ASSERT_EQ(sites[1].inUseBytes, 4 * MB);
+  int numProfiles{0};
+  for (const auto& entry :
+       std::filesystem::directory_iterator(tempDirectory->getPath())) {
+    ASSERT_EQ(
+        entry.path().filename().string().find("allocationSampling."), 0);
+    ++numProfiles;
+  }
+  ASSERT_EQ(numProfiles, 1);
+
+  // The root memory pool reports the samples from its descendants.
+  const auto profile = rootImpl->allocationProfile();
+  ASSERT_EQ(
+      profile.find(fmt::format(
+          "heap profile: {}: {} [{}: {}] @ heap\n",
+          128 + 1,
+          128 * KB + 4 * MB,
+          256 + 1,
+          256 * KB + 4 * MB)),
+      0);
+  ASSERT_NE(profile.find("\nMAPPED_LIBRARIES:\n"), std::string::npos);
+
+  child->free(largeBuffer, 4 * MB);
+  for (int i = 128; i < 256; ++i) {
+    child->free(buffers[i], KB);
+  }
+  sites = childImpl->testingAllocationSampler()->sites();
+  ASSERT_EQ(sites[0].inUseBytes, 0);
+  ASSERT_EQ(sites[1].inUseBytes, 0);
+}
+
 namespace {
 class MockMemoryReclaimer : public MemoryReclaimer {
  public:
@@ -2275,6 +2275,58 @@ TEST_F(MockSharedArbitrationTest, maxCapacityReserve) {
   }
 }
 
+TEST_F(MockSharedArbitrationTest, growCapacityToHint) {
+  const uint64_t memCapacity = 256 * MB;
+  const uint64_t reservedCapacity = 64 * MB;
+  const uint64_t poolInitCapacity = 8 * MB;
+  setupMemory(memCapacity, reservedCapacity, poolInitCapacity);
+
+  auto task1 = addTask();
+  ASSERT_EQ(task1->pool()->capacity(), poolInitCapacity);
+  ASSERT_EQ(arbitrator_->growCapacityToHint(task1->pool(), 64 * MB), 56 * MB);
+  ASSERT_EQ(task1->pool()->capacity(), 64 * MB);
+  // The hint is not counted as a capacity growth.
+  ASSERT_EQ(task1->pool()->stats().numCapacityGrowths, 0);
+  test::SharedArbitratorTestHelper arbitratorHelper(arbitrator_);
+  ASSERT_EQ(
+      arbitratorHelper.getParticipant(task1->pool()->name())->stats().numGrows,
+      0);
+  // No-op if the pool already has the hinted capacity.
+  ASSERT_EQ(arbitrator_->growCapacityToHint(task1->pool(), 32 * MB), 0);
+  ASSERT_EQ(task1->pool()->capacity(), 64 * MB);
+
+  // The hint is capped by the pool's max capacity.
+  auto task2 = addTask(32 * MB);
+  ASSERT_EQ(arbitrator_->growCapacityToHint(task2->pool(), 128 * MB), 24 * MB);
+  ASSERT_EQ(task2->pool()->capacity(), 32 * MB);
+
+  // The hint is only granted from the free non-reserved capacity.
+  auto task3 = addTask();
+  const uint64_t freeNonReservedCapacity =
+      memCapacity - reservedCapacity - 64 * MB - 32 * MB - poolInitCapacity;
+  ASSERT_EQ(
+      arbitrator_->growCapacityToHint(task3->pool(), memCapacity),
+      freeNonReservedCapacity);
+  ASSERT_EQ(
+      task3->pool()->capacity(), poolInitCapacity + freeNonReservedCapacity);
+  ASSERT_EQ(arbitrator_->stats().freeCapacityBytes, reservedCapacity);
+  ASSERT_EQ(arbitrator_->stats().freeReservedCapacityBytes, reservedCapacity);
+
+  // The pool doesn't need memory arbitration to grow within the hinted
+  // capacity.
+  auto* memOp = addMemoryOp(task1);
+  for (int i = 0; i < 32; ++i) {
+    memOp->allocate(MB);
+  }
+  ASSERT_EQ(task1->pool()->stats().numCapacityGrowths, 0);
+  ASSERT_EQ(arbitrator_->stats().numRequests, 0);
+
+  // The pool from a different memory manager is ignored.
+  MemoryManager otherManager{};
+  auto otherPool = otherManager.addRootPool("growCapacityToHint");
+  ASSERT_EQ(arbitrator_->growCapacityToHint(otherPool.get(), 8 * MB), 0);
+}
+
 TEST_F(MockSharedArbitrationTest, ensureMemoryPoolMaxCapacity) {
   const int memCapacity = 256 * MB;
   const int poolInitCapacity = 8 * MB;
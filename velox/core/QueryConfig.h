@@ -113,6 +113,13 @@ class QueryConfig {
   static constexpr const char* kMaxMergeExchangeBufferSize =
       "merge_exchange.max_buffer_size";
 
+  /// Maximum number of batches the merge operators read ahead from each source
+  /// while merging the current batch. For merge exchange, the read-ahead
+  /// batches of a source are also bounded by the per source share of
+  /// 'merge_exchange.max_buffer_size'. 0 disables the read-ahead.
+  static constexpr const char* kMergeSourceReadAheadBatches =
+      "merge_source_read_ahead_batches";
+
   /// The minimum number of bytes to accumulate in the ExchangeQueue
   /// before unblocking a consumer. This is used to avoid creating tiny
   /// batches which may have a negative impact on performance when the
@@ -122,6 +129,13 @@ class QueryConfig {
   static constexpr const char* kMinExchangeOutputBatchBytes =
       "min_exchange_output_batch_bytes";
 
+  /// If true, the Exchange operator deserializes uncompressed Presto pages
+  /// without copying the string data and the aligned fixed-width values out of
+  /// the received pages. The output vectors then reference the page memory
+  /// and each page is returned as a separate batch.
+  static constexpr const char* kExchangeZeroCopyDeserializationEnabled =
+      "exchange_zero_copy_deserialization_enabled";
+
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
@@ -134,6 +148,13 @@ class QueryConfig {
   static constexpr const char* kAbandonPartialAggregationMinPct =
       "abandon_partial_aggregation_min_pct";
 
+  /// Compacts the memory for variable width keys and accumulators of a hash
+  /// aggregation if this percentage or more of it is free. The compaction is
+  /// also tried before spilling when memory is reclaimed from the aggregation.
+  /// 0 disables the compaction.
+  static constexpr const char* kAggregationCompactionMinFragmentationPct =
+      "aggregation_compaction_min_fragmentation_pct";
+
   static constexpr const char* kAbandonPartialTopNRowNumberMinRows =
       "abandon_partial_topn_row_number_min_rows";
 
@@ -201,6 +222,14 @@ class QueryConfig {
   /// Join spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kJoinSpillEnabled = "join_spill_enabled";
 
+  /// If true, a hash build operator under memory pressure only spills the
+  /// partitions holding the fewest rows per byte until the reclaim target is
+  /// met, and keeps building the hash table from the other partitions. The
+  /// probe input rows of the spilled partitions are spilled too. Only applies
+  /// if "join_spill_enabled" flag is set.
+  static constexpr const char* kHashJoinHybridSpillEnabled =
+      "hash_join_hybrid_spill_enabled";
+
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
@@ -220,6 +249,17 @@ class QueryConfig {
   static constexpr const char* kTopNRowNumberSpillEnabled =
       "topn_row_number_spill_enabled";
 
+  /// If true, the memory arbitrator can reclaim memory from the partitioned
+  /// output buffer by spilling the pages which haven't been fetched by the
+  /// consumers to disk. Only applies if "spill_enabled" flag is set.
+  static constexpr const char* kOutputBufferSpillEnabled =
+      "output_buffer_spill_enabled";
+
+  /// If true, the memory arbitrator can reclaim memory from the exchange
+  /// client by spilling the received pages which haven't been consumed to
+  /// disk. Only applies if "spill_enabled" flag is set.
+  static constexpr const char* kExchangeSpillEnabled = "exchange_spill_enabled";
+
   /// The max row numbers to fill and spill for each spill run. This is used to
   /// cap the memory used for spilling. If it is zero, then there is no limit
   /// and spilling might run out of memory.
@@ -272,6 +312,29 @@ class QueryConfig {
   static constexpr const char* kSpillFileCreateConfig =
       "spill_file_create_config";
 
+  /// The max number of serialized spill buffers per spill writer which can be
+  /// queued for the asynchronous disk writes on the query's spill executor.
+  /// This lets the spilling thread serialize and compress the next batch while
+  /// the previous one is written. If it is zero or there is no spill executor,
+  /// then the spilled data is written synchronously.
+  static constexpr const char* kSpillMaxPendingWrites =
+      "spill_max_pending_writes";
+
+  /// If true, the spilled data with only scalar columns is written in the
+  /// columnar spill format which encodes each column with the lightweight
+  /// encodings such as frame of reference, delta and dictionary before the
+  /// general purpose compression. Otherwise, the Presto serialization format is
+  /// used.
+  static constexpr const char* kSpillColumnarEncodingEnabled =
+      "spill_columnar_encoding_enabled";
+
+  /// How to choose the directory for each spill file if the task spills to
+  /// multiple directories: 'round_robin' or 'least_loaded'. The latter skips
+  /// a disk with more pending spill writes or much less free space than the
+  /// others.
+  static constexpr const char* kSpillDirectorySelectionPolicy =
+      "spill_directory_selection_policy";
+
   /// Default offset spill start partition bit. It is used with
   /// 'kJoinSpillPartitionBits' or 'kAggregationSpillPartitionBits' together to
   /// calculate the spilling partition number for join spill or aggregation
@@ -520,6 +583,25 @@ class QueryConfig {
   static constexpr const char* kRequestDataSizesMaxWaitSec =
       "request_data_sizes_max_wait_sec";
 
+  /// A VARCHAR or VARBINARY vector buffered by a local exchange or a nested
+  /// loop join build is copied into a tight string buffer if the strings it
+  /// references take less than this ratio of the string buffers it holds,
+  /// e.g. after a selective filter. 0 disables the compaction.
+  static constexpr const char* kStringCompactionMinLiveRatio =
+      "string_compaction_min_live_ratio";
+
+  /// The min bytes of string buffers held by a vector for it to be considered
+  /// for string compaction.
+  static constexpr const char* kStringCompactionMinHeldBytes =
+      "string_compaction_min_held_bytes";
+
+  /// If true, the flat BIGINT, INTEGER and SMALLINT columns with a narrow
+  /// range of values are stored bias encoded in the local exchange queues,
+  /// e.g. in one byte per value instead of eight. They are decoded back to
+  /// flat when the consumers read them from the queues.
+  static constexpr const char* kLocalExchangeBiasEncodingEnabled =
+      "local_exchange_bias_encoding_enabled";
+
   bool selectiveNimbleReaderEnabled() const {
     return get<bool>(kSelectiveNimbleReaderEnabled, false);
   }
@@ -569,6 +651,10 @@ class QueryConfig {
     return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
   }
 
+  int32_t aggregationCompactionMinFragmentationPct() const {
+    return get<int32_t>(kAggregationCompactionMinFragmentationPct, 0);
+  }
+
   int32_t abandonPartialTopNRowNumberMinRows() const {
     return get<int32_t>(kAbandonPartialTopNRowNumberMinRows, 100'000);
   }
@@ -618,11 +704,19 @@ class QueryConfig {
     return get<uint64_t>(kMaxMergeExchangeBufferSize, kDefault);
   }
 
+  uint32_t mergeSourceReadAheadBatches() const {
+    return get<uint32_t>(kMergeSourceReadAheadBatches, 0);
+  }
+
   uint64_t minExchangeOutputBatchBytes() const {
     static constexpr uint64_t kDefault = 2UL << 20;
     return get<uint64_t>(kMinExchangeOutputBatchBytes, kDefault);
   }
 
+  bool exchangeZeroCopyDeserializationEnabled() const {
+    return get<bool>(kExchangeZeroCopyDeserializationEnabled, false);
+  }
+
   uint64_t preferredOutputBatchBytes() const {
     static constexpr uint64_t kDefault = 10UL << 20;
     return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
@@ -703,6 +797,10 @@ class QueryConfig {
     return get<bool>(kJoinSpillEnabled, true);
   }
 
+  bool hashJoinHybridSpillEnabled() const {
+    return get<bool>(kHashJoinHybridSpillEnabled, false);
+  }
+
   bool orderBySpillEnabled() const {
     return get<bool>(kOrderBySpillEnabled, true);
   }
@@ -723,6 +821,14 @@ class QueryConfig {
     return get<bool>(kTopNRowNumberSpillEnabled, true);
   }
 
+  bool outputBufferSpillEnabled() const {
+    return get<bool>(kOutputBufferSpillEnabled, false);
+  }
+
+  bool exchangeSpillEnabled() const {
+    return get<bool>(kExchangeSpillEnabled, false);
+  }
+
   int32_t maxSpillLevel() const {
     return get<int32_t>(kMaxSpillLevel, 1);
   }
@@ -770,6 +876,18 @@ class QueryConfig {
     return get<std::string>(kSpillFileCreateConfig, "");
   }
 
+  uint32_t spillMaxPendingWrites() const {
+    return get<uint32_t>(kSpillMaxPendingWrites, 0);
+  }
+
+  bool spillColumnarEncodingEnabled() const {
+    return get<bool>(kSpillColumnarEncodingEnabled, false);
+  }
+
+  std::string spillDirectorySelectionPolicy() const {
+    return get<std::string>(kSpillDirectorySelectionPolicy, "least_loaded");
+  }
+
   int32_t minSpillableReservationPct() const {
     constexpr int32_t kDefaultPct = 5;
     return get<int32_t>(kMinSpillableReservationPct, kDefaultPct);
@@ -953,6 +1071,18 @@ class QueryConfig {
     return get<int32_t>(kRequestDataSizesMaxWaitSec, 10);
   }
 
+  double stringCompactionMinLiveRatio() const {
+    return get<double>(kStringCompactionMinLiveRatio, 0.1);
+  }
+
+  uint64_t stringCompactionMinHeldBytes() const {
+    return get<uint64_t>(kStringCompactionMinHeldBytes, 1UL << 20);
+  }
+
+  bool localExchangeBiasEncodingEnabled() const {
+    return get<bool>(kLocalExchangeBiasEncodingEnabled, false);
+  }
+
   bool throwExceptionOnDuplicateMapKeys() const {
     return get<bool>(kThrowExceptionOnDuplicateMapKeys, false);
   }
@@ -62,6 +62,14 @@ QueryCtx::QueryCtx(
   initPool(queryId);
 }
 
+QueryCtx::~QueryCtx() {
+  VELOX_CHECK(!underArbitration_);
+  if (memoryHistory_ != nullptr) {
+    memoryHistory_->record(
+        memoryFingerprint_, pool_->peakBytes(), numArbitrationRoundTrips());
+  }
+}
+
 /*static*/ std::string QueryCtx::generatePoolName(const std::string& queryId) {
   // We attach a monotonically increasing sequence number to ensure the pool
   // name is unique.
@@ -69,6 +77,26 @@ QueryCtx::QueryCtx(
   return fmt::format("query.{}.{}", queryId.c_str(), seqNum++);
 }
 
+uint64_t QueryCtx::setMemoryCapacityHint(uint64_t capacityHint) {
+  VELOX_CHECK_NOT_NULL(pool_);
+  return memory::memoryManager()->arbitrator()->growCapacityToHint(
+      pool_.get(), capacityHint);
+}
+
+uint64_t QueryCtx::setMemoryHistory(
+    const std::string& fingerprint,
+    std::shared_ptr<QueryMemoryHistory> history) {
+  VELOX_CHECK_NOT_NULL(history);
+  VELOX_CHECK_NULL(memoryHistory_, "Query memory history has already been set");
+  memoryFingerprint_ = fingerprint;
+  memoryHistory_ = std::move(history);
+  const uint64_t capacityHint = memoryHistory_->predictCapacity(fingerprint);
+  if (capacityHint == 0) {
+    return 0;
+  }
+  return setMemoryCapacityHint(capacityHint);
+}
+
 void QueryCtx::maybeSetReclaimer() {
   VELOX_CHECK_NOT_NULL(pool_);
   VELOX_CHECK(!underArbitration_);
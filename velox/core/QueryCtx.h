@@ -20,7 +20,9 @@
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/memory/Memory.h"
+#include "velox/common/memory/RawVector.h"
 #include "velox/core/QueryConfig.h"
+#include "velox/core/QueryMemoryHistory.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/VectorPool.h"
 
@@ -32,9 +34,7 @@ namespace facebook::velox::core {
 
 class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
  public:
-  ~QueryCtx() {
-    VELOX_CHECK(!underArbitration_);
-  }
+  ~QueryCtx();
 
   /// QueryCtx is used in different places. When used with `Task::start()`, it's
   /// required that the caller supplies the executor and ensure its lifetime
@@ -126,6 +126,28 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
   /// the max query trace bytes limit.
   void updateTracedBytesAndCheckLimit(uint64_t bytes);
 
+  /// Grows the capacity of the query memory pool up front to 'capacityHint',
+  /// e.g. the expected peak memory usage of the query, to save the memory
+  /// arbitration rounds to grow it on demand. The hint is only granted from
+  /// the free capacity of the memory arbitrator. The function returns the
+  /// granted bytes.
+  uint64_t setMemoryCapacityHint(uint64_t capacityHint);
+
+  /// Associates the query with 'fingerprint' in the memory 'history', and sets
+  /// its memory capacity hint from the history. The peak memory usage of this
+  /// query is recorded in 'history' when the query ctx is destroyed. The
+  /// function returns the granted bytes.
+  uint64_t setMemoryHistory(
+      const std::string& fingerprint,
+      std::shared_ptr<QueryMemoryHistory> history);
+
+  /// Returns the number of memory arbitration round trips to grow the capacity
+  /// of the query memory pool so far. The capacity granted by
+  /// setMemoryCapacityHint() is not counted.
+  uint64_t numArbitrationRoundTrips() const {
+    return pool_->stats().numCapacityGrowths;
+  }
+
   void testingOverrideMemoryPool(std::shared_ptr<memory::MemoryPool> pool) {
     pool_ = std::move(pool);
   }
@@ -223,6 +245,9 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
   std::atomic<uint64_t> numSpilledBytes_{0};
   std::atomic<uint64_t> numTracedBytes_{0};
 
+  std::string memoryFingerprint_;
+  std::shared_ptr<QueryMemoryHistory> memoryHistory_;
+
   mutable std::mutex mutex_;
   // Indicates if this query is under memory arbitration or not.
   bool underArbitration_{false};
@@ -354,6 +379,16 @@ class ExecCtx {
     return false;
   }
 
+  /// Returns the scratch buffer for the gathered values of argument 'argIndex'
+  /// of a simple function. The buffer is kept across batches so that it is
+  /// allocated only when it grows. The contents are undefined.
+  raw_vector<uint64_t>& gatherScratch(column_index_t argIndex) {
+    while (gatherScratch_.size() <= argIndex) {
+      gatherScratch_.emplace_back(pool_);
+    }
+    return gatherScratch_[argIndex];
+  }
+
   VectorPool* vectorPool() {
     return vectorPool_.get();
   }
@@ -403,6 +438,9 @@ class ExecCtx {
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
   std::unique_ptr<VectorPool> vectorPool_;
+  // Scratch for the gathered values of the arguments of simple functions,
+  // indexed by argument position.
+  std::vector<raw_vector<uint64_t>> gatherScratch_;
 };
 
 } // namespace facebook::velox::core
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/core/QueryMemoryHistory.h"
+
+#include <algorithm>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::core {
+
+QueryMemoryHistory::QueryMemoryHistory(size_t maxEntries)
+    : maxEntries_(maxEntries) {
+  VELOX_CHECK_GT(maxEntries_, 0);
+}
+
+void QueryMemoryHistory::record(
+    const std::string& fingerprint,
+    uint64_t peakBytes,
+    uint64_t numCapacityGrowths) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(fingerprint);
+  if (it == entries_.end()) {
+    if (entries_.size() >= maxEntries_) {
+      entries_.erase(lru_.front());
+      lru_.pop_front();
+    }
+    lru_.push_back(fingerprint);
+    it = entries_.emplace(fingerprint, Slot{{}, std::prev(lru_.end())}).first;
+  } else {
+    touchLocked(it->second);
+  }
+
+  auto& entry = it->second.entry;
+  if (entry.recentPeakBytes.size() >= kMaxRecentExecutions) {
+    entry.recentPeakBytes.erase(entry.recentPeakBytes.begin());
+  }
+  entry.recentPeakBytes.push_back(peakBytes);
+  entry.lastNumCapacityGrowths = numCapacityGrowths;
+  ++entry.numExecutions;
+}
+
+uint64_t QueryMemoryHistory::predictCapacity(const std::string& fingerprint) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(fingerprint);
+  if (it == entries_.end()) {
+    return 0;
+  }
+  touchLocked(it->second);
+  const auto& peaks = it->second.entry.recentPeakBytes;
+  return *std::max_element(peaks.begin(), peaks.end());
+}
+
+std::optional<QueryMemoryHistory::Entry> QueryMemoryHistory::find(
+    const std::string& fingerprint) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(fingerprint);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  return it->second.entry;
+}
+
+size_t QueryMemoryHistory::size() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return entries_.size();
+}
+
+void QueryMemoryHistory::touchLocked(Slot& slot) {
+  lru_.splice(lru_.end(), lru_, slot.lruPosition);
+}
+} // namespace facebook::velox::core
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::velox::core {
+
+/// Remembers the memory usage of the recent executions of the recurring
+/// queries in the process. A query is identified by a fingerprint provided by
+/// the query system, e.g. the hash of its normalized plan. The history is used
+/// to predict the memory capacity of the next execution of the same query so
+/// that its memory pool can be granted the capacity up front instead of
+/// growing it through a number of memory arbitration rounds. The history keeps
+/// up to 'maxEntries' fingerprints and evicts the least recently used ones.
+///
+/// The class is thread-safe.
+class QueryMemoryHistory {
+ public:
+  /// The max number of recent executions remembered per fingerprint.
+  static constexpr size_t kMaxRecentExecutions{8};
+
+  struct Entry {
+    /// The peak memory usage in bytes of the recent executions, in the order
+    /// of their completion.
+    std::vector<uint64_t> recentPeakBytes;
+    /// The number of memory arbitration round trips to grow the capacity of
+    /// the most recent execution.
+    uint64_t lastNumCapacityGrowths{0};
+    /// The total number of executions recorded.
+    uint64_t numExecutions{0};
+  };
+
+  explicit QueryMemoryHistory(size_t maxEntries = 10'000);
+
+  /// Records an execution of the query with 'fingerprint' which has used
+  /// 'peakBytes' at most and grown its capacity 'numCapacityGrowths' times
+  /// through memory arbitration.
+  void record(
+      const std::string& fingerprint,
+      uint64_t peakBytes,
+      uint64_t numCapacityGrowths);
+
+  /// Returns the predicted memory capacity of the query with 'fingerprint',
+  /// which is the max peak memory usage of its recent executions, or zero if
+  /// there is no history.
+  uint64_t predictCapacity(const std::string& fingerprint);
+
+  std::optional<Entry> find(const std::string& fingerprint) const;
+
+  size_t size() const;
+
+ private:
+  struct Slot {
+    Entry entry;
+    // Position in 'lru_'.
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  // Moves 'slot' to the most recently used position.
+  void touchLocked(Slot& slot);
+
+  const size_t maxEntries_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Slot> entries_;
+  // The fingerprints from the least to the most recently used.
+  std::list<std::string> lru_;
+};
+} // namespace facebook::velox::core
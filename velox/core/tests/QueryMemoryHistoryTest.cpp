@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/core/QueryMemoryHistory.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/core/QueryCtx.h"
+
+namespace facebook::velox::core::test {
+
+class QueryMemoryHistoryTest : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance({});
+  }
+};
+
+TEST_F(QueryMemoryHistoryTest, predictCapacity) {
+  QueryMemoryHistory history;
+  ASSERT_EQ(history.predictCapacity("q1"), 0);
+  ASSERT_FALSE(history.find("q1").has_value());
+
+  history.record("q1", 100, 3);
+  history.record("q1", 300, 2);
+  history.record("q1", 200, 1);
+  ASSERT_EQ(history.predictCapacity("q1"), 300);
+  const auto entry = history.find("q1").value();
+  ASSERT_EQ(entry.numExecutions, 3);
+  ASSERT_EQ(entry.lastNumCapacityGrowths, 1);
+  ASSERT_EQ(entry.recentPeakBytes, (std::vector<uint64_t>{100, 300, 200}));
+
+  // Only the recent executions are used for the prediction.
+  for (size_t i = 0; i < QueryMemoryHistory::kMaxRecentExecutions; ++i) {
+    history.record("q1", 50, 0);
+  }
+  ASSERT_EQ(history.predictCapacity("q1"), 50);
+  ASSERT_EQ(
+      history.find("q1")->numExecutions,
+      3 + QueryMemoryHistory::kMaxRecentExecutions);
+}
+
+TEST_F(QueryMemoryHistoryTest, evict) {
+  QueryMemoryHistory history(2);
+  history.record("q1", 100, 0);
+  history.record("q2", 200, 0);
+  // Accessing 'q1' makes 'q2' the least recently used one.
+  ASSERT_EQ(history.predictCapacity("q1"), 100);
+  history.record("q3", 300, 0);
+  ASSERT_EQ(history.size(), 2);
+  ASSERT_TRUE(history.find("q1").has_value());
+  ASSERT_FALSE(history.find("q2").has_value());
+  ASSERT_TRUE(history.find("q3").has_value());
+
+  VELOX_ASSERT_THROW(QueryMemoryHistory(0), "");
+}
+
+TEST_F(QueryMemoryHistoryTest, queryCtx) {
+  auto history = std::make_shared<QueryMemoryHistory>();
+  uint64_t peakBytes;
+  {
+    auto queryCtx = QueryCtx::create();
+    // The default memory arbitrator doesn't grant capacity hints.
+    ASSERT_EQ(queryCtx->setMemoryHistory("q1", history), 0);
+    VELOX_ASSERT_THROW(
+        queryCtx->setMemoryHistory("q1", history),
+        "Query memory history has already been set");
+    auto leafPool = queryCtx->pool()->addLeafChild("leaf");
+    void* buffer = leafPool->allocate(1 << 20);
+    peakBytes = queryCtx->pool()->peakBytes();
+    leafPool->free(buffer, 1 << 20);
+    ASSERT_EQ(queryCtx->numArbitrationRoundTrips(), 0);
+  }
+  const auto entry = history->find("q1").value();
+  ASSERT_EQ(entry.numExecutions, 1);
+  ASSERT_EQ(entry.recentPeakBytes, std::vector<uint64_t>{peakBytes});
+  ASSERT_GE(peakBytes, 1 << 20);
+}
+} // namespace facebook::velox::core::test
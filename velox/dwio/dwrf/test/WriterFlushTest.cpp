@@ -71,6 +71,8 @@ class MockMemoryPool : public velox::memory::MemoryPool {
 
   void release() override {}
 
+  void releaseReservation(uint64_t /*unused*/) override {}
+
   Stats stats() const override {
     VELOX_NYI("{} unsupported", __FUNCTION__);
   }
@@ -142,7 +144,8 @@ class MockMemoryPool : public velox::memory::MemoryPool {
   void allocateContiguous(
       velox::memory::MachinePageCount /*unused*/,
       velox::memory::ContiguousAllocation& /*unused*/,
-      velox::memory::MachinePageCount /*unused*/ = 0) override {
+      velox::memory::MachinePageCount /*unused*/ = 0,
+      bool /*unused*/ = false) override {
     VELOX_UNSUPPORTED("allocateContiguous unsupported");
   }
 
@@ -89,6 +89,21 @@ class Aggregate {
     return false;
   }
 
+  /// Returns true if relocateAccumulators() moves all the memory the
+  /// accumulators have allocated from the HashStringAllocator, so that this
+  /// can be compacted. This is true for accumulators which keep no state in the
+  /// HashStringAllocator and do not override relocateAccumulators().
+  virtual bool supportsCompaction() const {
+    return false;
+  }
+
+  /// Moves the out-of-line state of the accumulators of 'groups' with
+  /// 'relocate' during HashStringAllocator::compact(). Only called if
+  /// supportsCompaction() returns true.
+  virtual void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::RelocateFn& relocate) {}
+
   void setAllocator(HashStringAllocator* allocator) {
     setAllocatorInternal(allocator);
   }
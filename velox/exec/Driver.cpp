@@ -144,7 +144,10 @@ std::optional<common::SpillConfig> DriverCtx::makeSpillConfig(
       queryConfig.spillPrefixSortEnabled()
           ? std::optional<common::PrefixSortConfig>(prefixSortConfig())
           : std::nullopt,
-      queryConfig.spillFileCreateConfig());
+      queryConfig.spillFileCreateConfig(),
+      queryConfig.spillMaxPendingWrites(),
+      queryConfig.spillColumnarEncodingEnabled(),
+      task->spillDirectorySelector());
 }
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
@@ -23,10 +23,16 @@ namespace {
 std::unique_ptr<VectorSerde::Options> getVectorSerdeOptions(
     const core::QueryConfig& queryConfig,
     VectorSerde::Kind kind) {
-  std::unique_ptr<VectorSerde::Options> options =
-      kind == VectorSerde::Kind::kPresto
-      ? std::make_unique<serializer::presto::PrestoVectorSerde::PrestoOptions>()
-      : std::make_unique<VectorSerde::Options>();
+  std::unique_ptr<VectorSerde::Options> options;
+  if (kind == VectorSerde::Kind::kPresto) {
+    auto prestoOptions = std::make_unique<
+        serializer::presto::PrestoVectorSerde::PrestoOptions>();
+    prestoOptions->zeroCopyDeserialize =
+        queryConfig.exchangeZeroCopyDeserializationEnabled();
+    options = std::move(prestoOptions);
+  } else {
+    options = std::make_unique<VectorSerde::Options>();
+  }
   options->compressionKind =
       common::stringToCompressionKind(queryConfig.shuffleCompressionKind());
   return options;
@@ -51,6 +57,9 @@ Exchange::Exchange(
       serdeOptions_{getVectorSerdeOptions(
           operatorCtx_->driverCtx()->queryConfig(),
           serdeKind_)},
+      zeroCopyDeserialize_{
+          serdeKind_ == VectorSerde::Kind::kPresto &&
+          driverCtx->queryConfig().exchangeZeroCopyDeserializationEnabled()},
       processSplits_{operatorCtx_->driverCtx()->driverId == 0},
       driverId_{driverCtx->driverId},
       exchangeClient_{std::move(exchangeClient)} {}
@@ -150,7 +159,12 @@ RowVectorPtr Exchange::getOutput() {
   uint64_t rawInputBytes{0};
   vector_size_t resultOffset = 0;
   if (getSerde()->supportsAppendInDeserialize()) {
-    for (const auto& page : currentPages_) {
+    // With zero-copy deserialization the output wraps the page memory, so
+    // each page is returned as a separate batch. Appending the next page would
+    // copy the wrapped buffers.
+    const auto numPages = zeroCopyDeserialize_ ? 1 : currentPages_.size();
+    for (auto i = 0; i < numPages; ++i) {
+      auto& page = currentPages_[i];
       rawInputBytes += page->size();
 
       auto inputStream = page->prepareStreamForDeserialize();
@@ -166,6 +180,8 @@ RowVectorPtr Exchange::getOutput() {
         resultOffset = result_->size();
       }
     }
+    currentPages_.erase(
+        currentPages_.begin(), currentPages_.begin() + numPages);
   } else {
     VELOX_CHECK(
         getSerde()->kind() == VectorSerde::Kind::kCompactRow ||
@@ -193,8 +209,8 @@ RowVectorPtr Exchange::getOutput() {
     // We expect the row-wise deserialization to consume all the input into one
     // output vector.
     VELOX_CHECK(inputStream->atEnd());
+    currentPages_.clear();
   }
-  currentPages_.clear();
 
   {
     auto lockedStats = stats_.wlock();
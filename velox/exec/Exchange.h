@@ -84,6 +84,10 @@ class Exchange : public SourceOperator {
 
   const std::unique_ptr<VectorSerde::Options> serdeOptions_;
 
+  // True if the output vectors wrap the memory of the received pages instead
+  // of copying it. Set for Presto serde only.
+  const bool zeroCopyDeserialize_;
+
   /// True if this operator is responsible for fetching splits from the Task
   /// and passing these to ExchangeClient.
   const bool processSplits_;
@@ -115,6 +115,17 @@ folly::F14FastMap<std::string, RuntimeMetric> ExchangeClient::stats() const {
   stats["numReceivedPages"] = RuntimeMetric(queue_->receivedPages());
   stats["averageReceivedPageBytes"] = RuntimeMetric(
       queue_->averageReceivedPageBytes(), RuntimeCounter::Unit::kBytes);
+  const auto spillStats = queue_->spillStats();
+  if (!spillStats.empty()) {
+    stats["exchangeSpilledBytes"] =
+        RuntimeMetric(spillStats.spilledBytes, RuntimeCounter::Unit::kBytes);
+    stats["exchangeSpillReadBytes"] =
+        RuntimeMetric(spillStats.spillReadBytes, RuntimeCounter::Unit::kBytes);
+    stats["exchangeSpillWriteNanos"] = RuntimeMetric(
+        spillStats.spillWriteTimeNanos, RuntimeCounter::Unit::kNanos);
+    stats["exchangeSpillReadNanos"] = RuntimeMetric(
+        spillStats.spillReadTimeNanos, RuntimeCounter::Unit::kNanos);
+  }
 
   return stats;
 }
@@ -127,6 +138,8 @@ std::vector<std::unique_ptr<SerializedPage>> ExchangeClient::next(
   std::vector<RequestSpec> requestSpecs;
   std::vector<std::unique_ptr<SerializedPage>> pages;
   ContinuePromise stalePromise = ContinuePromise::makeEmpty();
+  // Reads back the spilled pages, if any, outside of the queue lock.
+  queue_->loadSpilledPages(maxBytes);
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
     if (closed_) {
@@ -141,7 +154,7 @@ std::vector<std::unique_ptr<SerializedPage>> ExchangeClient::next(
       return pages;
     }
 
-    if (!pages.empty() && queue_->totalBytes() > maxQueuedBytes_) {
+    if (!pages.empty() && queuedBytesLocked() > maxQueuedBytes_) {
       return pages;
     }
 
@@ -240,7 +253,7 @@ ExchangeClient::pickSourcesToRequestLocked() {
     emptySources_.pop();
   }
   int64_t availableSpace =
-      maxQueuedBytes_ - queue_->totalBytes() - totalPendingBytes_;
+      maxQueuedBytes_ - queuedBytesLocked() - totalPendingBytes_;
   while (availableSpace > 0 && !producingSources_.empty()) {
     auto& source = producingSources_.front().source;
     int64_t requestBytes = 0;
@@ -280,6 +293,46 @@ ExchangeClient::~ExchangeClient() {
   close();
 }
 
+std::unique_ptr<memory::MemoryReclaimer> ExchangeClient::MemoryReclaimer::create(
+    const std::shared_ptr<ExchangeQueue>& queue) {
+  return std::unique_ptr<memory::MemoryReclaimer>(new MemoryReclaimer(queue));
+}
+
+bool ExchangeClient::MemoryReclaimer::reclaimableBytes(
+    const memory::MemoryPool& pool,
+    uint64_t& reclaimableBytes) const {
+  reclaimableBytes = 0;
+  auto queue = queue_.lock();
+  if (queue == nullptr || !queue->canSpill()) {
+    return false;
+  }
+  reclaimableBytes = pool.reservedBytes();
+  return true;
+}
+
+uint64_t ExchangeClient::MemoryReclaimer::reclaim(
+    memory::MemoryPool* pool,
+    uint64_t /*unused*/,
+    uint64_t /*unused*/,
+    memory::MemoryReclaimer::Stats& stats) {
+  auto queue = queue_.lock();
+  if (queue == nullptr || !queue->canSpill()) {
+    return 0;
+  }
+  return memory::MemoryReclaimer::run(
+      [&]() {
+        int64_t reclaimedBytes{0};
+        {
+          memory::ScopedReclaimedBytesRecorder recoder(pool, &reclaimedBytes);
+          queue->spill();
+        }
+        // NOTE: the exchange sources might keep receiving pages into the
+        // memory pool while we are spilling.
+        return std::max<int64_t>(reclaimedBytes, 0);
+      },
+      stats);
+}
+
 std::string ExchangeClient::toString() const {
   std::stringstream out;
   for (auto& source : sources_) {
@@ -17,6 +17,7 @@
 
 #include "velox/exec/ExchangeQueue.h"
 #include "velox/exec/ExchangeSource.h"
+#include "velox/exec/MemoryReclaimer.h"
 
 namespace facebook::velox::exec {
 
@@ -106,6 +107,30 @@ class ExchangeClient : public std::enable_shared_from_this<ExchangeClient> {
     return kRequestDataSizesMaxWaitSec_;
   }
 
+  /// Memory reclaimer for the exchange client memory pool which reclaims
+  /// memory by spilling the pages buffered in the exchange queue to disk.
+  class MemoryReclaimer : public exec::MemoryReclaimer {
+   public:
+    static std::unique_ptr<memory::MemoryReclaimer> create(
+        const std::shared_ptr<ExchangeQueue>& queue);
+
+    bool reclaimableBytes(
+        const memory::MemoryPool& pool,
+        uint64_t& reclaimableBytes) const override;
+
+    uint64_t reclaim(
+        memory::MemoryPool* pool,
+        uint64_t targetBytes,
+        uint64_t maxWaitMs,
+        memory::MemoryReclaimer::Stats& stats) override;
+
+   private:
+    explicit MemoryReclaimer(const std::shared_ptr<ExchangeQueue>& queue)
+        : exec::MemoryReclaimer(0), queue_(queue) {}
+
+    const std::weak_ptr<ExchangeQueue> queue_;
+  };
+
  private:
   struct RequestSpec {
     std::shared_ptr<ExchangeSource> source;
@@ -122,6 +147,12 @@ class ExchangeClient : public std::enable_shared_from_this<ExchangeClient> {
 
   std::vector<RequestSpec> pickSourcesToRequestLocked();
 
+  // Returns the bytes counted against 'maxQueuedBytes_': the pages in the
+  // queue plus the dequeued pages still retained by the deserialized vectors.
+  int64_t queuedBytesLocked() const {
+    return queue_->totalBytes() + queue_->retainedBytes();
+  }
+
   void request(std::vector<RequestSpec>&& requestSpecs);
 
   // Handy for ad-hoc logging.
@@ -16,16 +16,29 @@
 #include "velox/exec/ExchangeQueue.h"
 #include <algorithm>
 
+#include "velox/exec/SerializedPageSpiller.h"
+
 namespace facebook::velox::exec {
 
 SerializedPage::SerializedPage(
     std::unique_ptr<folly::IOBuf> iobuf,
     std::function<void(folly::IOBuf&)> onDestructionCb,
     std::optional<int64_t> numRows)
-    : iobuf_(std::move(iobuf)),
+    : releaseState_(std::make_shared<ReleaseState>(
+          ReleaseState{.onDestructionCb = std::move(onDestructionCb)})),
+      iobuf_(
+          iobuf.release(),
+          [state = releaseState_](folly::IOBuf* buf) {
+            if (state->onDestructionCb) {
+              state->onDestructionCb(*buf);
+            }
+            if (state->retainedBytes != nullptr) {
+              *state->retainedBytes -= state->countedBytes;
+            }
+            delete buf;
+          }),
       iobufBytes_(chainBytes(*iobuf_.get())),
-      numRows_(numRows),
-      onDestructionCb_(onDestructionCb) {
+      numRows_(numRows) {
   VELOX_CHECK_NOT_NULL(iobuf_);
   for (auto& buf : *iobuf_) {
     int32_t bufSize = buf.size();
@@ -37,13 +50,167 @@ SerializedPage::SerializedPage(
 }
 
 SerializedPage::~SerializedPage() {
-  if (onDestructionCb_) {
-    onDestructionCb_(*iobuf_.get());
+  // The memory is released by the last reference to 'iobuf_'.
+  if (releaseState_->retainedBytes != nullptr && iobuf_.use_count() > 1) {
+    releaseState_->countedBytes = iobufBytes_;
+    *releaseState_->retainedBytes += iobufBytes_;
   }
 }
 
 std::unique_ptr<ByteInputStream> SerializedPage::prepareStreamForDeserialize() {
-  return std::make_unique<BufferInputStream>(std::move(ranges_));
+  return std::make_unique<BufferInputStream>(std::move(ranges_), iobuf_);
+}
+
+void SerializedPage::setRetainedBytesCounter(
+    std::shared_ptr<std::atomic<int64_t>> counter) {
+  releaseState_->retainedBytes = std::move(counter);
+}
+
+ExchangeQueue::~ExchangeQueue() {
+  clearAllPromises();
+}
+
+bool ExchangeQueue::empty() const {
+  return queue_.empty() && !hasSpilledPagesLocked();
+}
+
+bool ExchangeQueue::hasSpilledPagesLocked() const {
+  return spiller_ != nullptr && !spiller_->empty();
+}
+
+uint64_t ExchangeQueue::spilledBytesLocked() const {
+  return spiller_ == nullptr ? 0 : spiller_->spilledBytes();
+}
+
+void ExchangeQueue::clearQueueLocked() {
+  queue_.clear();
+  if (spiller_ != nullptr) {
+    spiller_->clear();
+  }
+}
+
+uint64_t ExchangeQueue::frontPageBytesLocked() const {
+  if (hasSpilledPagesLocked()) {
+    return spiller_->frontPageSize();
+  }
+  return queue_.front()->size();
+}
+
+std::unique_ptr<SerializedPage> ExchangeQueue::popFrontLocked() {
+  if (hasSpilledPagesLocked()) {
+    return spiller_->popFront();
+  }
+  auto page = std::move(queue_.front());
+  queue_.pop_front();
+  return page;
+}
+
+void ExchangeQueue::enableSpill(
+    const common::SpillConfig& spillConfig,
+    memory::MemoryPool* pool) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!spillConfig_.has_value(), "Spilling has already been enabled");
+  VELOX_CHECK_NOT_NULL(pool);
+  spillConfig_ = spillConfig;
+  spillPool_ = pool->shared_from_this();
+}
+
+uint64_t ExchangeQueue::spill() {
+  std::shared_ptr<SerializedPageSpiller> spiller;
+  std::vector<std::unique_ptr<SerializedPage>> pages;
+  std::optional<SerializedPageSpiller::WriteBatch> batch;
+  {
+    std::unique_lock<std::mutex> l(mutex_, std::try_to_lock);
+    if (!l.owns_lock() || !spillConfig_.has_value() || !error_.empty() ||
+        queue_.empty()) {
+      return 0;
+    }
+    if (spiller_ == nullptr) {
+      spiller_ = std::make_shared<SerializedPageSpiller>(
+          &spillConfig_.value(), "exchange", spillPool_, &spillStats_);
+    }
+    if (spiller_->ioInProgress()) {
+      return 0;
+    }
+    // Moves the pages in memory out of the queue. They follow the spilled
+    // pages which are still on disk, if any.
+    std::vector<const SerializedPage*> pagesToWrite;
+    pagesToWrite.reserve(queue_.size());
+    pages.reserve(queue_.size());
+    for (auto& page : queue_) {
+      pagesToWrite.push_back(page.get());
+      pages.push_back(std::move(page));
+    }
+    queue_.clear();
+    batch = spiller_->startWrite(pagesToWrite);
+    VELOX_CHECK(batch.has_value());
+    spiller = spiller_;
+  }
+
+  // Writes the pages without holding 'mutex_'. The consumers wait for the
+  // pages under spill while the producers keep enqueuing to 'queue_'.
+  std::vector<ContinuePromise> promises;
+  try {
+    spiller->write(batch.value());
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (spiller->abortWrite(batch.value())) {
+        for (auto it = pages.rbegin(); it != pages.rend(); ++it) {
+          queue_.push_front(std::move(*it));
+        }
+      }
+      promises = clearAllPromisesLocked();
+    }
+    clearPromises(promises);
+    throw;
+  }
+
+  uint64_t spilledBytes{0};
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    spilledBytes = spiller->finishWrite(batch.value());
+    if (spilledBytes > 0) {
+      ++spillStats_.wlock()->spillRuns;
+    }
+    promises = clearAllPromisesLocked();
+  }
+  clearPromises(promises);
+  return spilledBytes;
+}
+
+void ExchangeQueue::loadSpilledPages(uint64_t maxBytes) {
+  std::shared_ptr<SerializedPageSpiller> spiller;
+  std::optional<SerializedPageSpiller::ReadBatch> batch;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!hasSpilledPagesLocked()) {
+      return;
+    }
+    batch = spiller_->startRead(maxBytes);
+    if (!batch.has_value()) {
+      return;
+    }
+    spiller = spiller_;
+  }
+
+  // Reads back the pages without holding 'mutex_'.
+  try {
+    spiller->read(batch.value());
+  } catch (...) {
+    std::lock_guard<std::mutex> l(mutex_);
+    spiller->abortRead(batch.value());
+    throw;
+  }
+
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    spiller->finishRead(batch.value());
+    // Wakes up the consumers waiting for the pages under read.
+    promises = clearAllPromisesLocked();
+  }
+  clearPromises(promises);
 }
 
 void ExchangeQueue::noMoreSources() {
@@ -153,7 +320,7 @@ std::vector<std::unique_ptr<SerializedPage>> ExchangeQueue::dequeueLocked(
   std::vector<std::unique_ptr<SerializedPage>> pages;
   uint32_t pageBytes = 0;
   for (;;) {
-    if (queue_.empty()) {
+    if (empty()) {
       if (atEnd_) {
         *atEnd = true;
       } else if (pages.empty()) {
@@ -162,12 +329,21 @@ std::vector<std::unique_ptr<SerializedPage>> ExchangeQueue::dequeueLocked(
       return pages;
     }
 
-    if (pageBytes > 0 && pageBytes + queue_.front()->size() > maxBytes) {
+    if (hasSpilledPagesLocked() && !spiller_->hasLoadedFront()) {
+      // The oldest page is on disk or under spill IO. Waits for it to be
+      // read back by loadSpilledPages() if there is no page to return.
+      if (pages.empty()) {
+        addPromiseLocked(consumerId, future, stalePromise);
+      }
+      return pages;
+    }
+
+    if (pageBytes > 0 && pageBytes + frontPageBytesLocked() > maxBytes) {
       return pages;
     }
 
-    pages.emplace_back(std::move(queue_.front()));
-    queue_.pop_front();
+    pages.emplace_back(popFrontLocked());
+    pages.back()->setRetainedBytesCounter(retainedBytes_);
     pageBytes += pages.back()->size();
     totalBytes_ -= pages.back()->size();
   }
@@ -186,7 +362,7 @@ void ExchangeQueue::setError(const std::string& error) {
     atEnd_ = true;
     // NOTE: clear the serialized page queue as we won't consume from an
     // errored queue.
-    queue_.clear();
+    clearQueueLocked();
     promises = clearAllPromisesLocked();
   }
   clearPromises(promises);
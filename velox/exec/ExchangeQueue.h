@@ -15,6 +15,10 @@
  */
 #pragma once
 
+#include <atomic>
+
+#include "velox/common/base/SpillConfig.h"
+#include "velox/common/base/SpillStats.h"
 #include "velox/common/memory/ByteStream.h"
 
 namespace facebook::velox::exec {
@@ -23,7 +27,10 @@ namespace facebook::velox::exec {
 /// in Presto wire format.
 class SerializedPage {
  public:
-  /// Construct from IOBuf chain.
+  /// Construct from IOBuf chain. 'onDestructionCb' is called once the page
+  /// memory is released, primarily to free externally allocated memory
+  /// backing the IOBuf. The caller is responsible to pass in proper cleanup
+  /// logic to prevent any memory leak.
   explicit SerializedPage(
       std::unique_ptr<folly::IOBuf> iobuf,
       std::function<void(folly::IOBuf&)> onDestructionCb = nullptr,
@@ -41,9 +48,15 @@ class SerializedPage {
   }
 
   /// Makes 'input' ready for deserializing 'this' with
-  /// VectorStreamGroup::read().
+  /// VectorStreamGroup::read(). The returned stream shares the ownership of the
+  /// page memory so that the deserialized vectors may wrap it without copying.
   std::unique_ptr<ByteInputStream> prepareStreamForDeserialize();
 
+  /// Sets 'counter' to account the page bytes from when 'this' is destroyed
+  /// while the page memory is still referenced, e.g. by the vectors
+  /// deserialized from it without copying, until the memory is released.
+  void setRetainedBytesCounter(std::shared_ptr<std::atomic<int64_t>> counter);
+
   std::unique_ptr<folly::IOBuf> getIOBuf() const {
     return iobuf_->clone();
   }
@@ -57,25 +70,33 @@ class SerializedPage {
     return size;
   }
 
+  // Invoked when the page memory is released, which might be after 'this'
+  // is destroyed.
+  struct ReleaseState {
+    std::function<void(folly::IOBuf&)> onDestructionCb;
+    std::shared_ptr<std::atomic<int64_t>> retainedBytes;
+    // The bytes added to 'retainedBytes' on destruction of the page.
+    int64_t countedBytes{0};
+  };
+
   // Buffers containing the serialized data. The memory is owned by 'iobuf_'.
   std::vector<ByteRange> ranges_;
 
-  // IOBuf holding the data in 'ranges_.
-  std::unique_ptr<folly::IOBuf> iobuf_;
+  const std::shared_ptr<ReleaseState> releaseState_;
+
+  // IOBuf holding the data in 'ranges_'. Shared with the input stream for
+  // deserialization so that the deserialized vectors may retain it.
+  std::shared_ptr<folly::IOBuf> iobuf_;
 
   // Number of payload bytes in 'iobuf_'.
   const int64_t iobufBytes_;
 
   // Number of payload rows, if provided.
   const std::optional<int64_t> numRows_;
-
-  // Callback that will be called on destruction of the SerializedPage,
-  // primarily used to free externally allocated memory backing folly::IOBuf
-  // from caller. Caller is responsible to pass in proper cleanup logic to
-  // prevent any memory leak.
-  std::function<void(folly::IOBuf&)> onDestructionCb_;
 };
 
+class SerializedPageSpiller;
+
 /// Queue of results retrieved from source. Owned by shared_ptr by
 /// Exchange and client threads and registered callbacks waiting
 /// for input.
@@ -89,17 +110,14 @@ class ExchangeQueue {
     VELOX_CHECK_GE(numberOfConsumers, 1);
   }
 
-  ~ExchangeQueue() {
-    clearAllPromises();
-  }
+  ~ExchangeQueue();
 
   std::mutex& mutex() {
     return mutex_;
   }
 
-  bool empty() const {
-    return queue_.empty();
-  }
+  /// Returns true if there is no buffered page in memory or on disk.
+  bool empty() const;
 
   /// Enqueues 'page' to the queue. One random promise(top of promise queue)
   /// associated with the future that is waiting for the data from the queue is
@@ -134,11 +152,18 @@ class ExchangeQueue {
       ContinueFuture* future,
       ContinuePromise* stalePromise);
 
-  /// Returns the total bytes held by SerializedPages in 'this'.
+  /// Returns the total bytes held by SerializedPages in 'this' including the
+  /// spilled ones.
   int64_t totalBytes() const {
     return totalBytes_;
   }
 
+  /// Returns the bytes of the dequeued pages whose memory is still referenced
+  /// by the vectors deserialized from them without copying.
+  int64_t retainedBytes() const {
+    return *retainedBytes_;
+  }
+
   /// Returns the maximum value of total bytes.
   uint64_t peakBytes() const {
     return peakBytes_;
@@ -164,12 +189,59 @@ class ExchangeQueue {
 
   void close();
 
+  /// Enables to spill the buffered pages to disk under memory pressure.
+  /// 'spillConfig' provides the spill directory and file options. 'pool' is
+  /// used to allocate the memory for the pages read back from disk.
+  void enableSpill(
+      const common::SpillConfig& spillConfig,
+      memory::MemoryPool* pool);
+
+  bool canSpill() const {
+    return spillConfig_.has_value();
+  }
+
+  /// Spills all the pages buffered in memory to disk. The pages are moved out
+  /// of the queue under 'mutex_' and written without holding it. They are
+  /// read back by loadSpilledPages() in the same order as they were enqueued.
+  /// The pages enqueued after the spill stay in memory behind the spilled
+  /// ones. Returns the number of spilled bytes.
+  ///
+  /// NOTE: this is invoked by memory arbitration and it skips spilling if
+  /// 'mutex_' is held by a concurrent queue operation which might be the one
+  /// triggering the memory arbitration.
+  uint64_t spill();
+
+  /// Reads back the oldest spilled pages until there are at least 'maxBytes'
+  /// read back without holding 'mutex_'. Called before dequeueLocked() which
+  /// only returns the spilled pages which have been read back.
+  void loadSpilledPages(uint64_t maxBytes);
+
+  /// Returns the total bytes of the spilled pages which haven't been dequeued
+  /// yet.
+  uint64_t spilledBytesLocked() const;
+
+  common::SpillStats spillStats() const {
+    return spillStats_.copy();
+  }
+
  private:
   std::vector<ContinuePromise> closeLocked() {
-    queue_.clear();
+    clearQueueLocked();
     return clearAllPromisesLocked();
   }
 
+  // Clears the buffered pages in memory and on disk.
+  void clearQueueLocked();
+
+  // Returns the byte size of the oldest buffered page.
+  uint64_t frontPageBytesLocked() const;
+
+  // Removes and returns the oldest buffered page. If there are spilled pages,
+  // the oldest one must have been read back.
+  std::unique_ptr<SerializedPage> popFrontLocked();
+
+  bool hasSpilledPagesLocked() const;
+
   std::vector<ContinuePromise> checkCompleteLocked() {
     if (noMoreSources_ && numCompleted_ == numSources_) {
       atEnd_ = true;
@@ -220,6 +292,10 @@ class ExchangeQueue {
   bool atEnd_{false};
 
   std::mutex mutex_;
+  // The buffered pages in memory.
+  //
+  // NOTE: if 'spiller_' has spilled pages, they precede the pages in 'queue_'
+  // which are dequeued after 'spiller_' is drained.
   std::deque<std::unique_ptr<SerializedPage>> queue_;
   // The map from consumer id to the waiting promise
   folly::F14FastMap<int, ContinuePromise> promises_;
@@ -236,5 +312,18 @@ class ExchangeQueue {
   int64_t receivedBytes_{0};
   // Maximum value of totalBytes_.
   int64_t peakBytes_{0};
+  // Total size of the dequeued pages retained by the deserialized vectors.
+  // Shared with the pages as they might be released after 'this' is
+  // destroyed.
+  const std::shared_ptr<std::atomic<int64_t>> retainedBytes_{
+      std::make_shared<std::atomic<int64_t>>(0)};
+
+  // Set if spilling is enabled.
+  std::optional<common::SpillConfig> spillConfig_;
+  // Used to allocate the memory for the pages read back from disk.
+  std::shared_ptr<memory::MemoryPool> spillPool_;
+  folly::Synchronized<common::SpillStats> spillStats_;
+  // Created on the first spill.
+  std::shared_ptr<SerializedPageSpiller> spiller_;
 };
 } // namespace facebook::velox::exec
@@ -186,6 +186,10 @@ vector_size_t FilterProject::filter(
     const SelectivityVector& allRows) {
   std::vector<VectorPtr> results;
   exprs_->eval(0, 1, true, allRows, evalCtx, results);
-  return processFilterResults(results[0], allRows, filterEvalCtx_, pool());
+  const auto numOut =
+      processFilterResults(results[0], allRows, filterEvalCtx_, pool());
+  // The filter result is only needed to compute the selected rows.
+  evalCtx.releaseVector(results[0]);
+  return numOut;
 }
 } // namespace facebook::velox::exec
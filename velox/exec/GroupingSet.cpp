@@ -929,6 +929,30 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
                << ", reservation: " << succinctBytes(pool_.reservedBytes());
 }
 
+int64_t GroupingSet::maybeCompact(
+    double minFragmentation,
+    bool withinReservation) {
+  // Compacting a small or moderately fragmented allocator does not release
+  // enough memory to pay for the copy.
+  constexpr int64_t kMinCompactionFreeBytes = 8 << 20;
+  if (table_ == nullptr) {
+    return 0;
+  }
+  auto* rows = table_->rows();
+  const auto& allocator = rows->stringAllocator();
+  const int64_t freeBytes = allocator.freeSpace();
+  if (freeBytes < kMinCompactionFreeBytes ||
+      allocator.fragmentation() < minFragmentation ||
+      !rows->supportsCompaction()) {
+    return 0;
+  }
+  if (withinReservation &&
+      pool_.availableReservation() < allocator.retainedSize() - freeBytes) {
+    return 0;
+  }
+  return rows->compactVariableWidthData();
+}
+
 void GroupingSet::ensureOutputFits() {
   // If spilling has already been triggered on this operator, then we don't need
   // to reserve memory for the output as we can't reclaim much memory from this
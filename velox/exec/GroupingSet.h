@@ -122,6 +122,20 @@ class GroupingSet {
   /// Returns true if spilling has triggered on this grouping set.
   bool hasSpilled() const;
 
+  /// Returns the fraction of the memory for variable width keys and
+  /// accumulators which is in free blocks.
+  double fragmentation() const {
+    return table_ ? table_->rows()->stringAllocator().fragmentation() : 0;
+  }
+
+  /// Compacts the memory for variable width keys and accumulators if at least
+  /// 'minFragmentation' of it is free and all the aggregates support
+  /// compaction. If 'withinReservation' is true, compacts only if the copy of
+  /// the live data fits in the unused memory reservation, so that the
+  /// compaction does not trigger memory arbitration. Returns the number of
+  /// bytes released.
+  int64_t maybeCompact(double minFragmentation, bool withinReservation);
+
   /// Returns the hashtable stats.
   HashTableStats hashTableStats() const {
     return table_ ? table_->stats() : HashTableStats{};
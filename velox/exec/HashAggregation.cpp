@@ -47,6 +47,8 @@ HashAggregation::HashAggregation(
           driverCtx->queryConfig().abandonPartialAggregationMinRows()),
       abandonPartialAggregationMinPct_(
           driverCtx->queryConfig().abandonPartialAggregationMinPct()),
+      compactionMinFragmentationPct_(
+          driverCtx->queryConfig().aggregationCompactionMinFragmentationPct()),
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {}
 
@@ -185,6 +187,7 @@ void HashAggregation::addInput(RowVectorPtr input) {
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
 
+  maybeCompact(/*withinReservation=*/false);
   updateRuntimeStats();
 
   // NOTE: we should not trigger partial output flush in case of global
@@ -242,6 +245,23 @@ void HashAggregation::updateRuntimeStats() {
       RuntimeMetric(hashTableStats.numDistinct);
   runtimeStats[BaseHashTable::kNumTombstones] =
       RuntimeMetric(hashTableStats.numTombstones);
+  runtimeStats[kFragmentationPct] =
+      RuntimeMetric(groupingSet_->fragmentation() * 100);
+}
+
+int64_t HashAggregation::maybeCompact(bool withinReservation) {
+  if (compactionMinFragmentationPct_ == 0) {
+    return 0;
+  }
+  const auto compactedBytes = groupingSet_->maybeCompact(
+      compactionMinFragmentationPct_ / 100.0, withinReservation);
+  if (compactedBytes > 0) {
+    addRuntimeStat(
+        kCompactedBytes,
+        RuntimeCounter(compactedBytes, RuntimeCounter::Unit::kBytes));
+    addRuntimeStat(kCompactionTimes, RuntimeCounter(1));
+  }
+  return compactedBytes;
 }
 
 void HashAggregation::prepareOutput(vector_size_t size) {
@@ -478,8 +498,14 @@ void HashAggregation::reclaim(
     // 'resultIterator_'.
     groupingSet_->spill(resultIterator_);
   } else {
-    // TODO: support fine-grain disk spilling based on 'targetBytes' after
-    // having row container memory compaction support later.
+    // Compacting the fragmented variable width data may release enough memory
+    // without spilling.
+    if (targetBytes > 0 &&
+        maybeCompact(/*withinReservation=*/true) >= targetBytes) {
+      pool()->release();
+      return;
+    }
+    // TODO: support fine-grain disk spilling based on 'targetBytes'.
     groupingSet_->spill();
   }
   VELOX_CHECK_EQ(groupingSet_->numRows(), 0);
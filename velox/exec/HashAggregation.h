@@ -22,6 +22,14 @@ namespace facebook::velox::exec {
 
 class HashAggregation : public Operator {
  public:
+  /// The percentage of the string allocator memory of the aggregation state
+  /// which is in free blocks.
+  static inline const std::string kFragmentationPct{"fragmentationPct"};
+  /// The bytes released by compacting the aggregation state.
+  static inline const std::string kCompactedBytes{"compactedBytes"};
+  /// The number of times the aggregation state is compacted.
+  static inline const std::string kCompactionTimes{"compactionTimes"};
+
   HashAggregation(
       int32_t operatorId,
       DriverCtx* driverCtx,
@@ -84,6 +92,11 @@ class HashAggregation : public Operator {
 
   void updateEstimatedOutputRowSize();
 
+  // Compacts the memory for variable width keys and accumulators if it is
+  // fragmented beyond 'compactionMinFragmentationPct_'. Returns the number of
+  // bytes released.
+  int64_t maybeCompact(bool withinReservation);
+
   std::shared_ptr<const core::AggregationNode> aggregationNode_;
 
   const bool isPartialOutput_;
@@ -96,6 +109,9 @@ class HashAggregation : public Operator {
   // Min unique rows pct for partial aggregation. If more than this many rows
   // are unique, the partial aggregation is not worthwhile.
   const int32_t abandonPartialAggregationMinPct_;
+  // Min percentage of free memory for variable width data to compact it. 0
+  // disables the compaction.
+  const int32_t compactionMinFragmentationPct_;
 
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
@@ -62,6 +62,9 @@ HashBuild::HashBuild(
       joinType_{joinNode_->joinType()},
       nullAware_{joinNode_->isNullAware()},
       needProbedFlagSpill_{needRightSideJoin(joinType_)},
+      hybridSpill_{
+          !nullAware_ &&
+          driverCtx->queryConfig().hashJoinHybridSpillEnabled()},
       joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
           operatorCtx_->driverCtx()->splitGroupId,
           planNodeId())),
@@ -1033,7 +1036,7 @@ bool HashBuild::canReclaim() const {
 }
 
 void HashBuild::reclaim(
-    uint64_t /*unused*/,
+    uint64_t targetBytes,
     memory::MemoryReclaimer::Stats& stats) {
   TestValue::adjust("facebook::velox::exec::HashBuild::reclaim", this);
   VELOX_CHECK(canSpill());
@@ -1101,15 +1104,88 @@ void HashBuild::reclaim(
     spillers.push_back(buildOp->spiller_.get());
   }
 
-  spillHashJoinTable(spillers, config);
+  // NOTE: all the hash build operators must spill the same partitions as the
+  // hash probe spills the probe input of the partitions spilled by any of them.
+  SpillPartitionNumSet spillPartitions;
+  if (hybridSpill_) {
+    std::vector<HashBuildSpiller::PartitionStats> partitionStats;
+    for (auto* spiller : spillers) {
+      const auto spillerStats = spiller->partitionStats();
+      partitionStats.resize(spillerStats.size());
+      for (auto i = 0; i < spillerStats.size(); ++i) {
+        partitionStats[i].numRows += spillerStats[i].numRows;
+        partitionStats[i].numBytes += spillerStats[i].numBytes;
+      }
+    }
+    spillPartitions = selectHybridSpillPartitions(partitionStats, targetBytes);
+  }
+
+  spillHashJoinTable(spillers, config, spillPartitions);
 
   for (auto* op : operators) {
     HashBuild* buildOp = static_cast<HashBuild*>(op);
-    buildOp->table_->clear(true);
+    // If only some partitions are spilled, the row container keeps the rows of
+    // the other partitions and the freed rows of the spilled ones are reused
+    // by the following input. There is no table to clear as the join table is
+    // only built after all the input is added.
+    if (spillPartitions.empty()) {
+      buildOp->table_->clear(true);
+    }
     buildOp->pool()->release();
   }
 }
 
+SpillPartitionNumSet selectHybridSpillPartitions(
+    const std::vector<HashBuildSpiller::PartitionStats>& partitionStats,
+    uint64_t targetBytes) {
+  std::vector<uint32_t> candidates;
+  uint64_t totalBytes{0};
+  for (auto partition = 0; partition < partitionStats.size(); ++partition) {
+    if (partitionStats[partition].numRows == 0) {
+      continue;
+    }
+    candidates.push_back(partition);
+    totalBytes += partitionStats[partition].numBytes;
+  }
+  if (targetBytes == 0) {
+    targetBytes = totalBytes / 2;
+  }
+
+  // Compares the rows per byte of two partitions by cross multiplication.
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [&](uint32_t lhs, uint32_t rhs) {
+        const auto& left = partitionStats[lhs];
+        const auto& right = partitionStats[rhs];
+        const auto leftDensity = static_cast<__uint128_t>(left.numRows) *
+            right.numBytes;
+        const auto rightDensity = static_cast<__uint128_t>(right.numRows) *
+            left.numBytes;
+        if (leftDensity != rightDensity) {
+          return leftDensity < rightDensity;
+        }
+        if (left.numBytes != right.numBytes) {
+          return left.numBytes > right.numBytes;
+        }
+        return lhs < rhs;
+      });
+
+  SpillPartitionNumSet spillPartitions;
+  uint64_t spillBytes{0};
+  for (const auto partition : candidates) {
+    if (!spillPartitions.empty() && spillBytes >= targetBytes) {
+      break;
+    }
+    spillPartitions.insert(partition);
+    spillBytes += partitionStats[partition].numBytes;
+  }
+  if (spillPartitions.size() == candidates.size()) {
+    return {};
+  }
+  return spillPartitions;
+}
+
 bool HashBuild::nonReclaimableState() const {
   // Apart from being in the nonReclaimable section, it's also not reclaimable
   // if:
@@ -1160,9 +1236,59 @@ HashBuildSpiller::HashBuildSpiller(
 }
 
 void HashBuildSpiller::spill() {
+  clearRowPartitions();
   SpillerBase::spill(nullptr);
 }
 
+void HashBuildSpiller::spill(const SpillPartitionNumSet& partitions) {
+  SCOPE_EXIT {
+    clearRowPartitions();
+  };
+  SpillerBase::spill(
+      partitions,
+      folly::Range<const uint8_t*>(
+          rowPartitions_.data(), rowPartitions_.size()));
+}
+
+void HashBuildSpiller::clearRowPartitions() {
+  rowPartitions_.clear();
+  rowPartitions_.shrink_to_fit();
+}
+
+std::vector<HashBuildSpiller::PartitionStats>
+HashBuildSpiller::partitionStats() {
+  std::vector<PartitionStats> stats(state_.maxPartitions());
+  rowPartitions_.clear();
+  rowPartitions_.reserve(container_->numRows());
+  constexpr int32_t kBatchSize = 4096;
+  std::vector<uint64_t> hashes(kBatchSize);
+  std::vector<char*> rows(kBatchSize);
+  const bool isSinglePartition = bits_.numPartitions() == 1;
+  RowContainerIterator iter;
+  for (;;) {
+    const auto numRows = container_->listRows(
+        &iter, rows.size(), RowContainer::kUnlimited, rows.data());
+    if (numRows == 0) {
+      break;
+    }
+    const auto rowSet = folly::Range<char**>(rows.data(), numRows);
+    if (!isSinglePartition) {
+      for (auto i = 0; i < container_->keyTypes().size(); ++i) {
+        container_->hash(i, rowSet, i > 0, hashes.data());
+      }
+    }
+    for (auto i = 0; i < numRows; ++i) {
+      const auto partition = isSinglePartition
+          ? 0
+          : bits_.partition(hashes[i], state_.maxPartitions());
+      rowPartitions_.push_back(partition);
+      ++stats[partition].numRows;
+      stats[partition].numBytes += container_->rowSize(rows[i]);
+    }
+  }
+  return stats;
+}
+
 void HashBuildSpiller::spill(
     uint32_t partition,
     const RowVectorPtr& spillVector) {
@@ -90,6 +90,10 @@ class HashBuild final : public Operator {
     return exceededMaxSpillLevelLimit_;
   }
 
+  const RowContainer* testingRows() const {
+    return table_->rows();
+  }
+
  private:
   void setState(State state);
   void checkStateTransition(State state);
@@ -213,6 +217,10 @@ class HashBuild final : public Operator {
   // not.
   const bool needProbedFlagSpill_;
 
+  // True if the reclaim only spills the partitions selected by
+  // selectHybridSpillPartitions() and keeps the others in memory.
+  const bool hybridSpill_;
+
   std::shared_ptr<HashJoinBridge> joinBridge_;
 
   tsan_atomic<bool> exceededMaxSpillLevelLimit_{false};
@@ -326,6 +334,22 @@ class HashBuildSpiller : public SpillerBase {
   /// build.
   void spill();
 
+  /// Invoked to spill the rows of 'partitions' stored in the row container of
+  /// the hash build. The rows of the other partitions are kept in memory and
+  /// the spilled rows are erased in place. Must follow a partitionStats() call
+  /// with no row added in between.
+  void spill(const SpillPartitionNumSet& partitions);
+
+  struct PartitionStats {
+    uint64_t numRows{0};
+    uint64_t numBytes{0};
+  };
+
+  /// Returns the number of rows and the row bytes of each spill partition
+  /// stored in the row container of the hash build. Also records the
+  /// partition of each row for the following spill of some partitions.
+  std::vector<PartitionStats> partitionStats();
+
   /// Invoked to spill a given partition from the input vector 'spillVector'.
   void spill(uint32_t partition, const RowVectorPtr& spillVector);
 
@@ -341,8 +365,26 @@ class HashBuildSpiller : public SpillerBase {
     return std::string(kType);
   }
 
+  void clearRowPartitions();
+
   const bool spillProbeFlag_;
+
+  // The spill partition of each row in the row container in the listRows()
+  // order, set by partitionStats() and consumed by spill(partitions).
+  std::vector<uint8_t> rowPartitions_;
 };
+
+/// Selects the partitions to spill from the row containers of the hash build
+/// operators in hybrid spill mode. 'partitionStats' has the number of rows and
+/// bytes of each partition summed over all the hash build operators. The
+/// partitions with the fewest rows per byte are spilled first, the larger ones
+/// first among the partitions of the same density, until at least
+/// 'targetBytes' are selected, or half of the total bytes if 'targetBytes' is
+/// 0. This keeps the most build rows in memory for the bytes retained. Returns
+/// an empty set if all the partitions with rows are selected.
+SpillPartitionNumSet selectHybridSpillPartitions(
+    const std::vector<HashBuildSpiller::PartitionStats>& partitionStats,
+    uint64_t targetBytes);
 } // namespace facebook::velox::exec
 
 template <>
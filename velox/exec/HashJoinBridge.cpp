@@ -83,7 +83,10 @@ void HashJoinBridge::reclaim() {
   buildResult_->table->clear(true);
 
   appendSpilledHashTablePartitionsLocked(std::move(spillPartitionSet));
-  buildResult_->spillPartitionIds = spillPartitionIdSet;
+  // NOTE: the table might have been built from the in-memory partitions of a
+  // hybrid spill, so we keep the partitions spilled before.
+  buildResult_->spillPartitionIds.insert(
+      spillPartitionIdSet.begin(), spillPartitionIdSet.end());
   VELOX_CHECK(!restoringSpillPartitionId_.has_value());
 }
 
@@ -111,7 +114,8 @@ std::unique_ptr<HashBuildSpiller> createSpiller(
 
 std::vector<std::unique_ptr<HashJoinTableSpillResult>> spillHashJoinTable(
     const std::vector<HashBuildSpiller*>& spillers,
-    const common::SpillConfig* spillConfig) {
+    const common::SpillConfig* spillConfig,
+    const SpillPartitionNumSet& partitions) {
   VELOX_CHECK_NOT_NULL(spillConfig);
   auto spillExecutor = spillConfig->executor;
   std::vector<std::shared_ptr<AsyncSource<HashJoinTableSpillResult>>>
@@ -119,9 +123,13 @@ std::vector<std::unique_ptr<HashJoinTableSpillResult>> spillHashJoinTable(
   for (auto* spiller : spillers) {
     spillTasks.push_back(
         memory::createAsyncMemoryReclaimTask<HashJoinTableSpillResult>(
-            [spiller]() {
+            [spiller, &partitions]() {
               try {
-                spiller->spill();
+                if (partitions.empty()) {
+                  spiller->spill();
+                } else {
+                  spiller->spill(partitions);
+                }
                 return std::make_unique<HashJoinTableSpillResult>(spiller);
               } catch (const std::exception& e) {
                 LOG(ERROR) << "Spill from hash join bridge failed: "
@@ -282,6 +290,7 @@ void HashJoinBridge::setAntiJoinHasNullKeys() {
     buildResult_ = HashBuildResult{};
     restoringSpillPartitionId_.reset();
     spillPartitions.swap(spillPartitionSets_);
+    probeSpillBytes_.clear();
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -327,11 +336,23 @@ bool HashJoinBridge::probeFinished() {
 
     if (!spillPartitionSets_.empty()) {
       hasSpillInput = true;
-      restoringSpillPartitionId_ = spillPartitionSets_.begin()->first;
-      restoringSpillShards_ =
-          spillPartitionSets_.begin()->second->split(numBuilders_);
+      auto restoreIt = spillPartitionSets_.begin();
+      uint64_t maxProbeSpillBytes{0};
+      for (auto it = spillPartitionSets_.begin();
+           it != spillPartitionSets_.end();
+           ++it) {
+        const auto bytesIt = probeSpillBytes_.find(it->first);
+        if (bytesIt != probeSpillBytes_.end() &&
+            bytesIt->second > maxProbeSpillBytes) {
+          maxProbeSpillBytes = bytesIt->second;
+          restoreIt = it;
+        }
+      }
+      restoringSpillPartitionId_ = restoreIt->first;
+      restoringSpillShards_ = restoreIt->second->split(numBuilders_);
       VELOX_CHECK_EQ(restoringSpillShards_.size(), numBuilders_);
-      spillPartitionSets_.erase(spillPartitionSets_.begin());
+      probeSpillBytes_.erase(restoreIt->first);
+      spillPartitionSets_.erase(restoreIt);
     }
     promises = std::move(promises_);
   }
@@ -339,6 +360,16 @@ bool HashJoinBridge::probeFinished() {
   return hasSpillInput;
 }
 
+void HashJoinBridge::addProbeSpillBytes(
+    const folly::F14FastMap<SpillPartitionId, uint64_t>& probeSpillBytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(started_);
+  for (const auto& [id, bytes] : probeSpillBytes) {
+    VELOX_CHECK_EQ(spillPartitionSets_.count(id), 1);
+    probeSpillBytes_[id] += bytes;
+  }
+}
+
 std::optional<HashJoinBridge::SpillInput> HashJoinBridge::spillInputOrFuture(
     ContinueFuture* future) {
   std::lock_guard<std::mutex> l(mutex_);
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/exec/HashBitRange.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
@@ -87,9 +89,10 @@ class HashJoinBridge : public JoinBridge {
     /// not built from restoration.
     std::optional<SpillPartitionId> restoredPartitionId;
 
-    /// Spilled partitions while building hash table. Since we don't support
-    /// fine-grained spilling for hash table, either 'table' is empty or
-    /// 'spillPartitionIds' is empty.
+    /// Spilled partitions while building hash table. Unless the hybrid spill
+    /// is enabled, either 'table' is empty or 'spillPartitionIds' is empty.
+    /// With the hybrid spill, 'table' holds the rows of the partitions not in
+    /// 'spillPartitionIds'.
     SpillPartitionIdSet spillPartitionIds;
   };
 
@@ -106,6 +109,14 @@ class HashJoinBridge : public JoinBridge {
   /// HashBuild operators next.
   bool probeFinished();
 
+  /// Invoked by HashProbe operator after it finishes spilling the probe input
+  /// of the spilled table partitions to report the spilled probe bytes of each
+  /// partition. probeFinished() restores the spilled partition with the most
+  /// probe bytes first, so the partitions which produce most of the join
+  /// output are processed first.
+  void addProbeSpillBytes(
+      const folly::F14FastMap<SpillPartitionId, uint64_t>& probeSpillBytes);
+
   /// Contains the spill input for one HashBuild operator: a shard of previously
   /// spilled partition data. 'spillPartition' is null if there is no more spill
   /// data to restore.
@@ -142,7 +153,9 @@ class HashJoinBridge : public JoinBridge {
 
   // restoringSpillPartitionXxx member variables are populated by the
   // bridge itself. When probe side finished processing, the bridge picks the
-  // first partition from 'spillPartitionSets_', splits it into "even" shards
+  // partition with the most spilled probe bytes from 'spillPartitionSets_', or
+  // the first one if there are no probe bytes reported, splits it into "even"
+  // shards
   // among the HashBuild operators and notifies these operators that they can
   // start building HashTables from these shards.
 
@@ -160,6 +173,10 @@ class HashJoinBridge : public JoinBridge {
   // memory and engages in recursive spilling.
   SpillPartitionSet spillPartitionSets_;
 
+  // The spilled probe input bytes of the partitions in 'spillPartitionSets_'
+  // reported by the HashProbe operators.
+  folly::F14FastMap<SpillPartitionId, uint64_t> probeSpillBytes_;
+
   // A flag indicating if any probe operator has poked 'this' join bridge to
   // attempt to get table. It is reset after probe side finish the (sub) table
   // processing.
@@ -222,10 +239,12 @@ struct HashJoinTableSpillResult {
 
 /// Invoked to spill the hash table from a set of spillers. If 'spillExecutor'
 /// is provided, then we do parallel spill. This is used by hash build to spill
-/// a partially built hash join table.
+/// a partially built hash join table. If 'partitions' is not empty, only the
+/// rows of 'partitions' are spilled and the others are kept in the table.
 std::vector<std::unique_ptr<HashJoinTableSpillResult>> spillHashJoinTable(
     const std::vector<HashBuildSpiller*>& spillers,
-    const common::SpillConfig* spillConfig);
+    const common::SpillConfig* spillConfig,
+    const SpillPartitionNumSet& partitions = {});
 
 /// Invoked to spill 'table' and returns spilled partitions. This is used by
 /// hash probe or hash join bridge to spill a fully built table.
@@ -1662,6 +1662,15 @@ void HashProbe::noMoreInputInternal() {
         inputSpiller_->state().spilledPartitionSet().size());
     inputSpiller_->finishSpill(inputSpillPartitionSet_);
     VELOX_CHECK_EQ(spillStats_.rlock()->spillSortTimeNanos, 0);
+
+    folly::F14FastMap<SpillPartitionId, uint64_t> probeSpillBytes;
+    for (const auto& id : spillInputPartitionIds_) {
+      const auto it = inputSpillPartitionSet_.find(id);
+      if (it != inputSpillPartitionSet_.end()) {
+        probeSpillBytes.emplace(id, it->second->size());
+      }
+    }
+    joinBridge_->addProbeSpillBytes(probeSpillBytes);
   }
 
   const bool hasSpillEnabled = canSpill();
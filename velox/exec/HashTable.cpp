@@ -728,7 +728,8 @@ void HashTable<ignoreNullKeys>::allocateTables(
   // cache line.
   const auto numPages =
       memory::AllocationTraits::numPages(size * tableSlotSize());
-  rows_->pool()->allocateContiguous(numPages, tableAllocation_);
+  rows_->pool()->allocateContiguous(
+      numPages, tableAllocation_, /*maxPages=*/0, /*hugeTlb=*/true);
   table_ = tableAllocation_.data<char*>();
   ::memset(table_, 0, capacity_ * sizeof(char*));
 }
@@ -1367,7 +1368,8 @@ void HashTable<ignoreNullKeys>::setHashMode(
   if (mode == HashMode::kArray) {
     const auto bytes = capacity_ * tableSlotSize();
     const auto numPages = memory::AllocationTraits::numPages(bytes);
-    rows_->pool()->allocateContiguous(numPages, tableAllocation_);
+    rows_->pool()->allocateContiguous(
+        numPages, tableAllocation_, /*maxPages=*/0, /*hugeTlb=*/true);
     table_ = tableAllocation_.data<char*>();
     memset(table_, 0, bytes);
     hashMode_ = HashMode::kArray;
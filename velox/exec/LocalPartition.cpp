@@ -16,6 +16,7 @@
 
 #include "velox/exec/LocalPartition.h"
 #include "velox/exec/Task.h"
+#include "velox/vector/BiasEncoding.h"
 
 namespace facebook::velox::exec {
 namespace {
@@ -236,7 +237,9 @@ LocalExchange::LocalExchange(
       queue_{operatorCtx_->task()->getLocalExchangeQueue(
           ctx->splitGroupId,
           planNodeId,
-          partition)} {}
+          partition)},
+      biasDecodeOutput_(
+          ctx->queryConfig().localExchangeBiasEncodingEnabled()) {}
 
 BlockingReason LocalExchange::isBlocked(ContinueFuture* future) {
   if (blockingReason_ != BlockingReason::kNotBlocked) {
@@ -259,6 +262,11 @@ RowVectorPtr LocalExchange::getOutput() {
     auto lockedStats = stats_.wlock();
     lockedStats->addInputVector(data->estimateFlatSize(), data->size());
   }
+  if (biasDecodeOutput_) {
+    // The downstream operators, serializers and functions do not handle bias
+    // encoded vectors.
+    data = biasDecode(data, pool());
+  }
   return data;
 }
 
@@ -283,7 +291,8 @@ LocalPartition::LocalPartition(
           numPartitions_ == 1 ? nullptr
                               : planNode->partitionFunctionSpec().create(
                                     numPartitions_,
-                                    /*localExchange=*/true)) {
+                                    /*localExchange=*/true)),
+      biasEncodeInput_(ctx->queryConfig().localExchangeBiasEncodingEnabled()) {
   VELOX_CHECK(numPartitions_ == 1 || partitionFunction_ != nullptr);
 
   for (auto& queue : queues_) {
@@ -354,6 +363,12 @@ RowVectorPtr LocalPartition::wrapChildren(
 
 void LocalPartition::addInput(RowVectorPtr input) {
   prepareForInput(input);
+  // The input is buffered in the queues. Do not let a selective upstream
+  // filter pin the string buffers of its whole input.
+  input = compactStrings(input);
+  if (biasEncodeInput_) {
+    input = biasEncode(input, pool());
+  }
 
   const auto singlePartition = numPartitions_ == 1
       ? 0
@@ -181,6 +181,9 @@ class LocalExchange : public SourceOperator {
  private:
   const int partition_;
   const std::shared_ptr<LocalExchangeQueue> queue_{nullptr};
+  // If true, the producers may have bias encoded the columns of the vectors in
+  // 'queue_'. They are decoded to flat before they are returned.
+  const bool biasDecodeOutput_;
   ContinueFuture future_;
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 };
@@ -230,6 +233,9 @@ class LocalPartition : public Operator {
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
+  // If true, the narrow range integer columns of the input are bias encoded
+  // before they are enqueued.
+  const bool biasEncodeInput_;
 
   std::vector<BlockingReason> blockingReasons_;
   std::vector<ContinueFuture> futures_;
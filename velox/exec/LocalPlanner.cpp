@@ -443,6 +443,27 @@ bool eagerFlush(const core::PlanNode& node) {
   return eagerFlush(*node.sources()[0]);
 }
 
+// Returns the number of sorted rows needed from the OrderBy at 'index' of
+// 'planNodes' if it is directly followed by a Limit in the same pipeline.
+std::optional<uint64_t> orderByLimit(
+    const std::vector<std::shared_ptr<const core::PlanNode>>& planNodes,
+    int32_t index) {
+  if (index + 1 >= planNodes.size()) {
+    return std::nullopt;
+  }
+  const auto* limit =
+      dynamic_cast<const core::LimitNode*>(planNodes[index + 1].get());
+  if (limit == nullptr || limit->sources()[0] != planNodes[index]) {
+    return std::nullopt;
+  }
+  uint64_t numRows;
+  if (__builtin_add_overflow(limit->offset(), limit->count(), &numRows) ||
+      numRows == 0) {
+    return std::nullopt;
+  }
+  return numRows;
+}
+
 } // namespace
 
 std::shared_ptr<Driver> DriverFactory::createDriver(
@@ -568,8 +589,8 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto orderByNode =
             std::dynamic_pointer_cast<const core::OrderByNode>(planNode)) {
-      operators.push_back(
-          std::make_unique<OrderBy>(id, ctx.get(), orderByNode));
+      operators.push_back(std::make_unique<OrderBy>(
+          id, ctx.get(), orderByNode, orderByLimit(planNodes, i)));
     } else if (
         auto windowNode =
             std::dynamic_pointer_cast<const core::WindowNode>(planNode)) {
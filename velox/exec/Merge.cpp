@@ -33,6 +33,94 @@ std::unique_ptr<VectorSerde::Options> getVectorSerdeOptions(
       common::stringToCompressionKind(queryConfig.shuffleCompressionKind());
   return options;
 }
+
+// Builds the layout of the normalized key prefixes used to compare the merge
+// source rows. Returns std::nullopt if the leading sorting key can't be
+// normalized.
+std::optional<PrefixSortLayout> makePrefixSortLayout(
+    const RowTypePtr& outputType,
+    const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys,
+    const core::QueryConfig& queryConfig) {
+  std::vector<TypePtr> keyTypes;
+  std::vector<CompareFlags> compareFlags;
+  for (const auto& [channel, flags] : sortingKeys) {
+    const auto& type = outputType->childAt(channel);
+    // The byte-wise comparison of the normalized key doesn't apply to the
+    // types with custom comparison. The keys from there on are compared by
+    // value.
+    if (type->providesCustomComparison()) {
+      break;
+    }
+    keyTypes.push_back(type);
+    compareFlags.push_back(flags);
+  }
+  if (keyTypes.empty()) {
+    return std::nullopt;
+  }
+  auto layout = PrefixSortLayout::generate(
+      keyTypes,
+      std::vector<bool>(keyTypes.size(), true),
+      compareFlags,
+      queryConfig.prefixSortNormalizedKeyMaxBytes(),
+      queryConfig.prefixSortMaxStringPrefixLength(),
+      std::vector<std::optional<uint32_t>>(keyTypes.size(), std::nullopt));
+  if (!layout.hasNormalizedKeys) {
+    return std::nullopt;
+  }
+  return layout;
+}
+
+// Encodes the string prefix as 'null byte + string content + padding zeros'
+// with the content and the padding inverted for descending order. This is the
+// same as 'PrefixSortEncoder' but reads the string from a vector instead of a
+// row container.
+FOLLY_ALWAYS_INLINE void encodeStringPrefix(
+    const prefixsort::PrefixSortEncoder& encoder,
+    const std::optional<StringView>& value,
+    char* dest,
+    uint32_t encodeSize) {
+  if (!value.has_value()) {
+    dest[0] = encoder.isNullsFirst() ? 0 : 1;
+    std::memset(dest + 1, 0, encodeSize - 1);
+    return;
+  }
+  dest[0] = encoder.isNullsFirst() ? 1 : 0;
+  ++dest;
+  --encodeSize;
+  const uint32_t copySize = std::min<uint32_t>(value->size(), encodeSize);
+  std::memcpy(dest, value->data(), copySize);
+  std::memset(dest + copySize, 0, encodeSize - copySize);
+  if (!encoder.isAscending()) {
+    for (uint32_t i = 0; i < encodeSize; ++i) {
+      dest[i] = ~dest[i];
+    }
+  }
+}
+
+template <typename T>
+void encodeKeyColumn(
+    const PrefixSortLayout& layout,
+    uint32_t index,
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    uint32_t prefixSize,
+    char* prefixes) {
+  VELOX_DCHECK(layout.normalizedKeyHasNullByte[index]);
+  const auto& encoder = layout.encoders[index];
+  const auto encodeSize = layout.encodeSizes[index];
+  char* dest = prefixes + layout.prefixOffsets[index];
+  for (vector_size_t row = 0; row < numRows; ++row, dest += prefixSize) {
+    std::optional<T> value;
+    if (!decoded.isNullAt(row)) {
+      value = decoded.valueAt<T>(row);
+    }
+    if constexpr (std::is_same_v<T, StringView>) {
+      encodeStringPrefix(encoder, value, dest, encodeSize);
+    } else {
+      encoder.encode(value, dest, encodeSize, true);
+    }
+  }
+}
 } // namespace
 
 Merge::Merge(
@@ -50,7 +138,9 @@ Merge::Merge(
           operatorId,
           planNodeId,
           operatorType),
-      outputBatchSize_{outputBatchRows()} {
+      outputBatchSize_{outputBatchRows()},
+      maxReadAheadBatches_{
+          driverCtx->queryConfig().mergeSourceReadAheadBatches()} {
   auto numKeys = sortingKeys.size();
   sortingKeys_.reserve(numKeys);
   for (int i = 0; i < numKeys; ++i) {
@@ -66,6 +156,8 @@ Merge::Merge(
             sortingOrders[i].isAscending(),
             false});
   }
+  prefixSortLayout_ = makePrefixSortLayout(
+      outputType_, sortingKeys_, driverCtx->queryConfig());
 }
 
 void Merge::initializeTreeOfLosers() {
@@ -73,7 +165,12 @@ void Merge::initializeTreeOfLosers() {
   sourceCursors.reserve(sources_.size());
   for (auto& source : sources_) {
     sourceCursors.push_back(std::make_unique<SourceStream>(
-        source.get(), sortingKeys_, outputBatchSize_));
+        source.get(),
+        sortingKeys_,
+        prefixSortLayout_.has_value() ? &prefixSortLayout_.value() : nullptr,
+        outputBatchSize_,
+        maxReadAheadBatches_,
+        maxReadAheadBytesPerSource_));
   }
 
   // Save the pointers to cursors before moving these into the TreeOfLosers.
@@ -202,7 +299,17 @@ void Merge::close() {
 
 bool SourceStream::operator<(const MergeStream& other) const {
   const auto& otherCursor = static_cast<const SourceStream&>(other);
-  for (auto i = 0; i < sortingKeys_.size(); ++i) {
+  uint32_t startIndex{0};
+  if (prefixSortLayout_ != nullptr) {
+    if (const auto result = std::memcmp(
+            keyPrefix(currentSourceRow_),
+            otherCursor.keyPrefix(otherCursor.currentSourceRow_),
+            keyPrefixSize_)) {
+      return result < 0;
+    }
+    startIndex = prefixSortLayout_->nonPrefixSortStartIndex;
+  }
+  for (auto i = startIndex; i < sortingKeys_.size(); ++i) {
     const auto& [_, compareFlags] = sortingKeys_[i];
     VELOX_DCHECK(
         compareFlags.nullAsValue(), "not supported null handling mode");
@@ -256,28 +363,159 @@ void SourceStream::copyToOutput(RowVectorPtr& output) {
 }
 
 bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
-  ContinueFuture future;
-  auto reason = source_->next(data_, &future);
-  if (reason != BlockingReason::kNotBlocked) {
-    needData_ = true;
-    futures.emplace_back(std::move(future));
-    return true;
+  if (readAhead_.empty() && !sourceAtEnd_) {
+    ContinueFuture future;
+    if (!readFromSource(&future)) {
+      needData_ = true;
+      futures.emplace_back(std::move(future));
+      return true;
+    }
   }
 
-  atEnd_ = !data_ || data_->size() == 0;
   needData_ = false;
   currentSourceRow_ = 0;
+  if (readAhead_.empty()) {
+    VELOX_CHECK(sourceAtEnd_);
+    data_ = nullptr;
+    atEnd_ = true;
+    return false;
+  }
+
+  data_ = std::move(readAhead_.front().first);
+  readAheadBytes_ -= readAhead_.front().second;
+  readAhead_.pop_front();
+  keyColumns_.clear();
+  for (const auto& key : sortingKeys_) {
+    keyColumns_.push_back(data_->childAt(key.first).get());
+  }
+  encodeKeyPrefixes();
+
+  // Fetch the following batches while the merge consumes this one so that
+  // this source is less likely to block the merge at the batch boundary.
+  readAhead();
+  return false;
+}
+
+bool SourceStream::readFromSource(ContinueFuture* future) {
+  RowVectorPtr data;
+  if (source_->next(data, future) != BlockingReason::kNotBlocked) {
+    return false;
+  }
+  if (data == nullptr || data->size() == 0) {
+    sourceAtEnd_ = true;
+    return true;
+  }
+  for (auto& child : data->children()) {
+    child = BaseVector::loadedVectorShared(child);
+  }
+  const uint64_t bytes = data->retainedSize();
+  readAheadBytes_ += bytes;
+  readAhead_.emplace_back(std::move(data), bytes);
+  return true;
+}
 
-  if (!atEnd_) {
-    for (auto& child : data_->children()) {
-      child = BaseVector::loadedVectorShared(child);
+void SourceStream::readAhead() {
+  while (!sourceAtEnd_ && readAhead_.size() < maxReadAheadBatches_ &&
+         readAheadBytes_ < maxReadAheadBytes_) {
+    // NOTE: the future is dropped if the source is blocked as the merge is
+    // not waiting for it. The source is polled again on the next fetch.
+    ContinueFuture future;
+    if (!readFromSource(&future)) {
+      return;
     }
-    keyColumns_.clear();
-    for (const auto& key : sortingKeys_) {
-      keyColumns_.push_back(data_->childAt(key.first).get());
+  }
+}
+
+void SourceStream::encodeKeyPrefixes() {
+  if (prefixSortLayout_ == nullptr) {
+    return;
+  }
+  const auto numRows = data_->size();
+  // The key encoders write all the bytes of the prefixes.
+  prefixes_.resize(static_cast<size_t>(numRows) * keyPrefixSize_);
+  for (auto i = 0; i < prefixSortLayout_->numNormalizedKeys; ++i) {
+    decodedKey_.decode(*keyColumns_[i]);
+    const auto kind = keyColumns_[i]->typeKind();
+    switch (kind) {
+      case TypeKind::SMALLINT:
+        encodeKeyColumn<int16_t>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::INTEGER:
+        encodeKeyColumn<int32_t>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::BIGINT:
+        encodeKeyColumn<int64_t>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::HUGEINT:
+        encodeKeyColumn<int128_t>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::REAL:
+        encodeKeyColumn<float>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::DOUBLE:
+        encodeKeyColumn<double>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::TIMESTAMP:
+        encodeKeyColumn<Timestamp>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      case TypeKind::VARCHAR:
+        [[fallthrough]];
+      case TypeKind::VARBINARY:
+        encodeKeyColumn<StringView>(
+            *prefixSortLayout_,
+            i,
+            decodedKey_,
+            numRows,
+            keyPrefixSize_,
+            prefixes_.data());
+        break;
+      default:
+        VELOX_UNREACHABLE(
+            "Unexpected normalized key type: {}", mapTypeKindToName(kind));
     }
   }
-  return false;
 }
 
 LocalMerge::LocalMerge(
@@ -354,6 +592,9 @@ BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
                   maxMergeExchangeBufferSize / remoteSourceTaskIds_.size(),
                   MergeSource::kMaxQueuedBytesLowerLimit),
               MergeSource::kMaxQueuedBytesUpperLimit);
+          // The decoded batches read ahead from each source share the same
+          // per source memory budget as the exchange client.
+          maxReadAheadBytesPerSource_ = maxQueuedBytesPerSource;
           for (uint32_t remoteSourceIndex = 0;
                remoteSourceIndex < remoteSourceTaskIds_.size();
                ++remoteSourceIndex) {
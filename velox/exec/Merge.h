@@ -17,7 +17,9 @@
 
 #include "velox/exec/Exchange.h"
 #include "velox/exec/MergeSource.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/TreeOfLosers.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace facebook::velox::exec {
 
@@ -55,14 +57,25 @@ class Merge : public SourceOperator {
 
   std::vector<std::shared_ptr<MergeSource>> sources_;
 
+  /// Upper bound on the retained bytes of the batches read ahead from each
+  /// source. Set by the sub-classes with a per source memory budget.
+  uint64_t maxReadAheadBytesPerSource_{std::numeric_limits<uint64_t>::max()};
+
  private:
   void initializeTreeOfLosers();
 
   /// Maximum number of rows in the output batch.
   const vector_size_t outputBatchSize_;
 
+  /// Maximum number of batches to read ahead from each source.
+  const uint32_t maxReadAheadBatches_;
+
   std::vector<std::pair<column_index_t, CompareFlags>> sortingKeys_;
 
+  /// The layout of the normalized key prefixes used to compare the source
+  /// rows. Not set if the leading sorting key can't be normalized.
+  std::optional<PrefixSortLayout> prefixSortLayout_;
+
   /// A list of cursors over batches of ordered source data. One per source.
   /// Aligned with 'sources'.
   std::vector<SourceStream*> streams_;
@@ -84,12 +97,28 @@ class Merge : public SourceOperator {
 
 class SourceStream final : public MergeStream {
  public:
+  /// If not null, 'prefixSortLayout' specifies the normalized key prefixes to
+  /// compare before comparing the sorting key columns. Up to
+  /// 'maxReadAheadBatches' batches with no more than 'maxReadAheadBytes'
+  /// retained bytes are fetched from 'source' ahead of the current batch
+  /// without blocking.
   SourceStream(
       MergeSource* source,
       const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys,
-      uint32_t outputBatchSize)
+      const PrefixSortLayout* prefixSortLayout,
+      uint32_t outputBatchSize,
+      uint32_t maxReadAheadBatches,
+      uint64_t maxReadAheadBytes)
       : source_{source},
         sortingKeys_{sortingKeys},
+        prefixSortLayout_{prefixSortLayout},
+        keyPrefixSize_{
+            prefixSortLayout == nullptr
+                ? 0
+                : prefixSortLayout->normalizedBufferSize -
+                    prefixSortLayout->numPaddingBytes},
+        maxReadAheadBatches_{maxReadAheadBatches},
+        maxReadAheadBytes_{maxReadAheadBytes},
         outputRows_(outputBatchSize, false),
         sourceRows_(outputBatchSize) {
     keyColumns_.reserve(sortingKeys.size());
@@ -133,16 +162,63 @@ class SourceStream final : public MergeStream {
   /// output batch.
   void copyToOutput(RowVectorPtr& output);
 
+  /// Returns the number of batches read ahead from the source.
+  size_t numReadAheadBatches() const {
+    return readAhead_.size();
+  }
+
  private:
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
+  /// Reads the next batch from 'source_' into 'readAhead_'. Returns false and
+  /// sets 'future' if the source is blocked.
+  bool readFromSource(ContinueFuture* future);
+
+  /// Reads ahead from 'source_' until the read-ahead limits are reached or
+  /// the source is blocked.
+  void readAhead();
+
+  /// Encodes the normalized key prefixes of the rows in 'data_'.
+  void encodeKeyPrefixes();
+
+  const char* keyPrefix(vector_size_t row) const {
+    return prefixes_.data() + row * keyPrefixSize_;
+  }
+
   MergeSource* source_;
 
   const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys_;
 
+  const PrefixSortLayout* const prefixSortLayout_;
+
+  /// The byte size of the normalized key prefix of a row. Excludes the padding
+  /// that 'prefixSortLayout_' adds to align its rows.
+  const uint32_t keyPrefixSize_;
+
+  const uint32_t maxReadAheadBatches_;
+
+  const uint64_t maxReadAheadBytes_;
+
   /// Ordered source rows.
   RowVectorPtr data_;
 
+  /// Batches fetched from the source ahead of 'data_' along with their
+  /// retained bytes.
+  std::deque<std::pair<RowVectorPtr, uint64_t>> readAhead_;
+
+  /// Total retained bytes of the batches in 'readAhead_'.
+  uint64_t readAheadBytes_{0};
+
+  /// True if the source has no more batches to read.
+  bool sourceAtEnd_{false};
+
+  /// Normalized key prefixes of the rows in 'data_' if 'prefixSortLayout_' is
+  /// set.
+  std::vector<char> prefixes_;
+
+  /// Reusable decoded key column used to encode the key prefixes.
+  DecodedVector decodedKey_;
+
   /// Raw pointers to vectors corresponding to sorting key columns in the same
   /// order as 'sortingKeys_'.
   std::vector<BaseVector*> keyColumns_;
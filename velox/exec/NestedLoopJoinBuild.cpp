@@ -58,7 +58,7 @@ void NestedLoopJoinBuild::addInput(RowVectorPtr input) {
     for (auto& child : input->children()) {
       child->loadedVector();
     }
-    dataVectors_.emplace_back(std::move(input));
+    dataVectors_.emplace_back(compactStrings(input));
   }
 }
 
@@ -22,6 +22,7 @@
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/TraceUtil.h"
 #include "velox/expression/Expr.h"
+#include "velox/vector/StringCompaction.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -364,6 +365,28 @@ vector_size_t Operator::outputBatchRows(
   return std::max<vector_size_t>(batchSize, 1);
 }
 
+RowVectorPtr Operator::compactStrings(const RowVectorPtr& input) {
+  const auto& queryConfig = operatorCtx_->task()->queryCtx()->queryConfig();
+  const StringCompactionOptions options{
+      .minLiveRatio = queryConfig.stringCompactionMinLiveRatio(),
+      .minHeldBytes = queryConfig.stringCompactionMinHeldBytes()};
+  StringCompactionStats compactionStats;
+  auto result =
+      velox::compactStrings(input, options, pool(), &compactionStats);
+  if (compactionStats.numCompactedVectors > 0) {
+    addRuntimeStat(
+        kStringCompactionReleasedBytes,
+        RuntimeCounter(
+            compactionStats.heldBytes - compactionStats.liveBytes,
+            RuntimeCounter::Unit::kBytes));
+    addRuntimeStat(
+        kStringCompactionCopiedBytes,
+        RuntimeCounter(
+            compactionStats.liveBytes, RuntimeCounter::Unit::kBytes));
+  }
+  return result;
+}
+
 void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
@@ -436,6 +459,14 @@ void Operator::recordSpillStats() {
             static_cast<int64_t>(lockedSpillStats->spillWriteTimeNanos),
             RuntimeCounter::Unit::kNanos});
   }
+  if (lockedSpillStats->spillWriteQueueWaitTimeNanos != 0) {
+    lockedStats->addRuntimeStat(
+        kSpillWriteQueueWaitTime,
+        RuntimeCounter{
+            static_cast<int64_t>(
+                lockedSpillStats->spillWriteQueueWaitTimeNanos),
+            RuntimeCounter::Unit::kNanos});
+  }
   if (lockedSpillStats->spillRuns != 0) {
     lockedStats->addRuntimeStat(
         kSpillRuns,
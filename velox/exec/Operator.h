@@ -169,6 +169,8 @@ class Operator : public BaseRuntimeStatWriter {
   static inline const std::string kSpillFlushTime{"spillFlushWallNanos"};
   static inline const std::string kSpillWrites{"spillWrites"};
   static inline const std::string kSpillWriteTime{"spillWriteWallNanos"};
+  static inline const std::string kSpillWriteQueueWaitTime{
+      "spillWriteQueueWaitWallNanos"};
   static inline const std::string kSpillRuns{"spillRuns"};
   static inline const std::string kExceededMaxSpillLevel{
       "exceededMaxSpillLevel"};
@@ -188,6 +190,13 @@ class Operator : public BaseRuntimeStatWriter {
   static inline const std::string kShuffleCompressionKind{
       "shuffleCompressionKind"};
 
+  /// The bytes of string buffers released and the bytes of strings copied by
+  /// the string compaction of the buffered input vectors.
+  static inline const std::string kStringCompactionReleasedBytes{
+      "stringCompactionReleasedBytes"};
+  static inline const std::string kStringCompactionCopiedBytes{
+      "stringCompactionCopiedBytes"};
+
   /// 'operatorId' is the initial index of the 'this' in the Driver's list of
   /// Operators. This is used as in index into OperatorStats arrays in the Task.
   /// 'planNodeId' is a query-level unique identifier of the PlanNode to which
@@ -589,6 +598,11 @@ class Operator : public BaseRuntimeStatWriter {
   vector_size_t outputBatchRows(
       std::optional<uint64_t> averageRowSize = std::nullopt) const;
 
+  /// Invoked by an operator which buffers 'input' to copy its string columns
+  /// into tight string buffers if they hold much more string memory than they
+  /// reference. See 'compactStrings' in velox/vector/StringCompaction.h.
+  RowVectorPtr compactStrings(const RowVectorPtr& input);
+
   /// Invoked to record spill stats in operator stats.
   virtual void recordSpillStats();
 
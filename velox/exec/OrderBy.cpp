@@ -33,7 +33,8 @@ CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
 OrderBy::OrderBy(
     int32_t operatorId,
     DriverCtx* driverCtx,
-    const std::shared_ptr<const core::OrderByNode>& orderByNode)
+    const std::shared_ptr<const core::OrderByNode>& orderByNode,
+    std::optional<uint64_t> limit)
     : Operator(
           driverCtx,
           orderByNode->outputType(),
@@ -67,7 +68,8 @@ OrderBy::OrderBy(
       &nonReclaimableSection_,
       driverCtx->prefixSortConfig(),
       spillConfig_.has_value() ? &(spillConfig_.value()) : nullptr,
-      &spillStats_);
+      &spillStats_,
+      limit);
 }
 
 void OrderBy::addInput(RowVectorPtr input) {
@@ -92,6 +94,10 @@ void OrderBy::noMoreInput() {
   Operator::noMoreInput();
   sortBuffer_->noMoreInput();
   maxOutputRows_ = outputBatchRows(sortBuffer_->estimateOutputRowSize());
+  const auto numDroppedRows = sortBuffer_->numBoundedDroppedRows();
+  if (numDroppedRows > 0) {
+    addRuntimeStat(kBoundedSortDroppedRows, RuntimeCounter(numDroppedRows));
+  }
 }
 
 RowVectorPtr OrderBy::getOutput() {
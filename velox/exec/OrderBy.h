@@ -31,12 +31,21 @@ namespace facebook::velox::exec {
 /// Limitations:
 /// * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 /// output.
+///
+/// If 'limit' is set, e.g. the OrderBy is followed by a Limit, only the first
+/// 'limit' sorted rows are output, and the spilled sorted runs are bounded to
+/// 'limit' rows.
 class OrderBy : public Operator {
  public:
+  /// The number of input rows dropped by the bounded sort.
+  static inline const std::string kBoundedSortDroppedRows{
+      "boundedSortDroppedRows"};
+
   OrderBy(
       int32_t operatorId,
       DriverCtx* driverCtx,
-      const std::shared_ptr<const core::OrderByNode>& orderByNode);
+      const std::shared_ptr<const core::OrderByNode>& orderByNode,
+      std::optional<uint64_t> limit = std::nullopt);
 
   bool needsInput() const override {
     return !finished_;
@@ -108,6 +108,26 @@ void DestinationBuffer::Stats::recordDelete(const SerializedPage& data) {
   recordAcknowledge(data);
 }
 
+void DestinationBuffer::Stats::recordDelete(
+    int64_t bytes,
+    int64_t rows,
+    int64_t pages) {
+  bytesBuffered -= bytes;
+  VELOX_DCHECK_GE(bytesBuffered, 0, "bytesBuffered must be non-negative");
+  rowsBuffered -= rows;
+  VELOX_DCHECK_GE(rowsBuffered, 0, "rowsBuffered must be non-negative");
+  pagesBuffered -= pages;
+  VELOX_DCHECK_GE(pagesBuffered, 0, "pagesBuffered must be non-negative");
+  bytesSent += bytes;
+  rowsSent += rows;
+  pagesSent += pages;
+}
+
+void DestinationBuffer::Stats::recordSpill(int64_t bytes, int64_t pages) {
+  bytesSpilled += bytes;
+  pagesSpilled += pages;
+}
+
 DestinationBuffer::Data DestinationBuffer::getData(
     uint64_t maxBytes,
     int64_t sequence,
@@ -119,6 +139,7 @@ DestinationBuffer::Data DestinationBuffer::getData(
   if (arbitraryBuffer != nullptr) {
     loadData(arbitraryBuffer, maxBytes);
   }
+  moveLoadedPages();
 
   if (sequence - sequence_ >= data_.size()) {
     if (sequence - sequence_ > data_.size()) {
@@ -131,9 +152,16 @@ DestinationBuffer::Data DestinationBuffer::getData(
       if (arbitraryBuffer) {
         arbitraryBuffer->getAvailablePageSizes(remainingBytes);
       }
+      appendSpilledPageSizes(remainingBytes);
       if (!remainingBytes.empty()) {
         return {{}, std::move(remainingBytes), true};
       }
+    } else if (hasSpilledData() && !spiller_->ioInProgress()) {
+      // The spilled pages have to be read back outside of the output buffer
+      // lock, so returns their sizes for the consumer to fetch them again.
+      std::vector<int64_t> remainingBytes;
+      appendSpilledPageSizes(remainingBytes);
+      return {{}, std::move(remainingBytes), true};
     }
     notify_ = std::move(notify);
     aliveCheck_ = std::move(activeCheck);
@@ -165,6 +193,8 @@ DestinationBuffer::Data DestinationBuffer::getData(
       }
     }
   }
+  fetchedSequence_ =
+      std::max<int64_t>(fetchedSequence_, sequence + data.size());
   bool atEnd = false;
   std::vector<int64_t> remainingBytes;
   remainingBytes.reserve(data_.size() - i);
@@ -179,6 +209,9 @@ DestinationBuffer::Data DestinationBuffer::getData(
   if (!atEnd && arbitraryBuffer) {
     arbitraryBuffer->getAvailablePageSizes(remainingBytes);
   }
+  if (!atEnd) {
+    appendSpilledPageSizes(remainingBytes);
+  }
   if (data.empty() && remainingBytes.empty() && atEnd) {
     data.push_back(nullptr);
   }
@@ -187,16 +220,160 @@ DestinationBuffer::Data DestinationBuffer::getData(
 
 void DestinationBuffer::enqueue(std::shared_ptr<SerializedPage> data) {
   // Drop duplicate end markers.
-  if (data == nullptr && !data_.empty() && data_.back() == nullptr) {
+  if (data == nullptr &&
+      ((!pendingData_.empty() && pendingData_.back() == nullptr) ||
+       (!data_.empty() && data_.back() == nullptr))) {
     return;
   }
 
   if (data != nullptr) {
     stats_.recordEnqueue(*data);
   }
+  if (hasSpilledData()) {
+    // Keeps the FIFO order by holding the page behind the spilled pages until
+    // they have all been read back.
+    pendingData_.push_back(std::move(data));
+    return;
+  }
   data_.push_back(std::move(data));
 }
 
+std::optional<DestinationBuffer::SpillBatch> DestinationBuffer::startSpill(
+    const std::function<std::shared_ptr<SerializedPageSpiller>()>&
+        spillerFactory) {
+  if (spiller_ != nullptr && spiller_->ioInProgress()) {
+    return std::nullopt;
+  }
+  if (!hasSpilledData()) {
+    // Nothing is on disk, so the pages which haven't been fetched are
+    // spillable. They are moved to the front of 'pendingData_' which follows
+    // the (empty) spilled pages.
+    movePendingData();
+    const int64_t firstSpillIndex =
+        std::max<int64_t>(fetchedSequence_ - sequence_, 0);
+    if (firstSpillIndex >= static_cast<int64_t>(data_.size())) {
+      return std::nullopt;
+    }
+    for (auto i = firstSpillIndex; i < data_.size(); ++i) {
+      pendingData_.push_back(std::move(data_[i]));
+    }
+    data_.resize(firstSpillIndex);
+  }
+
+  SpillBatch batch;
+  std::vector<const SerializedPage*> pages;
+  while (!pendingData_.empty() && pendingData_.front() != nullptr) {
+    pages.push_back(pendingData_.front().get());
+    batch.pages.push_back(std::move(pendingData_.front()));
+    pendingData_.pop_front();
+  }
+  if (pages.empty()) {
+    if (!hasSpilledData()) {
+      movePendingData();
+    }
+    return std::nullopt;
+  }
+  if (spiller_ == nullptr) {
+    spiller_ = spillerFactory();
+  }
+  auto writeBatch = spiller_->startWrite(pages);
+  VELOX_CHECK(writeBatch.has_value());
+  batch.spiller = spiller_;
+  batch.writeBatch = std::move(writeBatch.value());
+  return batch;
+}
+
+uint64_t DestinationBuffer::finishSpill(SpillBatch& batch) {
+  if (batch.spiller != spiller_) {
+    return 0;
+  }
+  const auto spilledBytes = spiller_->finishWrite(batch.writeBatch);
+  if (spilledBytes > 0) {
+    stats_.recordSpill(spilledBytes, batch.pages.size());
+  }
+  return spilledBytes;
+}
+
+void DestinationBuffer::abortSpill(SpillBatch& batch) {
+  if (batch.spiller != spiller_ || !spiller_->abortWrite(batch.writeBatch)) {
+    return;
+  }
+  for (auto it = batch.pages.rbegin(); it != batch.pages.rend(); ++it) {
+    pendingData_.push_front(std::move(*it));
+  }
+  batch.pages.clear();
+  if (!hasSpilledData()) {
+    movePendingData();
+  }
+}
+
+std::optional<DestinationBuffer::UnspillBatch> DestinationBuffer::startUnspill(
+    int64_t sequence,
+    uint64_t maxBytes) {
+  moveLoadedPages();
+  if (!hasSpilledData()) {
+    return std::nullopt;
+  }
+  uint64_t availableBytes{0};
+  for (auto i = std::max<int64_t>(sequence - sequence_, 0); i < data_.size();
+       ++i) {
+    availableBytes += data_[i]->size();
+  }
+  if (availableBytes >= maxBytes) {
+    return std::nullopt;
+  }
+  auto readBatch = spiller_->startRead(maxBytes - availableBytes);
+  if (!readBatch.has_value()) {
+    return std::nullopt;
+  }
+  return UnspillBatch{spiller_, std::move(readBatch.value())};
+}
+
+void DestinationBuffer::finishUnspill(UnspillBatch& batch) {
+  if (batch.spiller == spiller_) {
+    spiller_->finishRead(batch.readBatch);
+  }
+}
+
+void DestinationBuffer::abortUnspill(UnspillBatch& batch) {
+  if (batch.spiller == spiller_) {
+    spiller_->abortRead(batch.readBatch);
+  }
+}
+
+void DestinationBuffer::moveLoadedPages() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  VELOX_CHECK(!hasSpilledData() || data_.empty() || data_.back() != nullptr);
+  while (spiller_->hasLoadedFront()) {
+    data_.push_back(spiller_->popFront());
+  }
+  if (!hasSpilledData()) {
+    movePendingData();
+  }
+}
+
+void DestinationBuffer::movePendingData() {
+  VELOX_CHECK(!hasSpilledData());
+  while (!pendingData_.empty()) {
+    data_.push_back(std::move(pendingData_.front()));
+    pendingData_.pop_front();
+  }
+}
+
+void DestinationBuffer::appendSpilledPageSizes(
+    std::vector<int64_t>& remainingBytes) const {
+  if (spiller_ != nullptr) {
+    spiller_->appendPageSizes(remainingBytes);
+  }
+  for (const auto& page : pendingData_) {
+    if (page != nullptr) {
+      remainingBytes.push_back(page->size());
+    }
+  }
+}
+
 DataAvailable DestinationBuffer::getAndClearNotify() {
   if (notify_ == nullptr) {
     VELOX_CHECK_NULL(aliveCheck_);
@@ -294,6 +471,20 @@ DestinationBuffer::deleteResults() {
     freed.push_back(std::move(data_[i]));
   }
   data_.clear();
+  if (spiller_ != nullptr) {
+    const int64_t spilledBytes = spiller_->spilledBytes();
+    const int64_t spilledPages = spiller_->numPages();
+    const int64_t spilledRows = spiller_->clear();
+    stats_.recordDelete(spilledBytes, spilledRows, spilledPages);
+    spiller_.reset();
+  }
+  for (auto& page : pendingData_) {
+    if (page != nullptr) {
+      stats_.recordDelete(*page);
+      freed.push_back(std::move(page));
+    }
+  }
+  pendingData_.clear();
   return freed;
 }
 
@@ -304,7 +495,8 @@ DestinationBuffer::Stats DestinationBuffer::stats() const {
 std::string DestinationBuffer::toString() {
   std::stringstream out;
   out << "[available: " << data_.size() << ", " << "sequence: " << sequence_
-      << ", " << (notify_ ? "notify registered, " : "") << this << "]";
+      << ", " << (notify_ ? "notify registered, " : "")
+      << (hasSpilledData() ? spiller_->toString() + ", " : "") << this << "]";
   return out.str();
 }
 
@@ -335,7 +527,15 @@ OutputBuffer::OutputBuffer(
       continueSize_((maxSize_ * kContinuePct) / 100),
       arbitraryBuffer_(
           isArbitrary() ? std::make_unique<ArbitraryBuffer>() : nullptr),
+      spillConfig_(
+          isPartitioned() &&
+                  task_->queryCtx()->queryConfig().outputBufferSpillEnabled()
+              ? task_->makeSerializedPageSpillConfig("output")
+              : std::nullopt),
       numDrivers_(numDrivers) {
+  if (spillConfig_.has_value()) {
+    spillPool_ = task_->pool()->addLeafChild("outputBuffer.spill");
+  }
   buffers_.reserve(numDestinations);
   for (int i = 0; i < numDestinations; i++) {
     buffers_.push_back(std::make_unique<DestinationBuffer>());
@@ -721,6 +921,7 @@ void OutputBuffer::getData(
   DestinationBuffer::Data data;
   std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
+  std::optional<DestinationBuffer::UnspillBatch> unspillBatch;
   {
     std::lock_guard<std::mutex> l(mutex_);
 
@@ -733,8 +934,11 @@ void OutputBuffer::getData(
     if (buffer) {
       freed = buffer->acknowledge(sequence, true);
       updateAfterAcknowledgeLocked(freed, promises);
-      data = buffer->getData(
-          maxBytes, sequence, notify, activeCheck, arbitraryBuffer_.get());
+      unspillBatch = buffer->startUnspill(sequence, maxBytes);
+      if (!unspillBatch.has_value()) {
+        data = buffer->getData(
+            maxBytes, sequence, notify, activeCheck, arbitraryBuffer_.get());
+      }
     } else {
       data.data.emplace_back(nullptr);
       data.immediate = true;
@@ -743,11 +947,154 @@ void OutputBuffer::getData(
     }
   }
   releaseAfterAcknowledge(freed, promises);
+
+  if (unspillBatch.has_value()) {
+    getDataAfterUnspill(
+        destination,
+        maxBytes,
+        sequence,
+        std::move(notify),
+        std::move(activeCheck),
+        unspillBatch.value());
+    return;
+  }
+  if (data.immediate) {
+    notify(std::move(data.data), sequence, std::move(data.remainingBytes));
+  }
+}
+
+void OutputBuffer::getDataAfterUnspill(
+    int destination,
+    uint64_t maxBytes,
+    int64_t sequence,
+    DataAvailableCallback notify,
+    DataConsumerActiveCheckCallback activeCheck,
+    DestinationBuffer::UnspillBatch& unspillBatch) {
+  // Reads back the spilled pages without holding 'mutex_'.
+  try {
+    unspillBatch.spiller->read(unspillBatch.readBatch);
+  } catch (...) {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto* buffer = buffers_[destination].get();
+    if (buffer != nullptr) {
+      buffer->abortUnspill(unspillBatch);
+    }
+    throw;
+  }
+
+  DestinationBuffer::Data data;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto* buffer = buffers_[destination].get();
+    if (buffer) {
+      buffer->finishUnspill(unspillBatch);
+      data = buffer->getData(
+          maxBytes, sequence, notify, activeCheck, arbitraryBuffer_.get());
+    } else {
+      data.data.emplace_back(nullptr);
+      data.immediate = true;
+    }
+  }
   if (data.immediate) {
     notify(std::move(data.data), sequence, std::move(data.remainingBytes));
   }
 }
 
+uint64_t OutputBuffer::spill() {
+  if (!canSpill()) {
+    return 0;
+  }
+  VELOX_CHECK(isPartitioned());
+  struct SpillJob {
+    int destination;
+    DestinationBuffer::SpillBatch batch;
+  };
+  std::vector<SpillJob> jobs;
+  {
+    std::unique_lock<std::mutex> l(mutex_, std::try_to_lock);
+    if (!l.owns_lock()) {
+      return 0;
+    }
+    for (auto i = 0; i < buffers_.size(); ++i) {
+      auto* buffer = buffers_[i].get();
+      if (buffer == nullptr) {
+        continue;
+      }
+      auto batch = buffer->startSpill([&]() {
+        return std::make_shared<SerializedPageSpiller>(
+            &spillConfig_.value(),
+            fmt::format("destination-{}", i),
+            spillPool_,
+            &spillStats_);
+      });
+      if (batch.has_value()) {
+        jobs.push_back({i, std::move(batch.value())});
+      }
+    }
+  }
+  if (jobs.empty()) {
+    return 0;
+  }
+
+  // Writes the pages without holding 'mutex_'. The consumers keep fetching
+  // the pages in memory meanwhile.
+  size_t numWritten{0};
+  try {
+    for (; numWritten < jobs.size(); ++numWritten) {
+      auto& batch = jobs[numWritten].batch;
+      batch.spiller->write(batch.writeBatch);
+    }
+  } catch (...) {
+    // Puts back the pages which haven't been written, and publishes the ones
+    // which have.
+    std::vector<DataAvailable> dataAvailableCbs;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      for (size_t i = 0; i < jobs.size(); ++i) {
+        auto* buffer = buffers_[jobs[i].destination].get();
+        if (buffer == nullptr) {
+          continue;
+        }
+        if (i < numWritten) {
+          buffer->finishSpill(jobs[i].batch);
+        } else {
+          buffer->abortSpill(jobs[i].batch);
+        }
+        dataAvailableCbs.emplace_back(buffer->getAndClearNotify());
+      }
+    }
+    jobs.clear();
+    for (auto& callback : dataAvailableCbs) {
+      callback.notify();
+    }
+    throw;
+  }
+
+  uint64_t spilledBytes{0};
+  std::vector<DataAvailable> dataAvailableCbs;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& job : jobs) {
+      auto* buffer = buffers_[job.destination].get();
+      if (buffer == nullptr) {
+        continue;
+      }
+      spilledBytes += buffer->finishSpill(job.batch);
+      // Wakes up the consumer waiting for the pages under spill.
+      dataAvailableCbs.emplace_back(buffer->getAndClearNotify());
+    }
+    if (spilledBytes > 0) {
+      ++spillStats_.wlock()->spillRuns;
+    }
+  }
+  // Frees the spilled pages outside of 'mutex_'.
+  jobs.clear();
+  for (auto& callback : dataAvailableCbs) {
+    callback.notify();
+  }
+  return spilledBytes;
+}
+
 void OutputBuffer::terminate() {
   VELOX_CHECK(!task_->isRunning());
 
@@ -17,6 +17,7 @@
 
 #include "velox/core/PlanNode.h"
 #include "velox/exec/ExchangeQueue.h"
+#include "velox/exec/SerializedPageSpiller.h"
 
 namespace facebook::velox::exec {
 
@@ -104,6 +105,12 @@ class DestinationBuffer {
 
     void recordDelete(const SerializedPage& data);
 
+    /// Records the deletion of the spilled data which has never been read
+    /// back.
+    void recordDelete(int64_t bytes, int64_t rows, int64_t pages);
+
+    void recordSpill(int64_t bytes, int64_t pages);
+
     bool finished{false};
 
     /// Number of buffered bytes / rows / pages.
@@ -115,6 +122,10 @@ class DestinationBuffer {
     int64_t bytesSent{0};
     int64_t rowsSent{0};
     int64_t pagesSent{0};
+
+    /// Number of bytes / pages spilled to disk under memory pressure.
+    int64_t bytesSpilled{0};
+    int64_t pagesSpilled{0};
   };
 
   void enqueue(std::shared_ptr<SerializedPage> data);
@@ -172,6 +183,53 @@ class DestinationBuffer {
   /// Removes all remaining data from the queue and returns the removed data.
   std::vector<std::shared_ptr<SerializedPage>> deleteResults();
 
+  /// The pages moved out of the buffer by startSpill() to write to disk.
+  struct SpillBatch {
+    std::shared_ptr<SerializedPageSpiller> spiller;
+    std::vector<std::shared_ptr<SerializedPage>> pages;
+    SerializedPageSpiller::WriteBatch writeBatch;
+  };
+
+  /// Moves the buffered pages which haven't been fetched by the consumer out
+  /// of the buffer to spill them to disk with 'SpillBatch::spiller' without
+  /// holding the output buffer lock. 'spillerFactory' is used to create the
+  /// spiller on the first spill. Once there are spilled pages, the
+  /// subsequently enqueued pages are held behind them until all the spilled
+  /// pages have been read back to keep the FIFO order. Those are spilled by
+  /// the next spill. Returns std::nullopt if there is nothing to spill or
+  /// there is a spill IO in progress.
+  ///
+  /// NOTE: this can't be used for broadcast output as the pages are shared
+  /// among the destination buffers.
+  std::optional<SpillBatch> startSpill(
+      const std::function<std::shared_ptr<SerializedPageSpiller>()>&
+          spillerFactory);
+
+  /// Publishes the pages written by 'batch'. Returns the number of spilled
+  /// bytes.
+  uint64_t finishSpill(SpillBatch& batch);
+
+  /// Puts the pages of 'batch' back after a failed write.
+  void abortSpill(SpillBatch& batch);
+
+  /// The spilled pages reserved by startUnspill() to read back from disk.
+  struct UnspillBatch {
+    std::shared_ptr<SerializedPageSpiller> spiller;
+    SerializedPageSpiller::ReadBatch readBatch;
+  };
+
+  /// Reserves the spilled pages to read back from disk without holding the
+  /// output buffer lock for a getData() of 'maxBytes' from 'sequence'.
+  /// Returns std::nullopt if the pages in memory are enough or there is
+  /// nothing to read back.
+  std::optional<UnspillBatch> startUnspill(int64_t sequence, uint64_t maxBytes);
+
+  /// Publishes the pages read back by 'batch'.
+  void finishUnspill(UnspillBatch& batch);
+
+  /// Puts the pages of 'batch' back on disk after a failed read.
+  void abortUnspill(UnspillBatch& batch);
+
   /// Returns and clears the notify callback, if any, along with arguments for
   /// the callback.
   DataAvailable getAndClearNotify();
@@ -187,9 +245,34 @@ class DestinationBuffer {
  private:
   void clearNotify();
 
+  bool hasSpilledData() const {
+    return spiller_ != nullptr && !spiller_->empty();
+  }
+
+  // Moves the spilled pages which have been read back to 'data_', followed by
+  // 'pendingData_' once all the spilled pages have been read back.
+  void moveLoadedPages();
+
+  // Moves 'pendingData_' to the end of 'data_'. There must be no spilled
+  // page.
+  void movePendingData();
+
+  // Appends the sizes of the pages following 'data_' to 'remainingBytes'.
+  void appendSpilledPageSizes(std::vector<int64_t>& remainingBytes) const;
+
   std::vector<std::shared_ptr<SerializedPage>> data_;
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
+  // The sequence number following the last page returned by getData. The
+  // pages before it might be fetched again by the consumer so they are not
+  // spillable.
+  int64_t fetchedSequence_{0};
+  // Holds the spilled pages which logically follow the pages in 'data_'.
+  std::shared_ptr<SerializedPageSpiller> spiller_;
+  // The pages, including the end marker, enqueued while there are spilled
+  // pages. They logically follow the spilled pages and are moved to 'data_'
+  // once all the spilled pages have been read back.
+  std::deque<std::shared_ptr<SerializedPage>> pendingData_;
   DataAvailableCallback notify_{nullptr};
   DataConsumerActiveCheckCallback aliveCheck_{nullptr};
   // The sequence number of the first item to pass to 'notify'.
@@ -324,6 +407,25 @@ class OutputBuffer {
   /// Gets the Stats of this output buffer.
   Stats stats();
 
+  /// Returns true if the buffered pages can be spilled to disk under memory
+  /// pressure.
+  bool canSpill() const {
+    return spillConfig_.has_value();
+  }
+
+  /// Spills the buffered pages which haven't been fetched by the consumers to
+  /// disk. The pages are moved out under 'mutex_' and written without holding
+  /// it. Returns the number of spilled bytes.
+  ///
+  /// NOTE: this is invoked by memory arbitration and it skips spilling if
+  /// 'mutex_' is held by a concurrent buffer operation which might be the one
+  /// triggering the memory arbitration.
+  uint64_t spill();
+
+  common::SpillStats spillStats() const {
+    return spillStats_.copy();
+  }
+
  private:
   // Percentage of maxSize below which a blocked producer should
   // be unblocked.
@@ -342,6 +444,16 @@ class OutputBuffer {
   // updating the total number of drivers, we don't.
   void checkIfDone(bool oneDriverFinished);
 
+  // Reads back the spilled pages reserved by 'unspillBatch' without holding
+  // 'mutex_' and then gets the data for the consumer.
+  void getDataAfterUnspill(
+      int destination,
+      uint64_t maxBytes,
+      int64_t sequence,
+      DataAvailableCallback notify,
+      DataConsumerActiveCheckCallback activeCheck,
+      DestinationBuffer::UnspillBatch& unspillBatch);
+
   // Updates buffered size and returns possibly continuable producer promises
   // in 'promises'.
   void updateAfterAcknowledgeLocked(
@@ -388,6 +500,13 @@ class OutputBuffer {
   // resumed.
   const uint64_t continueSize_;
   const std::unique_ptr<ArbitraryBuffer> arbitraryBuffer_;
+  // Set if the buffered pages can be spilled to disk. This only applies for
+  // partitioned output buffer type.
+  const std::optional<common::SpillConfig> spillConfig_;
+  // Used to allocate the memory for the spilled pages read back from disk.
+  // Set if spilling is enabled.
+  std::shared_ptr<memory::MemoryPool> spillPool_;
+  folly::Synchronized<common::SpillStats> spillStats_;
 
   // Total number of drivers expected to produce results. This number will
   // decrease in the end of grouped execution, when we understand the real
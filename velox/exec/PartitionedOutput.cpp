@@ -201,6 +201,10 @@ PartitionedOutput::PartitionedOutput(
                             ->queryConfig()
                             .maxPartitionedOutputBufferSize()),
       eagerFlush_(eagerFlush),
+      outputBufferSpillEnabled_(
+          planNode->isPartitioned() &&
+          ctx->task->queryCtx()->queryConfig().outputBufferSpillEnabled() &&
+          ctx->makeSpillConfig(operatorId).has_value()),
       serde_(getNamedVectorSerde(planNode->serdeKind())),
       serdeOptions_(getVectorSerdeOptions(
           operatorCtx_->driverCtx()->queryConfig(),
@@ -489,4 +493,24 @@ void PartitionedOutput::close() {
   destinations_.clear();
 }
 
+void PartitionedOutput::reclaim(
+    uint64_t /*targetBytes*/,
+    memory::MemoryReclaimer::Stats& /*stats*/) {
+  VELOX_CHECK(canReclaim());
+  auto bufferManager = bufferManager_.lock();
+  if (bufferManager == nullptr) {
+    return;
+  }
+  auto buffer = bufferManager->getBufferIfExists(taskId());
+  if (buffer == nullptr) {
+    return;
+  }
+  const auto spilledBytes = buffer->spill();
+  if (spilledBytes > 0) {
+    addRuntimeStat(
+        "outputBufferSpilledBytes",
+        RuntimeCounter(spilledBytes, RuntimeCounter::Unit::kBytes));
+  }
+}
+
 } // namespace facebook::velox::exec
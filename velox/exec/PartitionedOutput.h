@@ -185,6 +185,15 @@ class PartitionedOutput : public Operator {
 
   void close() override;
 
+  /// Returns true if the output buffer of the task can spill the pages which
+  /// haven't been fetched by the consumers under memory pressure.
+  bool canReclaim() const override {
+    return outputBufferSpillEnabled_;
+  }
+
+  void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
+      override;
+
   static void testingSetMinCompressionRatio(float ratio) {
     minCompressionRatio_ = ratio;
   }
@@ -219,6 +228,7 @@ class PartitionedOutput : public Operator {
   const std::function<void()> bufferReleaseFn_;
   const int64_t maxBufferedBytes_;
   const bool eagerFlush_;
+  const bool outputBufferSpillEnabled_;
   VectorSerde* const serde_;
   const std::unique_ptr<VectorSerde::Options> serdeOptions_;
 
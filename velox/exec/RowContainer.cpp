@@ -56,6 +56,7 @@ Accumulator::Accumulator(Aggregate* aggregate, TypePtr spillType)
       fixedSize_{aggregate->accumulatorFixedWidthSize()},
       usesExternalMemory_{aggregate->accumulatorUsesExternalMemory()},
       alignment_{aggregate->accumulatorAlignmentSize()},
+      supportsCompaction_{aggregate->supportsCompaction()},
       spillType_{std::move(spillType)},
       spillExtractFunction_{
           [aggregate](folly::Range<char**> groups, VectorPtr& result) {
@@ -64,6 +65,11 @@ Accumulator::Accumulator(Aggregate* aggregate, TypePtr spillType)
           }},
       destroyFunction_{[aggregate](folly::Range<char**> groups) {
         aggregate->destroy(groups);
+      }},
+      relocateFunction_{[aggregate](
+                            folly::Range<char**> groups,
+                            const HashStringAllocator::RelocateFn& relocate) {
+        aggregate->relocateAccumulators(groups, relocate);
       }} {
   VELOX_CHECK_NOT_NULL(aggregate);
 }
@@ -105,6 +111,17 @@ void Accumulator::destroy(folly::Range<char**> groups) {
   destroyFunction_(groups);
 }
 
+bool Accumulator::supportsCompaction() const {
+  return supportsCompaction_;
+}
+
+void Accumulator::relocate(
+    folly::Range<char**> groups,
+    const HashStringAllocator::RelocateFn& relocate) {
+  VELOX_CHECK(supportsCompaction_);
+  relocateFunction_(groups, relocate);
+}
+
 const TypePtr& Accumulator::spillType() const {
   return spillType_;
 }
@@ -443,6 +460,48 @@ void RowContainer::freeVariableWidthFields(folly::Range<char**> rows) {
   }
 }
 
+void RowContainer::relocateVariableWidthFields(
+    folly::Range<char**> rows,
+    const HashStringAllocator::RelocateFn& relocate) {
+  for (auto i = 0; i < types_.size(); ++i) {
+    const auto column = columnAt(i);
+    switch (typeKinds_[i]) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY: {
+        for (auto row : rows) {
+          if (isNullAt(row, column.nullByte(), column.nullMask())) {
+            continue;
+          }
+          auto& view = valueAt<StringView>(row, column.offset());
+          if (view.isInline()) {
+            continue;
+          }
+          auto* header = relocate(HashStringAllocator::headerOf(view.data()));
+          view = StringView(header->begin(), view.size());
+        }
+        break;
+      }
+      case TypeKind::ROW:
+      case TypeKind::ARRAY:
+      case TypeKind::MAP: {
+        for (auto row : rows) {
+          if (isNullAt(row, column.nullByte(), column.nullMask())) {
+            continue;
+          }
+          auto& view = valueAt<std::string_view>(row, column.offset());
+          if (view.empty()) {
+            continue;
+          }
+          auto* header = relocate(HashStringAllocator::headerOf(view.data()));
+          view = std::string_view(header->begin(), view.size());
+        }
+        break;
+      }
+      default:;
+    }
+  }
+}
+
 void RowContainer::freeAggregates(folly::Range<char**> rows) {
   for (auto& accumulator : accumulators_) {
     accumulator.destroy(rows);
@@ -1039,6 +1098,35 @@ void RowContainer::clear() {
   rowColumnsStats_.resize(types_.size());
 }
 
+bool RowContainer::supportsCompaction() const {
+  if (hasDuplicateRows_) {
+    return false;
+  }
+  for (const auto& accumulator : accumulators_) {
+    if (!accumulator.supportsCompaction()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t RowContainer::compactVariableWidthData() {
+  VELOX_CHECK(supportsCompaction());
+  return stringAllocator_->compact(
+      [&](const HashStringAllocator::RelocateFn& relocate) {
+        constexpr int32_t kBatch = 1000;
+        std::vector<char*> rows(kBatch);
+        RowContainerIterator iter;
+        while (auto numRows = listRows(&iter, kBatch, rows.data())) {
+          folly::Range<char**> range(rows.data(), numRows);
+          relocateVariableWidthFields(range, relocate);
+          for (auto& accumulator : accumulators_) {
+            accumulator.relocate(range, relocate);
+          }
+        }
+      });
+}
+
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
   for (auto i = 0; i < numRows; i++) {
     // Row may be null in case of a FULL join.
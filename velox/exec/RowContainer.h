@@ -60,14 +60,27 @@ class Accumulator {
 
   void destroy(folly::Range<char**> groups);
 
+  /// Returns true if relocate() moves all the out-of-line state of the
+  /// accumulators in the HashStringAllocator.
+  bool supportsCompaction() const;
+
+  void relocate(
+      folly::Range<char**> groups,
+      const HashStringAllocator::RelocateFn& relocate);
+
  private:
   const bool isFixedSize_;
   const int32_t fixedSize_;
   const bool usesExternalMemory_;
   const int32_t alignment_;
+  const bool supportsCompaction_{false};
   const TypePtr spillType_;
   std::function<void(folly::Range<char**>, VectorPtr&)> spillExtractFunction_;
   std::function<void(folly::Range<char**> groups)> destroyFunction_;
+  std::function<void(
+      folly::Range<char**> groups,
+      const HashStringAllocator::RelocateFn& relocate)>
+      relocateFunction_;
 };
 
 using normalized_key_t = uint64_t;
@@ -799,6 +812,16 @@ class RowContainer {
   /// Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
+  /// Returns true if compactVariableWidthData() can move all the data of
+  /// 'this' in the HashStringAllocator. This is false if there are duplicate
+  /// row vectors or accumulators which do not support compaction.
+  bool supportsCompaction() const;
+
+  /// Compacts the HashStringAllocator of 'this' and moves the out-of-line
+  /// keys, dependents and accumulators of all rows to the compacted blocks.
+  /// Returns the number of bytes released to the memory pool.
+  int64_t compactVariableWidthData();
+
   int32_t compareRows(
       const char* left,
       const char* right,
@@ -1474,6 +1497,12 @@ class RowContainer {
   // complex-typed field in 'rows'.
   void freeVariableWidthFields(folly::Range<char**> rows);
 
+  // Moves the variable-width fields of 'rows' with 'relocate' during
+  // HashStringAllocator::compact().
+  void relocateVariableWidthFields(
+      folly::Range<char**> rows,
+      const HashStringAllocator::RelocateFn& relocate);
+
   // Free any aggregates associated with the 'rows'.
   void freeAggregates(folly::Range<char**> rows);
 
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SerializedPageSpiller.h"
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Holds the memory pool allocation backing an unspilled page's IOBuf. The
+// pool is kept alive as the page might outlive the owning queue.
+struct PageBuffer {
+  std::shared_ptr<memory::MemoryPool> pool;
+  uint64_t size;
+};
+
+void freePageBuffer(void* data, void* userData) {
+  auto* buffer = static_cast<PageBuffer*>(userData);
+  buffer->pool->free(data, buffer->size);
+  delete buffer;
+}
+} // namespace
+
+struct SerializedPageSpiller::SpilledFile {
+  explicit SpilledFile(std::string _path) : path(std::move(_path)) {}
+
+  ~SpilledFile() {
+    try {
+      auto fs = filesystems::getFileSystem(path, nullptr);
+      fs->remove(path);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Failed to remove serialized page spill file " << path
+                 << ": " << e.what();
+    }
+  }
+
+  const std::string path;
+};
+
+SerializedPageSpiller::SerializedPageSpiller(
+    const common::SpillConfig* spillConfig,
+    const std::string& fileNamePrefix,
+    std::shared_ptr<memory::MemoryPool> pool,
+    folly::Synchronized<common::SpillStats>* stats)
+    : spillConfig_(spillConfig),
+      fileNamePrefix_(fileNamePrefix),
+      pool_(std::move(pool)),
+      stats_(stats) {
+  VELOX_CHECK_NOT_NULL(spillConfig_);
+  VELOX_CHECK_NOT_NULL(pool_);
+  VELOX_CHECK_NOT_NULL(stats_);
+}
+
+std::optional<SerializedPageSpiller::WriteBatch>
+SerializedPageSpiller::startWrite(
+    const std::vector<const SerializedPage*>& pages) {
+  if (ioInProgress_ || pages.empty()) {
+    return std::nullopt;
+  }
+  ioInProgress_ = true;
+  WriteBatch batch{.generation = generation_, .pages = pages};
+  for (const auto* page : pages) {
+    VELOX_CHECK_NOT_NULL(page);
+    pages_.push_back(SpilledPage{
+        .state = State::kWriting,
+        .size = page->size(),
+        .numRows = page->numRows()});
+    spilledBytes_ += page->size();
+  }
+  return batch;
+}
+
+void SerializedPageSpiller::write(WriteBatch& batch) {
+  VELOX_CHECK_NOT_NULL(
+      spillConfig_->getSpillDirPathCb,
+      "Spill directory callback not specified.");
+  const auto spillDir = spillConfig_->getSpillDirPathCb();
+  VELOX_CHECK(!spillDir.empty(), "Spill directory does not exist");
+
+  std::unique_ptr<SpillWriteFile> writeFile;
+  std::shared_ptr<SpilledFile> spilledFile;
+  uint64_t offset{0};
+  batch.locations.reserve(batch.pages.size());
+  for (const auto* page : batch.pages) {
+    if (writeFile != nullptr && spillConfig_->maxFileSize != 0 &&
+        offset >= spillConfig_->maxFileSize) {
+      writeFile->finish();
+      writeFile.reset();
+    }
+    if (writeFile == nullptr) {
+      writeFile = SpillWriteFile::create(
+          nextFileId_++,
+          fmt::format(
+              "{}/{}-{}-pages",
+              spillDir,
+              spillConfig_->fileNamePrefix,
+              fileNamePrefix_),
+          spillConfig_->fileCreateConfig);
+      spilledFile = std::make_shared<SpilledFile>(writeFile->path());
+      offset = 0;
+      ++stats_->wlock()->spilledFiles;
+      common::incrementGlobalSpilledFiles();
+    }
+
+    uint64_t writeTimeNs{0};
+    uint64_t writtenBytes{0};
+    {
+      NanosecondTimer timer(&writeTimeNs);
+      // NOTE: the cloned IOBuf shares the page memory so there is no extra
+      // memory allocation from the page's memory pool.
+      writtenBytes = writeFile->write(page->getIOBuf());
+    }
+    VELOX_CHECK_EQ(writtenBytes, page->size());
+    batch.locations.push_back(PageLocation{spilledFile, offset});
+    offset += writtenBytes;
+    batch.writtenBytes += writtenBytes;
+
+    {
+      auto statsLocked = stats_->wlock();
+      statsLocked->spilledBytes += writtenBytes;
+      statsLocked->spilledRows += page->numRows().value_or(0);
+      statsLocked->spillWriteTimeNanos += writeTimeNs;
+      ++statsLocked->spillWrites;
+    }
+    common::updateGlobalSpillWriteStats(writtenBytes, 0, writeTimeNs);
+    if (spillConfig_->updateAndCheckSpillLimitCb != nullptr) {
+      spillConfig_->updateAndCheckSpillLimitCb(writtenBytes);
+    }
+  }
+  if (writeFile != nullptr) {
+    writeFile->finish();
+  }
+}
+
+uint64_t SerializedPageSpiller::finishWrite(WriteBatch& batch) {
+  if (batch.generation != generation_) {
+    // The spilled pages have been cleared while writing.
+    return 0;
+  }
+  VELOX_CHECK(ioInProgress_);
+  VELOX_CHECK_EQ(batch.locations.size(), batch.pages.size());
+  VELOX_CHECK_GE(pages_.size(), batch.pages.size());
+  // The pages being written are at the end as nothing else can be appended
+  // while the write is in progress.
+  const auto first = pages_.size() - batch.pages.size();
+  for (auto i = 0; i < batch.locations.size(); ++i) {
+    auto& page = pages_[first + i];
+    VELOX_CHECK(page.state == State::kWriting);
+    page.state = State::kOnDisk;
+    page.location = std::move(batch.locations[i]);
+  }
+  batch.locations.clear();
+  ioInProgress_ = false;
+  return batch.writtenBytes;
+}
+
+bool SerializedPageSpiller::abortWrite(const WriteBatch& batch) {
+  if (batch.generation != generation_) {
+    return false;
+  }
+  VELOX_CHECK(ioInProgress_);
+  VELOX_CHECK_GE(pages_.size(), batch.pages.size());
+  for (auto i = 0; i < batch.pages.size(); ++i) {
+    VELOX_CHECK(pages_.back().state == State::kWriting);
+    spilledBytes_ -= pages_.back().size;
+    pages_.pop_back();
+  }
+  ioInProgress_ = false;
+  return true;
+}
+
+std::optional<SerializedPageSpiller::ReadBatch>
+SerializedPageSpiller::startRead(uint64_t maxBytes) {
+  if (ioInProgress_) {
+    return std::nullopt;
+  }
+  uint64_t loadedBytes{0};
+  size_t first{0};
+  while (first < pages_.size() && pages_[first].state == State::kLoaded) {
+    loadedBytes += pages_[first].size;
+    ++first;
+  }
+  if (loadedBytes >= maxBytes || first == pages_.size() ||
+      pages_[first].state != State::kOnDisk) {
+    return std::nullopt;
+  }
+  ioInProgress_ = true;
+  ReadBatch batch{
+      .generation = generation_,
+      .sequence = firstSequence_ + static_cast<int64_t>(first)};
+  for (auto i = first; i < pages_.size() && loadedBytes < maxBytes; ++i) {
+    auto& page = pages_[i];
+    if (page.state != State::kOnDisk) {
+      break;
+    }
+    page.state = State::kReading;
+    batch.locations.push_back(page.location);
+    batch.sizes.push_back(page.size);
+    batch.numRows.push_back(page.numRows);
+    loadedBytes += page.size;
+  }
+  return batch;
+}
+
+void SerializedPageSpiller::read(ReadBatch& batch) {
+  // Opens each file once for the pages of the batch which are mostly in the
+  // same file.
+  const SpilledFile* openFile{nullptr};
+  std::unique_ptr<ReadFile> readFile;
+  batch.pages.reserve(batch.locations.size());
+  for (auto i = 0; i < batch.locations.size(); ++i) {
+    const auto& location = batch.locations[i];
+    if (location.file.get() != openFile) {
+      auto fs = filesystems::getFileSystem(location.file->path, nullptr);
+      readFile = fs->openFileForRead(location.file->path);
+      openFile = location.file.get();
+    }
+
+    const auto size = batch.sizes[i];
+    auto* buffer = pool_->allocate(size);
+    auto iobuf = folly::IOBuf::takeOwnership(
+        buffer, size, freePageBuffer, new PageBuffer{pool_, size});
+    uint64_t readTimeNs{0};
+    {
+      NanosecondTimer timer(&readTimeNs);
+      readFile->pread(location.offset, size, buffer);
+    }
+    {
+      auto statsLocked = stats_->wlock();
+      ++statsLocked->spillReads;
+      statsLocked->spillReadBytes += size;
+      statsLocked->spillReadTimeNanos += readTimeNs;
+    }
+    common::updateGlobalSpillReadStats(1, size, readTimeNs);
+    batch.pages.push_back(std::make_unique<SerializedPage>(
+        std::move(iobuf), nullptr, batch.numRows[i]));
+  }
+}
+
+void SerializedPageSpiller::finishRead(ReadBatch& batch) {
+  if (batch.generation != generation_) {
+    return;
+  }
+  VELOX_CHECK(ioInProgress_);
+  VELOX_CHECK_EQ(batch.pages.size(), batch.locations.size());
+  const auto first = batch.sequence - firstSequence_;
+  for (auto i = 0; i < batch.pages.size(); ++i) {
+    auto& page = pages_[first + i];
+    VELOX_CHECK(page.state == State::kReading);
+    page.state = State::kLoaded;
+    page.page = std::move(batch.pages[i]);
+    // Drops the reference to the spill file so that it is removed with the
+    // batch outside of the owning queue's lock once fully read.
+    page.location = {};
+  }
+  ioInProgress_ = false;
+}
+
+void SerializedPageSpiller::abortRead(const ReadBatch& batch) {
+  if (batch.generation != generation_) {
+    return;
+  }
+  VELOX_CHECK(ioInProgress_);
+  const auto first = batch.sequence - firstSequence_;
+  for (auto i = 0; i < batch.locations.size(); ++i) {
+    auto& page = pages_[first + i];
+    VELOX_CHECK(page.state == State::kReading);
+    page.state = State::kOnDisk;
+  }
+  ioInProgress_ = false;
+}
+
+std::unique_ptr<SerializedPage> SerializedPageSpiller::popFront() {
+  VELOX_CHECK(hasLoadedFront(), "No spilled page to pop");
+  auto page = std::move(pages_.front().page);
+  spilledBytes_ -= pages_.front().size;
+  pages_.pop_front();
+  ++firstSequence_;
+  return page;
+}
+
+void SerializedPageSpiller::appendPageSizes(std::vector<int64_t>& out) const {
+  out.reserve(out.size() + pages_.size());
+  for (const auto& page : pages_) {
+    out.push_back(page.size);
+  }
+}
+
+int64_t SerializedPageSpiller::clear() {
+  int64_t numRows{0};
+  for (const auto& page : pages_) {
+    numRows += page.numRows.value_or(0);
+  }
+  firstSequence_ += pages_.size();
+  pages_.clear();
+  spilledBytes_ = 0;
+  ++generation_;
+  ioInProgress_ = false;
+  return numRows;
+}
+
+std::string SerializedPageSpiller::toString() const {
+  return fmt::format(
+      "[SPILLED PAGES[{}] SPILLED BYTES[{}]{}]",
+      pages_.size(),
+      succinctBytes(spilledBytes_),
+      ioInProgress_ ? " IO IN PROGRESS" : "");
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <deque>
+
+#include "velox/common/base/SpillConfig.h"
+#include "velox/common/base/SpillStats.h"
+#include "velox/exec/ExchangeQueue.h"
+#include "velox/exec/SpillFile.h"
+
+namespace facebook::velox::exec {
+
+/// Spills serialized pages buffered in a FIFO page queue such as
+/// DestinationBuffer or ExchangeQueue to local disk and reads them back in the
+/// same order. The page payload is written as-is to spill files while the page
+/// metadata (byte size and number of rows) stays in memory so that the owning
+/// queue can still report the remaining bytes without reading from disk.
+///
+/// The spilled pages logically follow the pages the owning queue holds in
+/// memory before them and precede the ones enqueued after the spill. The disk
+/// IO runs without holding the owning queue's lock in three steps:
+///  - startWrite()/startRead() reserve the pages under the queue lock.
+///  - write()/read() do the disk IO without the queue lock.
+///  - finishWrite()/finishRead() publish the result under the queue lock, or
+///    abortWrite()/abortRead() roll back the reservation if the IO failed.
+/// There is at most one write or read in progress at a time.
+///
+/// NOTE: this class is not thread-safe. Except for write() and read(), the
+/// methods must be called under the owning queue's lock.
+class SerializedPageSpiller {
+ public:
+  /// 'fileNamePrefix' is used to name the spill files under the spill
+  /// directory provided by 'spillConfig'. 'pool' is used to allocate the memory
+  /// for the pages read back from disk. 'stats' is used to collect the spill
+  /// stats.
+  SerializedPageSpiller(
+      const common::SpillConfig* spillConfig,
+      const std::string& fileNamePrefix,
+      std::shared_ptr<memory::MemoryPool> pool,
+      folly::Synchronized<common::SpillStats>* stats);
+
+ private:
+  // A spill file which is removed from disk once no spilled page refers to
+  // it.
+  struct SpilledFile;
+
+ public:
+  /// Describes the location of a page on disk.
+  struct PageLocation {
+    std::shared_ptr<SpilledFile> file;
+    uint64_t offset;
+  };
+
+  /// The pages reserved by startWrite() to write by write().
+  struct WriteBatch {
+    uint64_t generation;
+    // The pages to write which are owned by the caller until the batch is
+    // finished or aborted.
+    std::vector<const SerializedPage*> pages;
+    // Set by write().
+    std::vector<PageLocation> locations;
+    uint64_t writtenBytes{0};
+  };
+
+  /// The pages reserved by startRead() to read by read().
+  struct ReadBatch {
+    uint64_t generation;
+    // The sequence number of the first page to read.
+    int64_t sequence;
+    std::vector<PageLocation> locations;
+    std::vector<uint64_t> sizes;
+    std::vector<std::optional<int64_t>> numRows;
+    // Set by read().
+    std::vector<std::unique_ptr<SerializedPage>> pages;
+  };
+
+  /// Appends 'pages' to the end of the spilled pages and reserves them to
+  /// write to disk. The caller keeps 'pages' alive until the returned batch
+  /// is finished or aborted. Returns std::nullopt if there is a write or read
+  /// in progress.
+  std::optional<WriteBatch> startWrite(
+      const std::vector<const SerializedPage*>& pages);
+
+  /// Writes the pages of 'batch' to new spill files. Called without holding
+  /// the owning queue's lock.
+  void write(WriteBatch& batch);
+
+  /// Publishes the locations of the pages written by 'batch'. Returns the
+  /// number of bytes written to disk, or zero if the spilled pages have been
+  /// cleared in the meantime.
+  uint64_t finishWrite(WriteBatch& batch);
+
+  /// Removes the pages of 'batch' from the end of the spilled pages after a
+  /// failed write. Returns true if the caller should put the pages back to
+  /// the front of the pages it holds after the spilled ones, or false if the
+  /// spilled pages have been cleared in the meantime.
+  bool abortWrite(const WriteBatch& batch);
+
+  /// Reserves the spilled pages on disk at the front to read them back until
+  /// there are at least 'maxBytes' read back or there is no more page on
+  /// disk. Returns std::nullopt if there is nothing to read or there is a
+  /// write or read in progress.
+  std::optional<ReadBatch> startRead(uint64_t maxBytes);
+
+  /// Reads the pages of 'batch' into memory allocated from 'pool_'. Called
+  /// without holding the owning queue's lock.
+  void read(ReadBatch& batch);
+
+  /// Publishes the pages read by 'batch' for popFront().
+  void finishRead(ReadBatch& batch);
+
+  /// Puts the pages of 'batch' back on disk after a failed read.
+  void abortRead(const ReadBatch& batch);
+
+  /// Returns true if there is a write or read in progress.
+  bool ioInProgress() const {
+    return ioInProgress_;
+  }
+
+  /// Returns true if there is no spilled page left.
+  bool empty() const {
+    return pages_.empty();
+  }
+
+  /// Returns the number of spilled pages left, including the ones being
+  /// written and the ones read back which haven't been popped yet.
+  size_t numPages() const {
+    return pages_.size();
+  }
+
+  /// Returns the total byte size of the spilled pages left.
+  uint64_t spilledBytes() const {
+    return spilledBytes_;
+  }
+
+  /// Returns the byte size of the oldest spilled page.
+  uint64_t frontPageSize() const {
+    VELOX_CHECK(!pages_.empty());
+    return pages_.front().size;
+  }
+
+  /// Returns true if the oldest spilled page has been read back.
+  bool hasLoadedFront() const {
+    return !pages_.empty() && pages_.front().page != nullptr;
+  }
+
+  /// Removes and returns the oldest spilled page which has been read back.
+  std::unique_ptr<SerializedPage> popFront();
+
+  /// Appends the byte sizes of the spilled pages to 'out' in FIFO order.
+  void appendPageSizes(std::vector<int64_t>& out) const;
+
+  /// Drops all the spilled pages without reading them back. The spill files
+  /// are removed once the write or read in progress, if any, is done. Returns
+  /// the total number of rows of the dropped pages.
+  int64_t clear();
+
+  std::string toString() const;
+
+ private:
+  enum class State {
+    // The page is being written to disk.
+    kWriting,
+    kOnDisk,
+    // The page is being read back from disk.
+    kReading,
+    // The page has been read back and is waiting to be popped.
+    kLoaded,
+  };
+
+  struct SpilledPage {
+    State state;
+    uint64_t size;
+    std::optional<int64_t> numRows;
+    // Set if the page is on disk.
+    PageLocation location;
+    // Set if the page has been read back.
+    std::unique_ptr<SerializedPage> page;
+  };
+
+  const common::SpillConfig* const spillConfig_;
+  const std::string fileNamePrefix_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  folly::Synchronized<common::SpillStats>* const stats_;
+
+  // Used to name the spill files. Atomic as a write might still be running
+  // after clear().
+  std::atomic<uint32_t> nextFileId_{0};
+  // Incremented by clear() to ignore the write or read in progress.
+  uint64_t generation_{0};
+  bool ioInProgress_{false};
+  // The sequence number of the first page in 'pages_'.
+  int64_t firstSequence_{0};
+  std::deque<SpilledPage> pages_;
+  uint64_t spilledBytes_{0};
+};
+} // namespace facebook::velox::exec
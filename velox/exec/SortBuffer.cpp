@@ -28,7 +28,8 @@ SortBuffer::SortBuffer(
     tsan_atomic<bool>* nonReclaimableSection,
     common::PrefixSortConfig prefixSortConfig,
     const common::SpillConfig* spillConfig,
-    folly::Synchronized<velox::common::SpillStats>* spillStats)
+    folly::Synchronized<velox::common::SpillStats>* spillStats,
+    std::optional<uint64_t> limit)
     : input_(input),
       sortCompareFlags_(sortCompareFlags),
       pool_(pool),
@@ -36,11 +37,13 @@ SortBuffer::SortBuffer(
       prefixSortConfig_(prefixSortConfig),
       spillConfig_(spillConfig),
       spillStats_(spillStats),
+      limit_(limit),
       sortedRows_(0, memory::StlAllocator<char*>(*pool)) {
   VELOX_CHECK_GE(input_->size(), sortCompareFlags_.size());
   VELOX_CHECK_GT(sortCompareFlags_.size(), 0);
   VELOX_CHECK_EQ(sortColumnIndices.size(), sortCompareFlags_.size());
   VELOX_CHECK_NOT_NULL(nonReclaimableSection_);
+  VELOX_CHECK(!limit_.has_value() || limit_.value() > 0);
 
   std::vector<TypePtr> sortedColumnTypes;
   std::vector<TypePtr> nonSortedColumnTypes;
@@ -83,11 +86,15 @@ SortBuffer::~SortBuffer() {
   pool_->release();
 }
 
-void SortBuffer::addInput(const VectorPtr& input) {
+void SortBuffer::addInput(const VectorPtr& vector) {
   velox::common::testutil::TestValue::adjust(
       "facebook::velox::exec::SortBuffer::addInput", this);
 
   VELOX_CHECK(!noMoreInput_);
+  const auto input = dropRowsAboveThreshold(vector);
+  if (input == nullptr) {
+    return;
+  }
   ensureInputFits(input);
 
   SelectivityVector allRows(input->size());
@@ -107,6 +114,77 @@ void SortBuffer::addInput(const VectorPtr& input) {
   numInputRows_ += allRows.size();
 }
 
+VectorPtr SortBuffer::dropRowsAboveThreshold(const VectorPtr& input) {
+  if (topKThreshold_ == nullptr) {
+    return input;
+  }
+  const auto* inputRow = input->asUnchecked<RowVector>();
+  for (column_index_t i = 0; i < sortCompareFlags_.size(); ++i) {
+    inputRow->childAt(columnMap_[i].outputChannel)->loadedVector();
+  }
+  auto indices = allocateIndices(input->size(), pool_);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t numRows{0};
+  for (vector_size_t row = 0; row < input->size(); ++row) {
+    if (compareWithThreshold(*inputRow, row) <= 0) {
+      rawIndices[numRows++] = row;
+    }
+  }
+  numFilteredRows_ += input->size() - numRows;
+  if (numRows == input->size()) {
+    return input;
+  }
+  if (numRows == 0) {
+    return nullptr;
+  }
+  return wrap(
+      numRows, std::move(indices), std::static_pointer_cast<RowVector>(input));
+}
+
+int32_t SortBuffer::compareWithThreshold(
+    const RowVector& vector,
+    vector_size_t row) const {
+  VELOX_DCHECK_NOT_NULL(topKThreshold_);
+  for (column_index_t i = 0; i < sortCompareFlags_.size(); ++i) {
+    const auto channel = columnMap_[i].outputChannel;
+    const auto result = vector.childAt(channel)->loadedVector()->compare(
+        topKThreshold_->childAt(channel).get(), row, 0, sortCompareFlags_[i]);
+    VELOX_DCHECK(result.has_value());
+    if (result.value() != 0) {
+      return result.value();
+    }
+  }
+  return 0;
+}
+
+void SortBuffer::updateTopKThreshold(const std::vector<char*>& boundaryRows) {
+  if (boundaryRows.empty()) {
+    return;
+  }
+  char* minRow = boundaryRows[0];
+  for (auto* row : boundaryRows) {
+    if (data_->compareRows(row, minRow, sortCompareFlags_) < 0) {
+      minRow = row;
+    }
+  }
+  auto candidate = BaseVector::create<RowVector>(input_, 1, pool_);
+  for (const auto& columnProjection : columnMap_) {
+    data_->extractColumn(
+        &minRow,
+        1,
+        columnProjection.inputChannel,
+        candidate->childAt(columnProjection.outputChannel));
+  }
+  if (topKThreshold_ == nullptr || compareWithThreshold(*candidate, 0) < 0) {
+    topKThreshold_ = std::move(candidate);
+  }
+}
+
+uint64_t SortBuffer::numBoundedDroppedRows() const {
+  return numFilteredRows_ +
+      (inputSpiller_ == nullptr ? 0 : inputSpiller_->numTruncatedRows());
+}
+
 void SortBuffer::noMoreInput() {
   velox::common::testutil::TestValue::adjust(
       "facebook::velox::exec::SortBuffer::noMoreInput", this);
@@ -154,13 +232,21 @@ RowVectorPtr SortBuffer::getOutput(vector_size_t maxOutputRows) {
 
   VELOX_CHECK(noMoreInput_);
 
-  if (numOutputRows_ == numInputRows_) {
+  // The rows truncated from the spilled sorted runs are not output.
+  uint64_t numRows = numInputRows_;
+  if (inputSpiller_ != nullptr) {
+    numRows -= inputSpiller_->numTruncatedRows();
+  }
+  if (limit_.has_value()) {
+    numRows = std::min(numRows, limit_.value());
+  }
+  if (numOutputRows_ == numRows) {
     return nullptr;
   }
   VELOX_CHECK_GT(maxOutputRows, 0);
-  VELOX_CHECK_GT(numInputRows_, numOutputRows_);
+  VELOX_CHECK_GT(numRows, numOutputRows_);
   const vector_size_t batchSize =
-      std::min<uint64_t>(numInputRows_ - numOutputRows_, maxOutputRows);
+      std::min<uint64_t>(numRows - numOutputRows_, maxOutputRows);
   ensureOutputFits(batchSize);
   prepareOutput(batchSize);
   if (hasSpilled()) {
@@ -352,9 +438,11 @@ void SortBuffer::spillInput() {
         data_->keyTypes().size(),
         sortCompareFlags_,
         spillConfig_,
-        spillStats_);
+        spillStats_,
+        limit_);
   }
   inputSpiller_->spill();
+  updateTopKThreshold(inputSpiller_->takeBoundaryRows());
   data_->clear();
 }
 
@@ -363,7 +451,11 @@ void SortBuffer::spillOutput() {
     // Already spilled.
     return;
   }
-  if (numOutputRows_ == sortedRows_.size()) {
+  // Only the first 'limit_' sorted rows are output.
+  const auto numRows = std::min<uint64_t>(
+      sortedRows_.size(),
+      limit_.value_or(std::numeric_limits<uint64_t>::max()));
+  if (numOutputRows_ >= numRows) {
     // All the output has been produced.
     return;
   }
@@ -372,7 +464,7 @@ void SortBuffer::spillOutput() {
       data_.get(), spillerStoreType_, spillConfig_, spillStats_);
   auto spillRows = SpillerBase::SpillRows(
       sortedRows_.begin() + numOutputRows_,
-      sortedRows_.end(),
+      sortedRows_.begin() + numRows,
       *memory::spillMemoryPool());
   outputSpiller_->spill(spillRows);
   data_->clear();
@@ -30,6 +30,11 @@ class SortOutputSpiller;
 /// A utility class to accumulate data inside and output the sorted result.
 /// Spilling would be triggered if spilling is enabled and memory usage exceeds
 /// limit.
+///
+/// If 'limit' is set, only the first 'limit' sorted rows are output. Each
+/// sorted run spilled from the input is then truncated to 'limit' rows, and
+/// the input rows sorting after the smallest truncated run boundary are
+/// dropped as they can't be in the output.
 class SortBuffer {
  public:
   SortBuffer(
@@ -40,7 +45,8 @@ class SortBuffer {
       tsan_atomic<bool>* nonReclaimableSection,
       common::PrefixSortConfig prefixSortConfig,
       const common::SpillConfig* spillConfig = nullptr,
-      folly::Synchronized<velox::common::SpillStats>* spillStats = nullptr);
+      folly::Synchronized<velox::common::SpillStats>* spillStats = nullptr,
+      std::optional<uint64_t> limit = std::nullopt);
 
   ~SortBuffer();
 
@@ -69,7 +75,23 @@ class SortBuffer {
 
   std::optional<uint64_t> estimateOutputRowSize() const;
 
+  /// Returns the number of input rows dropped by the bounded sort, either
+  /// filtered at input or truncated from the spilled sorted runs.
+  uint64_t numBoundedDroppedRows() const;
+
  private:
+  // Returns 'input' without the rows sorting after 'topKThreshold_', or null
+  // if all the rows are dropped.
+  VectorPtr dropRowsAboveThreshold(const VectorPtr& input);
+
+  // Compares the sort keys of 'row' in 'vector' with 'topKThreshold_'.
+  int32_t compareWithThreshold(const RowVector& vector, vector_size_t row)
+      const;
+
+  // Sets 'topKThreshold_' to the smallest of 'boundaryRows' in 'data_' if it
+  // sorts before the current threshold.
+  void updateTopKThreshold(const std::vector<char*>& boundaryRows);
+
   // Ensures there is sufficient memory reserved to process 'input'.
   void ensureInputFits(const VectorPtr& input);
 
@@ -127,6 +149,8 @@ class SortBuffer {
 
   folly::Synchronized<common::SpillStats>* const spillStats_;
 
+  const std::optional<uint64_t> limit_;
+
   // The column projection map between 'input_' and 'spillerStoreType_' as sort
   // buffer stores the sort columns first in 'data_'.
   std::vector<IdentityProjection> columnMap_;
@@ -170,5 +194,13 @@ class SortBuffer {
 
   // The number of rows that has been returned.
   uint64_t numOutputRows_{0};
+
+  // The row sorting last among the first 'limit_' rows of a spilled sorted run
+  // with the smallest sort keys. A single row vector with 'input_' type. Set
+  // only if 'limit_' is set and a spilled run has been truncated.
+  RowVectorPtr topKThreshold_;
+
+  // The number of input rows dropped as they sort after 'topKThreshold_'.
+  uint64_t numFilteredRows_{0};
 };
 } // namespace facebook::velox::exec
@@ -103,7 +103,11 @@ SpillState::SpillState(
     const std::optional<common::PrefixSortConfig>& prefixSortConfig,
     memory::MemoryPool* pool,
     folly::Synchronized<common::SpillStats>* stats,
-    const std::string& fileCreateConfig)
+    const std::string& fileCreateConfig,
+    folly::Executor* executor,
+    uint32_t maxPendingWrites,
+    bool columnarEncoding,
+    common::SpillDirectorySelector* directorySelector)
     : getSpillDirPathCb_(getSpillDirPathCb),
       updateAndCheckSpillLimitCb_(updateAndCheckSpillLimitCb),
       fileNamePrefix_(fileNamePrefix),
@@ -118,6 +122,10 @@ SpillState::SpillState(
       fileCreateConfig_(fileCreateConfig),
       pool_(pool),
       stats_(stats),
+      executor_(executor),
+      maxPendingWrites_(maxPendingWrites),
+      columnarEncoding_(columnarEncoding),
+      directorySelector_(directorySelector),
       partitionWriters_(maxPartitions_) {}
 
 void SpillState::setPartitionSpilled(uint32_t partition) {
@@ -162,18 +170,26 @@ uint64_t SpillState::appendToPartition(
   VELOX_CHECK(!spillDir.empty(), "Spill directory does not exist");
   // Ensure that partition exist before writing.
   if (partitionWriters_.at(partition) == nullptr) {
+    const auto fileName =
+        fmt::format("{}-spill-{}", fileNamePrefix_, partition);
     partitionWriters_[partition] = std::make_unique<SpillWriter>(
         std::static_pointer_cast<const RowType>(rows->type()),
         numSortKeys_,
         sortCompareFlags_,
         compressionKind_,
-        fmt::format("{}/{}-spill-{}", spillDir, fileNamePrefix_, partition),
+        directorySelector_ == nullptr
+            ? fmt::format("{}/{}", spillDir, fileName)
+            : fileName,
         targetFileSize_,
         writeBufferSize_,
         fileCreateConfig_,
         updateAndCheckSpillLimitCb_,
         pool_,
-        stats_);
+        stats_,
+        executor_,
+        maxPendingWrites_,
+        columnarEncoding_,
+        directorySelector_);
   }
 
   const uint64_t bytes = rows->estimateFlatSize();
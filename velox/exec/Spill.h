@@ -358,7 +358,11 @@ class SpillState {
       const std::optional<common::PrefixSortConfig>& prefixSortConfig,
       memory::MemoryPool* pool,
       folly::Synchronized<common::SpillStats>* stats,
-      const std::string& fileCreateConfig = {});
+      const std::string& fileCreateConfig = {},
+      folly::Executor* executor = nullptr,
+      uint32_t maxPendingWrites = 0,
+      bool columnarEncoding = false,
+      common::SpillDirectorySelector* directorySelector = nullptr);
 
   /// Indicates if a given 'partition' has been spilled or not.
   bool isPartitionSpilled(uint32_t partition) const {
@@ -467,6 +471,14 @@ class SpillState {
   const std::string fileCreateConfig_;
   memory::MemoryPool* const pool_;
   folly::Synchronized<common::SpillStats>* const stats_;
+  // The executor and the max number of queued buffers for the asynchronous
+  // spill writes. See SpillWriter for details.
+  folly::Executor* const executor_;
+  const uint32_t maxPendingWrites_;
+  // True if the spilled data is written in the columnar spill format.
+  const bool columnarEncoding_;
+  // If set, spreads the spill files over multiple directories.
+  common::SpillDirectorySelector* const directorySelector_;
 
   // A set of spilled partition numbers.
   SpillPartitionNumSet spilledPartitionSet_;
@@ -0,0 +1,686 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SpillEncoding.h"
+
+#include <folly/container/F14Map.h>
+
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+namespace {
+// The compressed size in the page header if the payload is not compressed.
+constexpr int32_t kNotCompressed = -1;
+
+// The max ratio of distinct values to non-null values to use the dictionary
+// encoding for strings.
+constexpr double kMaxDictionaryRatio = 0.5;
+
+uint8_t bitsRequired(uint64_t value) {
+  return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+// Returns the number of bytes of 'numValues' values bit-packed with 'width'
+// bits each. The packed values are stored in whole words.
+uint64_t packedBytes(uint64_t numValues, uint8_t width) {
+  return bits::nwords(numValues * width) * sizeof(uint64_t);
+}
+
+template <typename T>
+void writeValue(T value, OutputStream* out) {
+  out->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Bit-packs 'values' with 'width' bits each and writes them to 'out'.
+void writePacked(
+    const std::vector<uint64_t>& values,
+    uint8_t width,
+    OutputStream* out) {
+  if (width == 0 || values.empty()) {
+    return;
+  }
+  std::vector<uint64_t> words(bits::nwords(values.size() * width), 0);
+  for (size_t i = 0; i < values.size(); ++i) {
+    const uint64_t bit = i * width;
+    const auto word = bit / 64;
+    const auto shift = bit % 64;
+    words[word] |= values[i] << shift;
+    if (shift + width > 64) {
+      words[word + 1] |= values[i] >> (64 - shift);
+    }
+  }
+  out->write(
+      reinterpret_cast<const char*>(words.data()),
+      words.size() * sizeof(uint64_t));
+}
+
+// Reads the encoded data of a page payload.
+class PayloadReader {
+ public:
+  PayloadReader(const char* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  template <typename T>
+  T read() {
+    T value;
+    ::memcpy(&value, next(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  // Returns a pointer to the next 'size' bytes and advances past them.
+  const char* next(size_t size) {
+    VELOX_CHECK_LE(
+        size, end_ - data_, "Truncated columnar spill page: {}", size);
+    const char* data = data_;
+    data_ += size;
+    return data;
+  }
+
+  bool atEnd() const {
+    return data_ == end_;
+  }
+
+ private:
+  const char* data_;
+  const char* const end_;
+};
+
+// Reads bit-packed values with 'width' bits each. The packed words are read
+// with memcpy as they might not be aligned in the page.
+class PackedReader {
+ public:
+  PackedReader(PayloadReader& reader, uint64_t numValues, uint8_t width)
+      : width_(width),
+        mask_(width == 64 ? ~0ULL : (1ULL << width) - 1),
+        words_(
+            width == 0 ? nullptr
+                       : reader.next(packedBytes(numValues, width))) {
+    VELOX_CHECK_LE(width, 64);
+  }
+
+  uint64_t get(uint64_t index) const {
+    if (width_ == 0) {
+      return 0;
+    }
+    const uint64_t bit = index * width_;
+    const auto shift = bit % 64;
+    uint64_t value = loadWord(bit / 64) >> shift;
+    if (shift + width_ > 64) {
+      value |= loadWord(bit / 64 + 1) << (64 - shift);
+    }
+    return value & mask_;
+  }
+
+ private:
+  uint64_t loadWord(uint64_t index) const {
+    uint64_t word;
+    ::memcpy(&word, words_ + index * sizeof(uint64_t), sizeof(uint64_t));
+    return word;
+  }
+
+  const uint8_t width_;
+  const uint64_t mask_;
+  const char* const words_;
+};
+
+void writeNulls(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    memory::MemoryPool* pool,
+    OutputStream* out) {
+  const bool hasNulls = decoded.mayHaveNulls();
+  writeValue<uint8_t>(hasNulls, out);
+  if (!hasNulls) {
+    return;
+  }
+  auto nulls = AlignedBuffer::allocate<bool>(numRows, pool, bits::kNotNull);
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (decoded.isNullAt(row)) {
+      bits::setNull(rawNulls, row);
+    }
+  }
+  out->write(nulls->as<char>(), bits::nbytes(numRows));
+}
+
+template <typename T>
+void encodeIntegers(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    OutputStream* out) {
+  std::vector<int64_t> values;
+  values.reserve(numRows);
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (!decoded.isNullAt(row)) {
+      values.push_back(decoded.valueAt<T>(row));
+    }
+  }
+  if (values.empty()) {
+    writeValue(SpillColumnEncoding::kPlain, out);
+    return;
+  }
+
+  // The offsets and the deltas are computed in unsigned arithmetic which
+  // wraps around on overflow and is undone the same way on decode.
+  int64_t minValue = values[0];
+  int64_t maxValue = values[0];
+  int64_t minDelta = 0;
+  int64_t maxDelta = 0;
+  for (size_t i = 1; i < values.size(); ++i) {
+    minValue = std::min(minValue, values[i]);
+    maxValue = std::max(maxValue, values[i]);
+    const auto delta =
+        static_cast<int64_t>((uint64_t)values[i] - (uint64_t)values[i - 1]);
+    if (i == 1) {
+      minDelta = maxDelta = delta;
+    } else {
+      minDelta = std::min(minDelta, delta);
+      maxDelta = std::max(maxDelta, delta);
+    }
+  }
+  const auto forWidth = bitsRequired((uint64_t)maxValue - (uint64_t)minValue);
+  const auto deltaWidth = bitsRequired((uint64_t)maxDelta - (uint64_t)minDelta);
+
+  const uint64_t plainSize = values.size() * sizeof(T);
+  const uint64_t forSize = sizeof(int64_t) + sizeof(uint8_t) +
+      packedBytes(values.size(), forWidth);
+  const uint64_t deltaSize = 2 * sizeof(int64_t) + sizeof(uint8_t) +
+      packedBytes(values.size() - 1, deltaWidth);
+
+  if (plainSize <= forSize && plainSize <= deltaSize) {
+    writeValue(SpillColumnEncoding::kPlain, out);
+    for (const auto value : values) {
+      writeValue<T>(value, out);
+    }
+    return;
+  }
+
+  std::vector<uint64_t> packed;
+  if (forSize <= deltaSize) {
+    writeValue(SpillColumnEncoding::kFrameOfReference, out);
+    writeValue<int64_t>(minValue, out);
+    writeValue<uint8_t>(forWidth, out);
+    packed.reserve(values.size());
+    for (const auto value : values) {
+      packed.push_back((uint64_t)value - (uint64_t)minValue);
+    }
+    writePacked(packed, forWidth, out);
+    return;
+  }
+
+  writeValue(SpillColumnEncoding::kDelta, out);
+  writeValue<int64_t>(values[0], out);
+  writeValue<int64_t>(minDelta, out);
+  writeValue<uint8_t>(deltaWidth, out);
+  packed.reserve(values.size() - 1);
+  for (size_t i = 1; i < values.size(); ++i) {
+    const auto delta = (uint64_t)values[i] - (uint64_t)values[i - 1];
+    packed.push_back(delta - (uint64_t)minDelta);
+  }
+  writePacked(packed, deltaWidth, out);
+}
+
+void encodeStrings(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    OutputStream* out) {
+  std::vector<StringView> values;
+  values.reserve(numRows);
+  uint64_t totalBytes{0};
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (!decoded.isNullAt(row)) {
+      values.push_back(decoded.valueAt<StringView>(row));
+      totalBytes += values.back().size();
+    }
+  }
+
+  folly::F14FastMap<StringView, int32_t> distinctIndices;
+  std::vector<StringView> distinctValues;
+  std::vector<uint64_t> indices;
+  indices.reserve(values.size());
+  uint64_t distinctBytes{0};
+  const size_t maxDistinct = values.size() * kMaxDictionaryRatio;
+  for (const auto& value : values) {
+    auto [it, inserted] =
+        distinctIndices.emplace(value, distinctIndices.size());
+    if (inserted) {
+      if (distinctValues.size() >= maxDistinct) {
+        distinctValues.clear();
+        break;
+      }
+      distinctValues.push_back(value);
+      distinctBytes += value.size();
+    }
+    indices.push_back(it->second);
+  }
+
+  if (!distinctValues.empty()) {
+    const auto width = bitsRequired(distinctValues.size() - 1);
+    const uint64_t plainSize = values.size() * sizeof(int32_t) + totalBytes;
+    const uint64_t dictionarySize = sizeof(int32_t) + sizeof(uint8_t) +
+        distinctValues.size() * sizeof(int32_t) + distinctBytes +
+        packedBytes(values.size(), width);
+    if (dictionarySize < plainSize) {
+      writeValue(SpillColumnEncoding::kDictionary, out);
+      writeValue<int32_t>(distinctValues.size(), out);
+      for (const auto& value : distinctValues) {
+        writeValue<int32_t>(value.size(), out);
+      }
+      for (const auto& value : distinctValues) {
+        out->write(value.data(), value.size());
+      }
+      writeValue<uint8_t>(width, out);
+      writePacked(indices, width, out);
+      return;
+    }
+  }
+
+  writeValue(SpillColumnEncoding::kPlain, out);
+  for (const auto& value : values) {
+    writeValue<int32_t>(value.size(), out);
+  }
+  for (const auto& value : values) {
+    out->write(value.data(), value.size());
+  }
+}
+
+template <typename T>
+void encodePlain(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    OutputStream* out) {
+  writeValue(SpillColumnEncoding::kPlain, out);
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (decoded.isNullAt(row)) {
+      continue;
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      writeValue<uint8_t>(decoded.valueAt<bool>(row), out);
+    } else {
+      writeValue<T>(decoded.valueAt<T>(row), out);
+    }
+  }
+}
+
+template <TypeKind Kind>
+void encodeColumn(
+    const DecodedVector& decoded,
+    vector_size_t numRows,
+    OutputStream* out) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  if constexpr (
+      Kind == TypeKind::TINYINT || Kind == TypeKind::SMALLINT ||
+      Kind == TypeKind::INTEGER || Kind == TypeKind::BIGINT) {
+    encodeIntegers<T>(decoded, numRows, out);
+  } else if constexpr (
+      Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
+    encodeStrings(decoded, numRows, out);
+  } else if constexpr (
+      TypeTraits<Kind>::isFixedWidth && Kind != TypeKind::UNKNOWN) {
+    encodePlain<T>(decoded, numRows, out);
+  } else {
+    VELOX_UNREACHABLE("Unsupported columnar spill type: {}", Kind);
+  }
+}
+
+BufferPtr readNulls(
+    PayloadReader& reader,
+    vector_size_t numRows,
+    memory::MemoryPool* pool) {
+  if (reader.read<uint8_t>() == 0) {
+    return nullptr;
+  }
+  auto nulls = AlignedBuffer::allocate<bool>(numRows, pool);
+  ::memcpy(
+      nulls->asMutable<char>(),
+      reader.next(bits::nbytes(numRows)),
+      bits::nbytes(numRows));
+  return nulls;
+}
+
+template <typename T>
+VectorPtr decodeIntegers(
+    PayloadReader& reader,
+    SpillColumnEncoding encoding,
+    const TypePtr& type,
+    vector_size_t numRows,
+    BufferPtr nulls,
+    memory::MemoryPool* pool) {
+  auto values = AlignedBuffer::allocate<T>(numRows, pool);
+  auto* rawValues = values->asMutable<T>();
+  const auto* rawNulls = nulls == nullptr ? nullptr : nulls->as<uint64_t>();
+  const auto isNull = [&](vector_size_t row) {
+    return rawNulls != nullptr && bits::isBitNull(rawNulls, row);
+  };
+  const auto numValues =
+      rawNulls == nullptr ? numRows : bits::countBits(rawNulls, 0, numRows);
+
+  switch (encoding) {
+    case SpillColumnEncoding::kPlain: {
+      const char* data = reader.next(numValues * sizeof(T));
+      for (vector_size_t row = 0, i = 0; row < numRows; ++row) {
+        if (!isNull(row)) {
+          ::memcpy(rawValues + row, data + i++ * sizeof(T), sizeof(T));
+        }
+      }
+      break;
+    }
+    case SpillColumnEncoding::kFrameOfReference: {
+      const auto minValue = reader.read<int64_t>();
+      const auto width = reader.read<uint8_t>();
+      PackedReader packed(reader, numValues, width);
+      for (vector_size_t row = 0, i = 0; row < numRows; ++row) {
+        if (!isNull(row)) {
+          rawValues[row] = static_cast<T>((uint64_t)minValue + packed.get(i++));
+        }
+      }
+      break;
+    }
+    case SpillColumnEncoding::kDelta: {
+      auto value = (uint64_t)reader.read<int64_t>();
+      const auto minDelta = (uint64_t)reader.read<int64_t>();
+      const auto width = reader.read<uint8_t>();
+      PackedReader packed(reader, numValues - 1, width);
+      bool first = true;
+      for (vector_size_t row = 0, i = 0; row < numRows; ++row) {
+        if (isNull(row)) {
+          continue;
+        }
+        if (!first) {
+          value += minDelta + packed.get(i++);
+        }
+        first = false;
+        rawValues[row] = static_cast<T>(value);
+      }
+      break;
+    }
+    default:
+      VELOX_FAIL("Unexpected integer spill encoding: {}", (int)encoding);
+  }
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      std::move(nulls),
+      numRows,
+      std::move(values),
+      std::vector<BufferPtr>{});
+}
+
+VectorPtr decodeStrings(
+    PayloadReader& reader,
+    SpillColumnEncoding encoding,
+    const TypePtr& type,
+    vector_size_t numRows,
+    BufferPtr nulls,
+    memory::MemoryPool* pool) {
+  auto values = AlignedBuffer::allocate<StringView>(numRows, pool);
+  auto* rawValues = values->asMutable<StringView>();
+  const auto* rawNulls = nulls == nullptr ? nullptr : nulls->as<uint64_t>();
+  const auto numValues =
+      rawNulls == nullptr ? numRows : bits::countBits(rawNulls, 0, numRows);
+
+  // Copies the string bytes into one buffer and points the string views of
+  // the vector into it.
+  const auto copyStrings = [&](int32_t numStrings,
+                               std::vector<StringView>& strings) {
+    const char* sizes = reader.next(numStrings * sizeof(int32_t));
+    uint64_t totalBytes{0};
+    std::vector<int32_t> stringSizes(numStrings);
+    ::memcpy(stringSizes.data(), sizes, numStrings * sizeof(int32_t));
+    for (const auto size : stringSizes) {
+      VELOX_CHECK_GE(size, 0);
+      totalBytes += size;
+    }
+    auto buffer = AlignedBuffer::allocate<char>(totalBytes, pool);
+    char* rawBuffer = buffer->asMutable<char>();
+    ::memcpy(rawBuffer, reader.next(totalBytes), totalBytes);
+    strings.reserve(numStrings);
+    for (const auto size : stringSizes) {
+      strings.emplace_back(rawBuffer, size);
+      rawBuffer += size;
+    }
+    return buffer;
+  };
+
+  std::vector<StringView> strings;
+  std::vector<BufferPtr> stringBuffers;
+  switch (encoding) {
+    case SpillColumnEncoding::kPlain: {
+      stringBuffers.push_back(copyStrings(numValues, strings));
+      for (vector_size_t row = 0, i = 0; row < numRows; ++row) {
+        rawValues[row] = (rawNulls != nullptr && bits::isBitNull(rawNulls, row))
+            ? StringView()
+            : strings[i++];
+      }
+      break;
+    }
+    case SpillColumnEncoding::kDictionary: {
+      const auto numDistinct = reader.read<int32_t>();
+      stringBuffers.push_back(copyStrings(numDistinct, strings));
+      const auto width = reader.read<uint8_t>();
+      PackedReader packed(reader, numValues, width);
+      for (vector_size_t row = 0, i = 0; row < numRows; ++row) {
+        if (rawNulls != nullptr && bits::isBitNull(rawNulls, row)) {
+          rawValues[row] = StringView();
+          continue;
+        }
+        const auto index = packed.get(i++);
+        VELOX_CHECK_LT(index, numDistinct);
+        rawValues[row] = strings[index];
+      }
+      break;
+    }
+    default:
+      VELOX_FAIL("Unexpected string spill encoding: {}", (int)encoding);
+  }
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      std::move(nulls),
+      numRows,
+      std::move(values),
+      std::move(stringBuffers));
+}
+
+template <typename T>
+VectorPtr decodePlain(
+    PayloadReader& reader,
+    const TypePtr& type,
+    vector_size_t numRows,
+    BufferPtr nulls,
+    memory::MemoryPool* pool) {
+  auto values = AlignedBuffer::allocate<T>(numRows, pool);
+  auto* rawValues = values->asMutable<T>();
+  const auto* rawNulls = nulls == nullptr ? nullptr : nulls->as<uint64_t>();
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (rawNulls != nullptr && bits::isBitNull(rawNulls, row)) {
+      continue;
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      bits::setBit(rawValues, row, reader.read<uint8_t>() != 0);
+    } else {
+      rawValues[row] = reader.read<T>();
+    }
+  }
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      std::move(nulls),
+      numRows,
+      std::move(values),
+      std::vector<BufferPtr>{});
+}
+
+template <TypeKind Kind>
+VectorPtr decodeColumn(
+    PayloadReader& reader,
+    SpillColumnEncoding encoding,
+    const TypePtr& type,
+    vector_size_t numRows,
+    BufferPtr nulls,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  if constexpr (
+      Kind == TypeKind::TINYINT || Kind == TypeKind::SMALLINT ||
+      Kind == TypeKind::INTEGER || Kind == TypeKind::BIGINT) {
+    return decodeIntegers<T>(
+        reader, encoding, type, numRows, std::move(nulls), pool);
+  } else if constexpr (
+      Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
+    return decodeStrings(
+        reader, encoding, type, numRows, std::move(nulls), pool);
+  } else if constexpr (
+      TypeTraits<Kind>::isFixedWidth && Kind != TypeKind::UNKNOWN) {
+    VELOX_CHECK(encoding == SpillColumnEncoding::kPlain);
+    return decodePlain<T>(reader, type, numRows, std::move(nulls), pool);
+  } else {
+    VELOX_UNREACHABLE("Unsupported columnar spill type: {}", Kind);
+  }
+}
+
+RowVectorPtr decodePayload(
+    const char* data,
+    size_t size,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool,
+    std::vector<SpillColumnEncoding>* encodings) {
+  PayloadReader reader(data, size);
+  const auto numRows = reader.read<int32_t>();
+  VELOX_CHECK_GE(numRows, 0);
+  std::vector<VectorPtr> children;
+  children.reserve(type->size());
+  for (const auto& childType : type->children()) {
+    auto nulls = readNulls(reader, numRows, pool);
+    const auto encoding = reader.read<SpillColumnEncoding>();
+    if (encodings != nullptr) {
+      encodings->push_back(encoding);
+    }
+    children.push_back(VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+        decodeColumn,
+        childType->kind(),
+        reader,
+        encoding,
+        childType,
+        numRows,
+        std::move(nulls),
+        pool));
+  }
+  VELOX_CHECK(reader.atEnd(), "Unexpected data after columnar spill page");
+  return std::make_shared<RowVector>(
+      pool, type, nullptr, numRows, std::move(children));
+}
+} // namespace
+
+bool isColumnarSpillSupported(const RowTypePtr& type) {
+  for (const auto& child : type->children()) {
+    const auto kind = child->kind();
+    if (!child->isPrimitiveType() || kind == TypeKind::UNKNOWN ||
+        kind == TypeKind::OPAQUE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<folly::IOBuf> encodeColumnarSpillPage(
+    const RowVectorPtr& input,
+    common::CompressionKind compressionKind,
+    memory::MemoryPool* pool) {
+  const auto numRows = input->size();
+  IOBufOutputStream out(*pool, nullptr, 64 * 1024);
+  writeValue<int32_t>(numRows, &out);
+  DecodedVector decoded;
+  for (const auto& child : input->children()) {
+    decoded.decode(*child);
+    writeNulls(decoded, numRows, pool, &out);
+    VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+        encodeColumn, child->typeKind(), decoded, numRows, &out);
+  }
+
+  auto payload = out.getIOBuf();
+  const auto uncompressedSize = payload->computeChainDataLength();
+  VELOX_CHECK_LE(uncompressedSize, std::numeric_limits<int32_t>::max());
+  int32_t compressedSize{kNotCompressed};
+  if (compressionKind != common::CompressionKind::CompressionKind_NONE) {
+    const auto codec = common::compressionKindToCodec(compressionKind);
+    auto compressed = codec->compress(payload.get());
+    const auto size = compressed->computeChainDataLength();
+    // Keeps the uncompressed payload if compression doesn't help.
+    if (size < uncompressedSize) {
+      compressedSize = size;
+      payload = std::move(compressed);
+    }
+  }
+
+  auto page = folly::IOBuf::create(2 * sizeof(int32_t));
+  const int32_t header[2] = {
+      static_cast<int32_t>(uncompressedSize), compressedSize};
+  ::memcpy(page->writableData(), header, sizeof(header));
+  page->append(sizeof(header));
+  page->prependChain(std::move(payload));
+  return page;
+}
+
+void decodeColumnarSpillPage(
+    ByteInputStream* input,
+    const RowTypePtr& type,
+    common::CompressionKind compressionKind,
+    memory::MemoryPool* pool,
+    RowVectorPtr& result) {
+  const auto uncompressedSize = input->read<int32_t>();
+  const auto compressedSize = input->read<int32_t>();
+  VELOX_CHECK_GE(uncompressedSize, 0);
+
+  auto payload = AlignedBuffer::allocate<char>(uncompressedSize, pool);
+  if (compressedSize == kNotCompressed) {
+    input->readBytes(payload->asMutable<char>(), uncompressedSize);
+  } else {
+    VELOX_CHECK_GE(compressedSize, 0);
+    VELOX_CHECK_NE(
+        compressionKind, common::CompressionKind::CompressionKind_NONE);
+    auto compressed = folly::IOBuf::create(compressedSize);
+    input->readBytes(compressed->writableData(), compressedSize);
+    compressed->append(compressedSize);
+    const auto codec = common::compressionKindToCodec(compressionKind);
+    const auto uncompressed =
+        codec->uncompress(compressed.get(), uncompressedSize);
+    size_t offset{0};
+    for (const auto& range : *uncompressed) {
+      VELOX_CHECK_LE(offset + range.size(), uncompressedSize);
+      ::memcpy(
+          payload->asMutable<char>() + offset, range.data(), range.size());
+      offset += range.size();
+    }
+    VELOX_CHECK_EQ(offset, uncompressedSize);
+  }
+  result = decodePayload(
+      payload->as<char>(), uncompressedSize, type, pool, nullptr);
+}
+
+std::vector<SpillColumnEncoding> testingColumnarSpillEncodings(
+    const folly::IOBuf& page,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  auto coalesced = page.cloneCoalescedAsValue();
+  const char* data = reinterpret_cast<const char*>(coalesced.data());
+  int32_t header[2];
+  ::memcpy(header, data, sizeof(header));
+  VELOX_CHECK_EQ(header[1], kNotCompressed);
+  std::vector<SpillColumnEncoding> encodings;
+  decodePayload(data + sizeof(header), header[0], type, pool, &encodings);
+  return encodings;
+}
+} // namespace facebook::velox::exec
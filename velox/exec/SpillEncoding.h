@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/io/IOBuf.h>
+
+#include "velox/common/compression/Compression.h"
+#include "velox/common/memory/ByteStream.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+/// The per-column encodings of the columnar spill page format. The encoding
+/// of each column is chosen per page as the one with the smallest encoded
+/// size.
+enum class SpillColumnEncoding : uint8_t {
+  /// The non-null values are stored as is.
+  kPlain = 0,
+  /// Integers are stored as the bit-packed offsets from the min value.
+  kFrameOfReference = 1,
+  /// Integers are stored as the first value followed by the bit-packed
+  /// deltas between the consecutive values, offset from the min delta. This
+  /// suits the sorted columns such as the sort keys of a sorted spill run.
+  kDelta = 2,
+  /// Strings are stored as the distinct values followed by the bit-packed
+  /// indices into them.
+  kDictionary = 3,
+};
+
+/// Returns true if all the columns of 'type' can be spilled in the columnar
+/// format. Only the scalar types are supported.
+bool isColumnarSpillSupported(const RowTypePtr& type);
+
+/// Encodes 'input' into one page of the columnar spill format. The page is
+/// compressed with 'compressionKind' on top of the column encodings unless it
+/// is CompressionKind_NONE.
+///
+/// The page layout is:
+///   int32 uncompressed payload size
+///   int32 compressed payload size, or -1 if the payload is not compressed
+///   payload:
+///     int32 number of rows
+///     for each column:
+///       uint8 has nulls, followed by the null bits if set
+///       uint8 SpillColumnEncoding
+///       the encoded non-null values
+std::unique_ptr<folly::IOBuf> encodeColumnarSpillPage(
+    const RowVectorPtr& input,
+    common::CompressionKind compressionKind,
+    memory::MemoryPool* pool);
+
+/// Reads the next page of the columnar spill format from 'input' and decodes
+/// it into flat vectors in 'result'. 'type' is the row type of the spilled
+/// data.
+void decodeColumnarSpillPage(
+    ByteInputStream* input,
+    const RowTypePtr& type,
+    common::CompressionKind compressionKind,
+    memory::MemoryPool* pool,
+    RowVectorPtr& result);
+
+/// Returns the encodings of the columns of an encoded page. Used for test.
+std::vector<SpillColumnEncoding> testingColumnarSpillEncodings(
+    const folly::IOBuf& page,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool);
+} // namespace facebook::velox::exec
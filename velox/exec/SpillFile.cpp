@@ -15,8 +15,12 @@
  */
 
 #include "velox/exec/SpillFile.h"
+
+#include <folly/ScopeGuard.h>
+
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/exec/SpillEncoding.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
@@ -27,21 +31,42 @@ namespace {
 // nanosecond precision, we use this serde option to ensure the serializer
 // preserves precision.
 static const bool kDefaultUseLosslessTimestamp = true;
+
+// Updates the disk write stats of a spill writer.
+void updateWriteStats(
+    folly::Synchronized<common::SpillStats>* stats,
+    uint64_t spilledBytes,
+    uint64_t flushTimeNs,
+    uint64_t fileWriteTimeNs) {
+  {
+    auto statsLocked = stats->wlock();
+    statsLocked->spilledBytes += spilledBytes;
+    statsLocked->spillFlushTimeNanos += flushTimeNs;
+    statsLocked->spillWriteTimeNanos += fileWriteTimeNs;
+    ++statsLocked->spillWrites;
+  }
+  common::updateGlobalSpillWriteStats(
+      spilledBytes, flushTimeNs, fileWriteTimeNs);
+}
 } // namespace
 
 std::unique_ptr<SpillWriteFile> SpillWriteFile::create(
     uint32_t id,
     const std::string& pathPrefix,
-    const std::string& fileCreateConfig) {
+    const std::string& fileCreateConfig,
+    common::SpillDevice* device) {
   return std::unique_ptr<SpillWriteFile>(
-      new SpillWriteFile(id, pathPrefix, fileCreateConfig));
+      new SpillWriteFile(id, pathPrefix, fileCreateConfig, device));
 }
 
 SpillWriteFile::SpillWriteFile(
     uint32_t id,
     const std::string& pathPrefix,
-    const std::string& fileCreateConfig)
-    : id_(id), path_(fmt::format("{}-{}", pathPrefix, ordinalCounter_++)) {
+    const std::string& fileCreateConfig,
+    common::SpillDevice* device)
+    : id_(id),
+      path_(fmt::format("{}-{}", pathPrefix, ordinalCounter_++)),
+      device_(device) {
   auto fs = filesystems::getFileSystem(path_, nullptr);
   file_ = fs->openFileForWrite(
       path_,
@@ -68,10 +93,151 @@ uint64_t SpillWriteFile::size() const {
 
 uint64_t SpillWriteFile::write(std::unique_ptr<folly::IOBuf> iobuf) {
   auto writtenBytes = iobuf->computeChainDataLength();
-  file_->append(std::move(iobuf));
+  if (device_ != nullptr) {
+    device_->startWrite();
+  }
+  // Set after the write succeeds.
+  uint64_t deviceWrittenBytes{0};
+  uint64_t writeTimeNs{0};
+  SCOPE_EXIT {
+    if (device_ != nullptr) {
+      device_->finishWrite(deviceWrittenBytes, writeTimeNs);
+    }
+  };
+  {
+    NanosecondTimer timer(&writeTimeNs);
+    file_->append(std::move(iobuf));
+  }
+  deviceWrittenBytes = writtenBytes;
   return writtenBytes;
 }
 
+// static
+std::shared_ptr<SpillWriteQueue> SpillWriteQueue::create(
+    folly::Executor* executor,
+    uint32_t maxPendingWrites,
+    folly::Synchronized<common::SpillStats>* stats) {
+  return std::shared_ptr<SpillWriteQueue>(
+      new SpillWriteQueue(executor, maxPendingWrites, stats));
+}
+
+SpillWriteQueue::SpillWriteQueue(
+    folly::Executor* executor,
+    uint32_t maxPendingWrites,
+    folly::Synchronized<common::SpillStats>* stats)
+    : executor_(executor), maxPendingWrites_(maxPendingWrites), stats_(stats) {
+  VELOX_CHECK_NOT_NULL(executor_);
+  VELOX_CHECK_GT(maxPendingWrites_, 0);
+  VELOX_CHECK_NOT_NULL(stats_);
+}
+
+void SpillWriteQueue::enqueue(
+    SpillWriteFile* file,
+    std::unique_ptr<folly::IOBuf> iobuf,
+    uint64_t flushTimeNs) {
+  uint64_t waitTimeNs{0};
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    waitTimeNs = waitLocked(l, maxPendingWrites_ - 1, /*idle=*/false);
+    pending_.push_back(PendingWrite{file, std::move(iobuf), flushTimeNs});
+    maybeScheduleLocked();
+  }
+  recordWaitTime(waitTimeNs);
+}
+
+void SpillWriteQueue::drain() {
+  uint64_t waitTimeNs{0};
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    waitTimeNs = waitLocked(l, 0, /*idle=*/true);
+  }
+  recordWaitTime(waitTimeNs);
+}
+
+void SpillWriteQueue::abort() {
+  std::unique_lock<std::mutex> l(mutex_);
+  pending_.clear();
+  cv_.wait(l, [&]() { return !writing_; });
+}
+
+size_t SpillWriteQueue::numPending() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return pending_.size();
+}
+
+uint64_t SpillWriteQueue::waitLocked(
+    std::unique_lock<std::mutex>& lock,
+    size_t maxPending,
+    bool idle) {
+  uint64_t waitTimeNs{0};
+  while (error_ == nullptr &&
+         (pending_.size() > maxPending || (idle && writing_))) {
+    if (!writing_) {
+      writeLocked(lock);
+      continue;
+    }
+    NanosecondTimer timer(&waitTimeNs);
+    cv_.wait(lock);
+  }
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  return waitTimeNs;
+}
+
+void SpillWriteQueue::writeLocked(std::unique_lock<std::mutex>& lock) {
+  VELOX_CHECK(!writing_);
+  writing_ = true;
+  while (!pending_.empty() && error_ == nullptr) {
+    auto write = std::move(pending_.front());
+    pending_.pop_front();
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      uint64_t writeTimeNs{0};
+      uint64_t writtenBytes{0};
+      {
+        NanosecondTimer timer(&writeTimeNs);
+        writtenBytes = write.file->write(std::move(write.iobuf));
+      }
+      updateWriteStats(stats_, writtenBytes, write.flushTimeNs, writeTimeNs);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if (error != nullptr) {
+      error_ = error;
+      pending_.clear();
+    }
+    // Wakes up the spilling thread waiting for a free slot.
+    cv_.notify_all();
+  }
+  writing_ = false;
+  cv_.notify_all();
+}
+
+void SpillWriteQueue::maybeScheduleLocked() {
+  if (scheduled_ || writing_) {
+    return;
+  }
+  scheduled_ = true;
+  executor_->add([self = shared_from_this()]() {
+    std::unique_lock<std::mutex> l(self->mutex_);
+    self->scheduled_ = false;
+    if (!self->writing_) {
+      self->writeLocked(l);
+    }
+  });
+}
+
+void SpillWriteQueue::recordWaitTime(uint64_t waitTimeNs) {
+  if (waitTimeNs == 0) {
+    return;
+  }
+  stats_->wlock()->spillWriteQueueWaitTimeNanos += waitTimeNs;
+  common::updateGlobalSpillWriteQueueWaitTime(waitTimeNs);
+}
+
 SpillWriter::SpillWriter(
     const RowTypePtr& type,
     const uint32_t numSortKeys,
@@ -83,7 +249,11 @@ SpillWriter::SpillWriter(
     const std::string& fileCreateConfig,
     common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
     memory::MemoryPool* pool,
-    folly::Synchronized<common::SpillStats>* stats)
+    folly::Synchronized<common::SpillStats>* stats,
+    folly::Executor* executor,
+    uint32_t maxPendingWrites,
+    bool columnarEncoding,
+    common::SpillDirectorySelector* directorySelector)
     : type_(type),
       numSortKeys_(numSortKeys),
       sortCompareFlags_(sortCompareFlags),
@@ -92,6 +262,8 @@ SpillWriter::SpillWriter(
       targetFileSize_(targetFileSize),
       writeBufferSize_(writeBufferSize),
       fileCreateConfig_(fileCreateConfig),
+      columnarEncoding_(columnarEncoding && isColumnarSpillSupported(type)),
+      directorySelector_(directorySelector),
       updateAndCheckSpillLimitCb_(updateAndCheckSpillLimitCb),
       pool_(pool),
       serde_(getNamedVectorSerde(VectorSerde::Kind::kPresto)),
@@ -100,17 +272,41 @@ SpillWriter::SpillWriter(
   // comparison flags, then it must match the number of sorting keys.
   VELOX_CHECK(
       sortCompareFlags_.empty() || sortCompareFlags_.size() == numSortKeys_);
+  if (executor != nullptr && maxPendingWrites > 0) {
+    writeQueue_ = SpillWriteQueue::create(executor, maxPendingWrites, stats_);
+  }
+}
+
+SpillWriter::~SpillWriter() {
+  // Makes sure there is no write in progress on the files owned by 'this'.
+  if (writeQueue_ != nullptr) {
+    writeQueue_->abort();
+  }
 }
 
 SpillWriteFile* SpillWriter::ensureFile() {
-  if ((currentFile_ != nullptr) && (currentFile_->size() > targetFileSize_)) {
+  if ((currentFile_ != nullptr) && (currentFileSize_ > targetFileSize_)) {
     closeFile();
   }
   if (currentFile_ == nullptr) {
-    currentFile_ = SpillWriteFile::create(
-        nextFileId_++,
-        fmt::format("{}-{}", pathPrefix_, finishedFiles_.size()),
-        fileCreateConfig_);
+    if (directorySelector_ == nullptr) {
+      currentFile_ = SpillWriteFile::create(
+          nextFileId_++,
+          fmt::format("{}-{}", pathPrefix_, finishedFiles_.size()),
+          fileCreateConfig_);
+    } else {
+      const auto index = directorySelector_->select();
+      const auto& directory = directorySelector_->directory(index);
+      auto* device = directorySelector_->device(index);
+      device->addFile(directory);
+      currentFile_ = SpillWriteFile::create(
+          nextFileId_++,
+          fmt::format(
+              "{}/{}-{}", directory, pathPrefix_, finishedFiles_.size()),
+          fileCreateConfig_,
+          device);
+    }
+    currentFileSize_ = 0;
   }
   return currentFile_.get();
 }
@@ -119,6 +315,9 @@ void SpillWriter::closeFile() {
   if (currentFile_ == nullptr) {
     return;
   }
+  if (writeQueue_ != nullptr) {
+    writeQueue_->drain();
+  }
   currentFile_->finish();
   updateSpilledFileStats(currentFile_->size());
   finishedFiles_.push_back(SpillFileInfo{
@@ -128,7 +327,8 @@ void SpillWriter::closeFile() {
       .size = currentFile_->size(),
       .numSortKeys = numSortKeys_,
       .sortFlags = sortCompareFlags_,
-      .compressionKind = compressionKind_});
+      .compressionKind = compressionKind_,
+      .columnarEncoded = columnarEncoding_});
   currentFile_.reset();
 }
 
@@ -137,30 +337,47 @@ size_t SpillWriter::numFinishedFiles() const {
 }
 
 uint64_t SpillWriter::flush() {
-  if (batch_ == nullptr) {
+  if (batch_ == nullptr && pendingRows_ == nullptr) {
     return 0;
   }
 
   auto* file = ensureFile();
   VELOX_CHECK_NOT_NULL(file);
 
-  IOBufOutputStream out(
-      *pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
+  std::unique_ptr<folly::IOBuf> iobuf;
   uint64_t flushTimeNs{0};
-  {
+  if (pendingRows_ != nullptr) {
     NanosecondTimer timer(&flushTimeNs);
-    batch_->flush(&out);
+    iobuf = encodeColumnarSpillPage(pendingRows_, compressionKind_, pool_);
+    pendingRows_.reset();
+    pendingBytes_ = 0;
+  } else {
+    IOBufOutputStream out(
+        *pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
+    {
+      NanosecondTimer timer(&flushTimeNs);
+      batch_->flush(&out);
+    }
+    batch_.reset();
+    iobuf = out.getIOBuf();
+  }
+
+  if (writeQueue_ != nullptr) {
+    const auto queuedBytes = iobuf->computeChainDataLength();
+    writeQueue_->enqueue(file, std::move(iobuf), flushTimeNs);
+    currentFileSize_ += queuedBytes;
+    updateAndCheckSpillLimitCb_(queuedBytes);
+    return queuedBytes;
   }
-  batch_.reset();
 
   uint64_t writeTimeNs{0};
   uint64_t writtenBytes{0};
-  auto iobuf = out.getIOBuf();
   {
     NanosecondTimer timer(&writeTimeNs);
     writtenBytes = file->write(std::move(iobuf));
   }
-  updateWriteStats(writtenBytes, flushTimeNs, writeTimeNs);
+  currentFileSize_ += writtenBytes;
+  updateWriteStats(stats_, writtenBytes, flushTimeNs, writeTimeNs);
   updateAndCheckSpillLimitCb_(writtenBytes);
   return writtenBytes;
 }
@@ -170,6 +387,20 @@ uint64_t SpillWriter::write(
     const folly::Range<IndexRange*>& indices) {
   checkNotFinished();
 
+  if (columnarEncoding_) {
+    uint64_t timeNs{0};
+    vector_size_t numRows{0};
+    {
+      NanosecondTimer timer(&timeNs);
+      numRows = appendPendingRows(rows, indices);
+    }
+    updateAppendStats(numRows, timeNs);
+    if (pendingBytes_ < writeBufferSize_) {
+      return 0;
+    }
+    return flush();
+  }
+
   uint64_t timeNs{0};
   {
     NanosecondTimer timer(&timeNs);
@@ -194,6 +425,33 @@ uint64_t SpillWriter::write(
   return flush();
 }
 
+vector_size_t SpillWriter::appendPendingRows(
+    const RowVectorPtr& rows,
+    const folly::Range<IndexRange*>& indices) {
+  vector_size_t numRows{0};
+  std::vector<BaseVector::CopyRange> ranges;
+  ranges.reserve(indices.size());
+  const vector_size_t offset =
+      pendingRows_ == nullptr ? 0 : pendingRows_->size();
+  for (const auto& range : indices) {
+    ranges.push_back({range.begin, offset + numRows, range.size});
+    numRows += range.size;
+  }
+  if (pendingRows_ == nullptr) {
+    pendingRows_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(type_, numRows, pool_));
+  } else {
+    pendingRows_->resize(offset + numRows);
+  }
+  pendingRows_->copyRanges(rows.get(), ranges);
+  // Estimates the size of the copied rows from the average row size of the
+  // input rather than of the growing 'pendingRows_'.
+  if (rows->size() > 0) {
+    pendingBytes_ += rows->estimateFlatSize() * numRows / rows->size();
+  }
+  return numRows;
+}
+
 void SpillWriter::updateAppendStats(
     uint64_t numRows,
     uint64_t serializationTimeNs) {
@@ -203,19 +461,6 @@ void SpillWriter::updateAppendStats(
   common::updateGlobalSpillAppendStats(numRows, serializationTimeNs);
 }
 
-void SpillWriter::updateWriteStats(
-    uint64_t spilledBytes,
-    uint64_t flushTimeNs,
-    uint64_t fileWriteTimeNs) {
-  auto statsLocked = stats_->wlock();
-  statsLocked->spilledBytes += spilledBytes;
-  statsLocked->spillFlushTimeNanos += flushTimeNs;
-  statsLocked->spillWriteTimeNanos += fileWriteTimeNs;
-  ++statsLocked->spillWrites;
-  common::updateGlobalSpillWriteStats(
-      spilledBytes, flushTimeNs, fileWriteTimeNs);
-}
-
 void SpillWriter::updateSpilledFileStats(uint64_t fileSize) {
   ++stats_->wlock()->spilledFiles;
   addThreadLocalRuntimeStat(
@@ -278,6 +523,7 @@ std::unique_ptr<SpillReadFile> SpillReadFile::create(
       fileInfo.numSortKeys,
       fileInfo.sortFlags,
       fileInfo.compressionKind,
+      fileInfo.columnarEncoded,
       pool,
       stats));
 }
@@ -291,6 +537,7 @@ SpillReadFile::SpillReadFile(
     uint32_t numSortKeys,
     const std::vector<CompareFlags>& sortCompareFlags,
     common::CompressionKind compressionKind,
+    bool columnarEncoded,
     memory::MemoryPool* pool,
     folly::Synchronized<common::SpillStats>* stats)
     : id_(id),
@@ -300,6 +547,7 @@ SpillReadFile::SpillReadFile(
       numSortKeys_(numSortKeys),
       sortCompareFlags_(sortCompareFlags),
       compressionKind_(compressionKind),
+      columnarEncoded_(columnarEncoded),
       readOptions_{
           kDefaultUseLosslessTimestamp,
           compressionKind_,
@@ -323,8 +571,13 @@ bool SpillReadFile::nextBatch(RowVectorPtr& rowVector) {
   uint64_t timeNs{0};
   {
     NanosecondTimer timer{&timeNs};
-    VectorStreamGroup::read(
-        input_.get(), pool_, type_, serde_, &rowVector, &readOptions_);
+    if (columnarEncoded_) {
+      decodeColumnarSpillPage(
+          input_.get(), type_, compressionKind_, pool_, rowVector);
+    } else {
+      VectorStreamGroup::read(
+          input_.get(), pool_, type_, serde_, &rowVector, &readOptions_);
+    }
   }
   stats_->wlock()->spillDeserializationTimeNanos += timeNs;
   common::updateGlobalSpillDeserializationTimeNs(timeNs);
@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+
 #include <folly/container/F14Set.h>
+#include <folly/executors/Executor.h>
 
 #include "velox/common/base/SpillConfig.h"
 #include "velox/common/base/SpillStats.h"
@@ -37,10 +41,13 @@ namespace facebook::velox::exec {
 /// file.
 class SpillWriteFile {
  public:
+  /// 'device' is the storage device of the file to record the write stats.
+  /// It is set if the spill files are spread over multiple directories.
   static std::unique_ptr<SpillWriteFile> create(
       uint32_t id,
       const std::string& pathPrefix,
-      const std::string& fileCreateConfig);
+      const std::string& fileCreateConfig,
+      common::SpillDevice* device = nullptr);
 
   uint32_t id() const {
     return id_;
@@ -68,12 +75,14 @@ class SpillWriteFile {
   SpillWriteFile(
       uint32_t id,
       const std::string& pathPrefix,
-      const std::string& fileCreateConfig);
+      const std::string& fileCreateConfig,
+      common::SpillDevice* device);
 
   // The spill file id which is monotonically increasing and unique for each
   // associated spill partition.
   const uint32_t id_;
   const std::string path_;
+  common::SpillDevice* const device_;
 
   std::unique_ptr<WriteFile> file_;
   // Byte size of the backing file. Set when finishing writing.
@@ -90,10 +99,95 @@ struct SpillFileInfo {
   uint32_t numSortKeys;
   std::vector<CompareFlags> sortFlags;
   common::CompressionKind compressionKind;
+  /// True if the file is written in the columnar spill format instead of the
+  /// Presto serialization format. See SpillEncoding.h.
+  bool columnarEncoded{false};
 };
 
 using SpillFiles = std::vector<SpillFileInfo>;
 
+/// Writes the serialized spill data to spill files on an executor so that the
+/// spilling thread can serialize and compress the next batch while the previous
+/// one is being written. The buffers are written in FIFO order by at most one
+/// thread at a time. The spilling thread blocks when 'maxPendingWrites' buffers
+/// are already queued in addition to the one being written.
+///
+/// NOTE: the write task scheduled on the executor holds a reference to the
+/// queue as it might run after the owning spill writer has gone. The owner must
+/// drain or abort the queue before destroying the files being written.
+class SpillWriteQueue : public std::enable_shared_from_this<SpillWriteQueue> {
+ public:
+  static std::shared_ptr<SpillWriteQueue> create(
+      folly::Executor* executor,
+      uint32_t maxPendingWrites,
+      folly::Synchronized<common::SpillStats>* stats);
+
+  /// Enqueues 'iobuf' to write to 'file'. 'flushTimeNs' is the time spent on
+  /// producing 'iobuf' which is recorded with the disk write stats. Blocks if
+  /// the queue is full. Throws if any previous write has failed.
+  void enqueue(
+      SpillWriteFile* file,
+      std::unique_ptr<folly::IOBuf> iobuf,
+      uint64_t flushTimeNs);
+
+  /// Waits for all the enqueued buffers to be written. Throws if any write has
+  /// failed.
+  void drain();
+
+  /// Drops the buffers which are not written yet and waits for the one being
+  /// written if any. Used on the error path.
+  void abort();
+
+  /// Returns the number of buffers waiting to be written.
+  size_t numPending() const;
+
+ private:
+  struct PendingWrite {
+    SpillWriteFile* file;
+    std::unique_ptr<folly::IOBuf> iobuf;
+    uint64_t flushTimeNs;
+  };
+
+  SpillWriteQueue(
+      folly::Executor* executor,
+      uint32_t maxPendingWrites,
+      folly::Synchronized<common::SpillStats>* stats);
+
+  // Waits until at most 'maxPending' buffers are queued and, if 'idle' is
+  // true, no buffer is being written. If no thread is writing, the caller
+  // writes the queued buffers itself instead of waiting. This avoids the
+  // deadlock when all the executor threads are blocked on spilling. Returns
+  // the time spent on waiting for another thread to write.
+  uint64_t waitLocked(
+      std::unique_lock<std::mutex>& lock,
+      size_t maxPending,
+      bool idle);
+
+  // Writes the queued buffers until the queue is empty or a write fails.
+  // 'lock' holds 'mutex_' on entry and exit and is released while writing.
+  void writeLocked(std::unique_lock<std::mutex>& lock);
+
+  // Schedules a write task on 'executor_' if there is none scheduled or
+  // running.
+  void maybeScheduleLocked();
+
+  void recordWaitTime(uint64_t waitTimeNs);
+
+  folly::Executor* const executor_;
+  const uint32_t maxPendingWrites_;
+  folly::Synchronized<common::SpillStats>* const stats_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<PendingWrite> pending_;
+  // True if a write task is scheduled on 'executor_' but not started yet.
+  bool scheduled_{false};
+  // True if a thread is writing the queued buffers.
+  bool writing_{false};
+  // The first write error which is rethrown to the spilling thread.
+  std::exception_ptr error_;
+};
+
 /// Used to write the spilled data to a sequence of files for one partition. If
 /// data is sorted, each file is sorted. The globally sorted order is produced
 /// by merging the constituent files.
@@ -106,7 +200,13 @@ class SpillWriter {
   /// write to file. 'fileOptions' specifies the file layout on remote storage
   /// which is storage system specific. 'pool' is used for buffering and
   /// constructing the result data read from 'this'. 'stats' is used to collect
-  /// the spill write stats.
+  /// the spill write stats. If 'executor' is set and 'maxPendingWrites' is not
+  /// zero, the serialized data is written to disk asynchronously on
+  /// 'executor' with up to 'maxPendingWrites' buffers queued. If
+  /// 'columnarEncoding' is true and 'type' only has scalar columns, the data
+  /// is written in the columnar spill format with per-column encodings. If
+  /// 'directorySelector' is set, 'pathPrefix' is a file name prefix and each
+  /// file is created in the directory chosen by the selector.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -121,7 +221,13 @@ class SpillWriter {
       const std::string& fileCreateConfig,
       common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
       memory::MemoryPool* pool,
-      folly::Synchronized<common::SpillStats>* stats);
+      folly::Synchronized<common::SpillStats>* stats,
+      folly::Executor* executor = nullptr,
+      uint32_t maxPendingWrites = 0,
+      bool columnarEncoding = false,
+      common::SpillDirectorySelector* directorySelector = nullptr);
+
+  ~SpillWriter();
 
   /// Adds 'rows' for the positions in 'indices' into 'this'. The indices
   /// must produce a view where the rows are sorted if sorting is desired.
@@ -162,22 +268,23 @@ class SpillWriter {
   // Closes the current open spill file pointed by 'currentFile_'.
   void closeFile();
 
-  // Writes data from 'batch_' to the current output file. Returns the actual
-  // written size.
+  // Writes data from 'batch_' or 'pendingRows_' to the current output file.
+  // Returns the actual written size. If 'writeQueue_' is set, the data is
+  // queued for write and the function returns the queued size.
   uint64_t flush();
 
+  // Copies the rows in 'indices' to 'pendingRows_' to encode in the columnar
+  // spill format on flush. Returns the number of copied rows.
+  vector_size_t appendPendingRows(
+      const RowVectorPtr& rows,
+      const folly::Range<IndexRange*>& indices);
+
   // Invoked to increment the number of spilled files and the file size.
   void updateSpilledFileStats(uint64_t fileSize);
 
   // Invoked to update the number of spilled rows.
   void updateAppendStats(uint64_t numRows, uint64_t serializationTimeUs);
 
-  // Invoked to update the disk write stats.
-  void updateWriteStats(
-      uint64_t spilledBytes,
-      uint64_t flushTimeUs,
-      uint64_t writeTimeUs);
-
   const RowTypePtr type_;
   const uint32_t numSortKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
@@ -186,6 +293,9 @@ class SpillWriter {
   const uint64_t targetFileSize_;
   const uint64_t writeBufferSize_;
   const std::string fileCreateConfig_;
+  // True if the data is written in the columnar spill format.
+  const bool columnarEncoding_;
+  common::SpillDirectorySelector* const directorySelector_;
 
   // Updates the aggregated spill bytes of this query, and throws if exceeds
   // the max spill bytes limit.
@@ -197,8 +307,17 @@ class SpillWriter {
   bool finished_{false};
   uint32_t nextFileId_{0};
   std::unique_ptr<VectorStreamGroup> batch_;
+  // The buffered rows to write in the columnar spill format.
+  RowVectorPtr pendingRows_;
+  // The estimated flat size of 'pendingRows_'. Tracked on append so that it is
+  // not recomputed over all the buffered rows on each write.
+  uint64_t pendingBytes_{0};
   std::unique_ptr<SpillWriteFile> currentFile_;
+  // The bytes written or queued for write to 'currentFile_'.
+  uint64_t currentFileSize_{0};
   SpillFiles finishedFiles_;
+  // Set if the spilled data is written asynchronously.
+  std::shared_ptr<SpillWriteQueue> writeQueue_;
 };
 
 /// Represents a spill file for read which turns the serialized spilled data
@@ -249,6 +368,7 @@ class SpillReadFile {
       uint32_t numSortKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       common::CompressionKind compressionKind,
+      bool columnarEncoded,
       memory::MemoryPool* pool,
       folly::Synchronized<common::SpillStats>* stats);
 
@@ -266,6 +386,8 @@ class SpillReadFile {
   const uint32_t numSortKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const common::CompressionKind compressionKind_;
+  // True if the file is in the columnar spill format.
+  const bool columnarEncoded_;
   const serializer::presto::PrestoVectorSerde::PrestoOptions readOptions_;
   memory::MemoryPool* const pool_;
   VectorSerde* const serde_;
@@ -27,6 +27,32 @@
 using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::exec {
+namespace {
+// Bounds the number of partition spill writes running on the spill executors
+// in the process by FLAGS_velox_spill_max_concurrent_writes. It never blocks.
+// A write that doesn't get a slot is not handed to the executor and runs on
+// the spilling thread instead. The flag is read on each acquire so that it can
+// be changed at runtime.
+class ExecutorWriteLimiter {
+ public:
+  static bool tryAcquire() {
+    const auto numWrites = numWrites_.fetch_add(1);
+    const auto maxWrites = FLAGS_velox_spill_max_concurrent_writes;
+    if (maxWrites > 0 && numWrites >= maxWrites) {
+      release();
+      return false;
+    }
+    return true;
+  }
+
+  static void release() {
+    VELOX_CHECK_GT(numWrites_.fetch_sub(1), 0);
+  }
+
+ private:
+  static inline std::atomic<int32_t> numWrites_{0};
+};
+} // namespace
 
 SpillerBase::SpillerBase(
     RowContainer* container,
@@ -57,7 +83,11 @@ SpillerBase::SpillerBase(
           spillConfig->prefixSortConfig,
           memory::spillMemoryPool(),
           spillStats,
-          spillConfig->fileCreateConfig) {
+          spillConfig->fileCreateConfig,
+          spillConfig->executor,
+          spillConfig->maxPendingWrites,
+          spillConfig->columnarEncoding,
+          spillConfig->directorySelector.get()) {
   TestValue::adjust("facebook::velox::exec::SpillerBase", this);
 
   spillRuns_.reserve(state_.maxPartitions());
@@ -101,6 +131,85 @@ void SpillerBase::spill(const RowContainerIterator* startRowIter) {
   checkEmptySpillRuns();
 }
 
+void SpillerBase::spill(
+    const SpillPartitionNumSet& partitions,
+    folly::Range<const uint8_t*> rowPartitions) {
+  VELOX_CHECK(!finalized_);
+  VELOX_CHECK(!partitions.empty());
+  VELOX_CHECK_EQ(rowPartitions.size(), container_->numRows());
+
+  for (const auto partition : partitions) {
+    VELOX_CHECK_LT(partition, state_.maxPartitions());
+    if (!state_.isPartitionSpilled(partition)) {
+      state_.setPartitionSpilled(partition);
+    }
+  }
+
+  RowContainerIterator rowIter;
+  size_t nextRow{0};
+  std::vector<char*> spilledRows;
+  bool lastRun{false};
+  do {
+    lastRun = fillSpillRuns(&rowIter, partitions, rowPartitions, nextRow);
+    for (const auto partition : partitions) {
+      const auto& rows = spillRuns_[partition].rows;
+      spilledRows.insert(spilledRows.end(), rows.begin(), rows.end());
+    }
+    runSpill(lastRun);
+    // The rows have been written out. Their space is freed for reuse by the
+    // rows added later. The iterator only moves forward and skips the freed
+    // rows, so 'nextRow' stays in sync with 'rowPartitions'.
+    container_->eraseRows(
+        folly::Range<char**>(spilledRows.data(), spilledRows.size()));
+    spilledRows.clear();
+  } while (!lastRun);
+
+  checkEmptySpillRuns();
+}
+
+bool SpillerBase::fillSpillRuns(
+    RowContainerIterator* iterator,
+    const SpillPartitionNumSet& partitions,
+    folly::Range<const uint8_t*> rowPartitions,
+    size_t& nextRow) {
+  checkEmptySpillRuns();
+
+  bool lastRun{false};
+  uint64_t execTimeNs{0};
+  {
+    NanosecondTimer timer(&execTimeNs);
+
+    constexpr int32_t kBatchSize = 4096;
+    std::vector<char*> rows(kBatchSize);
+    uint64_t totalRows{0};
+    for (;;) {
+      const auto numRows = container_->listRows(
+          iterator, rows.size(), RowContainer::kUnlimited, rows.data());
+      if (numRows == 0) {
+        lastRun = true;
+        break;
+      }
+      VELOX_CHECK_LE(nextRow + numRows, rowPartitions.size());
+      for (auto i = 0; i < numRows; ++i) {
+        const auto partition = rowPartitions[nextRow++];
+        if (!partitions.contains(partition)) {
+          continue;
+        }
+        spillRuns_[partition].rows.push_back(rows[i]);
+        spillRuns_[partition].numBytes += container_->rowSize(rows[i]);
+      }
+
+      totalRows += numRows;
+      if (maxSpillRunRows_ > 0 && totalRows >= maxSpillRunRows_) {
+        break;
+      }
+    }
+  }
+  updateSpillFillTime(execTimeNs);
+
+  return lastRun;
+}
+
 bool SpillerBase::fillSpillRuns(RowContainerIterator* iterator) {
   checkEmptySpillRuns();
 
@@ -161,17 +270,25 @@ void SpillerBase::runSpill(bool lastRun) {
 
   std::vector<std::shared_ptr<AsyncSource<SpillStatus>>> writes;
   for (auto partition = 0; partition < spillRuns_.size(); ++partition) {
+    if (spillRuns_[partition].rows.empty()) {
+      continue;
+    }
     VELOX_CHECK(
         state_.isPartitionSpilled(partition),
         "Partition {} is not marked as spilled",
         partition);
-    if (spillRuns_[partition].rows.empty()) {
-      continue;
-    }
     writes.push_back(memory::createAsyncMemoryReclaimTask<SpillStatus>(
         [partition, this]() { return writeSpill(partition); }));
-    if ((writes.size() > 1) && executor_ != nullptr) {
-      executor_->add([source = writes.back()]() { source->prepare(); });
+    // The first write and the ones over the executor write limit are made on
+    // this thread when their results are moved below. The executor slot is
+    // released when the task is destroyed, whether it has run or not.
+    if ((writes.size() > 1) && executor_ != nullptr &&
+        ExecutorWriteLimiter::tryAcquire()) {
+      executor_->add(
+          [source = writes.back(),
+           slot = folly::makeGuard(&ExecutorWriteLimiter::release)]() {
+            source->prepare();
+          });
     }
   }
   auto sync = folly::makeGuard([&]() {
@@ -200,10 +317,6 @@ void SpillerBase::runSpill(bool lastRun) {
     auto& run = spillRuns_[partition];
     VELOX_CHECK_EQ(numWritten, run.rows.size());
     run.clear();
-    // When a sorted run ends, we start with a new file next time.
-    if (needSort()) {
-      state_.finishFile(partition);
-    }
   }
 }
 
@@ -215,6 +328,8 @@ std::unique_ptr<SpillerBase::SpillStatus> SpillerBase::writeSpill(
   constexpr int32_t kTargetBatchBytes = 1 << 18; // 256K
   constexpr int32_t kTargetBatchRows = 64;
 
+  TestValue::adjust("facebook::velox::exec::SpillerBase::writeSpill", this);
+
   RowVectorPtr spillVector;
   auto& run = spillRuns_[partition];
   try {
@@ -225,6 +340,12 @@ std::unique_ptr<SpillerBase::SpillStatus> SpillerBase::writeSpill(
           run.rows, kTargetBatchRows, kTargetBatchBytes, spillVector, written);
       state_.appendToPartition(partition, spillVector);
     }
+    // When a sorted run ends, we start with a new file next time. The file is
+    // closed here so that flushing the buffered data and waiting for the
+    // pending disk writes also run in parallel across partitions.
+    if (needSort()) {
+      state_.finishFile(partition);
+    }
     return std::make_unique<SpillStatus>(partition, written, nullptr);
   } catch (const std::exception&) {
     // The exception is passed to the caller thread which checks this in
@@ -408,6 +529,25 @@ void SortInputSpiller::spill() {
   SpillerBase::spill(nullptr);
 }
 
+void SortInputSpiller::runSpill(bool lastRun) {
+  if (maxRunRows_.has_value()) {
+    const auto maxRunRows = maxRunRows_.value();
+    for (auto& run : spillRuns_) {
+      if (run.rows.size() <= maxRunRows) {
+        continue;
+      }
+      ensureSorted(run);
+      for (auto i = maxRunRows; i < run.rows.size(); ++i) {
+        run.numBytes -= container_->rowSize(run.rows[i]);
+      }
+      numTruncatedRows_ += run.rows.size() - maxRunRows;
+      run.rows.resize(maxRunRows);
+      boundaryRows_.push_back(run.rows.back());
+    }
+  }
+  SpillerBase::runSpill(lastRun);
+}
+
 SortOutputSpiller::SortOutputSpiller(
     RowContainer* container,
     RowTypePtr rowType,
@@ -15,11 +15,15 @@
  */
 #pragma once
 
+#include <gflags/gflags.h>
+
 #include "velox/common/base/SpillConfig.h"
 #include "velox/common/compression/Compression.h"
 #include "velox/exec/HashBitRange.h"
 #include "velox/exec/RowContainer.h"
 
+DECLARE_int32(velox_spill_max_concurrent_writes);
+
 namespace facebook::velox::exec {
 namespace test {
 class SpillerTest;
@@ -65,6 +69,15 @@ class SpillerBase {
   // from row container starting at the offset pointed by 'startRowIter'.
   void spill(const RowContainerIterator* startRowIter);
 
+  // Invoked to spill the rows of 'partitions' from the row container.
+  // 'rowPartitions' has the spill partition of each row in the row container
+  // in the listRows() order. The spilled rows are erased from the row
+  // container after each run is written, so that their space is reused by
+  // the rows added later without growing the row container.
+  void spill(
+      const SpillPartitionNumSet& partitions,
+      folly::Range<const uint8_t*> rowPartitions);
+
   // Writes out all the rows collected in spillRuns_.
   virtual void runSpill(bool lastRun);
 
@@ -85,6 +98,9 @@ class SpillerBase {
 
   void checkEmptySpillRuns() const;
 
+  // Sorts 'run' if not already sorted.
+  void ensureSorted(SpillRun& run);
+
   // Represents a run of rows from a spillable partition of
   // a RowContainer. Rows that hash to the same partition are accumulated here
   // and sorted in the case of sorted spilling. The run is then
@@ -165,13 +181,20 @@ class SpillerBase {
   // The function returns true if it is the last spill run.
   bool fillSpillRuns(RowContainerIterator* startRowIter = nullptr);
 
+  // Prepares spill runs for the rows of 'partitions' taking the partition of
+  // each row from 'rowPartitions'. 'nextRow' is the index in 'rowPartitions'
+  // of the next row listed by 'iterator' and is advanced past the listed
+  // rows. The function returns true if it is the last spill run.
+  bool fillSpillRuns(
+      RowContainerIterator* iterator,
+      const SpillPartitionNumSet& partitions,
+      folly::Range<const uint8_t*> rowPartitions,
+      size_t& nextRow);
+
   void updateSpillExtractVectorTime(uint64_t timeNs);
 
   void updateSpillSortTime(uint64_t timeNs);
 
-  // Sorts 'run' if not already sorted.
-  void ensureSorted(SpillRun& run);
-
   // Extracts up to 'maxRows' or 'maxBytes' from 'rows' into 'spillVector'. The
   // extract starts at nextBatchIndex and updates nextBatchIndex to be the
   // index of the first non-extracted element of 'rows'. Returns the byte size
@@ -227,7 +250,8 @@ class SortInputSpiller : public SpillerBase {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const common::SpillConfig* spillConfig,
-      folly::Synchronized<common::SpillStats>* spillStats)
+      folly::Synchronized<common::SpillStats>* spillStats,
+      std::optional<uint64_t> maxRunRows = std::nullopt)
       : SpillerBase(
             container,
             std::move(rowType),
@@ -237,11 +261,32 @@ class SortInputSpiller : public SpillerBase {
             std::numeric_limits<uint64_t>::max(),
             spillConfig->maxSpillRunRows,
             spillConfig,
-            spillStats) {}
+            spillStats),
+        maxRunRows_(maxRunRows) {
+    VELOX_CHECK(!maxRunRows_.has_value() || maxRunRows_.value() > 0);
+  }
 
   void spill();
 
+  /// Returns the last row of each sorted run truncated to 'maxRunRows' since
+  /// the last call, and clears them. The returned rows are still in the row
+  /// container until it is cleared.
+  std::vector<char*> takeBoundaryRows() {
+    return std::move(boundaryRows_);
+  }
+
+  /// Returns the number of rows dropped from the sorted runs truncated to
+  /// 'maxRunRows'.
+  uint64_t numTruncatedRows() const {
+    return numTruncatedRows_;
+  }
+
  private:
+  // Truncates each sorted run to its first 'maxRunRows_' rows if set, as the
+  // rows after them can't be in the first 'maxRunRows_' rows of the merged
+  // output.
+  void runSpill(bool lastRun) override;
+
   std::string type() const override {
     return std::string(kType);
   }
@@ -249,6 +294,12 @@ class SortInputSpiller : public SpillerBase {
   bool needSort() const override {
     return true;
   }
+
+  const std::optional<uint64_t> maxRunRows_;
+
+  std::vector<char*> boundaryRows_;
+
+  uint64_t numTruncatedRows_{0};
 };
 
 class SortOutputSpiller : public SpillerBase {
@@ -462,6 +462,13 @@ const std::string& Task::getOrCreateSpillDirectory() {
 
     auto fileSystem = filesystems::getFileSystem(spillDirectory_, nullptr);
     fileSystem->mkdir(spillDirectory_);
+    if (spillDirectorySelector_ != nullptr) {
+      for (const auto& directory : spillDirectorySelector_->directories()) {
+        if (directory != spillDirectory_) {
+          filesystems::getFileSystem(directory, nullptr)->mkdir(directory);
+        }
+      }
+    }
   } catch (const std::exception& e) {
     VELOX_FAIL(
         "Failed to create spill directory '{}' for Task {}: {}",
@@ -473,16 +480,37 @@ const std::string& Task::getOrCreateSpillDirectory() {
   return spillDirectory_;
 }
 
+void Task::setSpillDirectories(
+    const std::vector<std::string>& spillDirectories,
+    bool alreadyCreated) {
+  VELOX_CHECK(!spillDirectories.empty(), "No spill directory specified");
+  setSpillDirectory(spillDirectories.front(), alreadyCreated);
+  if (spillDirectories.size() == 1) {
+    spillDirectorySelector_.reset();
+    return;
+  }
+  spillDirectorySelector_ = std::make_shared<common::SpillDirectorySelector>(
+      spillDirectories,
+      common::SpillDirectorySelector::toPolicy(
+          queryCtx_->queryConfig().spillDirectorySelectionPolicy()));
+}
+
 void Task::removeSpillDirectoryIfExists() {
   if (spillDirectory_.empty() || !spillDirectoryCreated_) {
     return;
   }
-  try {
-    auto fs = filesystems::getFileSystem(spillDirectory_, nullptr);
-    fs->rmdir(spillDirectory_);
-  } catch (const std::exception& e) {
-    LOG(ERROR) << "Failed to remove spill directory '" << spillDirectory_
-               << "' for Task " << taskId() << ": " << e.what();
+  std::vector<std::string> spillDirectories{spillDirectory_};
+  if (spillDirectorySelector_ != nullptr) {
+    spillDirectories = spillDirectorySelector_->directories();
+  }
+  for (const auto& directory : spillDirectories) {
+    try {
+      auto fs = filesystems::getFileSystem(directory, nullptr);
+      fs->rmdir(directory);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Failed to remove spill directory '" << directory
+                 << "' for Task " << taskId() << ": " << e.what();
+    }
   }
 }
 
@@ -613,15 +641,54 @@ velox::memory::MemoryPool* Task::addMergeSourcePool(
 
 velox::memory::MemoryPool* Task::addExchangeClientPool(
     const core::PlanNodeId& planNodeId,
-    uint32_t pipelineId) {
+    uint32_t pipelineId,
+    bool spillable) {
   auto* nodePool = getOrAddNodePool(planNodeId);
   childPools_.push_back(nodePool->addLeafChild(
       fmt::format("exchangeClient.{}.{}", planNodeId, pipelineId),
       true,
-      createExchangeClientReclaimer()));
+      spillable ? nullptr : createExchangeClientReclaimer()));
   return childPools_.back().get();
 }
 
+std::optional<common::SpillConfig> Task::makeSerializedPageSpillConfig(
+    const std::string& fileNamePrefix) {
+  const auto& queryConfig = queryCtx_->queryConfig();
+  if (!queryConfig.spillEnabled()) {
+    return std::nullopt;
+  }
+  if (spillDirectory_.empty() && !hasCreateSpillDirectoryCb()) {
+    return std::nullopt;
+  }
+  common::GetSpillDirectoryPathCB getSpillDirPathCb =
+      [this]() -> std::string_view { return getOrCreateSpillDirectory(); };
+  common::UpdateAndCheckSpillLimitCB updateAndCheckSpillLimitCb =
+      [this](uint64_t bytes) {
+        queryCtx_->updateSpilledBytesAndCheckLimit(bytes);
+      };
+  return common::SpillConfig(
+      std::move(getSpillDirPathCb),
+      std::move(updateAndCheckSpillLimitCb),
+      fileNamePrefix,
+      queryConfig.maxSpillFileSize(),
+      queryConfig.spillWriteBufferSize(),
+      queryConfig.spillReadBufferSize(),
+      queryCtx_->spillExecutor(),
+      queryConfig.minSpillableReservationPct(),
+      queryConfig.spillableReservationGrowthPct(),
+      queryConfig.spillStartPartitionBit(),
+      queryConfig.spillNumPartitionBits(),
+      queryConfig.maxSpillLevel(),
+      queryConfig.maxSpillRunRows(),
+      queryConfig.writerFlushThresholdBytes(),
+      queryConfig.spillCompressionKind(),
+      std::nullopt,
+      queryConfig.spillFileCreateConfig(),
+      queryConfig.spillMaxPendingWrites(),
+      queryConfig.spillColumnarEncodingEnabled(),
+      spillDirectorySelector_);
+}
+
 bool Task::supportSerialExecutionMode() const {
   if (consumerSupplier_) {
     return false;
@@ -3003,6 +3070,14 @@ void Task::createExchangeClientLocked(
       getExchangeClientLocked(planNodeId),
       "Exchange client has been created for planNode: {}",
       planNodeId);
+  std::optional<common::SpillConfig> spillConfig;
+  if (queryCtx()->queryConfig().exchangeSpillEnabled() &&
+      pool()->reclaimer() != nullptr) {
+    spillConfig = makeSerializedPageSpillConfig(
+        fmt::format("exchange_{}_{}", planNodeId, pipelineId));
+  }
+  auto* exchangeClientPool = addExchangeClientPool(
+      planNodeId, pipelineId, /*spillable=*/spillConfig.has_value());
   // Low-water mark for filling the exchange queue is 1/2 of the per worker
   // buffer size of the producers.
   exchangeClients_[pipelineId] = std::make_shared<ExchangeClient>(
@@ -3011,9 +3086,15 @@ void Task::createExchangeClientLocked(
       queryCtx()->queryConfig().maxExchangeBufferSize(),
       numberOfConsumers,
       queryCtx()->queryConfig().minExchangeOutputBatchBytes(),
-      addExchangeClientPool(planNodeId, pipelineId),
+      exchangeClientPool,
       queryCtx()->executor(),
       queryCtx()->queryConfig().requestDataSizesMaxWaitSec());
+  if (spillConfig.has_value()) {
+    const auto& queue = exchangeClients_[pipelineId]->queue();
+    queue->enableSpill(spillConfig.value(), exchangeClientPool);
+    exchangeClientPool->setReclaimer(
+        ExchangeClient::MemoryReclaimer::create(queue));
+  }
   exchangeClientByPlanNode_.emplace(planNodeId, exchangeClients_[pipelineId]);
 }
 
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/common/base/SkewedPartitionBalancer.h"
+#include "velox/common/base/SpillDirectorySelector.h"
 #include "velox/common/base/TraceConfig.h"
 #include "velox/core/PlanFragment.h"
 #include "velox/core/QueryCtx.h"
@@ -110,6 +111,24 @@ class Task : public std::enable_shared_from_this<Task> {
     spillDirectoryCreated_ = alreadyCreated;
   }
 
+  /// Specifies multiple spill directories, e.g. one on each local disk, to
+  /// spread the spill files over. The first one is the spill directory of the
+  /// task as set by setSpillDirectory(). The directory for each spill file is
+  /// chosen with the query's spill directory selection policy. Set
+  /// 'alreadyCreated' to true if the directories have already been created by
+  /// the caller.
+  void setSpillDirectories(
+      const std::vector<std::string>& spillDirectories,
+      bool alreadyCreated = true);
+
+  /// Returns the selector which spreads the spill files over the directories
+  /// set by setSpillDirectories(), or nullptr if there is only one spill
+  /// directory.
+  const std::shared_ptr<common::SpillDirectorySelector>&
+  spillDirectorySelector() const {
+    return spillDirectorySelector_;
+  }
+
   void setCreateSpillDirectoryCb(
       std::function<std::string()> spillDirectoryCallback) {
     VELOX_CHECK_NULL(spillDirectoryCallback_);
@@ -696,6 +715,13 @@ class Task : public std::enable_shared_from_this<Task> {
   /// folder could not be created.
   const std::string& getOrCreateSpillDirectory();
 
+  /// Returns the spill config used to spill the serialized pages buffered in
+  /// this task's output buffer or exchange clients. 'fileNamePrefix' is used
+  /// to name the spill files under the spill directory. Returns std::nullopt
+  /// if spilling is not enabled or there is no spill directory set.
+  std::optional<common::SpillConfig> makeSerializedPageSpillConfig(
+      const std::string& fileNamePrefix);
+
   /// True if produces output via OutputBufferManager.
   bool hasPartitionedOutput() const {
     return numDriversInPartitionedOutput_ > 0;
@@ -836,10 +862,12 @@ class Task : public std::enable_shared_from_this<Task> {
 
   // Creates new instance of MemoryPool for the exchange client of an
   // ExchangeNode in a pipeline, stores it in the task to ensure lifetime and
-  // returns a raw pointer.
+  // returns a raw pointer. If 'spillable' is true, the caller sets the memory
+  // reclaimer after the exchange client has been created.
   velox::memory::MemoryPool* addExchangeClientPool(
       const core::PlanNodeId& planNodeId,
-      uint32_t pipelineId);
+      uint32_t pipelineId,
+      bool spillable = false);
 
   // Invoked to remove this task from the output buffer manager if it has set
   // output buffer.
@@ -1289,6 +1317,10 @@ class Task : public std::enable_shared_from_this<Task> {
   // Indicates whether the spill directory has been created.
   std::atomic<bool> spillDirectoryCreated_{false};
 
+  // Set if the task spills to multiple directories. The first directory is
+  // 'spillDirectory_'.
+  std::shared_ptr<common::SpillDirectorySelector> spillDirectorySelector_;
+
   // Stores unconsumed preloading splits to ensure they are closed promptly.
   folly::F14FastSet<std::shared_ptr<connector::ConnectorSplit>>
       preloadingSplits_;
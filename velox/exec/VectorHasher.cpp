@@ -52,6 +52,15 @@ namespace facebook::velox::exec {
   }()
 
 namespace {
+template <typename T>
+FOLLY_ALWAYS_INLINE uint64_t hashScalar(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return util::floating_point::NaNAwareHash<T>()(value);
+  } else {
+    return folly::hasher<T>()(value);
+  }
+}
+
 template <bool typeProvidesCustomComparison, TypeKind Kind>
 uint64_t hashOne(DecodedVector& decoded, vector_size_t index) {
   if constexpr (
@@ -68,13 +77,50 @@ uint64_t hashOne(DecodedVector& decoded, vector_size_t index) {
       return static_cast<const CanProvideCustomComparisonType<Kind>*>(
                  decoded.base()->type().get())
           ->hash(value);
-    } else if constexpr (std::is_floating_point_v<T>) {
-      return util::floating_point::NaNAwareHash<T>()(value);
     } else {
-      return folly::hasher<T>()(value);
+      return hashScalar(value);
     }
   }
 }
+
+// True if the values of a dictionary are gathered with SIMD before hashing.
+template <bool typeProvidesCustomComparison, TypeKind Kind>
+constexpr bool hashesGatheredValues() {
+  if constexpr (
+      typeProvidesCustomComparison || !TypeTraits<Kind>::isPrimitiveType) {
+    return false;
+  } else {
+    return DecodedVector::kSimdGather<
+        typename KindToFlatVector<Kind>::HashRowType>;
+  }
+}
+
+// Hashes the selected rows of a dictionary encoded 'decoded' after reading
+// the values through the indices a SIMD batch at a time into 'scratch'.
+template <TypeKind Kind>
+void hashGatheredValues(
+    DecodedVector& decoded,
+    const SelectivityVector& rows,
+    bool mix,
+    raw_vector<uint64_t>& scratch,
+    uint64_t* result) {
+  if constexpr (hashesGatheredValues<false, Kind>()) {
+    using T = typename KindToFlatVector<Kind>::HashRowType;
+    static_assert(sizeof(T) <= sizeof(uint64_t));
+    scratch.resize(rows.end());
+    auto* values = reinterpret_cast<T*>(scratch.data());
+    decoded.gatherValues(rows, values);
+    const auto* nulls = decoded.nulls(&rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      const auto hash = nulls != nullptr && bits::isBitNull(nulls, row)
+          ? BaseVector::kNullHash
+          : hashScalar(values[row]);
+      result[row] = mix ? bits::hashMix(result[row], hash) : hash;
+    });
+  } else {
+    VELOX_UNREACHABLE();
+  }
+}
 } // namespace
 
 template <bool typeProvidesCustomComparison, TypeKind Kind>
@@ -108,6 +154,10 @@ void VectorHasher::hashValues(
       }
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
+  } else if (
+      hashesGatheredValues<typeProvidesCustomComparison, Kind>() &&
+      !decoded_.isIdentityMapping()) {
+    hashGatheredValues<Kind>(decoded_, rows, mix, gatheredValues_, result);
   } else {
     rows.applyToSelected([&](vector_size_t row) {
       if (decoded_.isNullAt(row)) {
@@ -549,6 +549,8 @@ class VectorHasher {
 
   DecodedVector decoded_;
   raw_vector<uint64_t> cachedHashes_;
+  // Scratch for the values of a dictionary read with SIMD gathers.
+  raw_vector<uint64_t> gatheredValues_;
 
   // Single precomputed hash for constant partition keys.
   uint64_t precomputedHash_{0};
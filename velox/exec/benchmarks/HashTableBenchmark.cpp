@@ -38,6 +38,13 @@ DEFINE_int32(custom_num_ways, 10, "Number of build threads");
 
 DEFINE_bool(profile, false, "Generate perf profiles and memory stats");
 
+DEFINE_int64(
+    hugetlb_pool_gb,
+    0,
+    "If not zero, serves the hash tables from a pool of this many GB of "
+    "explicit huge pages instead of transparent huge pages. Needs as many "
+    "free huge pages in vm.nr_hugepages");
+
 DECLARE_bool(velox_time_allocations);
 
 using namespace facebook::velox;
@@ -628,6 +635,7 @@ int main(int argc, char** argv) {
   options.allocatorCapacity = 64UL << 30;
   options.useMmapArena = true;
   options.mmapArenaCapacityRatio = 1;
+  options.hugeTlbPoolBytes = FLAGS_hugetlb_pool_gb << 30;
   memory::MemoryManager::initialize(options);
   if (FLAGS_profile) {
     auto allocator = memory::MemoryManager::getInstance()->allocator();
@@ -684,5 +692,14 @@ int main(int argc, char** argv) {
   for (auto& result : results) {
     std::cout << result.toString() << std::endl;
   }
+  if (FLAGS_hugetlb_pool_gb != 0) {
+    auto* allocator = dynamic_cast<memory::MmapAllocator*>(
+        memory::MemoryManager::getInstance()->allocator());
+    const auto stats = allocator->hugeTlbPoolStats();
+    std::cout << "Huge TLB pool: capacity "
+              << succinctBytes(stats.capacityBytes) << " allocations "
+              << stats.numAllocations << " fallbacks " << stats.numFallbacks
+              << std::endl;
+  }
   return 0;
 }
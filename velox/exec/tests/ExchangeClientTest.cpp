@@ -933,6 +933,50 @@ TEST_P(ExchangeClientTest, minOutputBatchBytesMultipleConsumers) {
   client->close();
 }
 
+TEST_P(ExchangeClientTest, retainedBytes) {
+  auto client = std::make_shared<ExchangeClient>(
+      "test", 17, 100, 1, 0, pool(), executor());
+  const auto& queue = client->queue();
+  addSources(*queue, 1);
+
+  int numReleased{0};
+  auto ioBuf = folly::IOBuf::create(80);
+  ioBuf->append(80);
+  enqueue(
+      *queue,
+      std::make_unique<SerializedPage>(
+          std::move(ioBuf), [&](folly::IOBuf&) { ++numReleased; }, 1));
+
+  bool atEnd;
+  ContinueFuture future = ContinueFuture::makeEmpty();
+  auto pages = client->next(1, 1, &atEnd, &future);
+  ASSERT_EQ(1, pages.size());
+  ASSERT_EQ(queue->retainedBytes(), 0);
+
+  // Emulates a vector wrapping the page memory without copying.
+  auto inputStream = pages[0]->prepareStreamForDeserialize();
+  auto owner = inputStream->bufferOwner();
+  ASSERT_NE(owner, nullptr);
+  inputStream.reset();
+  pages.clear();
+  // The page memory is still counted against the queue limit.
+  ASSERT_EQ(queue->retainedBytes(), 80);
+  ASSERT_EQ(numReleased, 0);
+
+  owner.reset();
+  ASSERT_EQ(queue->retainedBytes(), 0);
+  ASSERT_EQ(numReleased, 1);
+
+  // A page released with the SerializedPage is not counted.
+  enqueue(*queue, makePage(10));
+  pages = client->next(1, 1, &atEnd, &future);
+  ASSERT_EQ(1, pages.size());
+  pages.clear();
+  ASSERT_EQ(queue->retainedBytes(), 0);
+
+  client->close();
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     ExchangeClientTest,
     ExchangeClientTest,
@@ -16,6 +16,7 @@
 #include "velox/exec/HashJoinBridge.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/exec/HashBuild.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/Spill.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -401,6 +402,58 @@ TEST_P(HashJoinBridgeTest, withSpill) {
   }
 }
 
+TEST_P(HashJoinBridgeTest, restoreByProbeSpillBytes) {
+  auto joinBridge = createJoinBridge();
+  for (int32_t i = 0; i < numBuilders_; ++i) {
+    joinBridge->addBuilder();
+  }
+  joinBridge->start();
+
+  SpillPartitionSet spillPartitionSet;
+  for (uint32_t partition = 0; partition < 4; ++partition) {
+    const SpillPartitionId id(startPartitionBitOffset_, partition);
+    spillPartitionSet.emplace(
+        id,
+        std::make_unique<SpillPartition>(
+            id, makeFakeSpillFiles(numSpillFilesPerPartition_)));
+  }
+  joinBridge->setHashTable(
+      createFakeHashTable(), std::move(spillPartitionSet), false, nullptr);
+
+  // The probe bytes are reported by multiple probe operators and accumulated.
+  const SpillPartitionId id1(startPartitionBitOffset_, 1);
+  const SpillPartitionId id2(startPartitionBitOffset_, 2);
+  const SpillPartitionId id3(startPartitionBitOffset_, 3);
+  // Can't report the probe bytes of a partition which is not spilled.
+  VELOX_ASSERT_THROW(
+      joinBridge->addProbeSpillBytes(
+          {{SpillPartitionId(startPartitionBitOffset_ + 2, 0), 1}}),
+      "");
+  joinBridge->addProbeSpillBytes({{id1, 100}, {id2, 200}});
+  joinBridge->addProbeSpillBytes({{id1, 150}, {id3, 10}});
+
+  // The partitions are restored in the descending order of the probe bytes,
+  // and then in the partition order.
+  const std::vector<uint32_t> expectedRestoreOrder{1, 2, 3, 0};
+  auto buildFutures = createEmptyFutures(numBuilders_);
+  for (const auto expectedPartition : expectedRestoreOrder) {
+    ContinueFuture probeFuture;
+    ASSERT_TRUE(joinBridge->tableOrFuture(&probeFuture).has_value());
+    ASSERT_TRUE(joinBridge->probeFinished());
+    for (int32_t i = 0; i < numBuilders_; ++i) {
+      auto inputOr = joinBridge->spillInputOrFuture(&buildFutures[i]);
+      ASSERT_TRUE(inputOr.has_value());
+      ASSERT_EQ(
+          inputOr.value().spillPartition->id(),
+          SpillPartitionId(startPartitionBitOffset_, expectedPartition));
+    }
+    joinBridge->setHashTable(createFakeHashTable(), {}, false, nullptr);
+  }
+  ContinueFuture probeFuture;
+  ASSERT_TRUE(joinBridge->tableOrFuture(&probeFuture).has_value());
+  ASSERT_FALSE(joinBridge->probeFinished());
+}
+
 TEST_P(HashJoinBridgeTest, multiThreading) {
   for (int32_t iter = 0; iter < 10; ++iter) {
     std::vector<std::thread> builderThreads;
@@ -684,6 +737,44 @@ TEST_P(HashJoinBridgeTest, hashJoinTableType) {
   }
 }
 
+TEST(HashJoinBridgeTest, selectHybridSpillPartitions) {
+  using PartitionStats = HashBuildSpiller::PartitionStats;
+  struct {
+    std::vector<PartitionStats> partitionStats;
+    uint64_t targetBytes;
+    std::vector<uint32_t> expectedPartitions;
+
+    std::string debugString() const {
+      return fmt::format(
+          "targetBytes: {}, numExpectedPartitions: {}",
+          targetBytes,
+          expectedPartitions.size());
+    }
+  } testSettings[] = {
+      // Spills the partitions with the fewest rows per byte first.
+      {{{100, 1'000}, {10, 1'000}, {100, 2'000}, {50, 1'000}}, 1'000, {1}},
+      {{{100, 1'000}, {10, 1'000}, {100, 2'000}, {50, 1'000}}, 1'001, {1, 2}},
+      // Spills the larger partitions first if the rows per byte are the same.
+      {{{10, 1'000}, {30, 3'000}, {20, 2'000}, {0, 0}}, 2'000, {1}},
+      // Spills half of the bytes if there is no target.
+      {{{10, 1'000}, {30, 3'000}, {20, 2'000}, {0, 0}}, 0, {1}},
+      {{{10, 1'000}, {10, 1'000}, {10, 1'000}, {10, 1'000}}, 0, {0, 1}},
+      // Spills all the partitions if the target can't be met otherwise.
+      {{{10, 1'000}, {10, 1'000}, {0, 0}, {0, 0}}, 1'500, {}},
+      {{{10, 1'000}, {0, 0}, {0, 0}, {0, 0}}, 1, {}},
+      {{{0, 0}, {0, 0}}, 0, {}}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    const auto partitions = selectHybridSpillPartitions(
+        testData.partitionStats, testData.targetBytes);
+    ASSERT_EQ(
+        partitions,
+        SpillPartitionNumSet(
+            testData.expectedPartitions.begin(),
+            testData.expectedPartitions.end()));
+  }
+}
+
 TEST(HashJoinBridgeTest, hashJoinTableSpillType) {
   const RowTypePtr tableType = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
   const RowTypePtr spillTypeWithProbedFlag =
@@ -4793,6 +4793,141 @@ TEST_F(HashJoinTest, spillFileSize) {
   }
 }
 
+DEBUG_ONLY_TEST_F(HashJoinTest, hybridSpill) {
+  constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
+  // No null keys so that all the build rows are stored in the table.
+  VectorFuzzer fuzzer({.vectorSize = 1000, .nullRatio = 0}, pool());
+  const int32_t numBuildVectors = 10;
+  std::vector<RowVectorPtr> buildVectors;
+  for (int32_t i = 0; i < numBuildVectors; ++i) {
+    buildVectors.push_back(fuzzer.fuzzRow(buildType_));
+  }
+  const int32_t numProbeVectors = 5;
+  std::vector<RowVectorPtr> probeVectors;
+  for (int32_t i = 0; i < numProbeVectors; ++i) {
+    probeVectors.push_back(fuzzer.fuzzRow(probeType_));
+  }
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  struct {
+    core::JoinType joinType;
+    std::string referenceQuery;
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       "SELECT t_k1, t_k2, t_v1, u_k1, u_k2, u_v1 FROM t, u "
+       "WHERE t.t_k1 = u.u_k1"},
+      {core::JoinType::kLeft,
+       "SELECT t_k1, t_k2, t_v1, u_k1, u_k2, u_v1 FROM t LEFT JOIN u "
+       "ON t.t_k1 = u.u_k1"},
+      {core::JoinType::kRight,
+       "SELECT t_k1, t_k2, t_v1, u_k1, u_k2, u_v1 FROM t RIGHT JOIN u "
+       "ON t.t_k1 = u.u_k1"},
+      {core::JoinType::kFull,
+       "SELECT t_k1, t_k2, t_v1, u_k1, u_k2, u_v1 FROM t FULL OUTER JOIN u "
+       "ON t.t_k1 = u.u_k1"}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(core::joinTypeName(testData.joinType));
+
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    auto queryPool = memory::memoryManager()->addRootPool(
+        "", kMaxBytes, memory::MemoryReclaimer::create());
+
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors, false)
+                    .hashJoin(
+                        {"t_k1"},
+                        {"u_k1"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors, false)
+                            .planNode(),
+                        "",
+                        concat(probeType_->names(), buildType_->names()),
+                        testData.joinType)
+                    .planNode();
+
+    folly::EventCount driverWait;
+    auto driverWaitKey = driverWait.prepareWait();
+    folly::EventCount testWait;
+    auto testWaitKey = testWait.prepareWait();
+
+    std::atomic<int> numInputs{0};
+    Operator* op;
+    SCOPED_TESTVALUE_SET(
+        "facebook::velox::exec::Driver::runInternal::addInput",
+        std::function<void(Operator*)>(([&](Operator* testOp) {
+          if (testOp->operatorType() != "HashBuild") {
+            return;
+          }
+          op = testOp;
+          // Reclaims after half of the build input is in the table.
+          if (++numInputs != numBuildVectors / 2 + 1) {
+            return;
+          }
+          testWait.notify();
+          driverWait.wait(driverWaitKey);
+        })));
+
+    std::thread taskThread([&]() {
+      HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+          .numDrivers(1)
+          .planNode(plan)
+          .queryPool(std::move(queryPool))
+          .injectSpill(false)
+          .spillDirectory(tempDirectory->getPath())
+          .referenceQuery(testData.referenceQuery)
+          .config(core::QueryConfig::kHashJoinHybridSpillEnabled, "true")
+          .config(core::QueryConfig::kSpillStartPartitionBit, "29")
+          .verifier([&](const std::shared_ptr<Task>& task, bool /*unused*/) {
+            const auto statsPair = taskSpilledStats(*task);
+            ASSERT_GT(statsPair.first.spilledPartitions, 0);
+            ASSERT_LT(statsPair.first.spilledPartitions, 8);
+          })
+          .run();
+    });
+
+    testWait.wait(testWaitKey);
+    ASSERT_TRUE(op != nullptr);
+    auto task = op->testingOperatorCtx()->task();
+    auto taskPauseWait = task->requestPause();
+    driverWait.notify();
+    taskPauseWait.wait();
+
+    const auto numRows = op->stats(false).inputPositions;
+    const auto usedBytes = op->pool()->usedBytes();
+    const auto peakBytes = op->pool()->peakBytes();
+    const auto* rows = static_cast<HashBuild*>(op)->testingRows();
+    ASSERT_EQ(rows->numRows(), numRows);
+    const auto numFreeRows = rows->freeSpace().first;
+    const auto spilledRows = common::globalSpillStats().spilledRows;
+    {
+      memory::ScopedMemoryArbitrationContext ctx(op->pool());
+      // Spills about half of the row bytes without a reclaim target.
+      op->pool()->reclaim(0, 0, reclaimerStats_);
+    }
+    reclaimerStats_.reset();
+    const auto numSpilledRows =
+        common::globalSpillStats().spilledRows - spilledRows;
+    ASSERT_GT(numSpilledRows, 0);
+    ASSERT_LT(numSpilledRows, numRows);
+    // The spilled rows are freed in place for reuse while the other rows
+    // stay in memory. The reclaim does not copy the kept rows, so the memory
+    // usage never goes above the usage before the reclaim.
+    ASSERT_EQ(rows->numRows(), numRows - numSpilledRows);
+    ASSERT_EQ(rows->freeSpace().first, numFreeRows + numSpilledRows);
+    ASSERT_GT(op->pool()->usedBytes(), 0);
+    ASSERT_LE(op->pool()->usedBytes(), usedBytes);
+    ASSERT_EQ(op->pool()->peakBytes(), peakBytes);
+
+    Task::resume(task);
+    task.reset();
+
+    taskThread.join();
+  }
+}
+
 TEST_F(HashJoinTest, spillPartitionBitsOverlap) {
   auto builder =
       HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
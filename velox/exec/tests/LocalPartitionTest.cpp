@@ -231,6 +231,50 @@ TEST_F(LocalPartitionTest, partition) {
   verifyExchangeSourceOperatorStats(task, 300, 6, 2);
 }
 
+TEST_F(LocalPartitionTest, biasEncoding) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.emplace_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000,
+            [i](auto row) { return 1'000'000 + (i * 1'000 + row) % 200; }),
+        makeFlatVector<int32_t>(
+            1'000, [](auto row) { return -500 + row; }, nullEvery(7)),
+        makeFlatVector<int16_t>(1'000, [](auto row) { return row % 100; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // The columns are bias encoded in the queues and decoded by LocalExchange,
+  // so that the expressions downstream see flat vectors.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .localPartition({"c0"})
+                  .project({"c0", "c1 + 1 AS p1", "c2 + c2 AS p2"})
+                  .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .maxDrivers(2)
+      .config(core::QueryConfig::kLocalExchangeBiasEncodingEnabled, "true")
+      .assertResults("SELECT c0, c1 + 1, c2 + c2 FROM tmp");
+
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder().values(vectors).localPartition({"c0"}).planNode();
+  params.copyResult = false;
+  params.maxDrivers = 2;
+  params.queryConfigs[core::QueryConfig::kLocalExchangeBiasEncodingEnabled] =
+      "true";
+  auto [cursor, results] = readCursor(params, [](Task*) {});
+  vector_size_t numRows{0};
+  for (const auto& result : results) {
+    for (const auto& child : result->children()) {
+      ASSERT_EQ(child->encoding(), VectorEncoding::Simple::FLAT);
+    }
+    numRows += result->size();
+  }
+  ASSERT_EQ(numRows, 4'000);
+}
+
 TEST_F(LocalPartitionTest, maxBufferSizeGather) {
   std::vector<RowVectorPtr> vectors;
   for (auto i = 0; i < 21; i++) {
@@ -183,3 +183,69 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchRows, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+/// Verifies the merge with and without the normalized key prefix comparisons
+/// and the source read-ahead. The string keys share a common prefix longer
+/// than the string prefix length to exercise the fallback to the value
+/// comparison.
+TEST_F(MergeTest, normalizedKeysAndReadAhead) {
+  const vector_size_t batchSize = 100;
+  std::vector<std::vector<RowVectorPtr>> sourceVectors(3);
+  std::vector<RowVectorPtr> allVectors;
+  for (int32_t source = 0; source < sourceVectors.size(); ++source) {
+    for (int32_t batch = 0; batch < 4; ++batch) {
+      const auto offset = (source * 4 + batch) * batchSize;
+      auto vector = makeRowVector({
+          makeFlatVector<int16_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % 7 - 3; },
+              nullEvery(13)),
+          makeFlatVector<std::string>(
+              batchSize,
+              [&](auto row) {
+                return fmt::format(
+                    "common-string-prefix-{}", (offset + row) % 17);
+              },
+              nullEvery(11)),
+          makeFlatVector<double>(
+              batchSize, [&](auto row) { return (offset + row) * 0.1; }),
+      });
+      sourceVectors[source].push_back(vector);
+      allVectors.push_back(vector);
+    }
+  }
+  createDuckDbTable(allVectors);
+
+  const std::vector<std::string> orderByClauses = {
+      "c0 DESC NULLS FIRST", "c1 NULLS LAST", "c2"};
+  const auto orderBySql = fmt::format(
+      "SELECT * FROM tmp ORDER BY {}", folly::join(", ", orderByClauses));
+  for (const auto& normalizedKeyMaxBytes : {"0", "4", "128"}) {
+    for (const auto& readAheadBatches : {"0", "1", "3"}) {
+      SCOPED_TRACE(fmt::format(
+          "normalizedKeyMaxBytes: {}, readAheadBatches: {}",
+          normalizedKeyMaxBytes,
+          readAheadBatches));
+      auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+      std::vector<core::PlanNodePtr> sources;
+      for (const auto& vectors : sourceVectors) {
+        sources.push_back(PlanBuilder(planNodeIdGenerator)
+                              .values(vectors)
+                              .orderBy(orderByClauses, false)
+                              .planNode());
+      }
+      CursorParameters params;
+      params.planNode = PlanBuilder(planNodeIdGenerator)
+                            .localMerge(orderByClauses, std::move(sources))
+                            .planNode();
+      params.queryCtx = core::QueryCtx::create(executor_.get());
+      params.queryCtx->testingOverrideConfigUnsafe({
+          {core::QueryConfig::kPrefixSortNormalizedKeyMaxBytes,
+           normalizedKeyMaxBytes},
+          {core::QueryConfig::kMergeSourceReadAheadBatches, readAheadBatches},
+          {core::QueryConfig::kPreferredOutputBatchRows, "64"},
+      });
+      assertQueryOrdered(params, orderBySql, {0, 1, 2});
+    }
+  }
+}
@@ -2370,6 +2370,68 @@ TEST_F(RowContainerTest, store) {
   }
 }
 
+TEST_F(RowContainerTest, compactVariableWidthData) {
+  const uint64_t kNumRows = 10'000;
+  auto rowVector = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      makeFlatVector<std::string>(
+          kNumRows,
+          [](auto row) {
+            return std::string(20 + row % 300, 'a' + row % 26);
+          },
+          nullEvery(7)),
+      makeArrayVector<int64_t>(
+          kNumRows,
+          [](auto i) { return i % 20; },
+          [](auto i) { return i; },
+          nullEvery(11)),
+  });
+  auto rowContainer =
+      makeRowContainer({BIGINT()}, {VARCHAR(), ARRAY(BIGINT())}, false);
+  ASSERT_TRUE(rowContainer->supportsCompaction());
+  std::vector<char*> rows;
+  for (size_t i = 0; i < kNumRows; ++i) {
+    rows.push_back(rowContainer->newRow());
+  }
+  SelectivityVector allRows(kNumRows);
+  for (int i = 0; i < rowContainer->columnTypes().size(); ++i) {
+    DecodedVector decoded(*rowVector->childAt(i), allRows);
+    rowContainer->store(decoded, folly::Range(rows.data(), kNumRows), i);
+  }
+
+  // Erases 3 of 4 rows to fragment the variable width data.
+  std::vector<char*> erased;
+  std::vector<char*> remaining;
+  std::vector<vector_size_t> remainingIndices;
+  for (auto i = 0; i < kNumRows; ++i) {
+    if (i % 4 == 0) {
+      remaining.push_back(rows[i]);
+      remainingIndices.push_back(i);
+    } else {
+      erased.push_back(rows[i]);
+    }
+  }
+  rowContainer->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  ASSERT_GT(rowContainer->stringAllocator().fragmentation(), 0.5);
+
+  const auto allocatedBytes = rowContainer->allocatedBytes();
+  const auto freedBytes = rowContainer->compactVariableWidthData();
+  ASSERT_GT(freedBytes, 0);
+  ASSERT_EQ(rowContainer->allocatedBytes(), allocatedBytes - freedBytes);
+  RowContainerTestHelper(rowContainer.get()).checkConsistency();
+
+  for (int i = 0; i < rowContainer->columnTypes().size(); ++i) {
+    auto vector = BaseVector::create(
+        rowVector->childAt(i)->type(), remaining.size(), pool());
+    rowContainer->extractColumn(
+        remaining.data(), remaining.size(), i, vector);
+    for (auto row = 0; row < remaining.size(); ++row) {
+      ASSERT_TRUE(vector->equalValueAt(
+          rowVector->childAt(i).get(), row, remainingIndices[row]));
+    }
+  }
+}
+
 TEST_F(RowContainerTest, customComparison) {
   auto values = makeNullableFlatVector<int64_t>(
       {std::nullopt,
@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SerializedPageSpiller.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/OutputBuffer.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+std::string pageContent(const SerializedPage& page) {
+  auto iobuf = page.getIOBuf();
+  iobuf->coalesce();
+  return std::string(
+      reinterpret_cast<const char*>(iobuf->data()), iobuf->length());
+}
+} // namespace
+
+class SerializedPageSpillerTest : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance({});
+    filesystems::registerLocalFileSystem();
+  }
+
+  void SetUp() override {
+    pool_ = memory::memoryManager()->addLeafPool();
+    tempDir_ = exec::test::TempDirectoryPath::create();
+    spillConfig_.getSpillDirPathCb = [&]() -> std::string_view {
+      if (failSpillDir_) {
+        return "";
+      }
+      return tempDir_->getPath();
+    };
+    spillConfig_.updateAndCheckSpillLimitCb = [&](uint64_t bytes) {
+      updatedSpillBytes_ += bytes;
+    };
+    spillConfig_.fileNamePrefix = "test";
+    spillConfig_.maxFileSize = 0;
+    spillConfig_.fileCreateConfig = "";
+  }
+
+  std::unique_ptr<SerializedPage> makePage(const std::string& content) {
+    return std::make_unique<SerializedPage>(
+        folly::IOBuf::copyBuffer(content), nullptr, content.size());
+  }
+
+  std::shared_ptr<SerializedPageSpiller> makeSpiller() {
+    return std::make_shared<SerializedPageSpiller>(
+        &spillConfig_, "pages", pool_, &spillStats_);
+  }
+
+  // Writes 'contents' as pages to 'spiller' and returns the written bytes.
+  uint64_t write(
+      SerializedPageSpiller& spiller,
+      const std::vector<std::string>& contents) {
+    std::vector<std::unique_ptr<SerializedPage>> pages;
+    std::vector<const SerializedPage*> pagesToWrite;
+    for (const auto& content : contents) {
+      pages.push_back(makePage(content));
+      pagesToWrite.push_back(pages.back().get());
+    }
+    auto batch = spiller.startWrite(pagesToWrite);
+    VELOX_CHECK(batch.has_value());
+    spiller.write(batch.value());
+    return spiller.finishWrite(batch.value());
+  }
+
+  // Reads back the spilled pages from 'spiller' until there are at least
+  // 'maxBytes' read back and pops them.
+  std::vector<std::string> read(
+      SerializedPageSpiller& spiller,
+      uint64_t maxBytes) {
+    {
+      auto batch = spiller.startRead(maxBytes);
+      if (batch.has_value()) {
+        spiller.read(batch.value());
+        spiller.finishRead(batch.value());
+      }
+    }
+    std::vector<std::string> contents;
+    while (spiller.hasLoadedFront()) {
+      contents.push_back(pageContent(*spiller.popFront()));
+    }
+    return contents;
+  }
+
+  uint64_t spill(DestinationBuffer& buffer) {
+    auto batch = buffer.startSpill([&]() { return makeSpiller(); });
+    if (!batch.has_value()) {
+      return 0;
+    }
+    batch->spiller->write(batch->writeBatch);
+    return buffer.finishSpill(batch.value());
+  }
+
+  DestinationBuffer::Data
+  getData(DestinationBuffer& buffer, uint64_t maxBytes, int64_t sequence) {
+    auto batch = buffer.startUnspill(sequence, maxBytes);
+    if (batch.has_value()) {
+      batch->spiller->read(batch->readBatch);
+      buffer.finishUnspill(batch.value());
+    }
+    return buffer.getData(maxBytes, sequence, nullptr, nullptr);
+  }
+
+  void enqueue(ExchangeQueue& queue, std::unique_ptr<SerializedPage> page) {
+    std::vector<ContinuePromise> promises;
+    {
+      std::lock_guard<std::mutex> l(queue.mutex());
+      queue.enqueueLocked(std::move(page), promises);
+    }
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  }
+
+  // Dequeues all the pages from 'queue' one at a time.
+  std::vector<std::string> dequeueAll(ExchangeQueue& queue) {
+    std::vector<std::string> dequeued;
+    bool atEnd{false};
+    while (!atEnd) {
+      queue.loadSpilledPages(1);
+      std::lock_guard<std::mutex> l(queue.mutex());
+      ContinueFuture future;
+      ContinuePromise stalePromise = ContinuePromise::makeEmpty();
+      auto pages = queue.dequeueLocked(0, 1, &atEnd, &future, &stalePromise);
+      VELOX_CHECK(atEnd || !pages.empty());
+      VELOX_CHECK_LE(pages.size(), 1);
+      for (const auto& page : pages) {
+        dequeued.push_back(pageContent(*page));
+      }
+    }
+    return dequeued;
+  }
+
+  int32_t numSpillFiles() const {
+    auto fs = filesystems::getFileSystem(tempDir_->getPath(), nullptr);
+    return fs->list(tempDir_->getPath()).size();
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_;
+  std::shared_ptr<exec::test::TempDirectoryPath> tempDir_;
+  common::SpillConfig spillConfig_;
+  folly::Synchronized<common::SpillStats> spillStats_;
+  uint64_t updatedSpillBytes_{0};
+  // Set to fail the spill writes.
+  bool failSpillDir_{false};
+};
+
+TEST_F(SerializedPageSpillerTest, writeAndRead) {
+  for (const uint64_t maxFileSize : {0, 1, 16}) {
+    SCOPED_TRACE(fmt::format("maxFileSize: {}", maxFileSize));
+    spillConfig_.maxFileSize = maxFileSize;
+    updatedSpillBytes_ = 0;
+    auto spiller = makeSpiller();
+    ASSERT_TRUE(spiller->empty());
+
+    const std::vector<std::string> contents{
+        "a", "bb", "ccc", "dddddddddddddddddddd", "eeeee"};
+    uint64_t totalBytes{0};
+    for (const auto& content : contents) {
+      totalBytes += content.size();
+    }
+    ASSERT_EQ(write(*spiller, contents), totalBytes);
+    ASSERT_FALSE(spiller->ioInProgress());
+    ASSERT_EQ(spiller->numPages(), contents.size());
+    ASSERT_EQ(spiller->spilledBytes(), totalBytes);
+    ASSERT_EQ(updatedSpillBytes_, totalBytes);
+    ASSERT_FALSE(spiller->hasLoadedFront());
+    std::vector<int64_t> pageSizes;
+    spiller->appendPageSizes(pageSizes);
+    ASSERT_EQ(pageSizes.size(), contents.size());
+    for (auto i = 0; i < contents.size(); ++i) {
+      ASSERT_EQ(pageSizes[i], contents[i].size());
+    }
+
+    // Interleave reads and writes to verify the FIFO order.
+    {
+      auto batch = spiller->startRead(1);
+      ASSERT_TRUE(batch.has_value());
+      ASSERT_EQ(batch->locations.size(), 1);
+      spiller->read(batch.value());
+      spiller->finishRead(batch.value());
+    }
+    // The page read back is allocated from the spiller's pool.
+    ASSERT_GE(pool_->usedBytes(), contents[0].size());
+    auto page = spiller->popFront();
+    ASSERT_EQ(pageContent(*page), contents[0]);
+    ASSERT_EQ(page->numRows().value(), contents[0].size());
+    page.reset();
+    ASSERT_EQ(pool_->usedBytes(), 0);
+
+    ASSERT_EQ(write(*spiller, {"ffff"}), 4);
+    ASSERT_EQ(spiller->frontPageSize(), contents[1].size());
+    ASSERT_EQ(
+        read(*spiller, std::numeric_limits<uint64_t>::max()),
+        (std::vector<std::string>{
+            "bb", "ccc", "dddddddddddddddddddd", "eeeee", "ffff"}));
+    ASSERT_TRUE(spiller->empty());
+    ASSERT_EQ(spiller->spilledBytes(), 0);
+    ASSERT_FALSE(spiller->startRead(1).has_value());
+    VELOX_ASSERT_THROW(spiller->popFront(), "No spilled page to pop");
+    // The fully consumed spill files are removed.
+    ASSERT_EQ(numSpillFiles(), 0);
+  }
+}
+
+TEST_F(SerializedPageSpillerTest, oneIoAtATime) {
+  auto spiller = makeSpiller();
+  auto page = makePage("abc");
+  auto writeBatch = spiller->startWrite({page.get()});
+  ASSERT_TRUE(writeBatch.has_value());
+  ASSERT_TRUE(spiller->ioInProgress());
+  // The page under write is accounted but can't be read back.
+  ASSERT_EQ(spiller->spilledBytes(), 3);
+  ASSERT_FALSE(spiller->startWrite({page.get()}).has_value());
+  ASSERT_FALSE(spiller->startRead(1).has_value());
+  spiller->write(writeBatch.value());
+  ASSERT_EQ(spiller->finishWrite(writeBatch.value()), 3);
+
+  auto readBatch = spiller->startRead(1);
+  ASSERT_TRUE(readBatch.has_value());
+  ASSERT_TRUE(spiller->ioInProgress());
+  ASSERT_FALSE(spiller->startWrite({page.get()}).has_value());
+  ASSERT_FALSE(spiller->startRead(1).has_value());
+  spiller->read(readBatch.value());
+  spiller->finishRead(readBatch.value());
+  ASSERT_FALSE(spiller->ioInProgress());
+  ASSERT_EQ(pageContent(*spiller->popFront()), "abc");
+}
+
+TEST_F(SerializedPageSpillerTest, abortWrite) {
+  auto spiller = makeSpiller();
+  ASSERT_EQ(write(*spiller, {"a"}), 1);
+
+  auto page = makePage("bb");
+  auto batch = spiller->startWrite({page.get()});
+  ASSERT_TRUE(batch.has_value());
+  failSpillDir_ = true;
+  VELOX_ASSERT_THROW(
+      spiller->write(batch.value()), "Spill directory does not exist");
+  ASSERT_TRUE(spiller->abortWrite(batch.value()));
+  ASSERT_FALSE(spiller->ioInProgress());
+  ASSERT_EQ(spiller->numPages(), 1);
+  ASSERT_EQ(spiller->spilledBytes(), 1);
+  ASSERT_EQ(read(*spiller, 1), (std::vector<std::string>{"a"}));
+  ASSERT_TRUE(spiller->empty());
+}
+
+TEST_F(SerializedPageSpillerTest, abortRead) {
+  auto spiller = makeSpiller();
+  ASSERT_EQ(write(*spiller, {"a", "bb"}), 3);
+  auto batch = spiller->startRead(1);
+  ASSERT_TRUE(batch.has_value());
+  spiller->abortRead(batch.value());
+  ASSERT_FALSE(spiller->ioInProgress());
+  ASSERT_FALSE(spiller->hasLoadedFront());
+  ASSERT_EQ(read(*spiller, 3), (std::vector<std::string>{"a", "bb"}));
+}
+
+TEST_F(SerializedPageSpillerTest, clear) {
+  auto spiller = makeSpiller();
+  write(*spiller, {"abc", "de"});
+  ASSERT_GT(numSpillFiles(), 0);
+  ASSERT_EQ(spiller->clear(), 5);
+  ASSERT_TRUE(spiller->empty());
+  ASSERT_EQ(numSpillFiles(), 0);
+
+  write(*spiller, {"gh"});
+  ASSERT_GT(numSpillFiles(), 0);
+  spiller.reset();
+  ASSERT_EQ(numSpillFiles(), 0);
+}
+
+TEST_F(SerializedPageSpillerTest, clearDuringIo) {
+  auto spiller = makeSpiller();
+  {
+    auto page = makePage("abc");
+    auto batch = spiller->startWrite({page.get()});
+    ASSERT_EQ(spiller->clear(), 3);
+    ASSERT_FALSE(spiller->ioInProgress());
+    spiller->write(batch.value());
+    ASSERT_EQ(spiller->finishWrite(batch.value()), 0);
+    ASSERT_FALSE(spiller->abortWrite(batch.value()));
+    ASSERT_TRUE(spiller->empty());
+  }
+  // The file written after clear is removed with the batch.
+  ASSERT_EQ(numSpillFiles(), 0);
+
+  write(*spiller, {"de"});
+  {
+    auto batch = spiller->startRead(1);
+    ASSERT_EQ(spiller->clear(), 2);
+    spiller->read(batch.value());
+    spiller->finishRead(batch.value());
+    ASSERT_FALSE(spiller->hasLoadedFront());
+    ASSERT_TRUE(spiller->empty());
+  }
+  ASSERT_EQ(numSpillFiles(), 0);
+  ASSERT_EQ(pool_->usedBytes(), 0);
+}
+
+TEST_F(SerializedPageSpillerTest, exchangeQueue) {
+  auto queue = std::make_shared<ExchangeQueue>(1, 0);
+  ASSERT_FALSE(queue->canSpill());
+  ASSERT_EQ(queue->spill(), 0);
+  queue->enableSpill(spillConfig_, pool_.get());
+  ASSERT_TRUE(queue->canSpill());
+  {
+    std::lock_guard<std::mutex> l(queue->mutex());
+    queue->addSourceLocked();
+  }
+  queue->noMoreSources();
+
+  enqueue(*queue, makePage("a"));
+  enqueue(*queue, makePage("bb"));
+  ASSERT_EQ(queue->spill(), 3);
+  // Pages enqueued after spill stay in memory behind the spilled ones.
+  enqueue(*queue, makePage("ccc"));
+  {
+    std::lock_guard<std::mutex> l(queue->mutex());
+    ASSERT_EQ(queue->spilledBytesLocked(), 3);
+    ASSERT_EQ(queue->totalBytes(), 6);
+  }
+  ASSERT_EQ(queue->spill(), 3);
+  enqueue(*queue, makePage("dddd"));
+  {
+    std::lock_guard<std::mutex> l(queue->mutex());
+    ASSERT_EQ(queue->spilledBytesLocked(), 6);
+    ASSERT_EQ(queue->totalBytes(), 10);
+
+    // The spilled pages are only dequeued after they are read back.
+    bool atEnd{false};
+    ContinueFuture future;
+    ContinuePromise stalePromise = ContinuePromise::makeEmpty();
+    ASSERT_TRUE(
+        queue->dequeueLocked(0, 1, &atEnd, &future, &stalePromise).empty());
+    ASSERT_FALSE(atEnd);
+    ASSERT_TRUE(future.valid());
+  }
+  enqueue(*queue, nullptr);
+
+  ASSERT_EQ(
+      dequeueAll(*queue),
+      (std::vector<std::string>{"a", "bb", "ccc", "dddd"}));
+  ASSERT_TRUE(queue->empty());
+  const auto stats = queue->spillStats();
+  ASSERT_EQ(stats.spilledBytes, 6);
+  ASSERT_EQ(stats.spillReadBytes, 6);
+  ASSERT_EQ(stats.spillRuns, 2);
+}
+
+TEST_F(SerializedPageSpillerTest, exchangeQueueSpillFailure) {
+  auto queue = std::make_shared<ExchangeQueue>(1, 0);
+  queue->enableSpill(spillConfig_, pool_.get());
+  {
+    std::lock_guard<std::mutex> l(queue->mutex());
+    queue->addSourceLocked();
+  }
+  queue->noMoreSources();
+
+  enqueue(*queue, makePage("a"));
+  ASSERT_EQ(queue->spill(), 1);
+  enqueue(*queue, makePage("bb"));
+  enqueue(*queue, makePage("ccc"));
+  failSpillDir_ = true;
+  VELOX_ASSERT_THROW(queue->spill(), "Spill directory does not exist");
+  // The pages failed to spill are put back in memory in order.
+  {
+    std::lock_guard<std::mutex> l(queue->mutex());
+    ASSERT_EQ(queue->spilledBytesLocked(), 1);
+    ASSERT_EQ(queue->totalBytes(), 6);
+  }
+  enqueue(*queue, nullptr);
+  ASSERT_EQ(
+      dequeueAll(*queue), (std::vector<std::string>{"a", "bb", "ccc"}));
+}
+
+TEST_F(SerializedPageSpillerTest, destinationBuffer) {
+  DestinationBuffer buffer;
+  const std::vector<std::string> contents{"a", "bb", "ccc", "dddd"};
+  for (const auto& content : contents) {
+    buffer.enqueue(makePage(content));
+  }
+
+  // Fetch the first page which is not spillable as it might be fetched again.
+  auto data = buffer.getData(1, 0, nullptr, nullptr);
+  ASSERT_EQ(data.data.size(), 1);
+  ASSERT_EQ(data.remainingBytes, (std::vector<int64_t>{2, 3, 4}));
+
+  ASSERT_EQ(spill(buffer), 9);
+  // Pages enqueued after spill stay in memory behind the spilled ones.
+  buffer.enqueue(makePage("eeeee"));
+  buffer.enqueue(nullptr);
+  auto stats = buffer.stats();
+  ASSERT_EQ(stats.bytesSpilled, 9);
+  ASSERT_EQ(stats.pagesSpilled, 3);
+  ASSERT_EQ(stats.pagesBuffered, 5);
+
+  // Re-fetch of the first page is served from memory.
+  data = getData(buffer, 1, 0);
+  ASSERT_EQ(data.data.size(), 1);
+  ASSERT_EQ(data.remainingBytes, (std::vector<int64_t>{2, 3, 4, 5}));
+
+  // The spilled pages are not read back under the output buffer lock.
+  buffer.acknowledge(1, true);
+  data = buffer.getData(3, 1, nullptr, nullptr);
+  ASSERT_TRUE(data.immediate);
+  ASSERT_TRUE(data.data.empty());
+  ASSERT_EQ(data.remainingBytes, (std::vector<int64_t>{2, 3, 4, 5}));
+
+  std::vector<std::string> fetched{"a"};
+  int64_t sequence{1};
+  bool atEnd{false};
+  while (!atEnd) {
+    buffer.acknowledge(sequence, true);
+    data = getData(buffer, 3, sequence);
+    ASSERT_FALSE(data.data.empty());
+    for (const auto& iobuf : data.data) {
+      if (iobuf == nullptr) {
+        atEnd = true;
+        break;
+      }
+      fetched.push_back(
+          iobuf->cloneCoalescedAsValue().moveToFbString().toStdString());
+      ++sequence;
+    }
+  }
+  ASSERT_EQ(
+      fetched, (std::vector<std::string>{"a", "bb", "ccc", "dddd", "eeeee"}));
+  buffer.acknowledge(sequence, false);
+  stats = buffer.stats();
+  ASSERT_EQ(stats.pagesBuffered, 0);
+  ASSERT_EQ(stats.pagesSent, 5);
+  ASSERT_EQ(numSpillFiles(), 0);
+}
+
+TEST_F(SerializedPageSpillerTest, destinationBufferSpillInProgress) {
+  DestinationBuffer buffer;
+  buffer.enqueue(makePage("a"));
+  buffer.enqueue(makePage("bb"));
+  auto batch = buffer.startSpill([&]() { return makeSpiller(); });
+  ASSERT_TRUE(batch.has_value());
+  ASSERT_EQ(batch->pages.size(), 2);
+  ASSERT_FALSE(
+      buffer.startSpill([&]() { return makeSpiller(); }).has_value());
+  buffer.enqueue(makePage("ccc"));
+
+  // The consumer waits for the pages under spill.
+  bool notified{false};
+  std::vector<int64_t> notifiedRemainingBytes;
+  auto data = buffer.getData(
+      1,
+      0,
+      [&](std::vector<std::unique_ptr<folly::IOBuf>> /*pages*/,
+          int64_t /*sequence*/,
+          std::vector<int64_t> remainingBytes) {
+        notified = true;
+        notifiedRemainingBytes = std::move(remainingBytes);
+      },
+      nullptr);
+  ASSERT_FALSE(data.immediate);
+
+  batch->spiller->write(batch->writeBatch);
+  ASSERT_EQ(buffer.finishSpill(batch.value()), 3);
+  buffer.getAndClearNotify().notify();
+  ASSERT_TRUE(notified);
+  ASSERT_EQ(notifiedRemainingBytes, (std::vector<int64_t>{1, 2, 3}));
+}
+
+TEST_F(SerializedPageSpillerTest, destinationBufferAbortSpill) {
+  DestinationBuffer buffer;
+  buffer.enqueue(makePage("a"));
+  buffer.enqueue(makePage("bb"));
+  auto batch = buffer.startSpill([&]() { return makeSpiller(); });
+  ASSERT_TRUE(batch.has_value());
+  buffer.enqueue(makePage("ccc"));
+  buffer.enqueue(nullptr);
+  buffer.abortSpill(batch.value());
+
+  // The pages are put back in memory in order.
+  auto data = buffer.getData(10, 0, nullptr, nullptr);
+  ASSERT_EQ(data.data.size(), 4);
+  ASSERT_EQ(data.data.back(), nullptr);
+  ASSERT_EQ(buffer.stats().bytesSpilled, 0);
+}
+
+TEST_F(SerializedPageSpillerTest, destinationBufferDeleteSpilledResults) {
+  DestinationBuffer buffer;
+  buffer.enqueue(makePage("abc"));
+  buffer.enqueue(makePage("de"));
+  ASSERT_EQ(spill(buffer), 5);
+  ASSERT_GT(numSpillFiles(), 0);
+  buffer.enqueue(makePage("f"));
+  ASSERT_EQ(buffer.deleteResults().size(), 1);
+  ASSERT_EQ(numSpillFiles(), 0);
+  const auto stats = buffer.stats();
+  ASSERT_EQ(stats.bytesBuffered, 0);
+  ASSERT_EQ(stats.rowsBuffered, 0);
+  ASSERT_EQ(stats.pagesBuffered, 0);
+  ASSERT_EQ(stats.bytesSent, 6);
+  buffer.finish();
+}
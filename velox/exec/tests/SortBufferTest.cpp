@@ -805,6 +805,78 @@ TEST_P(SortBufferTest, emptySpill) {
   }
 }
 
+TEST_P(SortBufferTest, boundedSort) {
+  constexpr int32_t kNumBatches = 5;
+  constexpr int32_t kBatchSize = 1'000;
+  constexpr int32_t kNumRows = kNumBatches * kBatchSize;
+  // The sort key 'c1' is a permutation of [0, kNumRows).
+  std::vector<RowVectorPtr> inputs;
+  for (int32_t batch = 0; batch < kNumBatches; ++batch) {
+    inputs.push_back(makeRowVector(
+        {"c0", "c1"},
+        {makeFlatVector<int64_t>(kBatchSize, [](auto row) { return row; }),
+         makeFlatVector<int32_t>(kBatchSize, [&](auto row) {
+           return (static_cast<int64_t>(batch * kBatchSize + row) * 7919) %
+               kNumRows;
+         })}));
+  }
+  const auto inputType = asRowType(inputs[0]->type());
+
+  struct {
+    bool triggerSpill;
+    uint64_t limit;
+    uint64_t expectedNumRows;
+    bool expectDroppedRows;
+
+    std::string debugString() const {
+      return fmt::format(
+          "triggerSpill: {}, limit: {}, expectedNumRows: {}",
+          triggerSpill,
+          limit,
+          expectedNumRows);
+    }
+  } testSettings[] = {
+      {false, 300, 300, false},
+      {true, 300, 300, true},
+      {true, 1, 1, true},
+      {true, 1'000, 1'000, false},
+      {true, 10'000, kNumRows, false}};
+
+  TestScopedSpillInjection scopedSpillInjection(100);
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    auto spillConfig = getSpillConfig(spillDirectory->getPath());
+    folly::Synchronized<common::SpillStats> spillStats;
+    auto sortBuffer = std::make_unique<SortBuffer>(
+        inputType,
+        std::vector<column_index_t>{1},
+        std::vector<CompareFlags>{sortCompareFlags_[0]},
+        pool_.get(),
+        &nonReclaimableSection_,
+        prefixSortConfig_,
+        testData.triggerSpill ? &spillConfig : nullptr,
+        &spillStats,
+        testData.limit);
+    for (const auto& input : inputs) {
+      sortBuffer->addInput(input);
+    }
+    sortBuffer->noMoreInput();
+
+    int32_t expectedKey = 0;
+    while (auto output = sortBuffer->getOutput(100)) {
+      auto* keys = output->childAt(1)->asFlatVector<int32_t>();
+      for (vector_size_t row = 0; row < output->size(); ++row) {
+        ASSERT_EQ(keys->valueAt(row), expectedKey++);
+      }
+    }
+    ASSERT_EQ(expectedKey, testData.expectedNumRows);
+    ASSERT_EQ(
+        sortBuffer->numBoundedDroppedRows() > 0, testData.expectDroppedRows);
+    ASSERT_EQ(!spillStats.rlock()->empty(), testData.triggerSpill);
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     SortBufferTest,
     SortBufferTest,
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SpillEncoding.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class SpillEncodingTest
+    : public testing::TestWithParam<common::CompressionKind>,
+      public facebook::velox::test::VectorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance({});
+  }
+
+  RowVectorPtr roundTrip(const RowVectorPtr& input) {
+    auto page = encodeColumnarSpillPage(input, GetParam(), pool());
+    auto coalesced = page->cloneCoalescedAsValue();
+    BufferInputStream in({ByteRange{
+        coalesced.writableData(),
+        static_cast<int32_t>(coalesced.length()),
+        0}});
+    RowVectorPtr result;
+    decodeColumnarSpillPage(
+        &in, asRowType(input->type()), GetParam(), pool(), result);
+    EXPECT_TRUE(in.atEnd());
+    return result;
+  }
+
+  std::vector<SpillColumnEncoding> encodings(const RowVectorPtr& input) {
+    auto page = encodeColumnarSpillPage(
+        input, common::CompressionKind::CompressionKind_NONE, pool());
+    return testingColumnarSpillEncodings(
+        *page, asRowType(input->type()), pool());
+  }
+};
+
+TEST_P(SpillEncodingTest, encodings) {
+  const vector_size_t size = 1'000;
+  auto input = makeRowVector({
+      // Sorted keys with small gaps.
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return 1'000'000'000'000 + row * 3; }),
+      // Unsorted values in a narrow range.
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return 5'000 + (row * 7919) % 1'000; }),
+      // Values spanning the whole range.
+      makeFlatVector<int32_t>(size, [](auto row) {
+        return row % 2 == 0 ? -2'000'000'000 : 2'000'000'000 - row;
+      }),
+      // Low cardinality strings.
+      makeFlatVector<std::string>(
+          size, [](auto row) { return fmt::format("category_{}", row % 4); }),
+      // Distinct strings.
+      makeFlatVector<std::string>(
+          size, [](auto row) { return fmt::format("distinct_{}", row); }),
+      makeFlatVector<double>(size, [](auto row) { return row * 1.5; }),
+  });
+  ASSERT_EQ(
+      encodings(input),
+      (std::vector<SpillColumnEncoding>{
+          SpillColumnEncoding::kDelta,
+          SpillColumnEncoding::kFrameOfReference,
+          SpillColumnEncoding::kPlain,
+          SpillColumnEncoding::kDictionary,
+          SpillColumnEncoding::kPlain,
+          SpillColumnEncoding::kPlain}));
+  facebook::velox::test::assertEqualVectors(input, roundTrip(input));
+}
+
+TEST_P(SpillEncodingTest, nulls) {
+  const vector_size_t size = 1'000;
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row; }, nullEvery(3)),
+      makeFlatVector<int16_t>(
+          size, [](auto row) { return row % 100; }, nullEvery(7)),
+      makeFlatVector<std::string>(
+          size,
+          [](auto row) {
+            return std::string(row % 2 == 0 ? "a" : "a long string value");
+          },
+          nullEvery(5)),
+      makeFlatVector<bool>(
+          size, [](auto row) { return row % 3 == 0; }, nullEvery(2)),
+      makeFlatVector<Timestamp>(
+          size, [](auto row) { return Timestamp(row, row); }, nullEvery(4)),
+      makeNullConstant(TypeKind::BIGINT, size),
+      makeNullConstant(TypeKind::VARCHAR, size),
+  });
+  facebook::velox::test::assertEqualVectors(input, roundTrip(input));
+}
+
+TEST_P(SpillEncodingTest, encodedInput) {
+  const vector_size_t size = 100;
+  auto input = makeRowVector({
+      makeConstant<int64_t>(7, size),
+      wrapInDictionary(
+          makeIndicesInReverse(size),
+          makeFlatVector<std::string>(
+              size, [](auto row) { return std::string(row % 20, 'x'); })),
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) {
+            return row % 2 == 0 ? std::numeric_limits<int64_t>::min()
+                                : std::numeric_limits<int64_t>::max();
+          }),
+  });
+  facebook::velox::test::assertEqualVectors(input, roundTrip(input));
+  facebook::velox::test::assertEqualVectors(
+      makeRowVector(ROW({"a"}, {BIGINT()}), 0),
+      roundTrip(makeRowVector(ROW({"a"}, {BIGINT()}), 0)));
+}
+
+TEST_P(SpillEncodingTest, supportedTypes) {
+  ASSERT_TRUE(isColumnarSpillSupported(
+      ROW({BIGINT(), VARCHAR(), DOUBLE(), TIMESTAMP(), BOOLEAN()})));
+  ASSERT_FALSE(isColumnarSpillSupported(ROW({BIGINT(), ARRAY(BIGINT())})));
+  ASSERT_FALSE(isColumnarSpillSupported(ROW({ROW({BIGINT()})})));
+  ASSERT_FALSE(isColumnarSpillSupported(ROW({UNKNOWN()})));
+}
+
+VELOX_INSTANTIATE_TEST_SUITE_P(
+    SpillEncodingTest,
+    SpillEncodingTest,
+    testing::Values(
+        common::CompressionKind::CompressionKind_NONE,
+        common::CompressionKind::CompressionKind_ZSTD,
+        common::CompressionKind::CompressionKind_LZ4));
@@ -592,6 +592,238 @@ TEST_P(SpillTest, spillTimestamp) {
   ASSERT_EQ(nullptr, merge->next());
 }
 
+TEST_P(SpillTest, asyncSpillWrites) {
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  for (const uint32_t maxPendingWrites : {1, 4}) {
+    for (const uint64_t targetFileSize : {1UL, 1UL << 30}) {
+      SCOPED_TRACE(fmt::format(
+          "maxPendingWrites: {}, targetFileSize: {}",
+          maxPendingWrites,
+          targetFileSize));
+      auto tempDirectory = exec::test::TempDirectoryPath::create();
+      spillStats_.wlock()->reset();
+      SpillState state(
+          [&]() -> const std::string& { return tempDirectory->getPath(); },
+          updateSpilledBytesCb_,
+          "test",
+          1,
+          0,
+          {},
+          targetFileSize,
+          0,
+          compressionKind_,
+          std::nullopt,
+          pool(),
+          &spillStats_,
+          "",
+          executor.get(),
+          maxPendingWrites);
+      state.setPartitionSpilled(0);
+
+      const int numBatches = 20;
+      std::vector<RowVectorPtr> batches;
+      for (int i = 0; i < numBatches; ++i) {
+        batches.push_back(makeRowVector({
+            makeFlatVector<int64_t>(1'000, [&](auto row) { return row * i; }),
+            makeFlatVector<std::string>(
+                1'000,
+                [&](auto row) { return std::string(row % 50, 'a' + i % 26); }),
+        }));
+        ASSERT_GT(state.appendToPartition(0, batches.back()), 0);
+      }
+      SpillPartition spillPartition(SpillPartitionId{0, 0}, state.finish(0));
+      const auto stats = spillStats_.copy();
+      ASSERT_EQ(stats.spillWrites, numBatches);
+      ASSERT_EQ(stats.spilledFiles, targetFileSize == 1 ? numBatches : 1);
+      ASSERT_GT(stats.spilledBytes, 0);
+      ASSERT_GT(stats.spillWriteThroughput(), 0);
+
+      auto reader =
+          spillPartition.createUnorderedReader(1 << 20, pool(), &spillStats_);
+      RowVectorPtr output;
+      for (int i = 0; i < numBatches; ++i) {
+        ASSERT_TRUE(reader->nextBatch(output));
+        facebook::velox::test::assertEqualVectors(batches[i], output);
+      }
+      ASSERT_FALSE(reader->nextBatch(output));
+    }
+  }
+}
+
+TEST_P(SpillTest, columnarEncoding) {
+  const auto scalarBatch = [&](int i) {
+    return makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return row % 7; }, nullEvery(5)),
+        makeFlatVector<std::string>(
+            1'000,
+            [&](auto row) { return fmt::format("value_{}", row % 10); },
+            nullEvery(11)),
+        makeFlatVector<double>(1'000, [&](auto row) { return row * 0.5; }),
+        makeFlatVector<bool>(1'000, [&](auto row) { return row % 3 == 0; }),
+    });
+  };
+  const auto complexBatch = [&](int i) {
+    return makeRowVector({
+        makeFlatVector<int64_t>(100, [&](auto row) { return i + row; }),
+        makeArrayVector<int32_t>(
+            100,
+            [](auto row) { return row % 5; },
+            [](auto row) { return row; }),
+    });
+  };
+
+  for (const bool scalar : {true, false}) {
+    SCOPED_TRACE(fmt::format("scalar: {}", scalar));
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        [&]() -> const std::string& { return tempDirectory->getPath(); },
+        updateSpilledBytesCb_,
+        "test",
+        1,
+        0,
+        {},
+        1 << 30,
+        0,
+        compressionKind_,
+        std::nullopt,
+        pool(),
+        &spillStats_,
+        "",
+        nullptr,
+        0,
+        /*columnarEncoding=*/true);
+    state.setPartitionSpilled(0);
+
+    const int numBatches = 10;
+    std::vector<RowVectorPtr> batches;
+    for (int i = 0; i < numBatches; ++i) {
+      batches.push_back(scalar ? scalarBatch(i) : complexBatch(i));
+      ASSERT_GT(state.appendToPartition(0, batches.back()), 0);
+    }
+    auto files = state.finish(0);
+    ASSERT_EQ(files.size(), 1);
+    // Falls back to the Presto serialization for the complex types.
+    ASSERT_EQ(files[0].columnarEncoded, scalar);
+
+    SpillPartition spillPartition(SpillPartitionId{0, 0}, std::move(files));
+    auto reader =
+        spillPartition.createUnorderedReader(1 << 20, pool(), &spillStats_);
+    RowVectorPtr output;
+    for (int i = 0; i < numBatches; ++i) {
+      ASSERT_TRUE(reader->nextBatch(output));
+      facebook::velox::test::assertEqualVectors(batches[i], output);
+    }
+    ASSERT_FALSE(reader->nextBatch(output));
+  }
+}
+
+TEST_P(SpillTest, appendStatsWithIndices) {
+  const auto rows = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      makeFlatVector<std::string>(
+          1'000, [](auto row) { return fmt::format("value_{}", row); }),
+  });
+  std::vector<IndexRange> indices{{10, 20}, {500, 5}, {990, 10}};
+  const uint64_t numRows = 20 + 5 + 10;
+
+  // The columnar encoding counts the appended rows. The Presto encoding keeps
+  // counting the size of the input vectors.
+  for (const bool columnarEncoding : {false, true}) {
+    SCOPED_TRACE(fmt::format("columnarEncoding: {}", columnarEncoding));
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    spillStats_.wlock()->reset();
+    SpillWriter writer(
+        asRowType(rows->type()),
+        0,
+        {},
+        compressionKind_,
+        fmt::format("{}/append", tempDirectory->getPath()),
+        1 << 30,
+        1 << 20,
+        "",
+        updateSpilledBytesCb_,
+        pool(),
+        &spillStats_,
+        nullptr,
+        0,
+        columnarEncoding);
+    writer.write(rows, folly::Range<IndexRange*>(indices.data(), 1));
+    writer.write(
+        rows,
+        folly::Range<IndexRange*>(indices.data() + 1, indices.size() - 1));
+    ASSERT_EQ(
+        spillStats_.rlock()->spilledRows,
+        columnarEncoding ? numRows : 2 * rows->size());
+    writer.finish();
+  }
+}
+
+TEST_P(SpillTest, multipleSpillDirectories) {
+  std::vector<std::shared_ptr<exec::test::TempDirectoryPath>> tempDirectories;
+  std::vector<std::string> directories;
+  for (int i = 0; i < 3; ++i) {
+    tempDirectories.push_back(exec::test::TempDirectoryPath::create());
+    directories.push_back(tempDirectories.back()->getPath());
+  }
+  common::SpillDirectorySelector selector(
+      directories, common::SpillDirectorySelector::Policy::kRoundRobin);
+  SpillState state(
+      [&]() -> const std::string& { return directories[0]; },
+      updateSpilledBytesCb_,
+      "test",
+      1,
+      0,
+      {},
+      1,
+      0,
+      compressionKind_,
+      std::nullopt,
+      pool(),
+      &spillStats_,
+      "",
+      nullptr,
+      0,
+      false,
+      &selector);
+  state.setPartitionSpilled(0);
+
+  // A new file is created for each batch with the tiny target file size, and
+  // the files are striped across the directories.
+  const int numBatches = 9;
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < numBatches; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [&](auto row) { return row * i; })}));
+    ASSERT_GT(state.appendToPartition(0, batches.back()), 0);
+  }
+  auto files = state.finish(0);
+  ASSERT_EQ(files.size(), numBatches);
+  for (int i = 0; i < numBatches; ++i) {
+    ASSERT_EQ(
+        files[i].path.rfind(directories[i % directories.size()] + "/", 0), 0)
+        << files[i].path;
+  }
+  auto* device = selector.device(0);
+  ASSERT_EQ(device->pendingWrites(), 0);
+  const auto deviceStats = device->stats();
+  ASSERT_GE(deviceStats.spilledFiles, numBatches);
+  ASSERT_GT(deviceStats.spilledBytes, 0);
+  ASSERT_GT(deviceStats.capacityBytes, 0);
+
+  SpillPartition spillPartition(SpillPartitionId{0, 0}, std::move(files));
+  auto reader =
+      spillPartition.createUnorderedReader(1 << 20, pool(), &spillStats_);
+  RowVectorPtr output;
+  for (int i = 0; i < numBatches; ++i) {
+    ASSERT_TRUE(reader->nextBatch(output));
+    facebook::velox::test::assertEqualVectors(batches[i], output);
+  }
+  ASSERT_FALSE(reader->nextBatch(output));
+}
+
 TEST_P(SpillTest, spillStateWithSmallTargetFileSize) {
   // Set the target file size to a small value to open a new file on each batch
   // write.
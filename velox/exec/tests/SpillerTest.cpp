@@ -1355,6 +1355,38 @@ TEST_P(SortedSpillerTest, error) {
   testSortedSpill(100, 1, false, true);
 }
 
+DEBUG_ONLY_TEST_P(SortedSpillerTest, maxConcurrentWrites) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_spill_max_concurrent_writes = 1;
+
+  const auto spillThreadId = std::this_thread::get_id();
+  std::atomic_int numExecutorWrites{0};
+  std::atomic_int maxExecutorWrites{0};
+  std::atomic_int numInlineWrites{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::SpillerBase::writeSpill",
+      std::function<void(SpillerBase*)>([&](SpillerBase* /*unused*/) {
+        if (std::this_thread::get_id() == spillThreadId) {
+          ++numInlineWrites;
+          return;
+        }
+        const auto numWrites = ++numExecutorWrites;
+        int maxWrites = maxExecutorWrites;
+        while (numWrites > maxWrites &&
+               !maxExecutorWrites.compare_exchange_weak(maxWrites, numWrites)) {
+        }
+        // Holds the executor slot for a while so that the other writes of the
+        // same run have to go inline.
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        --numExecutorWrites;
+      }));
+
+  // The spilled data is read back and verified.
+  testSortedSpill(100, 1);
+  ASSERT_LE(maxExecutorWrites, 1);
+  ASSERT_GT(numInlineWrites, 0);
+}
+
 class HashJoinBuildOnly : public SpillerTest,
                           public testing::WithParamInterface<TestParam> {
  public:
@@ -367,6 +367,55 @@ TEST_F(VectorHasherTest, dictionary) {
   }
 }
 
+TEST_F(VectorHasherTest, sequence) {
+  auto hasher = exec::VectorHasher::create(BIGINT(), 1);
+
+  // Runs of 10 rows with the values 3, 4, 5..12 and every fourth run null.
+  std::vector<std::optional<int64_t>> data(100);
+  for (int32_t i = 0; i < 100; i++) {
+    if (i / 10 % 4 != 3) {
+      data[i] = i / 10 + 3;
+    }
+  }
+  VectorPtr sequence = vectorMaker_.sequenceVector(data);
+  ASSERT_EQ(sequence->encoding(), VectorEncoding::Simple::SEQUENCE);
+
+  const auto expectedHash = [&](int32_t row) {
+    return data[row].has_value() ? folly::hasher<int64_t>()(data[row].value())
+                                 : BaseVector::kNullHash;
+  };
+
+  raw_vector<uint64_t> hashes(100);
+  std::fill(hashes.begin(), hashes.end(), 0);
+  hasher->decode(*sequence, oddRows_);
+  hasher->hash(oddRows_, false, hashes);
+  for (int32_t i = 0; i < 100; i++) {
+    if (i % 2 == 0) {
+      EXPECT_EQ(hashes[i], 0) << "at " << i;
+    } else {
+      EXPECT_EQ(hashes[i], expectedHash(i)) << "at " << i;
+    }
+  }
+
+  hasher->decode(*sequence, allRows_);
+  hasher->hash(allRows_, false, hashes);
+  for (int32_t i = 0; i < 100; i++) {
+    EXPECT_EQ(hashes[i], expectedHash(i)) << "at " << i;
+  }
+
+  // Sequence under a dictionary which reverses the rows.
+  auto dictionary = BaseVector::wrapInDictionary(
+      BufferPtr(nullptr),
+      makeIndices(100, [](vector_size_t row) { return 99 - row; }),
+      100,
+      sequence);
+  hasher->decode(*dictionary, allRows_);
+  hasher->hash(allRows_, false, hashes);
+  for (int32_t i = 0; i < 100; i++) {
+    EXPECT_EQ(hashes[i], expectedHash(99 - i)) << "at " << i;
+  }
+}
+
 // Tests how strings are mapped to uint64_t (if they fit) and to
 // consecutive ids of distinct values for the general case.
 TEST_F(VectorHasherTest, stringIds) {
@@ -419,6 +419,13 @@ void EvalCtx::addNulls(
     }
   }
 
+  if (rawNulls != nullptr && result->rawNulls() == nullptr &&
+      rows.hasSelections()) {
+    // Take a recycled nulls buffer instead of allocating a new one.
+    if (auto* vectorPool = context.vectorPool()) {
+      result->setNulls(vectorPool->getNulls(result->size()));
+    }
+  }
   result->addNulls(rawNulls, rows);
 }
 
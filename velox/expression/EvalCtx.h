@@ -505,6 +505,18 @@ class EvalCtx {
     return execCtx_->releaseVectors(vectors);
   }
 
+  /// Returns room for 'size' values of type T to gather the values of argument
+  /// 'argIndex' of a simple function into. The memory is owned by 'execCtx_'
+  /// and reused across batches. It stays valid until the next call with the
+  /// same 'argIndex'.
+  template <typename T>
+  T* gatherScratch(column_index_t argIndex, vector_size_t size) {
+    static_assert(sizeof(T) <= sizeof(uint64_t));
+    auto& scratch = execCtx_->gatherScratch(argIndex);
+    scratch.resize(bits::divRoundUp(size * sizeof(T), sizeof(uint64_t)));
+    return reinterpret_cast<T*>(scratch.data());
+  }
+
   /// Makes 'result' writable for 'rows'. Allocates or reuses a vector from the
   /// pool of 'execCtx_' if needed.
   void ensureWritable(
@@ -313,7 +313,7 @@ void mergeOrThrowArgumentErrors(
 }
 
 // Returns true if vector is a LazyVector that hasn't been loaded yet or
-// is not dictionary or constant encoded.
+// is not dictionary, sequence or constant encoded.
 bool isFlat(const BaseVector& vector) {
   auto encoding = vector.encoding();
   if (encoding == VectorEncoding::Simple::LAZY) {
@@ -325,6 +325,7 @@ bool isFlat(const BaseVector& vector) {
   }
   return !(
       encoding == VectorEncoding::Simple::DICTIONARY ||
+      encoding == VectorEncoding::Simple::SEQUENCE ||
       encoding == VectorEncoding::Simple::CONSTANT);
 }
 
@@ -1357,6 +1358,7 @@ inline bool isPeelable(VectorEncoding::Simple encoding) {
   switch (encoding) {
     case VectorEncoding::Simple::CONSTANT:
     case VectorEncoding::Simple::DICTIONARY:
+    case VectorEncoding::Simple::SEQUENCE:
       return true;
     default:
       return false;
@@ -1460,7 +1462,9 @@ bool Expr::applyFunctionWithPeeling(
       // If we have a single input, velox needs to ensure that the
       // vectorFunction would receive a flat or constant input.
       for (int i = 0; i < inputValues_.size(); ++i) {
-        if (inputValues_[i]->encoding() == VectorEncoding::Simple::DICTIONARY) {
+        const auto encoding = inputValues_[i]->encoding();
+        if (encoding == VectorEncoding::Simple::DICTIONARY ||
+            encoding == VectorEncoding::Simple::SEQUENCE) {
           BaseVector::flattenVector(inputValues_[i]);
         }
       }
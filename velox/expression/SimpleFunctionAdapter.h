@@ -553,6 +553,17 @@ class SimpleFunctionAdapter : public VectorFunction {
 
         auto* oneUnpacked = decodedArgs.at(POSITION).value().get();
         auto reader = VectorReader<arg_at<POSITION>>(oneUnpacked);
+        if constexpr (kVectorReaderGathersValues<arg_at<POSITION>>) {
+          using value_t = typename VectorReader<arg_at<POSITION>>::exec_in_t;
+          if (reader.shouldGather(*oneUnpacked)) {
+            const auto& rows = *applyContext.rows;
+            reader.gatherValues(
+                *oneUnpacked,
+                rows,
+                applyContext.context.template gatherScratch<value_t>(
+                    POSITION, rows.end()));
+          }
+        }
         unpack<POSITION + 1, allPrimitiveArgsFlatConstant>(
             applyContext, decodedArgs, rawArgs, readers..., reader);
       }
@@ -25,6 +25,7 @@
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "velox/expression/ComplexViewTypes.h"
 #include "velox/expression/DecodedArgs.h"
@@ -47,20 +48,63 @@ struct VectorReader {
   using exec_null_free_in_t =
       typename VectorExec::template resolver<T>::in_type;
 
-  explicit VectorReader(const DecodedVector* decoded) : decoded_(*decoded) {}
+  static constexpr bool kSimdGather =
+      DecodedVector::kSimdGather<exec_in_t> &&
+      std::is_same_v<exec_in_t, exec_null_free_in_t>;
+
+  explicit VectorReader(const DecodedVector* decoded) : decoded_(*decoded) {
+    if constexpr (kSimdGather) {
+      if (decoded_.isIdentityMapping()) {
+        values_ = decoded_.template data<exec_in_t>();
+      }
+    }
+  }
 
   explicit VectorReader(const VectorReader<T>&) = delete;
   VectorReader<T>& operator=(const VectorReader<T>&) = delete;
 
+  /// True if gatherValues() applies to 'decoded', i.e. it is neither an
+  /// identity nor a constant mapping.
+  static bool shouldGather(const DecodedVector& decoded) {
+    return !decoded.isIdentityMapping() && !decoded.isConstantMapping();
+  }
+
+  /// Reads the values of 'rows' up front with SIMD gathers into 'values', so
+  /// that the per row reads do not go through the indices. 'decoded' must be
+  /// the vector this reader was created with and shouldGather(decoded) must be
+  /// true. 'values' must have room for rows.end() values and outlive the
+  /// reads.
+  void gatherValues(
+      DecodedVector& decoded,
+      const SelectivityVector& rows,
+      exec_in_t* values) {
+    VELOX_DCHECK_EQ(&decoded, &decoded_);
+    VELOX_DCHECK(shouldGather(decoded));
+    if constexpr (kSimdGather) {
+      decoded.gatherValues(rows, values);
+      values_ = values;
+    }
+  }
+
   vector_size_t index(vector_size_t idx) const {
     return decoded_.index(idx);
   }
 
   exec_in_t operator[](size_t offset) const {
+    if constexpr (kSimdGather) {
+      if (values_ != nullptr) {
+        return values_[offset];
+      }
+    }
     return decoded_.template valueAt<exec_in_t>(offset);
   }
 
   exec_null_free_in_t readNullFree(size_t offset) const {
+    if constexpr (kSimdGather) {
+      if (values_ != nullptr) {
+        return values_[offset];
+      }
+    }
     return decoded_.template valueAt<exec_null_free_in_t>(offset);
   }
 
@@ -104,8 +148,23 @@ struct VectorReader {
   }
 
   const DecodedVector& decoded_;
+
+ private:
+  // The values indexed by row if they are read directly or gathered, nullptr
+  // otherwise.
+  const exec_in_t* values_{nullptr};
 };
 
+/// True if VectorReader<T> supports gatherValues().
+template <typename T, typename = void>
+constexpr bool kVectorReaderGathersValues = false;
+
+template <typename T>
+constexpr bool kVectorReaderGathersValues<
+    T,
+    std::void_t<decltype(VectorReader<T>::kSimdGather)>> =
+    VectorReader<T>::kSimdGather;
+
 // ConstantVectorReader and FlatVectorReader are optimized for primitive types
 // in constant or flat encoded vectors.  They operate directly on the vector's
 // content avoiding the need to go through the expensive decoding process.
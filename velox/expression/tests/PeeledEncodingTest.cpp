@@ -507,3 +507,48 @@ TEST_F(PeeledEncodingTest, peelingFails) {
     ASSERT_TRUE(!peeledEncoding);
   }
 }
+
+TEST_F(PeeledEncodingTest, sequence) {
+  // Two runs of 60 and 40 rows.
+  auto lengths = makeIndices({60, 40});
+  auto runs1 = makeFlatVector<int32_t>({1, 2});
+  auto runs2 = makeFlatVector<int32_t>({10, 20});
+  auto input1 =
+      std::make_shared<SequenceVector<int32_t>>(pool(), 100, runs1, lengths);
+  auto input2 =
+      std::make_shared<SequenceVector<int32_t>>(pool(), 100, runs2, lengths);
+
+  SelectivityVector rows(100);
+  LocalDecodedVector localDecodedVector(execCtx_);
+
+  // The runs are peeled off the sequences which share the lengths.
+  {
+    std::vector<VectorPtr> peeledVectors;
+    auto peeledEncoding = PeeledEncoding::peel(
+        {input1, input2}, rows, localDecodedVector, true, peeledVectors);
+    ASSERT_EQ(peeledVectors.size(), 2);
+    ASSERT_EQ(
+        peeledEncoding->wrapEncoding(), VectorEncoding::Simple::DICTIONARY);
+    ASSERT_EQ(peeledVectors[0].get(), runs1.get());
+    ASSERT_EQ(peeledVectors[1].get(), runs2.get());
+    assertEqualVectors(
+        input1, peeledEncoding->wrap(INTEGER(), pool(), runs1, rows), rows);
+
+    LocalSelectivityVector innerRowsHolder(execCtx_);
+    auto* innerRows =
+        peeledEncoding->translateToInnerRows(rows, innerRowsHolder);
+    ASSERT_EQ(innerRows->size(), 2);
+    ASSERT_EQ(innerRows->countSelected(), 2);
+  }
+
+  // Sequences with different lengths are not peeled.
+  {
+    auto input3 = std::make_shared<SequenceVector<int32_t>>(
+        pool(), 100, runs2, makeIndices({50, 50}));
+    std::vector<VectorPtr> peeledVectors;
+    auto peeledEncoding = PeeledEncoding::peel(
+        {input1, input3}, rows, localDecodedVector, true, peeledVectors);
+    ASSERT_TRUE(peeledVectors.empty());
+    ASSERT_TRUE(!peeledEncoding);
+  }
+}
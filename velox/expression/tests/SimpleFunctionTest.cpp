@@ -644,6 +644,121 @@ TEST_F(SimpleFunctionTest, returnNull) {
   assertEqualVectors(expected, resultCallNullable);
 }
 
+// Adds one to the input and counts the calls.
+template <typename T>
+struct CountingPlusOneFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  static inline int64_t numCalls{0};
+
+  FOLLY_ALWAYS_INLINE void call(int64_t& out, const int64_t& input) {
+    ++numCalls;
+    out = input + 1;
+  }
+};
+
+TEST_F(SimpleFunctionTest, sequenceInput) {
+  registerFunction<CountingPlusOneFunction, int64_t, int64_t>(
+      {"counting_plus_one"});
+  auto& numCalls = CountingPlusOneFunction<exec::VectorExec>::numCalls;
+
+  // 20 runs of 50 rows.
+  std::vector<std::optional<int64_t>> data(1'000);
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = i / 50;
+  }
+  auto makeExpected = [&]() {
+    std::vector<std::optional<int64_t>> expected(data.size());
+    for (auto i = 0; i < data.size(); ++i) {
+      if (data[i].has_value()) {
+        expected[i] = data[i].value() + 1;
+      }
+    }
+    return makeNullableFlatVector(expected);
+  };
+
+  // The sequence is peeled and the function is called once per run.
+  numCalls = 0;
+  auto result = evaluate(
+      "counting_plus_one(c0)",
+      makeRowVector({vectorMaker_.sequenceVector(data)}));
+  assertEqualVectors(makeExpected(), result);
+  ASSERT_EQ(numCalls, 20);
+
+  // Null runs.
+  for (auto i = 0; i < data.size(); ++i) {
+    if (i / 50 % 4 == 3) {
+      data[i] = std::nullopt;
+    }
+  }
+  result = evaluate(
+      "counting_plus_one(c0)",
+      makeRowVector({vectorMaker_.sequenceVector(data)}));
+  assertEqualVectors(makeExpected(), result);
+
+  // A sequence with different run lengths is not peeled with 'c0' and is
+  // decoded per row.
+  std::vector<std::optional<int64_t>> otherData(data.size());
+  for (auto i = 0; i < otherData.size(); ++i) {
+    otherData[i] = i / 30;
+  }
+  result = evaluate(
+      "counting_plus_one(c0) + c1",
+      makeRowVector(
+          {vectorMaker_.sequenceVector(data),
+           vectorMaker_.sequenceVector(otherData)}));
+  auto expected = makeFlatVector<int64_t>(
+      data.size(),
+      [&](auto row) {
+        return data[row].value_or(0) + 1 + otherData[row].value();
+      },
+      [&](auto row) { return !data[row].has_value(); });
+  assertEqualVectors(expected, result);
+}
+
+template <typename T>
+struct WeightedSumFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  void call(int64_t& out, const int64_t& a, const int32_t& b) {
+    out = a + 10 * b;
+  }
+};
+
+TEST_F(SimpleFunctionTest, dictionaryInputs) {
+  registerFunction<WeightedSumFunction, int64_t, int64_t, int32_t>(
+      {"weighted_sum"});
+
+  // The dictionaries have different indices, so they are not peeled and the
+  // values of both are gathered.
+  auto test = [&](vector_size_t size) {
+    auto base = makeFlatVector<int64_t>(size, [](auto row) { return row; });
+    auto otherBase =
+        makeFlatVector<int32_t>(size, [](auto row) { return row * 2; });
+    auto data = makeRowVector({
+        wrapInDictionary(makeIndicesInReverse(size), size, base),
+        BaseVector::wrapInDictionary(
+            makeNulls(size, nullEvery(7)),
+            makeIndices(size, [](auto row) { return row / 2; }),
+            size,
+            otherBase),
+    });
+    auto result = evaluate("weighted_sum(c0, c1)", data);
+    auto expected = makeFlatVector<int64_t>(
+        size,
+        [&](auto row) { return size - 1 - row + 10 * (row / 2 * 2); },
+        nullEvery(7));
+    assertEqualVectors(expected, result);
+  };
+
+  test(1'000);
+  const auto* scratch = execCtx_.gatherScratch(1).data();
+  ASSERT_NE(scratch, nullptr);
+  // The scratch of the first batch is reused by a smaller one.
+  test(500);
+  ASSERT_EQ(execCtx_.gatherScratch(1).data(), scratch);
+}
+
 // Ensures that the call method can be templated.
 template <typename T>
 struct IsInputVarcharFunction {
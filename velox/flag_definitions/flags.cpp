@@ -105,6 +105,24 @@ DEFINE_bool(
     false,
     "If true, 'MemoryPool' will be running in debug mode to track the allocation and free call sites to detect the source of memory leak for testing purpose");
 
+DEFINE_uint64(
+    velox_memory_pool_allocation_sample_bytes,
+    0,
+    "If not zero, the leaf memory pools sample an allocation with its call "
+    "stack every this many allocated bytes to profile the allocation sites");
+
+DEFINE_uint64(
+    velox_memory_pool_allocation_profile_threshold_bytes,
+    0,
+    "If not zero, a leaf memory pool with allocation sampling enabled dumps "
+    "its allocation profile once when its memory usage exceeds this many "
+    "bytes");
+
+DEFINE_string(
+    velox_memory_pool_allocation_profile_dir,
+    "/tmp",
+    "The directory to dump the allocation profiles of the memory pools in");
+
 // TODO: deprecate this after solves all the use cases that can cause
 // significant performance regression by memory usage tracking.
 DEFINE_bool(
@@ -127,6 +145,17 @@ DEFINE_int32(
 
 DEFINE_bool(velox_ssd_odirect, true, "Use O_DIRECT for SSD cache IO");
 
+// Used in exec/Spiller.cpp
+
+DEFINE_int32(
+    velox_spill_max_concurrent_writes,
+    0,
+    "The max number of partition spill writes running on the spill executors "
+    "at the same time in the process. It bounds the disk IO issued by the "
+    "parallel partition spilling across all the queries. The writes beyond "
+    "the limit run on the spilling threads instead of waiting. No limit if it "
+    "is not positive.");
+
 DEFINE_bool(
     velox_ssd_verify_write,
     false,
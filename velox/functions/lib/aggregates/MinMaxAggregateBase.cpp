@@ -45,6 +45,10 @@ class SimpleNumericMinMaxAggregate : public SimpleNumericAggregate<T, T, T> {
     return sizeof(T);
   }
 
+  bool supportsCompaction() const override {
+    return true;
+  }
+
   int32_t accumulatorAlignmentSize() const override {
     if constexpr (std::is_same_v<T, int128_t>) {
       // Override 'accumulatorAlignmentSize' for UnscaledLongDecimal values as
@@ -314,6 +318,20 @@ class MinMaxAggregateBase : public exec::Aggregate {
     return true;
   }
 
+  bool supportsCompaction() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::RelocateFn& relocate) override {
+    for (auto group : groups) {
+      if (isInitialized(group)) {
+        value<SingleValueAccumulator>(group)->relocate(relocate);
+      }
+    }
+  }
+
   void toIntermediate(
       const SelectivityVector& rows,
       std::vector<VectorPtr>& args,
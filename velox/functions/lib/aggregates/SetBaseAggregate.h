@@ -33,6 +33,9 @@ class SetBaseAggregate : public exec::Aggregate {
   explicit SetBaseAggregate(const TypePtr& resultType)
       : exec::Aggregate(resultType) {}
 
+  // Does not support compaction. The F14 map of the accumulator allocates its
+  // storage from the HashStringAllocator, which compact() can't move block by
+  // block.
   int32_t accumulatorFixedWidthSize() const override {
     return sizeof(AccumulatorType);
   }
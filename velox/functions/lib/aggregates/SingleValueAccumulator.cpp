@@ -67,4 +67,13 @@ void SingleValueAccumulator::destroy(HashStringAllocator* allocator) {
   }
 }
 
+void SingleValueAccumulator::relocate(
+    const HashStringAllocator::RelocateFn& relocate) {
+  if (start_.header != nullptr) {
+    const auto offset = HashStringAllocator::offset(start_.header, start_);
+    start_.header = relocate(start_.header);
+    start_ = HashStringAllocator::seek(start_.header, offset);
+  }
+}
+
 } // namespace facebook::velox::functions::aggregate
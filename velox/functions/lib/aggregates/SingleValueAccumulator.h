@@ -47,6 +47,9 @@ struct SingleValueAccumulator {
   /// Returns memory back to HashStringAllocator.
   void destroy(HashStringAllocator* allocator);
 
+  /// Moves the value with 'relocate' during HashStringAllocator::compact().
+  void relocate(const HashStringAllocator::RelocateFn& relocate);
+
  private:
   HashStringAllocator::Position start_;
 };
@@ -45,6 +45,10 @@ class SumAggregateBase
     return 1;
   }
 
+  bool supportsCompaction() const override {
+    return true;
+  }
+
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     BaseAggregate::template doExtractValues<ResultType>(
@@ -102,6 +102,19 @@ void ValueList::appendRange(
   }
 }
 
+void ValueList::relocate(const HashStringAllocator::RelocateFn& relocate) {
+  if (nullsBegin_ != nullptr) {
+    const auto offset = HashStringAllocator::offset(nullsBegin_, nullsCurrent_);
+    nullsBegin_ = relocate(nullsBegin_);
+    nullsCurrent_ = HashStringAllocator::seek(nullsBegin_, offset);
+  }
+  if (dataBegin_ != nullptr) {
+    const auto offset = HashStringAllocator::offset(dataBegin_, dataCurrent_);
+    dataBegin_ = relocate(dataBegin_);
+    dataCurrent_ = HashStringAllocator::seek(dataBegin_, offset);
+  }
+}
+
 ValueListReader::ValueListReader(ValueList& values)
     : size_{values.size()},
       lastNullsStart_{size_ % 64 == 0 ? size_ - 64 : size_ - size_ % 64},
@@ -165,6 +165,20 @@ class NonNumericArbitrary : public exec::Aggregate {
     return sizeof(SingleValueAccumulator);
   }
 
+  bool supportsCompaction() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::RelocateFn& relocate) override {
+    for (auto group : groups) {
+      if (isInitialized(group)) {
+        value<SingleValueAccumulator>(group)->relocate(relocate);
+      }
+    }
+  }
+
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     VELOX_CHECK(result);
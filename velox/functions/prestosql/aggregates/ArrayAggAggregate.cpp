@@ -39,6 +39,20 @@ class ArrayAggAggregate : public exec::Aggregate {
     return false;
   }
 
+  bool supportsCompaction() const override {
+    return true;
+  }
+
+  void relocateAccumulators(
+      folly::Range<char**> groups,
+      const HashStringAllocator::RelocateFn& relocate) override {
+    for (auto group : groups) {
+      if (isInitialized(group)) {
+        value<ArrayAccumulator>(group)->elements.relocate(relocate);
+      }
+    }
+  }
+
   bool supportsToIntermediate() const override {
     return true;
   }
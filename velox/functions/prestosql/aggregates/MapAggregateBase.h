@@ -27,6 +27,9 @@ class MapAggregateBase : public exec::Aggregate {
  public:
   explicit MapAggregateBase(TypePtr resultType) : Aggregate(resultType) {}
 
+  // Does not support compaction. The F14 map of the accumulator allocates its
+  // storage from the HashStringAllocator, which compact() can't move block by
+  // block.
   int32_t accumulatorFixedWidthSize() const override {
     return sizeof(AccumulatorType);
   }
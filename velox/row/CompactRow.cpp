@@ -16,6 +16,7 @@
 #include "velox/row/CompactRow.h"
 
 #include "velox/common/memory/RawVector.h"
+#include "velox/row/RowUtils.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::row {
@@ -339,8 +340,49 @@ void CompactRow::serializedRowSizes(
     return;
   }
 
-  for (const auto& row : rows) {
-    *sizes[row] = rowSize(row) + sizeof(TRowSize);
+  raw_vector<vector_size_t> rowSize(rows.size());
+  rowSizes(rows, rowSize.data());
+  for (auto i = 0; i < rows.size(); ++i) {
+    *sizes[rows[i]] = rowSize[i] + sizeof(TRowSize);
+  }
+}
+
+void CompactRow::rowSizes(
+    const folly::Range<const vector_size_t*>& rows,
+    vector_size_t* sizes) const {
+  const auto childRows = baseRows(decoded_, rows);
+
+  // Sums up the fixed-width fields first and then adds the variable-width
+  // fields column by column.
+  int32_t fixedSize = rowNullBytes_;
+  for (auto i = 0; i < children_.size(); ++i) {
+    if (childIsFixedWidth_[i]) {
+      fixedSize += children_[i].valueBytes_;
+    }
+  }
+  std::fill(sizes, sizes + rows.size(), fixedSize);
+
+  for (auto childIdx = 0; childIdx < children_.size(); ++childIdx) {
+    if (childIsFixedWidth_[childIdx]) {
+      continue;
+    }
+    const auto& child = children_[childIdx];
+    const bool mayHaveNulls = child.decoded_.mayHaveNulls();
+    if (child.typeKind_ == TypeKind::VARCHAR ||
+        child.typeKind_ == TypeKind::VARBINARY) {
+      for (auto i = 0; i < childRows.size(); ++i) {
+        if (!mayHaveNulls || !child.isNullAt(childRows[i])) {
+          sizes[i] += kSizeBytes +
+              child.decoded_.valueAt<StringView>(childRows[i]).size();
+        }
+      }
+    } else {
+      for (auto i = 0; i < childRows.size(); ++i) {
+        if (!mayHaveNulls || !child.isNullAt(childRows[i])) {
+          sizes[i] += child.variableWidthRowSize(childRows[i]);
+        }
+      }
+    }
   }
 }
 
@@ -381,19 +423,11 @@ int32_t CompactRow::serializeRow(vector_size_t index, char* buffer) const {
 }
 
 void CompactRow::serializeRow(
-    vector_size_t offset,
-    vector_size_t size,
+    const raw_vector<vector_size_t>& rows,
     char* buffer,
     const size_t* bufferOffsets) const {
-  raw_vector<vector_size_t> rows(size);
+  const auto size = rows.size();
   raw_vector<uint8_t*> nulls(size);
-  if (decoded_.isIdentityMapping()) {
-    std::iota(rows.begin(), rows.end(), offset);
-  } else {
-    for (auto i = 0; i < size; ++i) {
-      rows[i] = decoded_.index(offset + i);
-    }
-  }
 
   // After serializing each column, the 'offsets' are updated accordingly.
   std::vector<size_t> offsets(size);
@@ -661,7 +695,22 @@ void CompactRow::serialize(
     vector_size_t size,
     const size_t* bufferOffsets,
     char* buffer) const {
-  serializeRow(offset, size, buffer, bufferOffsets);
+  raw_vector<vector_size_t> rows(size);
+  if (decoded_.isIdentityMapping()) {
+    std::iota(rows.begin(), rows.end(), offset);
+  } else {
+    for (auto i = 0; i < size; ++i) {
+      rows[i] = decoded_.index(offset + i);
+    }
+  }
+  serializeRow(rows, buffer, bufferOffsets);
+}
+
+void CompactRow::serialize(
+    const folly::Range<const vector_size_t*>& rows,
+    const size_t* bufferOffsets,
+    char* buffer) const {
+  serializeRow(baseRows(decoded_, rows), buffer, bufferOffsets);
 }
 
 void CompactRow::serializeFixedWidth(vector_size_t index, char* buffer) const {
@@ -769,17 +818,37 @@ VectorPtr deserializeFixedWidth(
   using T = typename TypeTraits<Kind>::NativeType;
 
   const auto numRows = data.size();
-  auto flatVector = BaseVector::create<FlatVector<T>>(type, numRows, pool);
-
   auto* rawNulls = nulls->as<uint64_t>();
 
+  // Gathers the values into a flat buffer and adopts 'nulls', which is owned
+  // by this field only, if there is any null.
+  auto values = AlignedBuffer::allocate<T>(numRows, pool);
+  auto* rawValues = values->asMutable<T>();
+  bool hasNulls{false};
   for (auto i = 0; i < numRows; ++i) {
-    const bool isNull = bits::isBitNull(rawNulls, i);
-    readFixedWidthValue<T>(
-        isNull, data[i].data() + offsets[i], flatVector.get(), i);
+    if (bits::isBitNull(rawNulls, i)) {
+      hasNulls = true;
+      continue;
+    }
+    const char* buffer = data[i].data() + offsets[i];
+    if constexpr (std::is_same_v<T, bool>) {
+      bits::setBit(rawValues, i, *buffer != 0);
+    } else if constexpr (std::is_same_v<T, Timestamp>) {
+      int64_t micros;
+      ::memcpy(&micros, buffer, sizeof(int64_t));
+      rawValues[i] = Timestamp::fromMicros(micros);
+    } else {
+      ::memcpy(rawValues + i, buffer, sizeof(T));
+    }
   }
 
-  return flatVector;
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      hasNulls ? nulls : nullptr,
+      numRows,
+      std::move(values),
+      std::vector<BufferPtr>{});
 }
 
 vector_size_t totalSize(const vector_size_t* rawSizes, size_t numRows) {
@@ -874,18 +943,48 @@ VectorPtr deserializeStrings(
     std::vector<size_t>& offsets,
     memory::MemoryPool* pool) {
   const auto numRows = data.size();
-  auto flatVector =
-      BaseVector::create<FlatVector<StringView>>(type, numRows, pool);
-
   auto* rawNulls = nulls->as<uint64_t>();
 
+  // Sizes the string buffer up front for all the non-inlined strings.
+  size_t totalBytes = 0;
+  bool hasNulls{false};
+  for (auto i = 0; i < numRows; ++i) {
+    if (bits::isBitNull(rawNulls, i)) {
+      hasNulls = true;
+    } else {
+      const auto size = readInt32(data[i].data() + offsets[i]);
+      if (!StringView::isInline(size)) {
+        totalBytes += size;
+      }
+    }
+  }
+
+  auto flatVector = std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      hasNulls ? nulls : nullptr,
+      numRows,
+      AlignedBuffer::allocate<StringView>(numRows, pool),
+      std::vector<BufferPtr>{});
+  auto* rawValues = flatVector->mutableRawValues();
+  char* rawBuffer = totalBytes > 0
+      ? flatVector->getRawStringBufferWithSpace(totalBytes, true)
+      : nullptr;
   for (auto i = 0; i < numRows; ++i) {
     if (bits::isBitNull(rawNulls, i)) {
-      flatVector->setNull(i, true);
+      rawValues[i] = StringView();
+      continue;
+    }
+    const char* buffer = data[i].data() + offsets[i];
+    const auto size = readInt32(buffer);
+    if (StringView::isInline(size)) {
+      rawValues[i] = StringView(buffer + kSizeBytes, size);
     } else {
-      offsets[i] +=
-          readString(data[i].data() + offsets[i], flatVector.get(), i);
+      ::memcpy(rawBuffer, buffer + kSizeBytes, size);
+      rawValues[i] = StringView(rawBuffer, size);
+      rawBuffer += size;
     }
+    offsets[i] += kSizeBytes + size;
   }
 
   return flatVector;
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/memory/RawVector.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DecodedVector.h"
 
@@ -25,12 +26,17 @@ class CompactRow {
   explicit CompactRow(const RowVectorPtr& vector);
 
   /// Returns the serialized sizes of the rows at specified indexes.
-  ///
-  /// TODO: optimizes using columnar serialization size calculation.
   void serializedRowSizes(
       const folly::Range<const vector_size_t*>& rows,
       vector_size_t** sizes) const;
 
+  /// Computes the serialized sizes of the rows at specified indexes column by
+  /// column and writes these into 'sizes' which must be accessible for
+  /// 'rows.size()' elements. Use only if 'fixedRowSize' returned std::nullopt.
+  void rowSizes(
+      const folly::Range<const vector_size_t*>& rows,
+      vector_size_t* sizes) const;
+
   /// Returns row size if all fields are fixed width. Return std::nullopt if
   /// there are variable-width fields.
   static std::optional<int32_t> fixedRowSize(const RowTypePtr& rowType);
@@ -55,6 +61,13 @@ class CompactRow {
       const size_t* bufferOffsets,
       char* buffer) const;
 
+  /// Same as above but serializes the rows at specified indexes. The row at
+  /// 'rows[i]' is written at 'bufferOffsets[i]'.
+  void serialize(
+      const folly::Range<const vector_size_t*>& rows,
+      const size_t* bufferOffsets,
+      char* buffer) const;
+
   /// Deserializes multiple rows into a RowVector of specified type. The type
   /// must match the contents of the serialized rows.
   static RowVectorPtr deserialize(
@@ -130,11 +143,10 @@ class CompactRow {
   /// Serializes struct value to buffer. Value must not be null.
   int32_t serializeRow(vector_size_t index, char* buffer) const;
 
-  /// Serializes struct values in range [offset, offset + size) to buffer.
-  /// Value must not be null.
+  /// Serializes struct values at base vector indexes 'rows' to buffer column
+  /// by column. Value must not be null.
   void serializeRow(
-      vector_size_t offset,
-      vector_size_t size,
+      const raw_vector<vector_size_t>& rows,
       char* buffer,
       const size_t* bufferOffsets) const;
 
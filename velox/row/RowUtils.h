@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include "velox/common/memory/RawVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::row {
+
+/// Returns the base vector indexes of 'rows' in 'decoded'.
+inline raw_vector<vector_size_t> baseRows(
+    const DecodedVector& decoded,
+    const folly::Range<const vector_size_t*>& rows) {
+  raw_vector<vector_size_t> result(rows.size());
+  if (decoded.isIdentityMapping()) {
+    std::copy(rows.begin(), rows.end(), result.begin());
+  } else {
+    for (auto i = 0; i < rows.size(); ++i) {
+      result[i] = decoded.index(rows[i]);
+    }
+  }
+  return result;
+}
+
+} // namespace facebook::velox::row
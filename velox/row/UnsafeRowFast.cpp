@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/row/UnsafeRowFast.h"
+#include "velox/row/RowUtils.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::row {
@@ -33,6 +34,63 @@ int32_t alignBytes(int32_t numBytes) {
 bool isFixedWidth(const TypePtr& type) {
   return type->isFixedWidth() && !type->isLongDecimal();
 }
+
+// Writes the fixed-width values of field 'childIdx' at 'rows' into the field
+// slot at 'fieldOffset' of each row starting at 'rowBuffers'. Sets the null
+// bit of the row for null values.
+template <typename T>
+void serializeFixedWidthColumn(
+    const raw_vector<vector_size_t>& rows,
+    uint32_t childIdx,
+    const DecodedVector& decoded,
+    size_t fieldOffset,
+    const raw_vector<char*>& rowBuffers) {
+  const bool mayHaveNulls = decoded.mayHaveNulls();
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (mayHaveNulls && decoded.isNullAt(rows[i])) {
+      bits::setBit(rowBuffers[i], childIdx, true);
+      continue;
+    }
+    char* const dest = rowBuffers[i] + fieldOffset;
+    if constexpr (std::is_same_v<T, Timestamp>) {
+      const auto micros = decoded.valueAt<Timestamp>(rows[i]).toMicros();
+      ::memcpy(dest, &micros, sizeof(int64_t));
+    } else {
+      const T value = decoded.valueAt<T>(rows[i]);
+      ::memcpy(dest, &value, sizeof(T));
+    }
+  }
+}
+
+// Writes the string values of field 'childIdx' at 'rows' into the
+// variable-width section of each row starting at 'rowBuffers' and their size
+// and offset into the field slot at 'fieldOffset'. Advances
+// 'variableWidthOffsets' past the written strings.
+void serializeStringColumn(
+    const raw_vector<vector_size_t>& rows,
+    uint32_t childIdx,
+    const DecodedVector& decoded,
+    size_t fieldOffset,
+    const raw_vector<char*>& rowBuffers,
+    raw_vector<int64_t>& variableWidthOffsets) {
+  const bool mayHaveNulls = decoded.mayHaveNulls();
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (mayHaveNulls && decoded.isNullAt(rows[i])) {
+      bits::setBit(rowBuffers[i], childIdx, true);
+      continue;
+    }
+    const auto value = decoded.valueAt<StringView>(rows[i]);
+    auto& variableWidthOffset = variableWidthOffsets[i];
+    if (!value.empty()) {
+      ::memcpy(
+          rowBuffers[i] + variableWidthOffset, value.data(), value.size());
+    }
+    // Write size and offset.
+    const uint64_t sizeAndOffset = variableWidthOffset << 32 | value.size();
+    ::memcpy(rowBuffers[i] + fieldOffset, &sizeAndOffset, sizeof(uint64_t));
+    variableWidthOffset += alignBytes(value.size());
+  }
+}
 } // namespace
 
 // static
@@ -134,8 +192,46 @@ void UnsafeRowFast::serializedRowSizes(
     return;
   }
 
-  for (const auto& row : rows) {
-    *sizes[row] = rowSize(row) + sizeof(TRowSize);
+  raw_vector<vector_size_t> rowSize(rows.size());
+  rowSizes(rows, rowSize.data());
+  for (auto i = 0; i < rows.size(); ++i) {
+    *sizes[rows[i]] = rowSize[i] + sizeof(TRowSize);
+  }
+}
+
+void UnsafeRowFast::rowSizes(
+    const folly::Range<const vector_size_t*>& rows,
+    vector_size_t* sizes) const {
+  const auto childRows = baseRows(decoded_, rows);
+
+  // Every field takes a fixed-width slot. The variable-width values are added
+  // column by column.
+  std::fill(
+      sizes,
+      sizes + rows.size(),
+      rowNullBytes_ + children_.size() * kFieldWidth);
+
+  for (auto childIdx = 0; childIdx < children_.size(); ++childIdx) {
+    if (childIsFixedWidth_[childIdx]) {
+      continue;
+    }
+    const auto& child = children_[childIdx];
+    const bool mayHaveNulls = child.decoded_.mayHaveNulls();
+    if (child.typeKind_ == TypeKind::VARCHAR ||
+        child.typeKind_ == TypeKind::VARBINARY) {
+      for (auto i = 0; i < childRows.size(); ++i) {
+        if (!mayHaveNulls || !child.isNullAt(childRows[i])) {
+          sizes[i] += alignBytes(
+              child.decoded_.valueAt<StringView>(childRows[i]).size());
+        }
+      }
+    } else {
+      for (auto i = 0; i < childRows.size(); ++i) {
+        if (!mayHaveNulls || !child.isNullAt(childRows[i])) {
+          sizes[i] += alignBytes(child.variableWidthRowSize(childRows[i]));
+        }
+      }
+    }
   }
 }
 
@@ -173,6 +269,29 @@ int32_t UnsafeRowFast::serialize(vector_size_t index, char* buffer) const {
   return serializeRow(index, buffer);
 }
 
+void UnsafeRowFast::serialize(
+    vector_size_t offset,
+    vector_size_t size,
+    const size_t* bufferOffsets,
+    char* buffer) const {
+  raw_vector<vector_size_t> rows(size);
+  if (decoded_.isIdentityMapping()) {
+    std::iota(rows.begin(), rows.end(), offset);
+  } else {
+    for (auto i = 0; i < size; ++i) {
+      rows[i] = decoded_.index(offset + i);
+    }
+  }
+  serializeRow(rows, buffer, bufferOffsets);
+}
+
+void UnsafeRowFast::serialize(
+    const folly::Range<const vector_size_t*>& rows,
+    const size_t* bufferOffsets,
+    char* buffer) const {
+  serializeRow(baseRows(decoded_, rows), buffer, bufferOffsets);
+}
+
 void UnsafeRowFast::serializeFixedWidth(vector_size_t index, char* buffer)
     const {
   VELOX_DCHECK(fixedWidthTypeKind_);
@@ -427,6 +546,93 @@ int32_t UnsafeRowFast::serializeRow(vector_size_t index, char* buffer) const {
   return variableWidthOffset;
 }
 
+void UnsafeRowFast::serializeRow(
+    const raw_vector<vector_size_t>& rows,
+    char* buffer,
+    const size_t* bufferOffsets) const {
+  const auto size = rows.size();
+  raw_vector<char*> rowBuffers(size);
+  // The variable-width offsets relative to the start of each row. These are
+  // advanced as the variable-width columns are serialized.
+  raw_vector<int64_t> variableWidthOffsets(size);
+  const int64_t fixedWidthSize = rowNullBytes_ + kFieldWidth * children_.size();
+  for (auto i = 0; i < size; ++i) {
+    rowBuffers[i] = buffer + bufferOffsets[i];
+    variableWidthOffsets[i] = fixedWidthSize;
+  }
+
+  // The primitive types are serialized column by column with typed loops.
+  // Other data types are serialized row-by-row.
+  for (auto childIdx = 0; childIdx < children_.size(); ++childIdx) {
+    const auto& child = children_[childIdx];
+    const size_t fieldOffset = rowNullBytes_ + childIdx * kFieldWidth;
+    switch (child.typeKind_) {
+      case TypeKind::BOOLEAN:
+        serializeFixedWidthColumn<bool>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::TINYINT:
+        serializeFixedWidthColumn<int8_t>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::SMALLINT:
+        serializeFixedWidthColumn<int16_t>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::INTEGER:
+        serializeFixedWidthColumn<int32_t>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::BIGINT:
+        serializeFixedWidthColumn<int64_t>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::REAL:
+        serializeFixedWidthColumn<float>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::DOUBLE:
+        serializeFixedWidthColumn<double>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::TIMESTAMP:
+        serializeFixedWidthColumn<Timestamp>(
+            rows, childIdx, child.decoded_, fieldOffset, rowBuffers);
+        continue;
+      case TypeKind::VARCHAR:
+        [[fallthrough]];
+      case TypeKind::VARBINARY:
+        serializeStringColumn(
+            rows,
+            childIdx,
+            child.decoded_,
+            fieldOffset,
+            rowBuffers,
+            variableWidthOffsets);
+        continue;
+      default:
+        break;
+    }
+
+    for (auto i = 0; i < size; ++i) {
+      if (child.isNullAt(rows[i])) {
+        bits::setBit(rowBuffers[i], childIdx, true);
+      } else if (childIsFixedWidth_[childIdx]) {
+        child.serializeFixedWidth(rows[i], rowBuffers[i] + fieldOffset);
+      } else {
+        const auto serializedBytes = child.serializeVariableWidth(
+            rows[i], rowBuffers[i] + variableWidthOffsets[i]);
+        // Write size and offset.
+        const uint64_t sizeAndOffset =
+            variableWidthOffsets[i] << 32 | serializedBytes;
+        reinterpret_cast<uint64_t*>(rowBuffers[i] + rowNullBytes_)[childIdx] =
+            sizeAndOffset;
+        variableWidthOffsets[i] += alignBytes(serializedBytes);
+      }
+    }
+  }
+}
+
 namespace {
 // Reads single fixed-width value from buffer into rawValue[index].
 template <typename T>
@@ -437,7 +643,7 @@ readFixedWidthValue(const char* buffer, T* rawValue, vector_size_t index) {
     ::memcpy(&micros, buffer, sizeof(int64_t));
     rawValue[index] = Timestamp::fromMicros(micros);
   } else {
-    rawValue[index] = reinterpret_cast<const T*>(buffer)[0];
+    ::memcpy(rawValue + index, buffer, sizeof(T));
   }
 }
 
@@ -465,47 +671,34 @@ VectorPtr deserializeFixedWidth(
   using T = typename TypeTraits<Kind>::NativeType;
 
   const auto numRows = data.size();
-  auto flatVector = BaseVector::create<FlatVector<T>>(type, numRows, pool);
-  auto rawValues = flatVector->mutableRawValues();
-  auto* rawNulls = nulls->as<uint64_t>();
-
-  for (auto i = 0; i < numRows; ++i) {
-    const bool isNull = bits::isBitNull(rawNulls, i);
-    if (isNull) {
-      flatVector->setNull(i, true);
-    } else {
-      readFixedWidthValue<T>(data[i] + offsets[i], rawValues, i);
-    }
-    offsets[i] += kFieldWidth;
-  }
-
-  return flatVector;
-}
-
-template <>
-VectorPtr deserializeFixedWidth<TypeKind::BOOLEAN>(
-    const TypePtr& type,
-    const std::vector<char*>& data,
-    const BufferPtr& nulls,
-    std::vector<size_t>& offsets,
-    memory::MemoryPool* pool) {
-  const auto numRows = data.size();
-  auto flatVector = BaseVector::create<FlatVector<bool>>(type, numRows, pool);
-  auto rawValues = flatVector->mutableRawValues<uint64_t>();
   auto* rawNulls = nulls->as<uint64_t>();
 
+  // Gathers the values into a flat buffer and adopts 'nulls', which is owned
+  // by this field only, if there is any null.
+  auto values = AlignedBuffer::allocate<T>(numRows, pool);
+  auto* rawValues = values->asMutable<T>();
+  bool hasNulls{false};
   for (auto i = 0; i < numRows; ++i) {
-    const bool isNull = bits::isBitNull(rawNulls, i);
-    if (isNull) {
-      flatVector->setNull(i, true);
+    if (bits::isBitNull(rawNulls, i)) {
+      hasNulls = true;
     } else {
-      bool value = reinterpret_cast<const bool*>(data[i] + offsets[i])[0];
-      bits::setBit(rawValues, i, value);
+      const char* buffer = data[i] + offsets[i];
+      if constexpr (std::is_same_v<T, bool>) {
+        bits::setBit(rawValues, i, *buffer != 0);
+      } else {
+        readFixedWidthValue<T>(buffer, rawValues, i);
+      }
     }
     offsets[i] += kFieldWidth;
   }
 
-  return flatVector;
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      hasNulls ? nulls : nullptr,
+      numRows,
+      std::move(values),
+      std::vector<BufferPtr>{});
 }
 
 vector_size_t totalSize(const vector_size_t* rawSizes, size_t numRows) {
@@ -588,16 +781,17 @@ VectorPtr deserializeFixedWidthArrays(
   return flatVector;
 }
 
-inline const int32_t* readInt32Ptr(const char* buffer) {
-  return reinterpret_cast<const int32_t*>(buffer);
-}
-
+// The rows may not be aligned, so the values are read with memcpy.
 inline int32_t readInt32(const char* buffer) {
-  return *reinterpret_cast<const int32_t*>(buffer);
+  int32_t value;
+  ::memcpy(&value, buffer, sizeof(int32_t));
+  return value;
 }
 
 inline int64_t readInt64(const char* buffer) {
-  return *reinterpret_cast<const int64_t*>(buffer);
+  int64_t value;
+  ::memcpy(&value, buffer, sizeof(int64_t));
+  return value;
 }
 
 // Reads the offset to start and length from buffer, set flatVector[index].
@@ -608,8 +802,8 @@ inline void readString(
     const char* start,
     FlatVector<StringView>* flatVector,
     vector_size_t index) {
-  const auto* sizeAndOffset = readInt32Ptr(buffer);
-  StringView value(start + sizeAndOffset[1], sizeAndOffset[0]);
+  const auto size = readInt32(buffer);
+  StringView value(start + readInt32(buffer + sizeof(int32_t)), size);
   flatVector->set(index, value);
 }
 
@@ -619,10 +813,9 @@ void readLongDecimal(
     const char* start,
     int128_t* rawValue,
     vector_size_t index) {
-  const auto* sizeAndOffset = readInt32Ptr(buffer);
-  auto length = sizeAndOffset[0];
-  const uint8_t* bytesValue =
-      reinterpret_cast<const uint8_t*>(start + sizeAndOffset[1]);
+  const auto length = readInt32(buffer);
+  const auto offset = readInt32(buffer + sizeof(int32_t));
+  const uint8_t* bytesValue = reinterpret_cast<const uint8_t*>(start + offset);
   int128_t bigEndianValue = static_cast<int8_t>(bytesValue[0]) >= 0 ? 0 : -1;
   memcpy(
       reinterpret_cast<char*>(&bigEndianValue) + sizeof(int128_t) - length,
@@ -657,16 +850,48 @@ VectorPtr deserializeStrings(
     std::vector<size_t>& offsets,
     memory::MemoryPool* pool) {
   const auto numRows = data.size();
-  auto flatVector =
-      BaseVector::create<FlatVector<StringView>>(type, numRows, pool);
-
   auto* rawNulls = nulls->as<uint64_t>();
 
+  // Sizes the string buffer up front for all the non-inlined strings.
+  size_t totalBytes = 0;
+  bool hasNulls{false};
   for (auto i = 0; i < numRows; ++i) {
     if (bits::isBitNull(rawNulls, i)) {
-      flatVector->setNull(i, true);
+      hasNulls = true;
+    } else {
+      const auto size = readInt32(data[i] + offsets[i]);
+      if (!StringView::isInline(size)) {
+        totalBytes += size;
+      }
+    }
+  }
+
+  auto flatVector = std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      hasNulls ? nulls : nullptr,
+      numRows,
+      AlignedBuffer::allocate<StringView>(numRows, pool),
+      std::vector<BufferPtr>{});
+  auto* rawValues = flatVector->mutableRawValues();
+  char* rawBuffer = totalBytes > 0
+      ? flatVector->getRawStringBufferWithSpace(totalBytes, true)
+      : nullptr;
+  for (auto i = 0; i < numRows; ++i) {
+    if (bits::isBitNull(rawNulls, i)) {
+      rawValues[i] = StringView();
     } else {
-      readString(data[i] + offsets[i], data[i], flatVector.get(), i);
+      int32_t sizeAndOffset[2];
+      ::memcpy(sizeAndOffset, data[i] + offsets[i], sizeof(sizeAndOffset));
+      const char* value = data[i] + sizeAndOffset[1];
+      const auto size = sizeAndOffset[0];
+      if (StringView::isInline(size)) {
+        rawValues[i] = StringView(value, size);
+      } else {
+        ::memcpy(rawBuffer, value, size);
+        rawValues[i] = StringView(rawBuffer, size);
+        rawBuffer += size;
+      }
     }
     offsets[i] += kFieldWidth;
   }
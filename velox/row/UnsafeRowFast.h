@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/memory/RawVector.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DecodedVector.h"
 
@@ -25,12 +26,17 @@ class UnsafeRowFast {
   explicit UnsafeRowFast(const RowVectorPtr& vector);
 
   /// Returns the serialized sizes of the rows at specified row indexes.
-  ///
-  /// TODO: optimizes using columnar serialization size calculation.
   void serializedRowSizes(
       const folly::Range<const vector_size_t*>& rows,
       vector_size_t** sizes) const;
 
+  /// Computes the serialized sizes of the rows at specified indexes column by
+  /// column and writes these into 'sizes' which must be accessible for
+  /// 'rows.size()' elements. Use only if 'fixedRowSize' returned std::nullopt.
+  void rowSizes(
+      const folly::Range<const vector_size_t*>& rows,
+      vector_size_t* sizes) const;
+
   /// Returns row size if all fields are fixed width. Return std::nullopt if
   /// there are variable-width fields.
   static std::optional<int32_t> fixedRowSize(const RowTypePtr& rowType);
@@ -43,9 +49,29 @@ class UnsafeRowFast {
   /// 'buffer' must have sufficient capacity and set to all zeros.
   int32_t serialize(vector_size_t index, char* buffer) const;
 
+  /// Serializes rows in the range [offset, offset + size) into 'buffer' at
+  /// given 'bufferOffsets' column by column. 'buffer' must have sufficient
+  /// capacity and set to all zeros. 'bufferOffsets' must be pre-filled with
+  /// the write offsets for each row and must be accessible for 'size'
+  /// elements. The caller must ensure that the space between each offset in
+  /// 'bufferOffsets' is no less than the 'fixedRowSize' or 'rowSize'.
+  void serialize(
+      vector_size_t offset,
+      vector_size_t size,
+      const size_t* bufferOffsets,
+      char* buffer) const;
+
+  /// Same as above but serializes the rows at specified indexes. The row at
+  /// 'rows[i]' is written at 'bufferOffsets[i]'.
+  void serialize(
+      const folly::Range<const vector_size_t*>& rows,
+      const size_t* bufferOffsets,
+      char* buffer) const;
+
   /// Deserializes multiple rows into a RowVector of specified type. The type
   /// must match the contents of the serialized rows.
-  /// @param data The start memory address of each row.
+  /// @param data The start memory address of each row. The rows don't need to
+  /// be aligned.
   static RowVectorPtr deserialize(
       const std::vector<char*>& data,
       const RowTypePtr& rowType,
@@ -118,6 +144,13 @@ class UnsafeRowFast {
   /// Serializes struct value to buffer. Value must not be null.
   int32_t serializeRow(vector_size_t index, char* buffer) const;
 
+  /// Serializes struct values at base vector indexes 'rows' to buffer column
+  /// by column. Value must not be null.
+  void serializeRow(
+      const raw_vector<vector_size_t>& rows,
+      char* buffer,
+      const size_t* bufferOffsets) const;
+
   const TypeKind typeKind_;
   DecodedVector decoded_;
 
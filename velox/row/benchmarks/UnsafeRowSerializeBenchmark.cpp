@@ -39,6 +39,22 @@ class SerializeBenchmark {
     VELOX_CHECK_EQ(serialized.size(), data->size());
   }
 
+  void serializeUnsafeBatch(const RowTypePtr& rowType) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeData(rowType);
+    suspender.dismiss();
+
+    const auto numRows = data->size();
+    std::vector<vector_size_t> rowSize(numRows);
+    std::vector<size_t> offsets(numRows);
+
+    UnsafeRowFast fast(data);
+    auto totalSize = computeTotalSize(fast, rowType, numRows, rowSize, offsets);
+    auto buffer = AlignedBuffer::allocate<char>(totalSize, pool(), 0);
+    fast.serialize(0, numRows, offsets.data(), buffer->asMutable<char>());
+    VELOX_CHECK_EQ(offsets.back() + rowSize.back(), totalSize);
+  }
+
   void deserializeUnsafe(const RowTypePtr& rowType) {
     folly::BenchmarkSuspender suspender;
     auto data = makeData(rowType);
@@ -144,6 +160,28 @@ class SerializeBenchmark {
     return totalSize;
   }
 
+  // Computes the row sizes column by column.
+  size_t computeTotalSize(
+      UnsafeRowFast& unsafeRow,
+      const RowTypePtr& rowType,
+      vector_size_t numRows,
+      std::vector<vector_size_t>& rowSize,
+      std::vector<size_t>& offsets) {
+    if (auto fixedRowSize = UnsafeRowFast::fixedRowSize(rowType)) {
+      std::fill(rowSize.begin(), rowSize.end(), fixedRowSize.value());
+    } else {
+      std::vector<vector_size_t> rows(numRows);
+      std::iota(rows.begin(), rows.end(), 0);
+      unsafeRow.rowSizes(folly::Range(rows.data(), numRows), rowSize.data());
+    }
+    size_t totalSize = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      offsets[i] = totalSize;
+      totalSize += rowSize[i];
+    }
+    return totalSize;
+  }
+
   std::vector<char*> serialize(
       UnsafeRowFast& unsafeRow,
       vector_size_t numRows,
@@ -229,6 +267,11 @@ class SerializeBenchmark {
     benchmark.serializeUnsafe(rowType);      \
   }                                          \
                                              \
+  BENCHMARK_RELATIVE(unsafe_batch_##name) {  \
+    SerializeBenchmark benchmark;            \
+    benchmark.serializeUnsafeBatch(rowType); \
+  }                                          \
+                                             \
   BENCHMARK(compact_serialize_##name) {      \
     SerializeBenchmark benchmark;            \
     benchmark.serializeCompact(rowType);     \
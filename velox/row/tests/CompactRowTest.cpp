@@ -126,6 +126,33 @@ class CompactRowTest : public ::testing::Test, public VectorTestBase {
       auto copy = CompactRow::deserialize(serialized, rowType, pool());
       assertEqualVectors(data, copy);
     }
+    {
+      // Test serialize by row indexes in reverse order.
+      memset(rawBuffer, 0, totalSize);
+
+      std::vector<vector_size_t> reversedRows(rows.rbegin(), rows.rend());
+      std::vector<size_t> reversedOffsets(offsets.rbegin(), offsets.rend());
+      if (!CompactRow::fixedRowSize(rowType)) {
+        std::vector<vector_size_t> reversedRowSize(numRows);
+        row.rowSizes(
+            folly::Range(reversedRows.data(), numRows), reversedRowSize.data());
+        for (auto i = 0; i < numRows; ++i) {
+          ASSERT_EQ(reversedRowSize[i], rowSize[reversedRows[i]]);
+        }
+      }
+      row.serialize(
+          folly::Range(reversedRows.data(), numRows),
+          reversedOffsets.data(),
+          rawBuffer);
+
+      std::vector<std::string_view> serialized;
+      for (auto i = 0; i < numRows; ++i) {
+        serialized.push_back(
+            std::string_view(rawBuffer + offsets[i], rowSize[i]));
+      }
+      auto copy = CompactRow::deserialize(serialized, rowType, pool());
+      assertEqualVectors(data, copy);
+    }
   }
 };
 
@@ -233,6 +233,33 @@ TEST_F(UnsafeRowFuzzTests, fast) {
         }
         return serialized;
       });
+
+  // Serializes all the rows column by column in reverse order.
+  doTest<char*>(rowType, [&](const RowVectorPtr& data) {
+    const auto numRows = data->size();
+    UnsafeRowFast fast(data);
+
+    std::vector<vector_size_t> rows(numRows);
+    std::iota(rows.rbegin(), rows.rend(), 0);
+    std::vector<size_t> offsets(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      offsets[i] = rows[i] * kBufferSize;
+    }
+    std::vector<vector_size_t> rowSizes(numRows);
+    fast.rowSizes(folly::Range(rows.data(), numRows), rowSizes.data());
+    for (auto i = 0; i < numRows; ++i) {
+      VELOX_CHECK_LE(rowSizes[i], kBufferSize);
+      EXPECT_EQ(rowSizes[i], fast.rowSize(rows[i]));
+    }
+    fast.serialize(
+        folly::Range(rows.data(), numRows), offsets.data(), buffers_[0]);
+
+    std::vector<char*> serialized;
+    for (auto i = 0; i < numRows; ++i) {
+      serialized.push_back(buffers_[i]);
+    }
+    return serialized;
+  });
 }
 
 } // namespace
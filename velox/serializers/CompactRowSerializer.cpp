@@ -21,49 +21,6 @@
 #include "velox/row/CompactRow.h"
 
 namespace facebook::velox::serializer {
-namespace {
-using TRowSize = uint32_t;
-
-class CompactRowVectorSerializer : public RowSerializer<row::CompactRow> {
- public:
-  explicit CompactRowVectorSerializer(
-      memory::MemoryPool* pool,
-      const VectorSerde::Options* options)
-      : RowSerializer<row::CompactRow>(pool, options) {}
-
- private:
-  void serializeRanges(
-      const row::CompactRow& row,
-      const folly::Range<const IndexRange*>& ranges,
-      char* rawBuffer,
-      const std::vector<vector_size_t>& rowSize) override {
-    size_t offset = 0;
-    vector_size_t index = 0;
-    for (const auto& range : ranges) {
-      if (range.size == 1) {
-        // Fast path for single-row serialization.
-        *reinterpret_cast<TRowSize*>(rawBuffer + offset) =
-            folly::Endian::big(rowSize[index]);
-        auto size =
-            row.serialize(range.begin, rawBuffer + offset + sizeof(TRowSize));
-        offset += size + sizeof(TRowSize);
-        ++index;
-      } else {
-        raw_vector<size_t> offsets(range.size);
-        for (auto i = 0; i < range.size; ++i, ++index) {
-          // Write raw size. Needs to be in big endian order.
-          *(TRowSize*)(rawBuffer + offset) = folly::Endian::big(rowSize[index]);
-          offsets[i] = offset + sizeof(TRowSize);
-          offset += rowSize[index] + sizeof(TRowSize);
-        }
-        // Write row data for all rows in range.
-        row.serialize(range.begin, range.size, offsets.data(), rawBuffer);
-      }
-    }
-  }
-};
-
-} // namespace
 
 void CompactRowVectorSerde::estimateSerializedSize(
     const row::CompactRow* compactRow,
@@ -78,7 +35,7 @@ CompactRowVectorSerde::createIterativeSerializer(
     int32_t /* numRows */,
     StreamArena* streamArena,
     const Options* options) {
-  return std::make_unique<CompactRowVectorSerializer>(
+  return std::make_unique<RowSerializer<row::CompactRow>>(
       streamArena->pool(), options);
 }
 
@@ -89,9 +46,9 @@ void CompactRowVectorSerde::deserialize(
     RowVectorPtr* result,
     const Options* options) {
   std::vector<std::string_view> serializedRows;
-  std::vector<std::unique_ptr<std::string>> serializedBuffers;
-  RowDeserializer<std::string_view>::deserialize<RowIteratorImpl>(
-      source, serializedRows, serializedBuffers, options);
+  std::vector<BufferPtr> serializedBuffers;
+  RowDeserializer<std::string_view>::deserializeRowGroups(
+      source, serializedRows, serializedBuffers, pool, options);
 
   if (serializedRows.empty()) {
     *result = BaseVector::create<RowVector>(type, 0, pool);
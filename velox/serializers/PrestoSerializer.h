@@ -80,6 +80,14 @@ class PrestoVectorSerde : public VectorSerde {
     /// affect the encoding of the input vectors. This is only relevant when
     /// using BatchVectorSerializer.
     bool preserveEncodings{false};
+
+    /// If true and the input stream shares the ownership of its memory (see
+    /// ByteInputStream::bufferOwner()), the deserializer wraps the string data
+    /// and the suitably aligned fixed-width values of uncompressed pages in
+    /// buffer views instead of copying them. The wrapped memory stays alive as
+    /// long as any vector references it. Only applies to the data deserialized
+    /// at offset 0 of the result as the views can't be appended to.
+    bool zeroCopyDeserialize{false};
   };
 
   PrestoVectorSerde() : VectorSerde(Kind::kPresto) {}
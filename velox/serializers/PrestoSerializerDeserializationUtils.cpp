@@ -596,6 +596,56 @@ void readLosslessTimestampValues(
   }
 }
 
+// Keeps the memory of a deserialized page alive while a buffer view over it is
+// referenced.
+struct IOBufReleaser {
+  explicit IOBufReleaser(std::shared_ptr<folly::IOBuf> iobuf)
+      : iobuf_(std::move(iobuf)) {}
+
+  void addRef() const {}
+  void release() const {}
+
+ private:
+  const std::shared_ptr<folly::IOBuf> iobuf_;
+};
+
+// Fixed-width types whose serialized values have the same layout as the values
+// of a FlatVector and can thus be wrapped without copying.
+template <typename T>
+inline constexpr bool kZeroCopyValues = std::is_same_v<T, int8_t> ||
+    std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t> ||
+    std::is_same_v<T, int64_t> || std::is_same_v<T, float> ||
+    std::is_same_v<T, double>;
+
+// Returns a buffer view over the next 'size' bytes of 'source' and advances
+// 'source' past them if zero-copy deserialization is enabled, 'source' shares
+// the ownership of its memory, and the bytes are contiguous and aligned to
+// 'alignment'. Returns nullptr and leaves 'source' unchanged otherwise.
+BufferPtr tryReadBufferView(
+    ByteInputStream* source,
+    int32_t size,
+    size_t alignment,
+    const PrestoVectorSerde::PrestoOptions& opts) {
+  if (!opts.zeroCopyDeserialize || size == 0) {
+    return nullptr;
+  }
+  auto owner = source->bufferOwner();
+  if (owner == nullptr) {
+    return nullptr;
+  }
+  const auto position = source->tellp();
+  const auto view = source->nextView(size);
+  if (view.size() != static_cast<size_t>(size) ||
+      reinterpret_cast<uintptr_t>(view.data()) % alignment != 0) {
+    source->seekp(position);
+    return nullptr;
+  }
+  return BufferView<IOBufReleaser>::create(
+      reinterpret_cast<const uint8_t*>(view.data()),
+      size,
+      IOBufReleaser(std::move(owner)));
+}
+
 template <typename T>
 void readValues(
     ByteInputStream* source,
@@ -706,6 +756,18 @@ void read(
   auto nullCount = readNulls(
       source, size, resultOffset, incomingNulls, numIncomingNulls, *flatResult);
 
+  if constexpr (kZeroCopyValues<T>) {
+    // The values are serialized densely only if there are no nulls.
+    if (resultOffset == 0 && nullCount == 0 && !isUuidType(type) &&
+        !isIPAddressType(type)) {
+      if (auto view = tryReadBufferView(
+              source, numNewValues * sizeof(T), alignof(T), opts)) {
+        flatResult->unsafeSetValues(std::move(view));
+        return;
+      }
+    }
+  }
+
   BufferPtr values = flatResult->mutableValues(resultOffset + numNewValues);
   if constexpr (std::is_same_v<T, Timestamp>) {
     if (opts.useLosslessTimestamp) {
@@ -800,12 +862,17 @@ void read<StringView>(
     return;
   }
 
-  auto* rawStrings =
-      flatResult->getRawStringBufferWithSpace(dataSize, true /*exactSize*/);
-
-  source->readBytes(rawStrings, dataSize);
+  const char* rawChars;
+  if (auto view = tryReadBufferView(source, dataSize, 1, opts)) {
+    rawChars = view->as<char>();
+    flatResult->addStringBuffer(view);
+  } else {
+    auto* rawStrings =
+        flatResult->getRawStringBufferWithSpace(dataSize, true /*exactSize*/);
+    source->readBytes(rawStrings, dataSize);
+    rawChars = reinterpret_cast<const char*>(rawStrings);
+  }
   int32_t previousOffset = 0;
-  auto rawChars = reinterpret_cast<char*>(rawStrings);
   for (int32_t i = 0; i < numNewValues; ++i) {
     int32_t offset = rawValues[resultOffset + i].size();
     rawValues[resultOffset + i] =
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/memory/RawVector.h"
 #include "velox/serializers/CompactRowSerializer.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/VectorStream.h"
@@ -99,19 +100,23 @@ class RowSerializer : public IterativeVectorSerializer {
     }
 
     Serializer row(vector);
-    std::vector<vector_size_t> rowSize(totalRows);
+    raw_vector<vector_size_t> rows(totalRows);
+    vector_size_t index = 0;
+    for (const auto& range : ranges) {
+      std::iota(
+          rows.begin() + index, rows.begin() + index + range.size, range.begin);
+      index += range.size;
+    }
+
+    raw_vector<vector_size_t> rowSize(totalRows);
     if (auto fixedRowSize =
             Serializer::fixedRowSize(asRowType(vector->type()))) {
-      totalSize += (fixedRowSize.value() + sizeof(TRowSize)) * totalRows;
       std::fill(rowSize.begin(), rowSize.end(), fixedRowSize.value());
     } else {
-      vector_size_t index = 0;
-      for (const auto& range : ranges) {
-        for (auto i = 0; i < range.size; ++i, ++index) {
-          rowSize[index] = row.rowSize(range.begin + i);
-          totalSize += rowSize[index] + sizeof(TRowSize);
-        }
-      }
+      row.rowSizes(folly::Range(rows.data(), rows.size()), rowSize.data());
+    }
+    for (const auto size : rowSize) {
+      totalSize += size + sizeof(TRowSize);
     }
 
     if (totalSize == 0) {
@@ -122,7 +127,11 @@ class RowSerializer : public IterativeVectorSerializer {
     auto* rawBuffer = buffer->asMutable<char>();
     buffers_.push_back(std::move(buffer));
 
-    serializeRanges(row, ranges, rawBuffer, rowSize);
+    serializeRows(
+        row,
+        folly::Range(rows.data(), rows.size()),
+        [&](vector_size_t i) { return rowSize[i]; },
+        rawBuffer);
   }
 
   void append(
@@ -141,16 +150,12 @@ class RowSerializer : public IterativeVectorSerializer {
     auto* rawBuffer = buffer->asMutable<char>();
     buffers_.push_back(std::move(buffer));
 
-    size_t offset = 0;
-    for (auto& row : rows) {
-      // Write row data.
-      const TRowSize size =
-          compactRow.serialize(row, rawBuffer + offset + sizeof(TRowSize));
-
-      // Write raw size. Needs to be in big endian order.
-      *(TRowSize*)(rawBuffer + offset) = folly::Endian::big(size);
-      offset += sizeof(TRowSize) + size;
-    }
+    // 'sizes' include the row size prefix.
+    serializeRows(
+        compactRow,
+        rows,
+        [&](vector_size_t i) { return sizes[rows[i]] - sizeof(TRowSize); },
+        rawBuffer);
   }
 
   size_t maxSerializedSize() const override {
@@ -220,29 +225,42 @@ class RowSerializer : public IterativeVectorSerializer {
   void clear() override {}
 
  protected:
-  virtual void serializeRanges(
+  memory::MemoryPool* const pool_;
+  std::vector<BufferPtr> buffers_;
+
+ private:
+  // Serializes 'rows' of 'rowSerializer' into 'rawBuffer' column by column.
+  // Each row is prefixed with its size returned by 'rowSize' for the row at
+  // position i in 'rows'.
+  template <typename RowSize>
+  void serializeRows(
       const Serializer& rowSerializer,
-      const folly::Range<const IndexRange*>& ranges,
-      char* rawBuffer,
-      const std::vector<vector_size_t>& /*rowSize*/) {
+      const folly::Range<const vector_size_t*>& rows,
+      const RowSize& rowSize,
+      char* rawBuffer) {
+    if (rows.size() == 1) {
+      // Fast path for single-row serialization.
+      const TRowSize size =
+          rowSerializer.serialize(rows[0], rawBuffer + sizeof(TRowSize));
+      // Write raw size. Needs to be in big endian order.
+      *reinterpret_cast<TRowSize*>(rawBuffer) = folly::Endian::big(size);
+      return;
+    }
+
+    raw_vector<size_t> offsets(rows.size());
     size_t offset = 0;
-    for (auto& range : ranges) {
-      for (auto row = range.begin; row < range.begin + range.size; ++row) {
-        // Write row data.
-        TRowSize size =
-            rowSerializer.serialize(row, rawBuffer + offset + sizeof(TRowSize));
-
-        // Write raw size. Needs to be in big endian order.
-        *(TRowSize*)(rawBuffer + offset) = folly::Endian::big(size);
-        offset += sizeof(TRowSize) + size;
-      }
+    for (auto i = 0; i < rows.size(); ++i) {
+      const TRowSize size = rowSize(i);
+      // Write raw size. Needs to be in big endian order.
+      *reinterpret_cast<TRowSize*>(rawBuffer + offset) =
+          folly::Endian::big(size);
+      offsets[i] = offset + sizeof(TRowSize);
+      offset += sizeof(TRowSize) + size;
     }
+    // Write row data for all rows.
+    rowSerializer.serialize(rows, offsets.data(), rawBuffer);
   }
 
-  memory::MemoryPool* const pool_;
-  std::vector<BufferPtr> buffers_;
-
- private:
   std::unique_ptr<folly::IOBuf> toIOBuf(const std::vector<BufferPtr>& buffers) {
     std::unique_ptr<folly::IOBuf> iobuf;
     for (const auto& buffer : buffers) {
@@ -416,6 +434,91 @@ class RowDeserializer {
       }
     }
   }
+
+  /// Same as 'deserialize' but locates the serialized rows of each row group
+  /// in place instead of copying each row into its own buffer. An
+  /// uncompressed group that lies in one byte range of 'source' is referenced
+  /// there. Other groups are read or uncompressed into a single buffer
+  /// allocated from 'pool' and added to 'serializedBuffers'. The rows are not
+  /// aligned. 'source' and 'serializedBuffers' must outlive the use of
+  /// 'serializedRows'.
+  static void deserializeRowGroups(
+      ByteInputStream* source,
+      std::vector<SerializeView>& serializedRows,
+      std::vector<BufferPtr>& serializedBuffers,
+      memory::MemoryPool* pool,
+      const VectorSerde::Options* options) {
+    const auto compressionKind = options == nullptr
+        ? VectorSerde::Options().compressionKind
+        : options->compressionKind;
+    while (!source->atEnd()) {
+      const auto header = detail::RowGroupHeader::read(source);
+      const char* group{nullptr};
+      if (header.compressed) {
+        VELOX_DCHECK_NE(
+            compressionKind, common::CompressionKind::CompressionKind_NONE);
+        auto compressBuf = folly::IOBuf::create(header.compressedSize);
+        source->readBytes(compressBuf->writableData(), header.compressedSize);
+        compressBuf->append(header.compressedSize);
+
+        const auto codec = common::compressionKindToCodec(compressionKind);
+        const auto uncompressedBuf =
+            codec->uncompress(compressBuf.get(), header.uncompressedSize);
+        auto groupBuffer =
+            AlignedBuffer::allocate<char>(header.uncompressedSize, pool);
+        char* const rawGroup = groupBuffer->asMutable<char>();
+        size_t offset = 0;
+        for (const auto& range : *uncompressedBuf) {
+          VELOX_CHECK_LE(offset + range.size(), header.uncompressedSize);
+          ::memcpy(rawGroup + offset, range.data(), range.size());
+          offset += range.size();
+        }
+        VELOX_CHECK_EQ(offset, header.uncompressedSize);
+        group = rawGroup;
+        serializedBuffers.push_back(std::move(groupBuffer));
+      } else {
+        const auto view = source->nextView(header.uncompressedSize);
+        if (view.size() == header.uncompressedSize) {
+          group = view.data();
+        } else {
+          // The group spans byte ranges of 'source'.
+          auto groupBuffer =
+              AlignedBuffer::allocate<char>(header.uncompressedSize, pool);
+          char* const rawGroup = groupBuffer->asMutable<char>();
+          ::memcpy(rawGroup, view.data(), view.size());
+          source->readBytes(
+              rawGroup + view.size(), header.uncompressedSize - view.size());
+          group = rawGroup;
+          serializedBuffers.push_back(std::move(groupBuffer));
+        }
+      }
+
+      // Scans the row sizes to locate the rows in the group.
+      size_t offset = 0;
+      while (offset < header.uncompressedSize) {
+        VELOX_CHECK_LE(
+            offset + sizeof(TRowSize),
+            header.uncompressedSize,
+            "Truncated serialized row size");
+        TRowSize rowSize;
+        ::memcpy(&rowSize, group + offset, sizeof(TRowSize));
+        rowSize = folly::Endian::big(rowSize);
+        offset += sizeof(TRowSize);
+        VELOX_CHECK_LE(
+            offset + rowSize,
+            header.uncompressedSize,
+            "Unable to read full serialized row. Needed {} bytes.",
+            rowSize);
+        if constexpr (std::is_same_v<SerializeView, std::string_view>) {
+          serializedRows.emplace_back(group + offset, rowSize);
+        } else {
+          // The rows are only read by the deserialization.
+          serializedRows.push_back(const_cast<char*>(group + offset));
+        }
+        offset += rowSize;
+      }
+    }
+  }
 };
 
 } // namespace facebook::velox::serializer
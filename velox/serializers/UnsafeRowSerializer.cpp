@@ -44,9 +44,9 @@ void UnsafeRowVectorSerde::deserialize(
     RowVectorPtr* result,
     const Options* options) {
   std::vector<char*> serializedRows;
-  std::vector<std::unique_ptr<std::string>> serializedBuffers;
-  RowDeserializer<char*>::deserialize<RowIteratorImpl>(
-      source, serializedRows, serializedBuffers, options);
+  std::vector<BufferPtr> serializedBuffers;
+  RowDeserializer<char*>::deserializeRowGroups(
+      source, serializedRows, serializedBuffers, pool, options);
 
   if (serializedRows.empty()) {
     *result = BaseVector::create<RowVector>(type, 0, pool);
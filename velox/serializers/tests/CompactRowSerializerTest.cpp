@@ -72,6 +72,7 @@ class CompactRowSerializerTest : public ::testing::Test,
   }
 
   void serialize(RowVectorPtr rowVector, std::ostream* output) {
+    const auto streamInitialSize = output->tellp();
     const auto numRows = rowVector->size();
 
     // Serialize with different range size.
@@ -121,9 +122,9 @@ class CompactRowSerializerTest : public ::testing::Test,
     OStreamOutputStream out(output);
     serializer->flush(&out);
     if (!needCompression()) {
-      ASSERT_EQ(size, output->tellp());
+      ASSERT_EQ(size, output->tellp() - streamInitialSize);
     } else {
-      ASSERT_GT(size, output->tellp());
+      ASSERT_GT(size, output->tellp() - streamInitialSize);
     }
   }
 
@@ -149,8 +150,9 @@ class CompactRowSerializerTest : public ::testing::Test,
 
   RowVectorPtr deserialize(
       const RowTypePtr& rowType,
-      const std::string_view& input) {
-    auto byteStream = toByteStream(input);
+      const std::string_view& input,
+      size_t pageSize = 32) {
+    auto byteStream = toByteStream(input, pageSize);
 
     RowVectorPtr result;
     getVectorSerde()->deserialize(
@@ -220,6 +222,43 @@ TEST_P(CompactRowSerializerTest, fuzz) {
   testRoundTrip(data);
 }
 
+TEST_P(CompactRowSerializerTest, rowGroups) {
+  const auto first = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3}),
+      makeNullableFlatVector<std::string>(
+          {"a", std::nullopt, "a long string which is not inlined"}),
+  });
+  const auto second = makeRowVector({
+      makeFlatVector<int64_t>({4, 5}),
+      makeFlatVector<std::string>({"another long non-inlined string", "b"}),
+  });
+  // Each serialization produces a separate row group in the stream.
+  std::ostringstream out;
+  serialize(first, &out);
+  serialize(second, &out);
+
+  const auto expected = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3, 4, 5}),
+      makeNullableFlatVector<std::string>(
+          {"a",
+           std::nullopt,
+           "a long string which is not inlined",
+           "another long non-inlined string",
+           "b"}),
+  });
+  // Splits the input into small pages so that the rows and the row group
+  // headers span the page boundaries.
+  for (const size_t pageSize : {1, 7, 32, 1 << 20}) {
+    SCOPED_TRACE(fmt::format("pageSize: {}", pageSize));
+    const auto deserialized =
+        deserialize(asRowType(expected->type()), out.str(), pageSize);
+    test::assertEqualVectors(expected, deserialized);
+    // Only the column with nulls has a nulls buffer.
+    ASSERT_EQ(deserialized->childAt(0)->rawNulls(), nullptr);
+    ASSERT_NE(deserialized->childAt(1)->rawNulls(), nullptr);
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     CompactRowSerializerTest,
     CompactRowSerializerTest,
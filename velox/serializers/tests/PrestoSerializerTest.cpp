@@ -25,6 +25,8 @@
 #include "velox/functions/prestosql/types/IPPrefixType.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/serializers/PrestoBatchVectorSerializer.h"
+#include "velox/serializers/PrestoHeader.h"
+#include "velox/serializers/PrestoSerializerDeserializationUtils.h"
 #include "velox/serializers/PrestoVectorLexer.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
@@ -1123,6 +1125,82 @@ TEST_P(PrestoSerializerTest, multiPage) {
   }
 }
 
+TEST_P(PrestoSerializerTest, zeroCopyDeserialize) {
+  const vector_size_t size = 1'000;
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 3; }),
+      makeFlatVector<std::string>(
+          size,
+          [](auto row) {
+            return std::string(20 + row % 7, 'a' + row % 26);
+          }),
+      makeFlatVector<int32_t>(
+          size, [](auto row) { return row; }, nullEvery(5)),
+  });
+  std::ostringstream out;
+  serialize(input, &out, nullptr);
+  const auto serialized = out.str();
+  const auto rowType = asRowType(input->type());
+  // The serializer falls back to uncompressed pages if the compression ratio
+  // is not good enough.
+  std::string_view headerView(serialized);
+  const bool compressed = serializer::presto::detail::isCompressedBitSet(
+      serializer::presto::detail::PrestoHeader::read(&headerView)
+          ->pageCodecMarker);
+
+  auto paramOptions = getParamSerdeOptions(nullptr);
+  paramOptions.zeroCopyDeserialize = true;
+  int32_t numWrappedValues{0};
+  // Shift the page in memory to cover both aligned and unaligned values.
+  for (auto shift = 0; shift < sizeof(int64_t); ++shift) {
+    SCOPED_TRACE(fmt::format("shift: {}", shift));
+    auto iobuf = folly::IOBuf::create(serialized.size() + shift);
+    iobuf->advance(shift);
+    std::memcpy(iobuf->writableData(), serialized.data(), serialized.size());
+    iobuf->append(serialized.size());
+    std::shared_ptr<folly::IOBuf> owner(std::move(iobuf));
+    ByteRange range{owner->writableData(), (int32_t)owner->length(), 0};
+    auto byteStream = std::make_unique<BufferInputStream>(
+        std::vector<ByteRange>{range}, owner);
+
+    RowVectorPtr result;
+    serde_->deserialize(
+        byteStream.get(), pool_.get(), rowType, &result, 0, &paramOptions);
+    // The result keeps the page memory alive.
+    byteStream.reset();
+    owner.reset();
+    assertEqualVectors(input, result);
+    result->validate({});
+
+    auto* bigints = result->childAt(0)->asFlatVector<int64_t>();
+    if (bigints->values()->isView()) {
+      ASSERT_FALSE(compressed);
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(bigints->rawValues()) % 8, 0);
+      ++numWrappedValues;
+    }
+    const auto& stringBuffers =
+        result->childAt(1)->asFlatVector<StringView>()->stringBuffers();
+    ASSERT_EQ(stringBuffers.size(), 1);
+    ASSERT_EQ(stringBuffers[0]->isView(), !compressed);
+    // Values with nulls are not serialized densely and are always copied.
+    ASSERT_FALSE(
+        result->childAt(2)->asFlatVector<int32_t>()->values()->isView());
+  }
+  ASSERT_EQ(numWrappedValues, compressed ? 0 : 1);
+
+  // A stream without a buffer owner is always copied.
+  auto byteStream = toByteStream(serialized);
+  RowVectorPtr result;
+  serde_->deserialize(
+      byteStream.get(), pool_.get(), rowType, &result, 0, &paramOptions);
+  assertEqualVectors(input, result);
+  ASSERT_FALSE(result->childAt(0)->asFlatVector<int64_t>()->values()->isView());
+  ASSERT_FALSE(result->childAt(1)
+                   ->asFlatVector<StringView>()
+                   ->stringBuffers()[0]
+                   ->isView());
+}
+
 TEST_P(PrestoSerializerTest, timestampWithNanosecondPrecision) {
   // Verify that nanosecond precision is preserved when the right options are
   // passed to the serde.
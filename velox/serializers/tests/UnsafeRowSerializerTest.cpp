@@ -509,6 +509,47 @@ TEST_P(UnsafeRowSerializerTest, multiPage) {
   test::assertEqualVectors(deserialized, expected);
 }
 
+TEST_P(UnsafeRowSerializerTest, rowGroups) {
+  const auto first = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3}),
+      makeNullableFlatVector<std::string>(
+          {"a", std::nullopt, "a long string which is not inlined"}),
+  });
+  const auto second = makeRowVector({
+      makeFlatVector<int64_t>({4, 5}),
+      makeFlatVector<std::string>({"another long non-inlined string", "b"}),
+  });
+  // Each serialization produces a separate row group in the stream.
+  std::ostringstream out;
+  serialize(first, &out);
+  serialize(second, &out);
+  const auto serialized = out.str();
+
+  const auto expected = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 3, 4, 5}),
+      makeNullableFlatVector<std::string>(
+          {"a",
+           std::nullopt,
+           "a long string which is not inlined",
+           "another long non-inlined string",
+           "b"}),
+  });
+  // Splits the input into small pages so that the rows and the row group
+  // headers span the page boundaries.
+  for (const size_t pageSize : {1, 7, 32, 1 << 20}) {
+    SCOPED_TRACE(fmt::format("pageSize: {}", pageSize));
+    std::vector<std::string_view> pages;
+    for (size_t offset = 0; offset < serialized.size(); offset += pageSize) {
+      pages.push_back(std::string_view(serialized).substr(offset, pageSize));
+    }
+    const auto deserialized = deserialize(asRowType(expected->type()), pages);
+    test::assertEqualVectors(expected, deserialized);
+    // Only the column with nulls has a nulls buffer.
+    ASSERT_EQ(deserialized->childAt(0)->rawNulls(), nullptr);
+    ASSERT_NE(deserialized->childAt(1)->rawNulls(), nullptr);
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     UnsafeRowSerializerTest,
     UnsafeRowSerializerTest,
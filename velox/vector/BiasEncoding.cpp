@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/vector/BiasEncoding.h"
+
+#include "velox/vector/BiasVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox {
+namespace {
+
+template <typename T, typename U>
+BufferPtr makeBiasedValues(
+    const T* values,
+    vector_size_t size,
+    T bias,
+    memory::MemoryPool* pool) {
+  auto buffer = AlignedBuffer::allocate<U>(size, pool);
+  auto* rawBuffer = buffer->template asMutable<U>();
+  // The values of the null rows wrap around, which is fine as they are never
+  // read.
+  for (vector_size_t row = 0; row < size; ++row) {
+    rawBuffer[row] = static_cast<U>(
+        static_cast<uint64_t>(values[row]) - static_cast<uint64_t>(bias));
+  }
+  return buffer;
+}
+
+template <typename T>
+VectorPtr biasEncodeFlat(const VectorPtr& vector, memory::MemoryPool* pool) {
+  static const auto kType = CppToType<T>::create();
+  if (*vector->type() != *kType) {
+    return vector;
+  }
+  const auto* flat = vector->asUnchecked<FlatVector<T>>();
+  const auto* values = flat->rawValues();
+  const auto size = vector->size();
+  // The values buffer may be shorter than the vector due to trailing nulls.
+  if (values == nullptr || size == 0 ||
+      flat->values()->size() < size * sizeof(T)) {
+    return vector;
+  }
+
+  T minValue = std::numeric_limits<T>::max();
+  T maxValue = std::numeric_limits<T>::min();
+  bool hasValues{false};
+  auto addValue = [&](vector_size_t row) {
+    minValue = std::min(minValue, values[row]);
+    maxValue = std::max(maxValue, values[row]);
+    hasValues = true;
+  };
+  if (const auto* nulls = flat->rawNulls()) {
+    bits::forEachSetBit(nulls, 0, size, addValue);
+  } else {
+    for (vector_size_t row = 0; row < size; ++row) {
+      addValue(row);
+    }
+  }
+  if (!hasValues) {
+    return vector;
+  }
+
+  // See BiasVector.h for the choice of the bias.
+  const uint64_t delta =
+      static_cast<uint64_t>(maxValue) - static_cast<uint64_t>(minValue);
+  const T bias = minValue + static_cast<T>((delta + 1) / 2);
+  BufferPtr biasedValues;
+  TypeKind valueKind;
+  if (sizeof(T) > sizeof(int8_t) &&
+      delta <= std::numeric_limits<uint8_t>::max()) {
+    biasedValues = makeBiasedValues<T, int8_t>(values, size, bias, pool);
+    valueKind = TypeKind::TINYINT;
+  } else if (
+      sizeof(T) > sizeof(int16_t) &&
+      delta <= std::numeric_limits<uint16_t>::max()) {
+    biasedValues = makeBiasedValues<T, int16_t>(values, size, bias, pool);
+    valueKind = TypeKind::SMALLINT;
+  } else if (
+      sizeof(T) > sizeof(int32_t) &&
+      delta <= std::numeric_limits<uint32_t>::max()) {
+    biasedValues = makeBiasedValues<T, int32_t>(values, size, bias, pool);
+    valueKind = TypeKind::INTEGER;
+  } else {
+    return vector;
+  }
+  return std::make_shared<BiasVector<T>>(
+      pool, vector->nulls(), size, valueKind, std::move(biasedValues), bias);
+}
+
+template <typename T>
+VectorPtr biasDecodeTyped(const VectorPtr& vector, memory::MemoryPool* pool) {
+  const auto size = vector->size();
+  DecodedVector decoded(*vector);
+  auto result = BaseVector::create<FlatVector<T>>(vector->type(), size, pool);
+  auto* rawValues = result->mutableRawValues();
+  for (vector_size_t row = 0; row < size; ++row) {
+    if (decoded.isNullAt(row)) {
+      result->setNull(row, true);
+    } else {
+      rawValues[row] = decoded.valueAt<T>(row);
+    }
+  }
+  return result;
+}
+} // namespace
+
+VectorPtr biasEncode(const VectorPtr& vector, memory::MemoryPool* pool) {
+  if (vector == nullptr) {
+    return vector;
+  }
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      switch (vector->typeKind()) {
+        case TypeKind::BIGINT:
+          return biasEncodeFlat<int64_t>(vector, pool);
+        case TypeKind::INTEGER:
+          return biasEncodeFlat<int32_t>(vector, pool);
+        case TypeKind::SMALLINT:
+          return biasEncodeFlat<int16_t>(vector, pool);
+        default:
+          return vector;
+      }
+    case VectorEncoding::Simple::ROW: {
+      auto encoded = vector->asUnchecked<RowVector>()->transformChildren(
+          [&](const VectorPtr& child) { return biasEncode(child, pool); });
+      return encoded != nullptr ? encoded : vector;
+    }
+    default:
+      return vector;
+  }
+}
+
+RowVectorPtr biasEncode(const RowVectorPtr& input, memory::MemoryPool* pool) {
+  auto result = biasEncode(std::static_pointer_cast<BaseVector>(input), pool);
+  if (result == input) {
+    return input;
+  }
+  return std::static_pointer_cast<RowVector>(result);
+}
+
+VectorPtr biasDecode(const VectorPtr& vector, memory::MemoryPool* pool) {
+  if (vector == nullptr ||
+      (vector->isLazy() && !vector->asUnchecked<LazyVector>()->isLoaded())) {
+    return vector;
+  }
+  if (vector->encoding() == VectorEncoding::Simple::ROW) {
+    auto decoded = vector->asUnchecked<RowVector>()->transformChildren(
+        [&](const VectorPtr& child) { return biasDecode(child, pool); });
+    return decoded != nullptr ? decoded : vector;
+  }
+  if (vector->wrappedVector()->encoding() != VectorEncoding::Simple::BIASED) {
+    return vector;
+  }
+  switch (vector->typeKind()) {
+    case TypeKind::BIGINT:
+      return biasDecodeTyped<int64_t>(vector, pool);
+    case TypeKind::INTEGER:
+      return biasDecodeTyped<int32_t>(vector, pool);
+    case TypeKind::SMALLINT:
+      return biasDecodeTyped<int16_t>(vector, pool);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+RowVectorPtr biasDecode(const RowVectorPtr& input, memory::MemoryPool* pool) {
+  auto result = biasDecode(std::static_pointer_cast<BaseVector>(input), pool);
+  if (result == input) {
+    return input;
+  }
+  return std::static_pointer_cast<RowVector>(result);
+}
+} // namespace facebook::velox
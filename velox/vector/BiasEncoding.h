@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox {
+
+/// Returns a BiasVector which stores the values of the flat BIGINT, INTEGER or
+/// SMALLINT 'vector' as narrower deltas from a common bias if the range of its
+/// non-null values allows it, e.g. a BIGINT column with values in [1000, 1200]
+/// is stored in one byte per value. Returns 'vector' itself otherwise, which
+/// includes the vectors of other encodings, types and logical types, e.g.
+/// DATE.
+///
+/// Most of the engine, e.g. the serializers and the expression evaluation,
+/// does not handle BiasVector. A bias encoded vector must be passed through
+/// biasDecode() before it leaves the code which encoded it. LocalPartition
+/// encodes the vectors it enqueues and LocalExchange decodes them on dequeue.
+VectorPtr biasEncode(const VectorPtr& vector, memory::MemoryPool* pool);
+
+/// Same as above for the columns of 'input'.
+RowVectorPtr biasEncode(const RowVectorPtr& input, memory::MemoryPool* pool);
+
+/// Returns a flat copy of 'vector' if its base is a BiasVector, e.g. a
+/// dictionary over the result of biasEncode(). Only the rows of 'vector' are
+/// decoded. Returns 'vector' itself otherwise.
+VectorPtr biasDecode(const VectorPtr& vector, memory::MemoryPool* pool);
+
+/// Same as above for the columns of 'input'.
+RowVectorPtr biasDecode(const RowVectorPtr& input, memory::MemoryPool* pool);
+
+} // namespace facebook::velox
@@ -69,7 +69,32 @@ BiasVector<T>::BiasVector(
 }
 
 template <typename T>
+VectorPtr BiasVector<T>::slice(vector_size_t offset, vector_size_t length)
+    const {
+  BufferPtr values;
+  switch (valueType_) {
+    case TypeKind::TINYINT:
+      values = Buffer::slice<int8_t>(values_, offset, length, this->pool_);
+      break;
+    case TypeKind::SMALLINT:
+      values = Buffer::slice<int16_t>(values_, offset, length, this->pool_);
+      break;
+    case TypeKind::INTEGER:
+      values = Buffer::slice<int32_t>(values_, offset, length, this->pool_);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  return std::make_shared<BiasVector<T>>(
+      this->pool_,
+      this->sliceNulls(offset, length),
+      length,
+      valueType_,
+      std::move(values),
+      bias_);
+}
 
+template <typename T>
 std::unique_ptr<SimpleVector<uint64_t>> BiasVector<T>::hashAll() const {
   // TODO T70734527 dealing with zero length vector
   if (BaseVector::length_ == 0) {
@@ -159,9 +159,7 @@ class BiasVector : public SimpleVector<T> {
     return true;
   }
 
-  VectorPtr slice(vector_size_t, vector_size_t) const override {
-    VELOX_NYI();
-  }
+  VectorPtr slice(vector_size_t offset, vector_size_t length) const override;
 
   VectorPtr copyPreserveEncodings(
       velox::memory::MemoryPool* pool = nullptr) const override {
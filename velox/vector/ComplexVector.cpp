@@ -307,6 +307,41 @@ bool isAllNullVector(const BaseVector& vector) {
   }
   return false;
 }
+
+// Returns 'ranges' with the ranges which continue the previous one in both
+// source and target merged. Returns 'ranges' itself if there is nothing to
+// merge, otherwise the merged ranges are stored in 'merged'.
+folly::Range<const BaseVector::CopyRange*> coalesceRanges(
+    const folly::Range<const BaseVector::CopyRange*>& ranges,
+    std::vector<BaseVector::CopyRange>& merged) {
+  auto continues = [](const BaseVector::CopyRange& previous,
+                      const BaseVector::CopyRange& range) {
+    return previous.sourceIndex + previous.count == range.sourceIndex &&
+        previous.targetIndex + previous.count == range.targetIndex;
+  };
+  bool hasAdjacent = false;
+  for (auto i = 1; i < ranges.size(); ++i) {
+    if (continues(ranges[i - 1], ranges[i])) {
+      hasAdjacent = true;
+      break;
+    }
+  }
+  if (!hasAdjacent) {
+    return ranges;
+  }
+  merged.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    if (range.count == 0) {
+      continue;
+    }
+    if (!merged.empty() && continues(merged.back(), range)) {
+      merged.back().count += range.count;
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
 } // namespace
 
 void RowVector::copyRanges(
@@ -342,9 +377,14 @@ void RowVector::copyRanges(
     if (rawNulls_) {
       setNulls(mutableRawNulls(), ranges, false);
     }
+    // Many small ranges, e.g. one per row, are merged once here instead of
+    // being walked by every child.
+    std::vector<CopyRange> mergedRanges;
+    const auto childRanges = coalesceRanges(ranges, mergedRanges);
     auto* rowSource = source->loadedVector()->as<RowVector>();
     for (int i = 0; i < children_.size(); ++i) {
-      children_[i]->copyRanges(rowSource->childAt(i)->loadedVector(), ranges);
+      children_[i]->copyRanges(
+          rowSource->childAt(i)->loadedVector(), childRanges);
     }
   } else {
     std::vector<BaseVector::CopyRange> baseRanges;
@@ -577,45 +617,82 @@ void ArrayVectorBase::copyRangesImpl(
       }
     }
   } else {
-    std::vector<CopyRange> outRanges;
     vector_size_t totalCount = 0;
+    vector_size_t sourceBegin = std::numeric_limits<vector_size_t>::max();
+    vector_size_t sourceEnd = 0;
     applyToEachRange(
         ranges, [&](auto targetIndex, auto sourceIndex, auto count) {
           if (count > 0) {
             VELOX_DCHECK_GE(BaseVector::length_, targetIndex + count);
             totalCount += count;
+            sourceBegin = std::min(sourceBegin, sourceIndex);
+            sourceEnd = std::max(sourceEnd, sourceIndex + count);
           }
         });
-    outRanges.reserve(totalCount);
-    applyToEachRow(ranges, [&](auto targetIndex, auto sourceIndex) {
-      if (source->isNullAt(sourceIndex)) {
-        setNull(targetIndex, true);
-      } else {
-        if (setNotNulls) {
-          setNull(targetIndex, false);
-        }
-        auto wrappedIndex = source->wrappedIndex(sourceIndex);
-        auto copySize = sourceArray->sizeAt(wrappedIndex);
-
-        if (copySize > 0) {
-          auto copyOffset = sourceArray->offsetAt(wrappedIndex);
-
-          // If we're copying two adjacent ranges, merge them.  This only
-          // works if they're consecutive.
-          if (!outRanges.empty() &&
-              (outRanges.back().sourceIndex + outRanges.back().count ==
-               copyOffset)) {
-            outRanges.back().count += copySize;
-          } else {
-            outRanges.push_back({copyOffset, childSize, copySize});
-          }
-        }
+    if (totalCount == 0) {
+      return;
+    }
 
-        mutableOffsets[targetIndex] = childSize;
-        mutableSizes[targetIndex] = copySize;
-        childSize = checkedPlus<vector_size_t>(childSize, copySize);
+    // Decodes the source once so that the rows are read without virtual
+    // calls. The offsets and sizes of all the ranges are computed before
+    // the children are copied in a single copyRanges() call with the
+    // adjacent child ranges merged. Only the source rows between the first
+    // and the last range are decoded, so that repeated small copies from a
+    // large source do not decode all of it each time.
+    SelectivityVector sourceRows(sourceEnd, false);
+    sourceRows.setValidRange(sourceBegin, sourceEnd, true);
+    sourceRows.updateBounds();
+    DecodedVector decoded(*source, sourceRows);
+    const auto* sourceNulls = decoded.nulls(&sourceRows);
+    const auto* sourceOffsets = sourceArray->rawOffsets();
+    const auto* sourceSizes = sourceArray->rawSizes();
+    uint64_t* rawNulls = nullptr;
+    if (setNotNulls || sourceNulls != nullptr) {
+      rawNulls = mutableRawNulls();
+      if (decoded.isIdentityMapping()) {
+        if (sourceNulls != nullptr) {
+          BaseVector::copyNulls(rawNulls, sourceNulls, ranges);
+        } else {
+          BaseVector::setNulls(rawNulls, ranges, false);
+        }
+        rawNulls = nullptr;
       }
-    });
+    }
+
+    std::vector<CopyRange> outRanges;
+    outRanges.reserve(totalCount);
+    applyToEachRange(
+        ranges, [&](auto targetIndex, auto sourceIndex, auto count) {
+          for (auto i = 0; i < count; ++i) {
+            const auto targetRow = targetIndex + i;
+            const auto sourceRow = sourceIndex + i;
+            const bool isNull = sourceNulls != nullptr &&
+                bits::isBitNull(sourceNulls, sourceRow);
+            if (rawNulls != nullptr) {
+              bits::setNull(rawNulls, targetRow, isNull);
+            }
+            if (isNull) {
+              continue;
+            }
+            const auto wrappedIndex = decoded.index(sourceRow);
+            const auto copySize = sourceSizes[wrappedIndex];
+            if (copySize > 0) {
+              const auto copyOffset = sourceOffsets[wrappedIndex];
+              // If we're copying two adjacent ranges, merge them.  This only
+              // works if they're consecutive.
+              if (!outRanges.empty() &&
+                  (outRanges.back().sourceIndex + outRanges.back().count ==
+                   copyOffset)) {
+                outRanges.back().count += copySize;
+              } else {
+                outRanges.push_back({copyOffset, childSize, copySize});
+              }
+            }
+            mutableOffsets[targetRow] = childSize;
+            mutableSizes[targetRow] = copySize;
+            childSize = checkedPlus<vector_size_t>(childSize, copySize);
+          }
+        });
 
     targetValues->get()->resize(childSize);
     targetValues->get()->copyRanges(sourceValues, outRanges);
@@ -840,6 +917,25 @@ VectorPtr RowVector::pushDictionaryToRowVectorLeaves(const VectorPtr& input) {
       wrappers, input->size(), input, input->pool());
 }
 
+std::shared_ptr<RowVector> RowVector::transformChildren(
+    const std::function<VectorPtr(const VectorPtr&)>& transform) const {
+  std::vector<VectorPtr> children;
+  for (auto i = 0; i < children_.size(); ++i) {
+    auto transformed = transform(children_[i]);
+    if (transformed != children_[i]) {
+      if (children.empty()) {
+        children = children_;
+      }
+      children[i] = std::move(transformed);
+    }
+  }
+  if (children.empty()) {
+    return nullptr;
+  }
+  return std::make_shared<RowVector>(
+      pool(), type(), nulls(), size(), std::move(children));
+}
+
 namespace {
 
 // Returns the next non-null non-empty array/map on or after `index'.
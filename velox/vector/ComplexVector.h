@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <type_traits>
 
 #include <folly/container/F14Map.h>
@@ -255,6 +256,13 @@ class RowVector : public BaseVector {
   /// SlidingWindowMap.
   static VectorPtr pushDictionaryToRowVectorLeaves(const VectorPtr& input);
 
+  /// Returns a new RowVector with the type, nulls and size of 'this' whose
+  /// children are the results of 'transform' over the children of 'this'.
+  /// Returns nullptr if 'transform' returns every child as is, so that the
+  /// caller can keep using 'this'.
+  std::shared_ptr<RowVector> transformChildren(
+      const std::function<VectorPtr(const VectorPtr&)>& transform) const;
+
   VectorPtr& rawVectorForBatchReader() {
     return rawVectorForBatchReader_;
   }
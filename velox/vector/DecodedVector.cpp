@@ -14,9 +14,15 @@
  * limitations under the License.
  */
 #include "velox/vector/DecodedVector.h"
+
+#include <algorithm>
+#include <numeric>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/BiasVector.h"
 #include "velox/vector/LazyVector.h"
 
 namespace facebook::velox {
@@ -203,6 +209,9 @@ void DecodedVector::combineWrappers(
       hasExtraNulls_ = true;
       mayHaveNulls_ = true;
     }
+  } else if (topEncoding == VectorEncoding::Simple::SEQUENCE) {
+    setSequenceIndices(*vector);
+    values = getValueVector(vector);
   } else {
     VELOX_FAIL(
         "Unsupported wrapper encoding: {}",
@@ -241,6 +250,10 @@ void DecodedVector::combineWrappers(
         applyDictionaryWrapper(*values, rows);
         values = getValueVector(values);
         break;
+      case VectorEncoding::Simple::SEQUENCE:
+        applySequenceWrapper(*values, rows);
+        values = getValueVector(values);
+        break;
       default:
         VELOX_CHECK(false, "Unsupported vector encoding");
     }
@@ -286,6 +299,125 @@ void DecodedVector::applyDictionaryWrapper(
   });
 }
 
+void DecodedVector::setSequenceIndices(const BaseVector& sequenceVector) {
+  const auto* lengths = sequenceVector.wrapInfo()->as<vector_size_t>();
+  const auto numRuns = sequenceVector.valueVector()->size();
+  copiedIndices_.resize(size_ > 0 ? size_ : 1);
+  vector_size_t row = 0;
+  for (vector_size_t run = 0; run < numRuns && row < size_; ++run) {
+    const auto runEnd = std::min(row + lengths[run], size_);
+    std::fill(
+        copiedIndices_.begin() + row, copiedIndices_.begin() + runEnd, run);
+    row = runEnd;
+  }
+  indices_ = copiedIndices_.data();
+}
+
+void DecodedVector::applySequenceWrapper(
+    const BaseVector& sequenceVector,
+    const SelectivityVector* rows) {
+  if (size_ == 0 || (rows && !rows->hasSelections())) {
+    // No further processing is needed.
+    return;
+  }
+
+  const auto* lengths = sequenceVector.wrapInfo()->as<vector_size_t>();
+  const auto numRuns = sequenceVector.valueVector()->size();
+  auto currentIndices = indices_;
+  if (indicesNotCopied()) {
+    copiedIndices_.resize(size_);
+    indices_ = copiedIndices_.data();
+  }
+
+  // The wrapped indices are mostly ascending, e.g. the rows passing a filter
+  // over the sequence, and are mapped to their runs by walking the runs
+  // forward. An index before the current run is mapped by a binary search over
+  // the run ends, which are only computed if this happens.
+  vector_size_t run = 0;
+  vector_size_t runStart = 0;
+  vector_size_t runEnd = numRuns > 0 ? lengths[0] : 0;
+  bool hasRunEnds = false;
+  applyToRows(rows, [&](vector_size_t row) {
+    if (nulls_ && bits::isBitNull(nulls_, row)) {
+      return;
+    }
+    const auto index = currentIndices[row];
+    if (index < runStart) {
+      if (!hasRunEnds) {
+        sequenceRunEnds_.resize(numRuns);
+        std::partial_sum(lengths, lengths + numRuns, sequenceRunEnds_.begin());
+        hasRunEnds = true;
+      }
+      const auto it = std::upper_bound(
+          sequenceRunEnds_.begin(), sequenceRunEnds_.end(), index);
+      run = it - sequenceRunEnds_.begin();
+      runEnd = sequenceRunEnds_[run];
+      runStart = runEnd - lengths[run];
+    } else {
+      while (index >= runEnd) {
+        VELOX_DCHECK_LT(run + 1, numRuns);
+        runStart = runEnd;
+        runEnd += lengths[++run];
+      }
+    }
+    copiedIndices_[row] = run;
+  });
+}
+
+template <typename T, typename U>
+void DecodedVector::debias(
+    const BufferPtr& values,
+    T bias,
+    const SelectivityVector* rows,
+    T* result) {
+  const auto* biased = values->as<U>();
+  if (isIdentityMapping_) {
+    applyToRows(rows, [&](vector_size_t row) {
+      result[row] = static_cast<T>(bias + biased[row]);
+    });
+  } else {
+    // The indices of the rows which the wrappers set to null may be invalid.
+    const auto* wrapperNulls = hasExtraNulls_ ? nulls_ : nullptr;
+    applyToRows(rows, [&](vector_size_t row) {
+      if (wrapperNulls != nullptr && bits::isBitNull(wrapperNulls, row)) {
+        return;
+      }
+      const auto index = indices_[row];
+      result[index] = static_cast<T>(bias + biased[index]);
+    });
+  }
+}
+
+template <typename T>
+void DecodedVector::setBiasedData(
+    const BaseVector& vector,
+    const SelectivityVector* rows) {
+  const auto* biasVector = vector.asUnchecked<BiasVector<T>>();
+  // The scratch array is indexed like the base vector, but only the values
+  // the selected rows refer to are decoded.
+  const auto numWords =
+      bits::divRoundUp(vector.size() * sizeof(T), sizeof(uint64_t));
+  if (debiasedValues_.size() < numWords) {
+    debiasedValues_.resize(numWords);
+  }
+  auto* values = reinterpret_cast<T*>(debiasedValues_.data());
+  const auto bias = biasVector->bias();
+  switch (biasVector->valueType()) {
+    case TypeKind::TINYINT:
+      debias<T, int8_t>(biasVector->values(), bias, rows, values);
+      break;
+    case TypeKind::SMALLINT:
+      debias<T, int16_t>(biasVector->values(), bias, rows, values);
+      break;
+    case TypeKind::INTEGER:
+      debias<T, int32_t>(biasVector->values(), bias, rows, values);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  data_ = values;
+}
+
 void DecodedVector::fillInIndices() const {
   if (isConstantMapping_) {
     if (size_ > zeroIndices().size() || constantIndex_ != 0) {
@@ -365,6 +497,24 @@ void DecodedVector::setBaseData(
           vector->values() ? vector->values()->template as<void>() : nullptr;
       setFlatNulls(*vector, rows);
       break;
+    case VectorEncoding::Simple::BIASED:
+      switch (vector->typeKind()) {
+        case TypeKind::SMALLINT:
+          setBiasedData<int16_t>(*vector, rows);
+          break;
+        case TypeKind::INTEGER:
+          setBiasedData<int32_t>(*vector, rows);
+          break;
+        case TypeKind::BIGINT:
+          setBiasedData<int64_t>(*vector, rows);
+          break;
+        default:
+          VELOX_UNSUPPORTED(
+              "Unsupported type for bias encoding: {}",
+              vector->type()->toString());
+      }
+      setFlatNulls(*vector, rows);
+      break;
     case VectorEncoding::Simple::ROW:
     case VectorEncoding::Simple::ARRAY:
     case VectorEncoding::Simple::MAP:
@@ -512,11 +662,22 @@ const uint64_t* DecodedVector::nulls(const SelectivityVector* rows) {
         // end but not greater.
         VELOX_CHECK_LE(rows->end(), size_);
       }
-      VELOX_DEBUG_ONLY const auto baseSize = baseVector_->size();
-      applyToRows(rows, [&](auto i) {
-        VELOX_DCHECK_LT(indices_[i], baseSize);
-        bits::setNull(rawCopiedNulls, i, bits::isBitNull(nulls_, indices_[i]));
-      });
+      if (rows == nullptr || rows->isAllSelected()) {
+        // There are no wrapper nulls, so all the indices are defined. Gathers
+        // the null bits a batch of rows at a time.
+        simd::gatherBits(
+            nulls_,
+            folly::Range<const int32_t*>(
+                indices_, rows == nullptr ? size_ : rows->end()),
+            rawCopiedNulls);
+      } else {
+        VELOX_DEBUG_ONLY const auto baseSize = baseVector_->size();
+        applyToRows(rows, [&](auto i) {
+          VELOX_DCHECK_LT(indices_[i], baseSize);
+          bits::setNull(
+              rawCopiedNulls, i, bits::isBitNull(nulls_, indices_[i]));
+        });
+      }
       allNulls_ = copiedNulls_.data();
     }
   }
@@ -524,6 +685,62 @@ const uint64_t* DecodedVector::nulls(const SelectivityVector* rows) {
   return allNulls_.value();
 }
 
+template <typename TWord>
+void DecodedVector::gatherWords(
+    const SelectivityVector& rows,
+    const TWord* values,
+    TWord* result) {
+  constexpr int32_t kBatch = xsimd::batch<TWord>::size;
+  static_assert(64 % kBatch == 0);
+  constexpr uint64_t kAllLanes = bits::lowMask(kBatch);
+  // The null rows are masked out as their indices may be undefined.
+  const auto* rawNulls = nulls(partialRowsDecoded_ ? &rows : nullptr);
+  const auto* selected = rows.allBits();
+  const auto end = rows.end();
+  for (auto wordIndex = rows.begin() / 64; wordIndex * 64 < end; ++wordIndex) {
+    const vector_size_t wordBegin = wordIndex * 64;
+    auto word = selected[wordIndex];
+    if (rawNulls != nullptr) {
+      word &= rawNulls[wordIndex];
+    }
+    if (wordBegin + 64 > end) {
+      word &= bits::lowMask(end - wordBegin);
+    }
+    for (int32_t lane = 0; lane < 64 && (word >> lane) != 0;
+         lane += kBatch) {
+      const uint64_t mask = (word >> lane) & kAllLanes;
+      if (mask == 0) {
+        continue;
+      }
+      const auto row = wordBegin + lane;
+      if (row + kBatch > end) {
+        // A full batch would write past 'end'.
+        bits::forEachSetBit(&mask, 0, kBatch, [&](vector_size_t i) {
+          result[row + i] = values[indices_[row + i]];
+        });
+      } else if (mask == kAllLanes) {
+        simd::gather(values, indices_ + row).store_unaligned(result + row);
+      } else {
+        simd::maskGather(
+            xsimd::broadcast<TWord>(0),
+            simd::fromBitMask<TWord>(mask),
+            values,
+            indices_ + row)
+            .store_unaligned(result + row);
+      }
+    }
+  }
+}
+
+template void DecodedVector::gatherWords<int32_t>(
+    const SelectivityVector& rows,
+    const int32_t* values,
+    int32_t* result);
+template void DecodedVector::gatherWords<int64_t>(
+    const SelectivityVector& rows,
+    const int64_t* values,
+    int64_t* result);
+
 template <typename Func>
 void DecodedVector::applyToRows(const SelectivityVector* rows, Func&& func)
     const {
@@ -27,7 +27,9 @@ namespace facebook::velox {
 /// Takes a flat, constant or dictionary vector with possibly many layers of
 /// dictionary wrappings and converts it into a flat or constant base vector +
 /// at most one wrapping. Combines multiple layers of indices and nulls into
-/// one.
+/// one. A run-length encoded (sequence) layer is decoded like a dictionary
+/// whose indices are the run numbers, so that the base holds one value per
+/// run.
 ///
 /// Decoding a vector is straightforward if it is flat. However, if it is not,
 /// the following steps are taken:
@@ -178,6 +180,20 @@ class DecodedVector {
     return reinterpret_cast<const T*>(data_)[index(idx)];
   }
 
+  /// True if gatherValues() reads the values of type T with SIMD gathers.
+  template <typename T>
+  static constexpr bool kSimdGather = std::is_arithmetic_v<T> &&
+      !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8);
+
+  /// Writes the values of the selected rows to 'result' so that result[row] ==
+  /// valueAt<T>(row). If the mapping is neither identity nor constant and
+  /// kSimdGather<T> is true, reads the values through the indices with SIMD
+  /// gathers a batch of rows at a time instead of one index at a time.
+  /// 'result' must have room for rows.end() values. The values of the rows
+  /// which are not selected or null are undefined.
+  template <typename T>
+  void gatherValues(const SelectivityVector& rows, T* result);
+
   /// If false, there are no nulls. Otherwise, there is a possibility that there
   /// are some nulls, but no certainty.
   bool mayHaveNulls() const {
@@ -348,6 +364,39 @@ class DecodedVector {
       const BaseVector& dictionaryVector,
       const SelectivityVector* rows);
 
+  // Implements gatherValues() for a non-identity, non-constant mapping over
+  // 4 or 8 byte values. Defined in the .cpp for int32_t and int64_t.
+  template <typename TWord>
+  void gatherWords(
+      const SelectivityVector& rows,
+      const TWord* values,
+      TWord* result);
+
+  // Sets 'data_' to the values of the BiasVector 'vector' with the bias added
+  // back. Only the values of the base rows referred to by 'rows' are decoded,
+  // the others are left undefined.
+  template <typename T>
+  void setBiasedData(const BaseVector& vector, const SelectivityVector* rows);
+
+  // Writes 'bias' plus the 'values' of type U at the base rows referred to by
+  // 'rows' into the same positions of 'result'.
+  template <typename T, typename U>
+  void debias(
+      const BufferPtr& values,
+      T bias,
+      const SelectivityVector* rows,
+      T* result);
+
+  // Sets 'indices_' to the run numbers of the rows of a top-level run-length
+  // encoded 'sequenceVector'. The runs are then decoded like the indices of a
+  // dictionary over the run values.
+  void setSequenceIndices(const BaseVector& sequenceVector);
+
+  // Maps the current indices into 'sequenceVector' to the run numbers.
+  void applySequenceWrapper(
+      const BaseVector& sequenceVector,
+      const SelectivityVector* rows);
+
   void copyNulls(vector_size_t size);
 
   void fillInIndices() const;
@@ -440,10 +489,39 @@ class DecodedVector {
   // dictionary and base values.
   std::vector<uint64_t> copiedNulls_;
 
+  // The row numbers at which the runs of a nested sequence wrapper end. Used
+  // to map the wrapped indices that are not ascending to their runs.
+  std::vector<vector_size_t> sequenceRunEnds_;
+
+  // Used as backing for 'data_' when the base is a BiasVector. Holds the
+  // debiased values of the base rows the decoded rows refer to.
+  std::vector<uint64_t> debiasedValues_;
+
   // Used as 'nulls_' for a null constant vector.
   static uint64_t constantNullMask_;
 };
 
+template <typename T>
+void DecodedVector::gatherValues(const SelectivityVector& rows, T* result) {
+  static_assert(!std::is_same_v<T, bool>, "Use valueAt<bool>() for bool");
+  VELOX_DCHECK_LE(rows.end(), size_);
+  if constexpr (kSimdGather<T>) {
+    if (!isIdentityMapping_ && !isConstantMapping_) {
+      using TWord = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>;
+      gatherWords(
+          rows,
+          reinterpret_cast<const TWord*>(data_),
+          reinterpret_cast<TWord*>(result));
+      return;
+    }
+  }
+  rows.applyToSelected([&](vector_size_t row) {
+    if (!isNullAt(row)) {
+      result[row] = valueAt<T>(row);
+    }
+  });
+}
+
 template <>
 inline bool DecodedVector::valueAt(vector_size_t idx) const {
   return bits::isBitSet(reinterpret_cast<const uint64_t*>(data_), index(idx));
@@ -518,8 +518,8 @@ class FlatVector final : public SimpleVector<T> {
 
   /// Calls BaseVector::prapareForReuse() to check and reset nulls buffer if
   /// needed, checks and resets values buffer. Resets all strings buffers
-  /// except the first one. Keeps the first string buffer if singly-referenced
-  /// and mutable. Resizes the buffer to zero to allow for reuse instead of
+  /// except the largest singly-referenced and mutable one, which is kept if
+  /// not too large. Resizes the buffer to zero to allow for reuse instead of
   /// append.
   void prepareForReuse() override;
 
@@ -561,20 +561,23 @@ class FlatVector final : public SimpleVector<T> {
       const std::optional<T>& initialValue);
 
   // Check string buffers. Keep at most one singly-referenced buffer if it is
-  // not too large.
+  // not too large. Keeps the largest such buffer so that a recycled vector
+  // fits as much of the next batch as possible.
   void keepAtMostOneStringBuffer() {
-    if (stringBuffers_.empty()) {
-      return;
+    BufferPtr reusable;
+    for (const auto& buffer : stringBuffers_) {
+      if (buffer->isMutable() && buffer->capacity() <= kMaxStringSizeForReuse &&
+          (reusable == nullptr ||
+           buffer->capacity() > reusable->capacity())) {
+        reusable = buffer;
+      }
     }
-
-    auto& firstBuffer = stringBuffers_.front();
-    if (firstBuffer->isMutable() &&
-        firstBuffer->capacity() <= kMaxStringSizeForReuse) {
-      firstBuffer->setSize(0);
-      setStringBuffers({firstBuffer});
-    } else {
+    if (reusable == nullptr) {
       clearStringBuffers();
+      return;
     }
+    reusable->setSize(0);
+    setStringBuffers({std::move(reusable)});
   }
 
   // Contiguous values.
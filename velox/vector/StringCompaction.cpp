@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/vector/StringCompaction.h"
+
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox {
+namespace {
+
+bool isStringType(const TypePtr& type) {
+  return type->kind() == TypeKind::VARCHAR ||
+      type->kind() == TypeKind::VARBINARY;
+}
+
+uint64_t heldStringBytes(const BaseVector& base) {
+  uint64_t bytes{0};
+  for (const auto& buffer :
+       base.asUnchecked<FlatVector<StringView>>()->stringBuffers()) {
+    bytes += buffer->capacity();
+  }
+  return bytes;
+}
+
+VectorPtr compactStringVector(
+    const VectorPtr& vector,
+    const StringCompactionOptions& options,
+    memory::MemoryPool* pool,
+    StringCompactionStats* stats) {
+  const auto size = vector->size();
+  if (size == 0 || vector->isConstantEncoding()) {
+    return vector;
+  }
+  DecodedVector decoded(*vector);
+  if (decoded.isConstantMapping() || !decoded.base()->isFlatEncoding()) {
+    return vector;
+  }
+  const auto heldBytes = heldStringBytes(*decoded.base());
+  if (heldBytes < options.minHeldBytes) {
+    return vector;
+  }
+  // Stop counting once the live bytes make the compaction not worthwhile.
+  const auto maxLiveBytes = std::min<uint64_t>(
+      heldBytes, static_cast<uint64_t>(heldBytes * options.minLiveRatio));
+  uint64_t liveBytes{0};
+  for (vector_size_t row = 0; row < size; ++row) {
+    if (decoded.isNullAt(row)) {
+      continue;
+    }
+    const auto value = decoded.valueAt<StringView>(row);
+    if (!value.isInline()) {
+      liveBytes += value.size();
+      if (liveBytes >= maxLiveBytes) {
+        return vector;
+      }
+    }
+  }
+
+  auto result = BaseVector::create<FlatVector<StringView>>(
+      vector->type(), size, pool);
+  if (liveBytes > 0) {
+    result->getBufferWithSpace(liveBytes, true);
+  }
+  for (vector_size_t row = 0; row < size; ++row) {
+    if (decoded.isNullAt(row)) {
+      result->setNull(row, true);
+    } else {
+      result->set(row, decoded.valueAt<StringView>(row));
+    }
+  }
+  if (stats != nullptr) {
+    ++stats->numCompactedVectors;
+    stats->heldBytes += heldBytes;
+    stats->liveBytes += liveBytes;
+  }
+  return result;
+}
+} // namespace
+
+VectorPtr compactStrings(
+    const VectorPtr& vector,
+    const StringCompactionOptions& options,
+    memory::MemoryPool* pool,
+    StringCompactionStats* stats) {
+  if (vector == nullptr || options.minLiveRatio <= 0 ||
+      (vector->isLazy() && !vector->asUnchecked<LazyVector>()->isLoaded())) {
+    return vector;
+  }
+  const auto& loaded = BaseVector::loadedVectorShared(vector);
+  if (isStringType(loaded->type())) {
+    auto compacted = compactStringVector(loaded, options, pool, stats);
+    return compacted == loaded ? vector : compacted;
+  }
+  if (loaded->encoding() != VectorEncoding::Simple::ROW) {
+    return vector;
+  }
+  auto compacted = loaded->asUnchecked<RowVector>()->transformChildren(
+      [&](const VectorPtr& child) {
+        return compactStrings(child, options, pool, stats);
+      });
+  return compacted != nullptr ? compacted : vector;
+}
+
+RowVectorPtr compactStrings(
+    const RowVectorPtr& input,
+    const StringCompactionOptions& options,
+    memory::MemoryPool* pool,
+    StringCompactionStats* stats) {
+  auto result = compactStrings(
+      std::static_pointer_cast<BaseVector>(input), options, pool, stats);
+  if (result == input) {
+    return input;
+  }
+  return std::static_pointer_cast<RowVector>(result);
+}
+} // namespace facebook::velox
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox {
+
+struct StringCompactionOptions {
+  /// A string vector is compacted if the bytes of the strings it references
+  /// are less than this ratio of the bytes of the string buffers it holds.
+  /// 0 disables the compaction.
+  double minLiveRatio{0.1};
+
+  /// A string vector is not compacted if it holds less than this many bytes
+  /// of string buffers.
+  uint64_t minHeldBytes{1 << 20};
+};
+
+struct StringCompactionStats {
+  /// The number of string vectors copied.
+  uint32_t numCompactedVectors{0};
+  /// The bytes of string buffers held by the vectors before compaction.
+  uint64_t heldBytes{0};
+  /// The bytes of strings copied into the compacted vectors.
+  uint64_t liveBytes{0};
+};
+
+/// Copies the strings referenced by 'vector' into a new flat vector with a
+/// single string buffer of the exact size if 'vector' holds string buffers
+/// much larger than the strings it references. This is the case after a
+/// selective filter, where a dictionary or a copy over a few rows keeps the
+/// string buffers of the whole input alive. Applies to VARCHAR and VARBINARY
+/// vectors which are flat or wrap a flat vector, and to the children of a flat
+/// ROW vector. Returns 'vector' itself if nothing is compacted. Lazy vectors
+/// which are not loaded are left as is.
+///
+/// The copy costs one pass over the live strings. It pays off when the vector
+/// is held for long, e.g. by an operator which keeps its input past
+/// addInput(), and the released buffers outweigh the copied bytes, which
+/// 'options' control. 'stats' is updated for each compacted vector if given.
+VectorPtr compactStrings(
+    const VectorPtr& vector,
+    const StringCompactionOptions& options,
+    memory::MemoryPool* pool,
+    StringCompactionStats* stats = nullptr);
+
+/// Same as above for the columns of 'input'.
+RowVectorPtr compactStrings(
+    const RowVectorPtr& input,
+    const StringCompactionOptions& options,
+    memory::MemoryPool* pool,
+    StringCompactionStats* stats = nullptr);
+
+} // namespace facebook::velox
@@ -47,12 +47,28 @@ FOLLY_ALWAYS_INLINE int32_t toCacheIndex(const TypePtr& type) {
 
   return -1;
 }
+
+FOLLY_ALWAYS_INLINE bool isComplexType(const TypePtr& type) {
+  return type->kind() == TypeKind::ARRAY || type->kind() == TypeKind::MAP ||
+      type->kind() == TypeKind::ROW;
+}
+
+FOLLY_ALWAYS_INLINE bool isStringType(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
 } // namespace
 
 VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
-  auto cacheIndex = toCacheIndex(type);
-  if (cacheIndex >= 0 && size <= kMaxRecycleSize) {
-    return vectors_[cacheIndex].pop(type, size, *pool_);
+  if (size <= kMaxRecycleSize) {
+    auto cacheIndex = toCacheIndex(type);
+    if (cacheIndex >= 0) {
+      return vectors_[cacheIndex].pop(type, size, *pool_);
+    }
+    if (isComplexType(type)) {
+      if (auto* typePool = complexTypePool(type, false)) {
+        return typePool->pop(type, size, *pool_);
+      }
+    }
   }
   return BaseVector::create(type, size, pool_);
 }
@@ -65,11 +81,19 @@ bool VectorPool::release(VectorPtr& vector) {
     return false;
   }
 
+  TypePool* typePool{nullptr};
   auto cacheIndex = toCacheIndex(vector->type());
-  if (cacheIndex < 0) {
+  if (cacheIndex >= 0) {
+    typePool = &vectors_[cacheIndex];
+  } else if (isComplexType(vector->type())) {
+    typePool = complexTypePool(vector->type(), true);
+  }
+  if (typePool == nullptr || !typePool->canPushBack(*vector)) {
     return false;
   }
-  return vectors_[cacheIndex].maybePushBack(vector);
+  maybeTakeNulls(*vector);
+  typePool->pushBack(vector);
+  return true;
 }
 
 size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
@@ -84,25 +108,161 @@ size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
   return numReleased;
 }
 
+BufferPtr VectorPool::getNulls(vector_size_t size) {
+  const auto numBytes = bits::nbytes(size);
+  for (auto i = numNulls_ - 1; i >= 0; --i) {
+    if (nulls_[i]->capacity() < numBytes) {
+      continue;
+    }
+    auto nulls = std::move(nulls_[i]);
+    if (i != --numNulls_) {
+      nulls_[i] = std::move(nulls_[numNulls_]);
+    }
+    nulls->setSize(numBytes);
+    simd::memset(nulls->asMutable<char>(), bits::kNotNullByte, numBytes);
+    return nulls;
+  }
+  return AlignedBuffer::allocate<bool>(size, pool_, bits::kNotNull);
+}
+
+bool VectorPool::releaseNulls(BufferPtr& nulls) {
+  if (nulls == nullptr || !nulls->isMutable() || numNulls_ >= kNumNulls ||
+      nulls->pool() != pool_) {
+    return false;
+  }
+  nulls_[numNulls_++] = std::move(nulls);
+  return true;
+}
+
+void VectorPool::maybeTakeNulls(BaseVector& vector) {
+  // BaseVector::prepareForReuse() drops a nulls buffer without nulls. Keep it
+  // for the next vector which needs one instead.
+  auto nulls = vector.nulls();
+  if (nulls == nullptr || numNulls_ >= kNumNulls) {
+    return;
+  }
+  if (BaseVector::countNulls(nulls, vector.size()) != 0) {
+    return;
+  }
+  vector.resetNulls();
+  if (!releaseNulls(nulls)) {
+    vector.setNulls(nulls);
+  }
+}
+
 void VectorPool::clear() {
   for (auto& vectorPool : vectors_) {
     vectorPool.clear();
   }
+  for (auto i = 0; i < numComplexTypes_; ++i) {
+    complexVectors_[i].type = nullptr;
+    complexVectors_[i].vectors.clear();
+  }
+  numComplexTypes_ = 0;
+  std::fill_n(nulls_.begin(), numNulls_, nullptr);
+  numNulls_ = 0;
 }
 
-bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
+uint64_t VectorPool::stringBytesPerRowHint(const TypePtr& type) const {
+  auto cacheIndex = toCacheIndex(type);
+  if (cacheIndex < 0 || !isStringType(type->kind())) {
+    return 0;
+  }
+  return vectors_[cacheIndex].stringBytesPerRowHint;
+}
+
+VectorPool::TypePool* VectorPool::complexTypePool(
+    const TypePtr& type,
+    bool create) {
+  for (auto i = 0; i < numComplexTypes_; ++i) {
+    auto& entry = complexVectors_[i];
+    if (entry.type.get() == type.get() || *entry.type == *type) {
+      return &entry.vectors;
+    }
+  }
+  if (!create || numComplexTypes_ >= kNumComplexTypes) {
+    return nullptr;
+  }
+  auto& entry = complexVectors_[numComplexTypes_++];
+  entry.type = type;
+  return &entry.vectors;
+}
+
+bool VectorPool::TypePool::canPushBack(const BaseVector& vector) const {
   // Check that this is a Flat Vector with an initialized, unique, and mutable
-  // values Buffer and an uninitialized or unique and mutable nulls Buffer.
-  if (!vector->isWritable() || !vector->isFlatEncoding() || !vector->values()) {
+  // values Buffer and an uninitialized or unique and mutable nulls Buffer, or
+  // an array, map or row vector whose buffers and children are unique and
+  // mutable.
+  if (size >= kNumPerType || !vector.isWritable()) {
     return false;
   }
-  if (size >= kNumPerType) {
-    return false;
+  switch (vector.encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return vector.values() != nullptr;
+    case VectorEncoding::Simple::ARRAY:
+    case VectorEncoding::Simple::MAP:
+    case VectorEncoding::Simple::ROW:
+      return true;
+    default:
+      return false;
   }
+}
+
+void VectorPool::TypePool::pushBack(VectorPtr& vector) {
+  VELOX_DCHECK(canPushBack(*vector));
 
+  if (isStringType(vector->typeKind())) {
+    updateStringBytesHint(*vector);
+  }
   vector->prepareForReuse();
+  if (vector->encoding() == VectorEncoding::Simple::ROW) {
+    // RowVector::prepareForReuse() resizes the children to 0. Make the row
+    // vector empty as well so that 'pop' resizes the children back.
+    vector->resize(0);
+  }
   vectors[size++] = std::move(vector);
-  return true;
+}
+
+void VectorPool::TypePool::updateStringBytesHint(const BaseVector& vector) {
+  if (vector.size() == 0) {
+    return;
+  }
+  uint64_t usedBytes{0};
+  for (const auto& buffer :
+       vector.asUnchecked<FlatVector<StringView>>()->stringBuffers()) {
+    usedBytes += buffer->size();
+  }
+  const uint64_t bytesPerRow = bits::divRoundUp(usedBytes, vector.size());
+  // Decay the hint so that a single large batch does not make all the later
+  // vectors hold a large buffer.
+  stringBytesPerRowHint = std::max(
+      bytesPerRow, stringBytesPerRowHint - stringBytesPerRowHint / 4);
+}
+
+void VectorPool::TypePool::ensureStringCapacity(
+    BaseVector& vector,
+    vector_size_t vectorSize) const {
+  const uint64_t numBytes = std::min<uint64_t>(
+      stringBytesPerRowHint * vectorSize,
+      FlatVector<StringView>::kMaxStringSizeForReuse);
+  // Vectors with less than the initial string buffer size grow on demand as
+  // usual.
+  if (numBytes <= FlatVector<StringView>::kInitialStringSize) {
+    return;
+  }
+  auto* flat = vector.asUnchecked<FlatVector<StringView>>();
+  // A recycled vector keeps at most one empty string buffer. Replace it with a
+  // large enough one instead of adding a second buffer next to it.
+  const auto& stringBuffers = flat->stringBuffers();
+  if (!stringBuffers.empty()) {
+    VELOX_DCHECK_EQ(stringBuffers.size(), 1);
+    VELOX_DCHECK_EQ(stringBuffers.back()->size(), 0);
+    if (stringBuffers.back()->capacity() >= numBytes) {
+      return;
+    }
+    flat->clearStringBuffers();
+  }
+  flat->getBufferWithSpace(numBytes, true);
 }
 
 VectorPtr VectorPool::TypePool::pop(
@@ -110,6 +270,7 @@ VectorPtr VectorPool::TypePool::pop(
     vector_size_t vectorSize,
     memory::MemoryPool& pool) {
   if (size) {
+    const bool isString = isStringType(type->kind());
     auto result = std::move(vectors[--size]);
     if (UNLIKELY(result->rawNulls() != nullptr)) {
       // This is a recyclable vector, no need to check uniqueness.
@@ -118,9 +279,7 @@ VectorPtr VectorPool::TypePool::pop(
           bits::kNotNullByte,
           bits::roundUp(std::min<int32_t>(vectorSize, result->size()), 64) / 8);
     }
-    if (UNLIKELY(
-            result->typeKind() == TypeKind::VARCHAR ||
-            result->typeKind() == TypeKind::VARBINARY)) {
+    if (UNLIKELY(isString)) {
       simd::memset(
           const_cast<void*>(result->valuesAsVoid()),
           0,
@@ -129,6 +288,9 @@ VectorPtr VectorPool::TypePool::pop(
     if (result->size() != vectorSize) {
       result->resize(vectorSize);
     }
+    if (UNLIKELY(isString)) {
+      ensureStringCapacity(*result, vectorSize);
+    }
     return result;
   }
   return BaseVector::create(type, vectorSize, &pool);
@@ -20,42 +20,76 @@
 
 namespace facebook::velox {
 
-/// A thread-level cache of pre-allocated flat vectors of different types.
+/// A thread-level cache of pre-allocated vectors of different types.
 /// Keeps up to 10 recyclable vectors of each type. A vector is
-/// recyclable if it is flat and recursively singly-referenced.
-/// Only singleton built-in types are supported. Decimal types, fixed-size array
-/// type, complex and custom types are not supported. Calling 'get' for an
-/// unsupported type already returns a newly allocated vector. Calling 'release'
-/// for an unsupported type is a no-op.
+/// recyclable if it is flat, array, map or row encoded and recursively
+/// singly-referenced. Singleton built-in scalar types are cached by type kind.
+/// Up to 8 distinct complex types are cached by type equality, together with
+/// their children. Decimal types, fixed-size array type and custom types are
+/// not supported. Calling 'get' for an unsupported type already returns a
+/// newly allocated vector. Calling 'release' for an unsupported type is a
+/// no-op.
+///
+/// For strings the pool keeps the largest reusable string buffer of a
+/// released vector and learns the number of string bytes per row the vectors
+/// of each type use. A recycled vector returned by 'get' has its string buffer
+/// grown to fit a typical batch of the requested size. The pool also keeps
+/// the nulls buffers without nulls which 'release' would otherwise drop, see
+/// 'getNulls'.
 class VectorPool {
  public:
   explicit VectorPool(memory::MemoryPool* pool) : pool_{pool} {}
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
-  /// 'pool_' if no pre-allocated vector or type is a complex type.
+  /// 'pool_' if no pre-allocated vector or type is not supported.
   VectorPtr get(const TypePtr& type, vector_size_t size);
 
-  /// Moves vector into 'this' if it is flat, recursively singly referenced and
-  /// there is space. The function returns true if 'vector' is not null and has
-  /// been returned back to this pool, otherwise returns false.
+  /// Moves vector into 'this' if it is recyclable and there is space. The
+  /// function returns true if 'vector' is not null and has been returned back
+  /// to this pool, otherwise returns false.
   bool release(VectorPtr& vector);
 
   size_t release(std::vector<VectorPtr>& vectors);
 
-  /// Clears all the cached vectors.
+  /// Returns a possibly recycled nulls buffer for 'size' rows with all rows set
+  /// to not null.
+  BufferPtr getNulls(vector_size_t size);
+
+  /// Moves 'nulls' into 'this' if it is mutable and there is space. Returns
+  /// true if 'nulls' has been returned back to this pool.
+  bool releaseNulls(BufferPtr& nulls);
+
+  /// Clears all the cached vectors and nulls buffers.
   void clear();
 
+  /// Returns the learned number of string bytes per row for a vector of 'type'
+  /// returned by 'get'. Returns 0 if 'type' is not VARCHAR or VARBINARY or
+  /// nothing has been learned yet.
+  uint64_t stringBytesPerRowHint(const TypePtr& type) const;
+
  private:
   /// Max number of elements for a vector to be recyclable. The larger
   /// the batch the less the win from recycling.
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
   static constexpr int32_t kNumPerType = 10;
+  /// Max number of distinct complex types to cache vectors for.
+  static constexpr int32_t kNumComplexTypes = 8;
+  /// Max number of cached nulls buffers.
+  static constexpr int32_t kNumNulls = 32;
 
   struct TypePool {
     int32_t size{0};
     std::array<VectorPtr, kNumPerType> vectors;
 
-    bool maybePushBack(VectorPtr& vector);
+    /// Decaying max of the string bytes per row used by the released vectors.
+    /// Only used for VARCHAR and VARBINARY.
+    uint64_t stringBytesPerRowHint{0};
+
+    /// Returns true if 'vector' is recyclable and there is space for it.
+    bool canPushBack(const BaseVector& vector) const;
+
+    /// Moves 'vector' into the pool. 'canPushBack' must be true for it.
+    void pushBack(VectorPtr& vector);
 
     VectorPtr pop(
         const TypePtr& type,
@@ -64,8 +98,26 @@ class VectorPool {
 
     /// Clears all the cached vectors.
     void clear();
+
+   private:
+    void updateStringBytesHint(const BaseVector& vector);
+
+    void ensureStringCapacity(BaseVector& vector, vector_size_t vectorSize)
+        const;
   };
 
+  struct ComplexTypePool {
+    TypePtr type;
+    TypePool vectors;
+  };
+
+  // Returns the pool for complex 'type'. Returns nullptr if 'type' is not
+  // cached and 'create' is false or there is no space for another type.
+  TypePool* complexTypePool(const TypePtr& type, bool create);
+
+  // Moves the nulls buffer of 'vector' into the nulls cache if it has no nulls.
+  void maybeTakeNulls(BaseVector& vector);
+
   memory::MemoryPool* const pool_;
 
   static constexpr int32_t kNumCachedVectorTypes =
@@ -73,6 +125,14 @@ class VectorPool {
 
   /// Caches of pre-allocated vectors indexed by typeKind.
   std::array<TypePool, kNumCachedVectorTypes> vectors_;
+
+  /// Caches of pre-allocated vectors of complex types.
+  int32_t numComplexTypes_{0};
+  std::array<ComplexTypePool, kNumComplexTypes> complexVectors_;
+
+  /// Cache of nulls buffers.
+  int32_t numNulls_{0};
+  std::array<BufferPtr, kNumNulls> nulls_;
 };
 
 /// A simple vector ptr wrapper with an associated vector pool. It releases
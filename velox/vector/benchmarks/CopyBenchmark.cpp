@@ -66,6 +66,26 @@ size_t runBenchmark(
   return runBenchmark(data, selected, type, pool, data->size());
 }
 
+// Copies 'data' with one copyRanges() call per iteration. Every other row is
+// copied in a range of its own, as in the output of Unnest or MergeJoin.
+size_t runCopyRangesBenchmark(const VectorPtr& data, memory::MemoryPool* pool) {
+  folly::BenchmarkSuspender suspender;
+  const vector_size_t numRanges = data->size() / 2;
+  std::vector<BaseVector::CopyRange> ranges(numRanges);
+  for (auto i = 0; i < numRanges; ++i) {
+    ranges[i] = {i * 2, i, 1};
+  }
+  auto target = BaseVector::create(data->type(), numRanges, pool);
+  suspender.dismiss();
+
+  constexpr size_t kNumIters = 100;
+  for (auto i = 0; i < kNumIters; ++i) {
+    BaseVector::prepareForReuse(target, numRanges);
+    target->copyRanges(data.get(), ranges);
+  }
+  return numRanges * kNumIters;
+}
+
 BENCHMARK_MULTI(copyArray) {
   folly::BenchmarkSuspender suspender;
   std::shared_ptr<memory::MemoryPool> pool{
@@ -360,6 +380,93 @@ BENCHMARK_MULTI(copyStructNonContiguous) {
   return kIter * kSize;
 }
 
+BENCHMARK_MULTI(copyArrayRanges) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{
+      memory::memoryManager()->addLeafPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  auto arrayVector = vectorMaker.arrayVector<int32_t>(
+      10'000,
+      [](auto row) { return row % 10; },
+      [](auto row) { return row % 23; },
+      [](auto row) { return row % 13 == 0; });
+  suspender.dismiss();
+
+  return runCopyRangesBenchmark(arrayVector, pool.get());
+}
+
+BENCHMARK_MULTI(copyMapRanges) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{
+      memory::memoryManager()->addLeafPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  auto mapVector = vectorMaker.mapVector<int32_t, int32_t>(
+      10'000,
+      [](auto row) { return row % 10; },
+      [](auto row) { return row % 23; },
+      [](auto row) { return row % 37; });
+  suspender.dismiss();
+
+  return runCopyRangesBenchmark(mapVector, pool.get());
+}
+
+BENCHMARK_MULTI(copyArrayDictionaryRanges) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{
+      memory::memoryManager()->addLeafPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  auto arrayVector = vectorMaker.arrayVector<int32_t>(
+      size,
+      [](auto row) { return row % 10; },
+      [](auto row) { return row % 23; });
+  auto indices = makeIndices(
+      size, pool.get(), [size](auto row) { return (row * 13) % size; });
+  auto dictionary = BaseVector::wrapInDictionary(
+      BufferPtr(nullptr), indices, size, arrayVector);
+  suspender.dismiss();
+
+  return runCopyRangesBenchmark(dictionary, pool.get());
+}
+
+BENCHMARK_MULTI(copyStructOfArrayRanges) {
+  folly::BenchmarkSuspender suspender;
+  std::shared_ptr<memory::MemoryPool> pool{
+      memory::memoryManager()->addLeafPool()};
+  test::VectorMaker vectorMaker{pool.get()};
+
+  const vector_size_t size = 10'000;
+  auto rowVector = vectorMaker.rowVector({
+      vectorMaker.flatVector<int64_t>(size, folly::identity),
+      vectorMaker.arrayVector<int32_t>(
+          size,
+          [](auto row) { return row % 10; },
+          [](auto row) { return row % 23; }),
+      vectorMaker.mapVector<int32_t, int32_t>(
+          size,
+          [](auto row) { return row % 5; },
+          [](auto row) { return row % 23; },
+          [](auto row) { return row % 37; }),
+  });
+  // One range per row which are all adjacent.
+  std::vector<BaseVector::CopyRange> ranges(size);
+  for (auto i = 0; i < size; ++i) {
+    ranges[i] = {i, i, 1};
+  }
+  auto target = BaseVector::create(rowVector->type(), size, pool.get());
+  suspender.dismiss();
+
+  constexpr size_t kNumIters = 100;
+  for (auto i = 0; i < kNumIters; ++i) {
+    BaseVector::prepareForReuse(target, size);
+    target->copyRanges(rowVector.get(), ranges);
+  }
+  return size * kNumIters;
+}
+
 } // namespace
 } // namespace facebook::velox
 
@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/vector/BiasEncoding.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/SimpleVector.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
 
@@ -157,4 +159,153 @@ TYPED_TEST(BiasVectorOverflowTest, minOverflowTest_delta_int32) {
   this->runMinOverflowTest(delta);
 }
 
+class BiasEncodingTest : public BiasVectorTestBase {
+ protected:
+  template <typename T>
+  void assertDecoded(const BaseVector& expected, const BaseVector& actual) {
+    DecodedVector decoded(actual);
+    ASSERT_EQ(decoded.size(), expected.size());
+    for (vector_size_t row = 0; row < expected.size(); ++row) {
+      ASSERT_EQ(decoded.isNullAt(row), expected.isNullAt(row)) << row;
+      if (!expected.isNullAt(row)) {
+        ASSERT_EQ(
+            decoded.valueAt<T>(row),
+            expected.asUnchecked<SimpleVector<T>>()->valueAt(row))
+            << row;
+      }
+    }
+  }
+};
+
+TEST_F(BiasEncodingTest, encode) {
+  auto flat = vectorMaker_.flatVector<int64_t>(
+      1'000,
+      [](auto row) { return 1'000 + row % 256; },
+      [](auto row) { return row % 7 == 0; });
+  auto encoded = biasEncode(flat, pool_.get());
+  ASSERT_EQ(encoded->encoding(), VectorEncoding::Simple::BIASED);
+  ASSERT_EQ(
+      encoded->asUnchecked<BiasVector<int64_t>>()->valueType(),
+      TypeKind::TINYINT);
+  ASSERT_LT(encoded->retainedSize(), flat->retainedSize());
+  assertDecoded<int64_t>(*flat, *encoded);
+
+  auto sliced = encoded->slice(2, 3);
+  assertDecoded<int64_t>(*flat->slice(2, 3), *sliced);
+
+  // Dictionary over the bias encoded vector.
+  auto indices = AlignedBuffer::allocate<vector_size_t>(3, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  rawIndices[0] = 5;
+  rawIndices[1] = 2;
+  rawIndices[2] = 1;
+  assertDecoded<int64_t>(
+      *BaseVector::wrapInDictionary(nullptr, indices, 3, flat),
+      *BaseVector::wrapInDictionary(nullptr, indices, 3, encoded));
+
+  auto integers =
+      vectorMaker_.flatVector<int32_t>({-60'000, -10'000, -5'000, 0});
+  encoded = biasEncode(integers, pool_.get());
+  ASSERT_EQ(
+      encoded->asUnchecked<BiasVector<int32_t>>()->valueType(),
+      TypeKind::SMALLINT);
+  assertDecoded<int32_t>(*integers, *encoded);
+
+  auto doubles = vectorMaker_.flatVector<double>(
+      1'000, [](auto row) { return row * 0.1; });
+  auto row = vectorMaker_.rowVector({flat, doubles});
+  auto encodedRow = biasEncode(row, pool_.get());
+  ASSERT_NE(encodedRow, row);
+  ASSERT_EQ(
+      encodedRow->childAt(0)->encoding(), VectorEncoding::Simple::BIASED);
+  ASSERT_EQ(encodedRow->childAt(1), row->childAt(1));
+}
+
+TEST_F(BiasEncodingTest, notEncoded) {
+  // The range is too wide.
+  VectorPtr wide = vectorMaker_.flatVector<int64_t>(
+      {0, std::numeric_limits<int64_t>::max()});
+  ASSERT_EQ(biasEncode(wide, pool_.get()), wide);
+
+  // The deltas would not be narrower than the values.
+  VectorPtr integers = vectorMaker_.flatVector<int32_t>(
+      {0, std::numeric_limits<int32_t>::max()});
+  ASSERT_EQ(biasEncode(integers, pool_.get()), integers);
+
+  // Logical types and all null vectors are left as is.
+  VectorPtr dates = vectorMaker_.flatVector<int32_t>({1, 2}, DATE());
+  ASSERT_EQ(biasEncode(dates, pool_.get()), dates);
+  VectorPtr nulls = vectorMaker_.flatVectorNullable<int64_t>(
+      {std::nullopt, std::nullopt});
+  ASSERT_EQ(biasEncode(nulls, pool_.get()), nulls);
+}
+
+TEST_F(BiasEncodingTest, decodeSelectedRows) {
+  auto flat = vectorMaker_.flatVector<int32_t>(
+      1'000, [](auto row) { return -100 + row % 200; });
+  auto encoded = biasEncode(flat, pool_.get());
+  ASSERT_EQ(encoded->encoding(), VectorEncoding::Simple::BIASED);
+
+  SelectivityVector rows(1'000, false);
+  rows.setValidRange(10, 20, true);
+  rows.updateBounds();
+  DecodedVector decoded(*encoded, rows);
+  rows.applyToSelected([&](auto row) {
+    ASSERT_EQ(decoded.valueAt<int32_t>(row), flat->valueAt(row)) << row;
+  });
+
+  // A dictionary with nulls over the bias encoded vector.
+  auto indices = AlignedBuffer::allocate<vector_size_t>(3, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  rawIndices[0] = 500;
+  rawIndices[1] = 0;
+  rawIndices[2] = 7;
+  auto nulls = AlignedBuffer::allocate<bool>(3, pool_.get(), bits::kNotNull);
+  bits::setNull(nulls->asMutable<uint64_t>(), 1);
+  assertDecoded<int32_t>(
+      *BaseVector::wrapInDictionary(nulls, indices, 3, flat),
+      *BaseVector::wrapInDictionary(nulls, indices, 3, encoded));
+}
+
+TEST_F(BiasEncodingTest, biasDecode) {
+  auto flat = vectorMaker_.flatVector<int64_t>(
+      1'000,
+      [](auto row) { return 1'000 + row % 256; },
+      [](auto row) { return row % 7 == 0; });
+  auto encoded = biasEncode(flat, pool_.get());
+  ASSERT_EQ(encoded->encoding(), VectorEncoding::Simple::BIASED);
+
+  auto decoded = biasDecode(encoded, pool_.get());
+  ASSERT_EQ(decoded->encoding(), VectorEncoding::Simple::FLAT);
+  assertDecoded<int64_t>(*flat, *decoded);
+
+  // Only the rows of a dictionary over the bias encoded vector are decoded.
+  auto indices = AlignedBuffer::allocate<vector_size_t>(3, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  rawIndices[0] = 5;
+  rawIndices[1] = 7;
+  rawIndices[2] = 900;
+  decoded = biasDecode(
+      BaseVector::wrapInDictionary(nullptr, indices, 3, encoded), pool_.get());
+  ASSERT_EQ(decoded->encoding(), VectorEncoding::Simple::FLAT);
+  ASSERT_EQ(decoded->size(), 3);
+  assertDecoded<int64_t>(
+      *BaseVector::wrapInDictionary(nullptr, indices, 3, flat), *decoded);
+
+  // The other columns of a row vector are kept.
+  auto doubles = vectorMaker_.flatVector<double>(
+      1'000, [](auto row) { return row * 0.1; });
+  auto row = vectorMaker_.rowVector({encoded, doubles});
+  auto decodedRow = biasDecode(row, pool_.get());
+  ASSERT_NE(decodedRow, row);
+  ASSERT_EQ(decodedRow->childAt(0)->encoding(), VectorEncoding::Simple::FLAT);
+  assertDecoded<int64_t>(*flat, *decodedRow->childAt(0));
+  ASSERT_EQ(decodedRow->childAt(1), doubles);
+
+  // Vectors which are not bias encoded are returned as is.
+  ASSERT_EQ(biasDecode(flat, pool_.get()), flat);
+  auto flatRow = vectorMaker_.rowVector({flat, doubles});
+  ASSERT_EQ(biasDecode(flatRow, pool_.get()), flatRow);
+}
+
 } // namespace facebook::velox::test
@@ -23,6 +23,7 @@
 #include "velox/type/Variant.h"
 #include "velox/vector/BaseVector.h"
 #include "velox/vector/SelectivityVector.h"
+#include "velox/vector/SequenceVector.h"
 #include "velox/vector/TypeAliases.h"
 #include "velox/vector/tests/VectorTestUtils.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
@@ -1197,6 +1198,133 @@ TEST_F(DecodedVectorTest, emptyRowsMultiDict) {
   }
 }
 
+TEST_F(DecodedVectorTest, sequence) {
+  // Runs of 3, 1, 4 and 2 rows.
+  auto lengths = makeIndices({3, 1, 4, 2});
+  auto runs = makeNullableFlatVector<int64_t>({10, std::nullopt, 30, 40});
+  auto sequence =
+      std::make_shared<SequenceVector<int64_t>>(pool(), 10, runs, lengths);
+  const std::vector<vector_size_t> expectedRuns{0, 0, 0, 1, 2, 2, 2, 2, 3, 3};
+
+  auto assertDecoded = [&](const DecodedVector& decoded,
+                           const BaseVector& expected,
+                           const SelectivityVector& rows) {
+    ASSERT_FALSE(decoded.isIdentityMapping());
+    ASSERT_FALSE(decoded.isConstantMapping());
+    ASSERT_EQ(decoded.base(), runs.get());
+    rows.applyToSelected([&](auto row) {
+      ASSERT_EQ(decoded.isNullAt(row), expected.isNullAt(row)) << row;
+      if (!expected.isNullAt(row)) {
+        ASSERT_EQ(
+            decoded.valueAt<int64_t>(row),
+            expected.as<SimpleVector<int64_t>>()->valueAt(row))
+            << row;
+      }
+    });
+  };
+
+  SelectivityVector allRows(10);
+  DecodedVector decoded(*sequence);
+  assertDecoded(decoded, *sequence, allRows);
+  for (vector_size_t row = 0; row < 10; ++row) {
+    ASSERT_EQ(decoded.index(row), expectedRuns[row]);
+  }
+
+  // Decodes a subset of the rows.
+  SelectivityVector someRows(7);
+  someRows.setValid(1, false);
+  someRows.updateBounds();
+  decoded.decode(*sequence, someRows);
+  assertDecoded(decoded, *sequence, someRows);
+
+  // Dictionary over sequence.
+  auto dictionary = wrapInDictionary(
+      makeIndices({9, 0, 3, 5, 5, 8}),
+      6,
+      std::static_pointer_cast<BaseVector>(sequence));
+  decoded.decode(*dictionary);
+  assertDecoded(decoded, *dictionary, SelectivityVector(6));
+  ASSERT_EQ(decoded.index(0), 3);
+  ASSERT_EQ(decoded.index(2), 1);
+
+  // Dictionary with ascending indices over sequence. The decoder is reused
+  // after the non-ascending indices above.
+  dictionary = wrapInDictionary(
+      makeIndices({0, 2, 3, 4, 7, 8, 9}),
+      7,
+      std::static_pointer_cast<BaseVector>(sequence));
+  decoded.decode(*dictionary);
+  assertDecoded(decoded, *dictionary, SelectivityVector(7));
+  const std::vector<vector_size_t> expectedAscendingRuns{0, 0, 1, 2, 2, 3, 3};
+  for (vector_size_t row = 0; row < 7; ++row) {
+    ASSERT_EQ(decoded.index(row), expectedAscendingRuns[row]);
+  }
+}
+
+TEST_F(DecodedVectorTest, gatherValues) {
+  auto test = [&](auto typeTag) {
+    using T = decltype(typeTag);
+    SCOPED_TRACE(CppToType<T>::create()->toString());
+    const vector_size_t size = 1'000;
+    auto base = makeFlatVector<T>(
+        size, [](auto row) { return row * 3; }, nullEvery(7));
+    // Reverses the base and adds nulls in the dictionary.
+    auto indices = makeIndices(size, [&](auto row) { return size - 1 - row; });
+    auto dictionary = BaseVector::wrapInDictionary(
+        makeNulls(size, nullEvery(11)), indices, size, base);
+
+    auto assertGathered = [&](const SelectivityVector& rows) {
+      DecodedVector decoded(*dictionary, rows);
+      std::vector<T> result(rows.end());
+      decoded.gatherValues(rows, result.data());
+      rows.applyToSelected([&](auto row) {
+        ASSERT_EQ(decoded.isNullAt(row), dictionary->isNullAt(row)) << row;
+        if (!decoded.isNullAt(row)) {
+          ASSERT_EQ(result[row], decoded.valueAt<T>(row)) << row;
+        }
+      });
+    };
+
+    assertGathered(SelectivityVector(size));
+    // Odd sized ranges with a partial last batch.
+    assertGathered(SelectivityVector(size - 3));
+    SelectivityVector someRows(size);
+    for (auto row = 0; row < size; row += 3) {
+      someRows.setValid(row, false);
+    }
+    someRows.setValid(size - 1, false);
+    someRows.updateBounds();
+    assertGathered(someRows);
+
+    // Identity and constant mappings read the values directly.
+    DecodedVector decoded(*base);
+    std::vector<T> result(size);
+    decoded.gatherValues(SelectivityVector(size), result.data());
+    ASSERT_EQ(result[10], 30);
+    decoded.decode(*BaseVector::wrapInConstant(size, 2, base));
+    decoded.gatherValues(SelectivityVector(size), result.data());
+    ASSERT_EQ(result[size - 1], 6);
+  };
+  test(int32_t{});
+  test(int64_t{});
+  test(float{});
+  test(double{});
+}
+
+TEST_F(DecodedVectorTest, gatherNulls) {
+  auto base = makeFlatVector<int64_t>(
+      1'000, [](auto row) { return row; }, nullEvery(3));
+  auto indices = makeIndices(1'000, [](auto row) { return (row * 7) % 1'000; });
+  auto dictionary = wrapInDictionary(indices, 1'000, base);
+  DecodedVector decoded(*dictionary);
+  const auto* nulls = decoded.nulls(nullptr);
+  ASSERT_NE(nulls, nullptr);
+  for (auto row = 0; row < 1'000; ++row) {
+    ASSERT_EQ(bits::isBitNull(nulls, row), base->isNullAt((row * 7) % 1'000))
+        << row;
+  }
+}
+
 TEST_F(DecodedVectorTest, flatNulls) {
   // Flat vector with no nulls.
   auto flatNoNulls = makeFlatVector<int64_t>(100, [](auto row) { return row; });
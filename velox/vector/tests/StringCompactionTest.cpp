@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/vector/StringCompaction.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox {
+namespace {
+
+class StringCompactionTest : public testing::Test,
+                             public test::VectorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance({});
+  }
+
+  // Returns 'size' strings of 100 bytes each.
+  VectorPtr makeStrings(vector_size_t size) {
+    return makeFlatVector<std::string>(size, [](auto row) {
+      return fmt::format("{:0>100}", row);
+    });
+  }
+
+  static uint64_t stringBufferBytes(const VectorPtr& vector) {
+    uint64_t bytes{0};
+    for (const auto& buffer :
+         vector->asFlatVector<StringView>()->stringBuffers()) {
+      bytes += buffer->capacity();
+    }
+    return bytes;
+  }
+
+  const StringCompactionOptions options_{
+      .minLiveRatio = 0.1, .minHeldBytes = 1'000};
+};
+
+TEST_F(StringCompactionTest, selectiveDictionary) {
+  auto strings = makeStrings(1'000);
+  auto indices = makeIndices({3, 500, 999, 500});
+  auto nulls = makeNulls(4, [](auto row) { return row == 1; });
+  auto filtered = BaseVector::wrapInDictionary(nulls, indices, 4, strings);
+
+  StringCompactionStats stats;
+  auto compacted = compactStrings(filtered, options_, pool(), &stats);
+  ASSERT_NE(compacted, filtered);
+  ASSERT_EQ(compacted->encoding(), VectorEncoding::Simple::FLAT);
+  test::assertEqualVectors(filtered, compacted);
+  ASSERT_EQ(stats.numCompactedVectors, 1);
+  ASSERT_EQ(stats.liveBytes, 300);
+  ASSERT_EQ(stats.heldBytes, stringBufferBytes(strings));
+  ASSERT_LT(stringBufferBytes(compacted), stats.heldBytes / 10);
+}
+
+TEST_F(StringCompactionTest, notCompacted) {
+  auto strings = makeStrings(1'000);
+
+  // Most of the strings are referenced.
+  auto indices = makeIndices(900, [](auto row) { return row; });
+  auto dictionary = wrapInDictionary(indices, 900, strings);
+  ASSERT_EQ(compactStrings(dictionary, options_, pool()), dictionary);
+  ASSERT_EQ(compactStrings(strings, options_, pool()), strings);
+
+  // The held string buffers are too small to bother.
+  auto small = wrapInDictionary(makeIndices({1}), 1, strings);
+  ASSERT_EQ(
+      compactStrings(
+          small, {.minLiveRatio = 0.1, .minHeldBytes = 1 << 30}, pool()),
+      small);
+
+  // Compaction is disabled.
+  ASSERT_EQ(
+      compactStrings(small, {.minLiveRatio = 0, .minHeldBytes = 0}, pool()),
+      small);
+
+  // Inline strings do not reference the string buffers.
+  auto inlined = makeFlatVector<std::string>({"a", "b"});
+  inlined->asFlatVector<StringView>()->getBufferWithSpace(10'000);
+  auto compacted = compactStrings(inlined, options_, pool());
+  ASSERT_NE(compacted, inlined);
+  test::assertEqualVectors(inlined, compacted);
+  ASSERT_EQ(stringBufferBytes(compacted), 0);
+
+  // Constant and non-string vectors are left as is.
+  auto constant = BaseVector::wrapInConstant(1, 0, strings);
+  ASSERT_EQ(compactStrings(constant, options_, pool()), constant);
+  auto integers = makeFlatVector<int64_t>({1, 2, 3});
+  ASSERT_EQ(compactStrings(integers, options_, pool()), integers);
+}
+
+TEST_F(StringCompactionTest, rowVector) {
+  auto strings = makeStrings(1'000);
+  auto indices = makeIndices({10, 20});
+  auto input = makeRowVector(
+      {makeFlatVector<int32_t>({1, 2}),
+       wrapInDictionary(indices, 2, strings),
+       makeRowVector({wrapInDictionary(indices, 2, strings)})});
+
+  StringCompactionStats stats;
+  auto compacted = compactStrings(input, options_, pool(), &stats);
+  ASSERT_NE(compacted, input);
+  test::assertEqualVectors(input, compacted);
+  ASSERT_EQ(stats.numCompactedVectors, 2);
+  ASSERT_EQ(compacted->childAt(0), input->childAt(0));
+  ASSERT_EQ(
+      compacted->childAt(1)->encoding(), VectorEncoding::Simple::FLAT);
+
+  auto flat = makeRowVector({makeFlatVector<int32_t>({1, 2}), strings});
+  ASSERT_EQ(compactStrings(flat, options_, pool()), flat);
+}
+} // namespace
+} // namespace facebook::velox
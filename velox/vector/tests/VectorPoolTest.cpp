@@ -196,4 +196,136 @@ TEST_F(VectorPoolTest, clear) {
     ASSERT_EQ(vectorPtrs[i].lock(), nullptr);
   }
 }
+
+TEST_F(VectorPoolTest, complexTypes) {
+  VectorPool vectorPool(pool());
+
+  const auto rowType = ROW({"a", "b"}, {BIGINT(), ARRAY(VARCHAR())});
+  auto vector = vectorPool.get(rowType, 1'000);
+  ASSERT_EQ(1'000, vector->size());
+  auto* row = vector->as<RowVector>();
+  ASSERT_EQ(1'000, row->childAt(0)->size());
+  row->childAt(0)->setNull(5, true);
+  auto* rawVector = vector.get();
+  auto* rawArray = row->childAt(1).get();
+  ASSERT_TRUE(vectorPool.release(vector));
+
+  // An equal but not identical type finds the recycled vector. The children
+  // are resized back and the nulls are cleared.
+  vector =
+      vectorPool.get(ROW({"a", "b"}, {BIGINT(), ARRAY(VARCHAR())}), 2'000);
+  ASSERT_EQ(rawVector, vector.get());
+  row = vector->as<RowVector>();
+  ASSERT_EQ(rawArray, row->childAt(1).get());
+  ASSERT_EQ(2'000, row->childAt(0)->size());
+  ASSERT_EQ(2'000, row->childAt(1)->size());
+  ASSERT_FALSE(row->childAt(0)->isNullAt(5));
+  ASSERT_EQ(0, row->childAt(1)->as<ArrayVector>()->sizeAt(1'500));
+
+  // A shared child makes the vector not recyclable.
+  auto child = row->childAt(1);
+  ASSERT_FALSE(vectorPool.release(vector));
+  child.reset();
+
+  auto arrayVector = makeArrayVector<int64_t>({{1, 2}, {3}, {}});
+  auto* rawArrayVector = arrayVector.get();
+  ASSERT_TRUE(vectorPool.release(arrayVector));
+  arrayVector = vectorPool.get(ARRAY(BIGINT()), 3);
+  ASSERT_EQ(rawArrayVector, arrayVector.get());
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_EQ(0, arrayVector->as<ArrayVector>()->sizeAt(i));
+  }
+
+  // Only a limited number of distinct complex types is cached.
+  for (auto i = 0; i < 20; ++i) {
+    auto type = ROW({fmt::format("c{}", i)}, {BIGINT()});
+    auto rowVector = vectorPool.get(type, 10);
+    vectorPool.release(rowVector);
+  }
+  auto rowVector = vectorPool.get(ROW({"c19"}, {BIGINT()}), 10);
+  auto* rawRowVector = rowVector.get();
+  ASSERT_FALSE(vectorPool.release(rowVector));
+  ASSERT_EQ(rawRowVector, rowVector.get());
+}
+
+TEST_F(VectorPoolTest, stringBuffers) {
+  VectorPool vectorPool(pool());
+
+  const std::string value(1'000, 'x');
+  auto vector = vectorPool.get(VARCHAR(), 1'000);
+  auto* flat = vector->asFlatVector<StringView>();
+  for (auto i = 0; i < 1'000; ++i) {
+    flat->set(i, StringView(value));
+  }
+  ASSERT_GT(flat->stringBuffers().size(), 1);
+  ASSERT_TRUE(vectorPool.release(vector));
+  ASSERT_EQ(1'000, vectorPool.stringBytesPerRowHint(VARCHAR()));
+  ASSERT_EQ(0, vectorPool.stringBytesPerRowHint(VARBINARY()));
+  ASSERT_EQ(0, vectorPool.stringBytesPerRowHint(BIGINT()));
+
+  // The recycled vector grows its kept string buffer to fit the learned
+  // number of bytes for the requested size.
+  vector = vectorPool.get(VARCHAR(), 1'000);
+  flat = vector->asFlatVector<StringView>();
+  ASSERT_EQ(1, flat->stringBuffers().size());
+  ASSERT_EQ(0, flat->stringBuffers()[0]->size());
+  ASSERT_GE(flat->stringBuffers()[0]->capacity(), 1'000'000);
+  for (auto i = 0; i < 1'000; ++i) {
+    flat->set(i, StringView(value));
+  }
+  ASSERT_EQ(1, flat->stringBuffers().size());
+
+  // A newly allocated vector grows its string buffer on demand.
+  auto other = vectorPool.get(VARCHAR(), 500);
+  ASSERT_TRUE(other->asFlatVector<StringView>()->stringBuffers().empty());
+
+  // The kept string buffer is not shrunk for a smaller vector.
+  const auto* stringBuffer = flat->stringBuffers()[0].get();
+  ASSERT_TRUE(vectorPool.release(vector));
+  vector = vectorPool.get(VARCHAR(), 100);
+  flat = vector->asFlatVector<StringView>();
+  ASSERT_EQ(1, flat->stringBuffers().size());
+  ASSERT_EQ(stringBuffer, flat->stringBuffers()[0].get());
+
+  // The hint decays when the released vectors use fewer bytes per row.
+  ASSERT_TRUE(vectorPool.release(other));
+  ASSERT_EQ(750, vectorPool.stringBytesPerRowHint(VARCHAR()));
+}
+
+TEST_F(VectorPoolTest, nullsBuffers) {
+  VectorPool vectorPool(pool());
+
+  // A nulls buffer without nulls is taken from a released vector.
+  auto vector = vectorPool.get(BIGINT(), 1'000);
+  vector->setNull(10, true);
+  vector->setNull(10, false);
+  auto* rawNulls = vector->nulls().get();
+  ASSERT_NE(rawNulls, nullptr);
+  ASSERT_TRUE(vectorPool.release(vector));
+
+  auto nulls = vectorPool.getNulls(500);
+  ASSERT_EQ(rawNulls, nulls.get());
+  ASSERT_EQ(bits::nbytes(500), nulls->size());
+  ASSERT_EQ(0, BaseVector::countNulls(nulls, 500));
+
+  // A nulls buffer which is too small is not used.
+  ASSERT_TRUE(vectorPool.releaseNulls(nulls));
+  ASSERT_EQ(nulls, nullptr);
+  auto largeNulls = vectorPool.getNulls(10'000);
+  ASSERT_NE(rawNulls, largeNulls.get());
+  ASSERT_EQ(0, BaseVector::countNulls(largeNulls, 10'000));
+
+  // A shared nulls buffer is not taken.
+  auto copy = largeNulls;
+  ASSERT_FALSE(vectorPool.releaseNulls(largeNulls));
+
+  // A vector with nulls keeps its nulls buffer.
+  vector = vectorPool.get(BIGINT(), 1'000);
+  vector->setNull(10, true);
+  rawNulls = vector->nulls().get();
+  ASSERT_TRUE(vectorPool.release(vector));
+  vector = vectorPool.get(BIGINT(), 1'000);
+  ASSERT_EQ(rawNulls, vector->nulls().get());
+  ASSERT_FALSE(vector->isNullAt(10));
+}
 } // namespace facebook::velox::test
@@ -3117,6 +3117,70 @@ TEST_F(VectorTest, rowCopyRangesWithGap) {
   test::assertEqualVectors(expected, target);
 }
 
+TEST_F(VectorTest, nestedCopyManyRanges) {
+  const vector_size_t size = 1'000;
+  auto array = makeArrayVector<int32_t>(
+      size,
+      [](auto row) { return row % 7; },
+      [](auto row) { return row; },
+      nullEvery(5));
+  auto map = makeMapVector<int32_t, int64_t>(
+      size,
+      [](auto row) { return row % 4; },
+      [](auto row) { return row; },
+      [](auto row) { return row * 2; },
+      nullEvery(3));
+  auto dictionary = BaseVector::wrapInDictionary(
+      makeNulls(size, nullEvery(11)),
+      makeIndices(size, [](auto row) { return (row * 13) % size; }),
+      size,
+      array);
+  auto row = makeRowVector({array, map}, nullEvery(7));
+
+  // Copies every other row in a range of its own, then the same rows one at a
+  // time.
+  std::vector<BaseVector::CopyRange> ranges;
+  for (auto i = 0; i < size / 2; ++i) {
+    ranges.push_back({i * 2, i, 1});
+  }
+  for (const auto& source :
+       std::vector<VectorPtr>{array, map, dictionary, row}) {
+    SCOPED_TRACE(source->toString());
+    auto target = BaseVector::create(source->type(), size / 2, pool());
+    target->copyRanges(source.get(), ranges);
+    auto expected = BaseVector::create(source->type(), size / 2, pool());
+    for (const auto& range : ranges) {
+      expected->copy(source.get(), range.targetIndex, range.sourceIndex, 1);
+    }
+    test::assertEqualVectors(expected, target);
+  }
+
+  // Only the source rows spanned by the ranges are decoded.
+  const std::vector<BaseVector::CopyRange> tailRanges = {
+      {900, 0, 3}, {950, 3, 1}, {990, 4, 10}};
+  for (const auto& source : std::vector<VectorPtr>{array, map, dictionary}) {
+    SCOPED_TRACE(source->toString());
+    auto target = BaseVector::create(source->type(), 14, pool());
+    target->copyRanges(source.get(), tailRanges);
+    for (const auto& range : tailRanges) {
+      for (auto i = 0; i < range.count; ++i) {
+        ASSERT_TRUE(target->equalValueAt(
+            source.get(), range.targetIndex + i, range.sourceIndex + i));
+      }
+    }
+  }
+
+  // Adjacent ranges over a row vector are merged before the children are
+  // copied.
+  std::vector<BaseVector::CopyRange> adjacentRanges;
+  for (auto i = 0; i < size; ++i) {
+    adjacentRanges.push_back({i, i, 1});
+  }
+  auto target = BaseVector::create(row->type(), size, pool());
+  target->copyRanges(row.get(), adjacentRanges);
+  test::assertEqualVectors(row, target);
+}
+
 TEST_F(VectorTest, containsNullAtIntegers) {
   VectorPtr data = makeFlatVector<int32_t>({1, 2, 3});
   for (auto i = 0; i < data->size(); ++i) {